@@ -21,6 +21,17 @@
     (ar) = (type*)calloc((num),sizeof(type)); \
 }
 
+#define ARRAY_ALIGNMENT 8 /**< @brief Alignment in bytes of arrays carved from a block */
+
+#define ARRAY_size(type, num) \
+  ((((num)*sizeof(type)+ARRAY_ALIGNMENT-1)/ARRAY_ALIGNMENT)*ARRAY_ALIGNMENT)
+
+#define ARRAY_carve(ar, type, num, block, offset) {	\
+    if ((block))					\
+      (ar) = (type*)((block)+(offset));			\
+    (offset) += ARRAY_size(type,num);			\
+}
+
 #define ARRAY_clear(ar, type, num) {	 \
     if ((ar))			         \
       memset((ar),0,(num)*sizeof(type)); \
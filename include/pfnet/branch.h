@@ -71,10 +71,14 @@ typedef struct Vec Vec;
 // Prototypes
 void BRANCH_array_del(Branch* br_array, int size);
 void* BRANCH_array_get(void* br, int index);
+REAL* BRANCH_array_get_phase(Branch* br_array, int size, int t);
+REAL* BRANCH_array_get_ratio(Branch* br_array, int size, int t);
 Branch* BRANCH_array_new(int size, int num_periods);
 void BRANCH_array_show(Branch* br, int size, int t);
 void BRANCH_clear_sensitivities(Branch* br);
 void BRANCH_clear_flags(Branch* br, char flag_type);
+void BRANCH_copy_from_branch(Branch* br, Branch* other);
+void BRANCH_copy_state_from_branch(Branch* br, Branch* other);
 void BRANCH_propagate_data_in_time(Branch* br);
 int BRANCH_get_num_periods(Branch* br);
 char BRANCH_get_type(Branch* br);
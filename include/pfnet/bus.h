@@ -133,6 +133,8 @@ void BUS_del_branch_m(Bus* bus, Branch* branch);
 void BUS_array_del(Bus* bus_array, int size);
 BOOL BUS_array_check(Bus* bus_array, int size, BOOL verbose);
 void* BUS_array_get(void* bus_array, int index);
+REAL* BUS_array_get_v_ang(Bus* bus_array, int size, int t);
+REAL* BUS_array_get_v_mag(Bus* bus_array, int size, int t);
 Bus* BUS_array_new(int size, int num_periods);
 void BUS_array_show(Bus* bus_array, int size, int t);
 void BUS_array_get_max_mismatches(Bus* bus_array, int size, REAL* P, REAL* Q, int t);
@@ -142,6 +144,8 @@ void BUS_clear_sensitivities(Bus* bus);
 void BUS_clear_mismatches(Bus* bus);
 void BUS_clear_vargen(Bus* bus);
 void BUS_clear_bat(Bus* bus);
+void BUS_copy_from_bus(Bus* bus, Bus* other);
+void BUS_copy_state_from_bus(Bus* bus, Bus* other);
 void BUS_propagate_data_in_time(Bus* bus);
 char BUS_get_obj_type(void* bus);
 int BUS_get_degree(Bus* bus);
@@ -225,6 +229,7 @@ void BUS_init(Bus* bus, int num_periods);
 void BUS_inject_P(Bus* bus, REAL P, int t);
 void BUS_inject_Q(Bus* bus, REAL Q, int t);
 BOOL BUS_is_equal(Bus* bus, Bus* other);
+BOOL BUS_is_isolated(Bus* bus);
 BOOL BUS_is_regulated_by_gen(Bus* bus);
 BOOL BUS_is_regulated_by_tran(Bus* bus);
 BOOL BUS_is_regulated_by_shunt(Bus* bus);
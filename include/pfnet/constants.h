@@ -20,6 +20,15 @@
 #define LOWER_LIMITS 2
 /** @} */
 
+// Evaluation levels
+/** \defgroup eval_levels Codes for evaluation levels
+ *  @{
+ */
+#define EVAL_F 1   /**< @brief Function values only */
+#define EVAL_FJ 2  /**< @brief Function values and first derivatives */
+#define EVAL_FJH 3 /**< @brief Function values, first and second derivatives */
+/** @} */
+
 // Pi
 #define PI 3.14159265359
 
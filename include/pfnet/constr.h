@@ -20,11 +20,23 @@
 // Buffer
 #define CONSTR_BUFFER_SIZE 1024 /**< @brief Default constraint buffer size for strings */
 
+// Branch sides
+#define CONSTR_SIDE_K 0x01    /**< @brief Side of bus "k" of a branch */
+#define CONSTR_SIDE_M 0x02    /**< @brief Side of bus "m" of a branch */
+#define CONSTR_SIDE_BOTH 0x03 /**< @brief Both sides of a branch */
+
+// Matrix-free products
+#define CONSTR_PROD_NONE 0 /**< @brief No product (J and Hessians are stored) */
+#define CONSTR_PROD_JV 1   /**< @brief Jacobian times a vector of variable values */
+#define CONSTR_PROD_JTW 2  /**< @brief Transposed Jacobian times a vector of constraint values */
+#define CONSTR_PROD_HV 3   /**< @brief Combined Hessian times a vector of variable values */
+
 // Constraint
 typedef struct Constr Constr;
 
 // Function prototypes
 void CONSTR_clear_H_nnz(Constr* c);
+void CONSTR_clear_data(Constr* c);
 void CONSTR_clear_bus_counted(Constr* c);
 void CONSTR_combine_H(Constr* c, Vec* coeff, BOOL ensure_psd);
 void CONSTR_del(Constr* constr);
@@ -60,6 +72,14 @@ int CONSTR_get_J_row(Constr* c);
 int* CONSTR_get_J_row_ptr(Constr* c);
 char* CONSTR_get_bus_counted(Constr *c);
 int CONSTR_get_bus_counted_size(Constr* c);
+int CONSTR_get_branch_J_nnz(Constr* c, Branch* br, int t);
+int CONSTR_get_branch_J_row(Constr* c, Branch* br, int t);
+int CONSTR_get_bus_J_nnz(Constr* c, Bus* bus, int t);
+int CONSTR_get_bus_J_row(Constr* c, Bus* bus, int t);
+void CONSTR_save_bus_counters(Constr* c, Bus* bus, int t);
+void CONSTR_sync_eval_counters(Constr* c);
+char CONSTR_get_eval_level(Constr* c);
+char CONSTR_get_product_type(Constr* c);
 void* CONSTR_get_data(Constr* c);
 Constr* CONSTR_get_next(Constr* c);
 void CONSTR_finalize_structure_of_Hessians(Constr* c);
@@ -72,10 +92,18 @@ int CONSTR_list_len(Constr* clist);
 void CONSTR_list_del(Constr* clist);
 void CONSTR_list_combine_H(Constr* clist, Vec* coeff, BOOL ensure_psd);
 void CONSTR_list_count_step(Constr* clist, Branch* br, int t);
+void CONSTR_list_count_closed_form(Constr* clist);
+BOOL CONSTR_list_needs_count_sweep(Constr* clist);
 void CONSTR_list_allocate(Constr* clist);
 void CONSTR_list_clear(Constr* clist);
+void CONSTR_list_clear_data(Constr* clist);
+void CONSTR_list_clear_bus_counted(Constr* clist);
+void CONSTR_list_set_eval_level(Constr* clist, char level);
 void CONSTR_list_analyze_step(Constr* clist, Branch* br, int t);
 void CONSTR_list_eval_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_list_eval_serial_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_list_eval_bus_step(Constr* clist, Bus* bus, int t, Vec* v, Vec* ve);
+void CONSTR_list_sync_eval_counters(Constr* clist);
 void CONSTR_list_store_sens_step(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 Constr* CONSTR_new(Net* net);
 void CONSTR_set_name(Constr* c, char* name);
@@ -99,16 +127,29 @@ void CONSTR_set_A_row(Constr* c, int index);
 void CONSTR_set_G_row(Constr* c, int index);
 void CONSTR_set_J_row(Constr* c, int index);
 void CONSTR_set_bus_counted(Constr* c, char* counted, int size);
+void CONSTR_set_eval_level(Constr* c, char level);
+void CONSTR_set_matrix_free(Constr* c, BOOL flag);
+void CONSTR_set_product(Constr* c, char type, Vec* coeff, Vec* in, Vec* out);
 void CONSTR_set_data(Constr* c, void* data);
 void CONSTR_init(Constr* c);
 void CONSTR_count(Constr* c);
 void CONSTR_count_step(Constr* c, Branch* br, int t);
+BOOL CONSTR_needs_count_sweep(Constr* c);
 void CONSTR_allocate(Constr* c);
 void CONSTR_clear(Constr* c);
 void CONSTR_analyze(Constr* c);
 void CONSTR_analyze_step(Constr* c, Branch* br, int t);
 void CONSTR_eval(Constr* c, Vec* v, Vec* ve);
 void CONSTR_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_eval_branch_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides);
+void CONSTR_eval_bus_step(Constr* c, Bus* bus, int t, Vec* v, Vec* ve);
+void CONSTR_clear_bus_step(Constr* c, Bus* bus, int t);
+BOOL CONSTR_is_matrix_free(Constr* c);
+void CONSTR_add_J_product(Constr* c, int row, int col, REAL d);
+void CONSTR_add_H_product(Constr* c, int row, int i, int j, REAL d);
+void CONSTR_eval_stored_product(Constr* c);
+BOOL CONSTR_has_clear_bus_step(Constr* c);
+BOOL CONSTR_has_bus_branch_steps(Constr* c);
 void CONSTR_store_sens(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 BOOL CONSTR_is_safe_to_count(Constr* c);
@@ -120,14 +161,20 @@ BOOL CONSTR_has_error(Constr* c);
 char* CONSTR_get_error_string(Constr* c);
 void CONSTR_update_network(Constr* c);
 Net* CONSTR_get_network(Constr* c);
+Pool* CONSTR_get_pool(Constr* c);
+void CONSTR_set_pool(Constr* c, Pool* pool);
 int CONSTR_get_num_extra_vars(Constr* c);
 void CONSTR_set_num_extra_vars(Constr* c, int num);
 void CONSTR_set_func_init(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_count_step(Constr* c, void (*func)(Constr* c, Branch* br, int t));
+void CONSTR_set_func_count(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_allocate(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_clear(Constr* c, void (*func)(Constr* c));
 void CONSTR_set_func_analyze_step(Constr* c, void (*func)(Constr* c, Branch* br, int t));
 void CONSTR_set_func_eval_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* v, Vec* ve));
+void CONSTR_set_func_eval_branch_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides));
+void CONSTR_set_func_eval_bus_step(Constr* c, void (*func)(Constr* c, Bus* bus, int t, Vec* v, Vec* ve));
+void CONSTR_set_func_clear_bus_step(Constr* c, void (*func)(Constr* c, Bus* bus, int t));
 void CONSTR_set_func_store_sens_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl));
 void CONSTR_set_func_free(Constr* c, void (*func)(Constr* c));
 
@@ -24,7 +24,10 @@ void CONSTR_ACPF_count_step(Constr* c, Branch* br, int t);
 void CONSTR_ACPF_allocate(Constr* c);
 void CONSTR_ACPF_clear(Constr* c);
 void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t);
-void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_ACPF_eval_branch_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides);
+void CONSTR_ACPF_eval_bus_step(Constr* c, Bus* bus, int t, Vec* v, Vec* ve);
+void CONSTR_ACPF_add_H_product(Constr* c, int P_index, int Q_index, int i, int j, REAL HP_val, REAL HQ_val);
+void CONSTR_ACPF_clear_bus_step(Constr* c, Bus* bus, int t);
 void CONSTR_ACPF_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_ACPF_free(Constr* c);
 
@@ -18,6 +18,7 @@
 Constr* CONSTR_GEN_RAMP_new(Net* net);
 void CONSTR_GEN_RAMP_init(Constr* c);
 void CONSTR_GEN_RAMP_count_step(Constr* c, Branch* br, int t);
+void CONSTR_GEN_RAMP_count(Constr* c);
 void CONSTR_GEN_RAMP_allocate(Constr* c);
 void CONSTR_GEN_RAMP_clear(Constr* c);
 void CONSTR_GEN_RAMP_analyze_step(Constr* c, Branch* br, int t);
@@ -18,6 +18,7 @@
 Constr* CONSTR_LBOUND_new(Net* net);
 void CONSTR_LBOUND_init(Constr* c);
 void CONSTR_LBOUND_count_step(Constr* c, Branch* br, int t);
+void CONSTR_LBOUND_count(Constr* c);
 void CONSTR_LBOUND_allocate(Constr* c);
 void CONSTR_LBOUND_clear(Constr* c);
 void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t);
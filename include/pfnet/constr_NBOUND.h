@@ -24,7 +24,8 @@ void CONSTR_NBOUND_count_step(Constr* c, Branch* br, int t);
 void CONSTR_NBOUND_allocate(Constr* c);
 void CONSTR_NBOUND_clear(Constr* c);
 void CONSTR_NBOUND_analyze_step(Constr* c, Branch* br, int t);
-void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve);
+void CONSTR_NBOUND_eval_branch_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides);
+void CONSTR_NBOUND_eval_bus_step(Constr* c, Bus* bus, int t, Vec* v, Vec* ve);
 void CONSTR_NBOUND_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void CONSTR_NBOUND_free(Constr* c);
 
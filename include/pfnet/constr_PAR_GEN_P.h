@@ -20,6 +20,7 @@
 Constr* CONSTR_PAR_GEN_P_new(Net* net);
 void CONSTR_PAR_GEN_P_init(Constr* c);
 void CONSTR_PAR_GEN_P_count_step(Constr* c, Branch* br, int t);
+void CONSTR_PAR_GEN_P_count(Constr* c);
 void CONSTR_PAR_GEN_P_allocate(Constr* c);
 void CONSTR_PAR_GEN_P_clear(Constr* c);
 void CONSTR_PAR_GEN_P_analyze_step(Constr* c, Branch* br, int t);
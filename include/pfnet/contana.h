@@ -0,0 +1,47 @@
+/** @file contana.h
+ *  @brief This file lists the constants and routines associated with the ContAna data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __CONTANA_HEADER__
+#define __CONTANA_HEADER__
+
+#include "net.h"
+#include "contingency.h"
+#include "pflow.h"
+
+// Buffer
+#define CONTANA_BUFFER_SIZE 1024 /**< @brief Default buffer size for strings */
+
+// AC contingency analysis
+typedef struct ContAna ContAna;
+
+// Function prototypes
+void CONTANA_add_worker(ContAna* ca, Net* net);
+void CONTANA_clear_error(ContAna* ca);
+void CONTANA_del(ContAna* ca);
+REAL CONTANA_get_branch_max_loading(ContAna* ca, int k);
+int CONTANA_get_branch_num_overloads(ContAna* ca, int k);
+int CONTANA_get_branch_worst(ContAna* ca, int k);
+REAL CONTANA_get_bus_v_vio(ContAna* ca, int k);
+char* CONTANA_get_error_string(ContAna* ca);
+REAL CONTANA_get_gen_Q_vio(ContAna* ca, int k);
+REAL CONTANA_get_mismatch(ContAna* ca, int k);
+int CONTANA_get_num_conts(ContAna* ca);
+int CONTANA_get_num_iters(ContAna* ca, int k);
+int CONTANA_get_num_threads(ContAna* ca);
+int CONTANA_get_num_workers(ContAna* ca);
+PFlow* CONTANA_get_pflow(ContAna* ca);
+REAL CONTANA_get_time(ContAna* ca);
+BOOL CONTANA_has_converged(ContAna* ca, int k);
+BOOL CONTANA_has_error(ContAna* ca);
+ContAna* CONTANA_new(void);
+void CONTANA_run(ContAna* ca, Net* net, Cont** conts, int num_conts);
+void CONTANA_set_num_threads(ContAna* ca, int num_threads);
+
+#endif
@@ -30,6 +30,8 @@ void CONT_add_gen_outage(Cont* cont, Gen* gen);
 void CONT_apply(Cont* cont);
 void CONT_clear(Cont* cont);
 void CONT_del(Cont* cont);
+Branch* CONT_get_branch_outage(Cont* cont, int k);
+Gen* CONT_get_gen_outage(Cont* cont, int k);
 int CONT_get_num_gen_outages(Cont* cont);
 int CONT_get_num_branch_outages(Cont* cont);
 BOOL CONT_has_gen_outage(Cont* cont, Gen* gen);
@@ -0,0 +1,53 @@
+/** @file dcflow.h
+ *  @brief This file lists the constants and routines associated with the DCFlow data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __DCFLOW_HEADER__
+#define __DCFLOW_HEADER__
+
+#include "net.h"
+#include "spmat.h"
+#include "splu.h"
+
+// Buffer
+#define DCFLOW_BUFFER_SIZE 1024 /**< @brief Default buffer size for strings */
+
+// PTDF
+#define DCFLOW_PTDF_BLOCK_SIZE 32 /**< @brief Number of PTDF columns computed together */
+
+// Outages
+#define DCFLOW_ISLAND_TOL 1e-8 /**< @brief Smallest pivot of the outage transfer equations before an outage is treated as islanding */
+
+// DC power flow solver
+typedef struct DCFlow DCFlow;
+
+// Function prototypes
+void DCFLOW_analyze(DCFlow* dc, Net* net);
+void DCFLOW_clear_error(DCFlow* dc);
+void DCFLOW_clear_PTDF(DCFlow* dc);
+void DCFLOW_compute_flows(DCFlow* dc, Vec* w, Vec* flows, int num);
+void DCFLOW_compute_PTDF(DCFlow* dc, int* bus_indices, int num);
+void DCFLOW_compute_transfer_flows(DCFlow* dc, int* br_indices, int num, Vec* flows);
+void DCFLOW_del(DCFlow* dc);
+char* DCFLOW_get_error_string(DCFlow* dc);
+REAL DCFLOW_get_LODF(DCFlow* dc, int br_index, int out_index);
+SpLU* DCFLOW_get_LU(DCFlow* dc);
+int DCFLOW_get_num_branches(DCFlow* dc);
+int DCFLOW_get_num_buses(DCFlow* dc);
+int DCFLOW_get_num_PTDF_columns(DCFlow* dc);
+REAL DCFLOW_get_OTDF(DCFlow* dc, int br_index, int out_index, int bus_index);
+REAL DCFLOW_get_PTDF(DCFlow* dc, int br_index, int bus_index);
+REAL* DCFLOW_get_PTDF_column(DCFlow* dc, int bus_index);
+BOOL DCFLOW_has_error(DCFlow* dc);
+BOOL DCFLOW_is_analyzed(DCFlow* dc);
+DCFlow* DCFLOW_new(void);
+void DCFLOW_solve(DCFlow* dc, Net* net);
+void DCFLOW_solve_angles(DCFlow* dc, Vec* P, Vec* w, int num);
+
+#endif
@@ -0,0 +1,59 @@
+/** @file dcscreen.h
+ *  @brief This file lists the constants and routines associated with the DCScreen data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __DCSCREEN_HEADER__
+#define __DCSCREEN_HEADER__
+
+#include "net.h"
+#include "contingency.h"
+#include "dcflow.h"
+
+// Buffer
+#define DCSCREEN_BUFFER_SIZE 1024 /**< @brief Default buffer size for strings */
+
+// Ratings
+#define DCSCREEN_RATING_A 0 /**< @brief Branch rating A */
+#define DCSCREEN_RATING_B 1 /**< @brief Branch rating B */
+#define DCSCREEN_RATING_C 2 /**< @brief Branch rating C */
+
+// Defaults
+#define DCSCREEN_TOP 10         /**< @brief Default number of contingencies kept */
+#define DCSCREEN_BLOCK_SIZE 32  /**< @brief Number of contingencies whose transfer flows are computed together */
+
+// DC contingency screening
+typedef struct DCScreen DCScreen;
+
+// Function prototypes
+void DCSCREEN_add_double(DCScreen* s, int br_index1, int br_index2);
+void DCSCREEN_clear_doubles(DCScreen* s);
+void DCSCREEN_clear_error(DCScreen* s);
+void DCSCREEN_del(DCScreen* s);
+char* DCSCREEN_get_error_string(DCScreen* s);
+int DCSCREEN_get_num_doubles(DCScreen* s);
+int DCSCREEN_get_num_islanding(DCScreen* s);
+int DCSCREEN_get_num_overloaded(DCScreen* s);
+int DCSCREEN_get_num_results(DCScreen* s);
+int DCSCREEN_get_num_screened(DCScreen* s);
+char DCSCREEN_get_rating(DCScreen* s);
+int DCSCREEN_get_result_branch(DCScreen* s, int k, int j);
+REAL DCSCREEN_get_result_max_loading(DCScreen* s, int k);
+REAL DCSCREEN_get_result_severity(DCScreen* s, int k);
+int DCSCREEN_get_result_worst_branch(DCScreen* s, int k);
+BOOL DCSCREEN_get_singles(DCScreen* s);
+int DCSCREEN_get_top(DCScreen* s);
+BOOL DCSCREEN_has_error(DCScreen* s);
+DCScreen* DCSCREEN_new(void);
+Cont* DCSCREEN_new_cont(DCScreen* s, Net* net, int k);
+void DCSCREEN_run(DCScreen* s, DCFlow* dc, Net* net, int t);
+void DCSCREEN_set_rating(DCScreen* s, char rating);
+void DCSCREEN_set_singles(DCScreen* s, BOOL flag);
+void DCSCREEN_set_top(DCScreen* s, int top);
+
+#endif
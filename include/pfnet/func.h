@@ -45,10 +45,14 @@ Func* FUNC_list_add(Func* flist, Func* nf);
 int FUNC_list_len(Func* flist);
 void FUNC_list_del(Func* flist);
 void FUNC_list_count_step(Func* f, Branch* br, int t);
+void FUNC_list_count_closed_form(Func* f);
+BOOL FUNC_list_needs_count_sweep(Func* f);
 void FUNC_list_allocate(Func* f);
 void FUNC_list_clear(Func* f);
 void FUNC_list_analyze_step(Func* f, Branch* br, int t);
 void FUNC_list_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_list_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
+void FUNC_list_clear_bus_counted(Func* f);
 Func* FUNC_new(REAL weight, Net* net);
 void FUNC_set_name(Func* f, char* name);
 void FUNC_set_phi(Func* f, REAL phi);
@@ -59,12 +63,15 @@ void FUNC_set_bus_counted(Func* f, char* counted, int size);
 void FUNC_init(Func* f);
 void FUNC_count(Func* f);
 void FUNC_count_step(Func* f, Branch* br, int t);
+BOOL FUNC_needs_count_sweep(Func* f);
 void FUNC_allocate(Func* f);
 void FUNC_clear(Func* f);
 void FUNC_analyze(Func* f);
 void FUNC_analyze_step(Func* f, Branch* br, int t);
 void FUNC_eval(Func* f, Vec* var_values);
 void FUNC_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_eval_branch_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 BOOL FUNC_is_safe_to_count(Func* f);
 BOOL FUNC_is_safe_to_analyze(Func* f);
 BOOL FUNC_is_safe_to_eval(Func* f, Vec* values);
@@ -73,12 +80,17 @@ BOOL FUNC_has_error(Func* f);
 char* FUNC_get_error_string(Func* f);
 void FUNC_update_network(Func* f);
 Net* FUNC_get_network(Func* f);
+Pool* FUNC_get_pool(Func* f);
+void FUNC_set_pool(Func* f, Pool* pool);
 void FUNC_set_func_init(Func* f, void (*func)(Func* f));
 void FUNC_set_func_count_step(Func* f, void (*func)(Func* f, Branch* br, int t));
+void FUNC_set_func_count(Func* f, void (*func)(Func* f));
 void FUNC_set_func_allocate(Func* f, void (*func)(Func* f));
 void FUNC_set_func_clear(Func* f, void (*func)(Func* f));
 void FUNC_set_func_analyze_step(Func* f, void (*func)(Func* f, Branch* br, int t));
 void FUNC_set_func_eval_step(Func* f, void (*func)(Func* f, Branch* br, int t, Vec* v));
+void FUNC_set_func_eval_branch_step(Func* f, void (*func)(Func* f, Branch* br, int t, Vec* v));
+void FUNC_set_func_eval_bus_step(Func* f, void (*func)(Func* f, Bus* bus, int t, Vec* v));
 void FUNC_set_func_free(Func* f, void (*func)(Func* f));
 void* FUNC_get_data(Func* f);
 void FUNC_set_data(Func* f, void* data);
@@ -18,10 +18,11 @@
 Func* FUNC_GEN_COST_new(REAL weight, Net* net);
 void FUNC_GEN_COST_init(Func* f);
 void FUNC_GEN_COST_count_step(Func* f, Branch* br, int t);
+void FUNC_GEN_COST_count(Func* f);
 void FUNC_GEN_COST_allocate(Func* f);
 void FUNC_GEN_COST_clear(Func* f);
 void FUNC_GEN_COST_analyze_step(Func* f, Branch* br, int t);
-void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* v);
+void FUNC_GEN_COST_eval_bus_step(Func* f, Bus* bus, int t, Vec* v);
 void FUNC_GEN_COST_free(Func* f);
 
 #endif
@@ -18,10 +18,11 @@
 Func* FUNC_LOAD_UTIL_new(REAL weight, Net* net);
 void FUNC_LOAD_UTIL_init(Func* f);
 void FUNC_LOAD_UTIL_count_step(Func* f, Branch* br, int t);
+void FUNC_LOAD_UTIL_count(Func* f);
 void FUNC_LOAD_UTIL_allocate(Func* f);
 void FUNC_LOAD_UTIL_clear(Func* f);
 void FUNC_LOAD_UTIL_analyze_step(Func* f, Branch* br, int t);
-void FUNC_LOAD_UTIL_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_LOAD_UTIL_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 void FUNC_LOAD_UTIL_free(Func* f);
 
 #endif
@@ -21,7 +21,7 @@ void FUNC_NETCON_COST_count_step(Func* f, Branch* br, int t);
 void FUNC_NETCON_COST_allocate(Func* f);
 void FUNC_NETCON_COST_clear(Func* f);
 void FUNC_NETCON_COST_analyze_step(Func* f, Branch* br, int t);
-void FUNC_NETCON_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_NETCON_COST_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 void FUNC_NETCON_COST_free(Func* f);
 
 #endif
@@ -23,7 +23,7 @@ void FUNC_REG_PQ_count_step(Func* f, Branch* br, int t);
 void FUNC_REG_PQ_allocate(Func* f);
 void FUNC_REG_PQ_clear(Func* f);
 void FUNC_REG_PQ_analyze_step(Func* f, Branch* br, int t);
-void FUNC_REG_PQ_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_REG_PQ_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 void FUNC_REG_PQ_free(Func* f);
 
 #endif
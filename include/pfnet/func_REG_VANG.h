@@ -23,7 +23,8 @@ void FUNC_REG_VANG_count_step(Func* f, Branch* br, int t);
 void FUNC_REG_VANG_allocate(Func* f);
 void FUNC_REG_VANG_clear(Func* f);
 void FUNC_REG_VANG_analyze_step(Func* f, Branch* br, int t);
-void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_REG_VANG_eval_branch_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_REG_VANG_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 void FUNC_REG_VANG_free(Func* f);
 
 #endif
@@ -23,7 +23,7 @@ void FUNC_SLIM_VMAG_count_step(Func* f, Branch* br, int t);
 void FUNC_SLIM_VMAG_allocate(Func* f);
 void FUNC_SLIM_VMAG_clear(Func* f);
 void FUNC_SLIM_VMAG_analyze_step(Func* f, Branch* br, int t);
-void FUNC_SLIM_VMAG_eval_step(Func* f, Branch* br, int t, Vec* var_values);
+void FUNC_SLIM_VMAG_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values);
 void FUNC_SLIM_VMAG_free(Func* f);
 
 #endif
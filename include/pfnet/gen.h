@@ -54,6 +54,8 @@ Gen* GEN_array_new(int size, int num_periods);
 void GEN_array_show(Gen* gen_array, int size, int t);
 void GEN_clear_sensitivities(Gen* gen);
 void GEN_clear_flags(Gen* gen, char flag_type);
+void GEN_copy_from_gen(Gen* gen, Gen* other);
+void GEN_copy_state_from_gen(Gen* gen, Gen* other);
 void GEN_propagate_data_in_time(Gen* gen);
 int GEN_get_num_periods(Gen* gen);
 REAL GEN_get_sens_P_u_bound(Gen* gen, int t);
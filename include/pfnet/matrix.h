@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include "types.h"
+#include "pool.h"
 
 // Types
 typedef struct Mat Mat;
@@ -21,11 +22,17 @@ typedef struct Vec Vec;
 // Function prototypes
 void MAT_add_to_dentry(Mat* m, int index, REAL value);
 void MAT_array_del(Mat* m, int size);
+void MAT_array_del_to_pool(Pool* pool, Mat* m, int size);
 Mat* MAT_array_new(int size);
+Mat* MAT_array_new_block(int size, int size1, int size2, int* nnz, int* pattern);
+Mat* MAT_array_new_block_from_pool(Pool* pool, int size, int size1, int size2, int* nnz, int* pattern);
 Mat* MAT_array_get(Mat* m, int index);
+REAL* MAT_array_get_block_data(Mat* m, int size);
 void MAT_array_set_zero_d(Mat* m, int size);
 Mat* MAT_copy(Mat* m);
 void MAT_del(Mat* m);
+void MAT_del_to_pool(Pool* pool, Mat* m);
+void MAT_detach_view(Mat* m);
 int MAT_get_i(Mat* m, int index);
 int MAT_get_j(Mat* m, int index);
 REAL MAT_get_d(Mat* m, int index);
@@ -38,6 +45,7 @@ REAL* MAT_get_data_array(Mat* m);
 void MAT_init(Mat* m);
 Mat* MAT_new(int size1, int size2, int nnz);
 Mat* MAT_new_from_arrays(int size1, int size2, int nnz, int* row, int* col, REAL* data);
+Mat* MAT_new_from_pool(Pool* pool, int size1, int size2, int nnz);
 Vec* MAT_rmul_by_vec(Mat* m, Vec* v);
 void MAT_set_i(Mat* m, int index, int value);
 void MAT_set_j(Mat* m, int index, int value);
@@ -50,6 +58,7 @@ void MAT_set_col_array(Mat* m, int* array);
 void MAT_set_data_array(Mat* m, REAL* array);
 void MAT_set_nnz(Mat* m, int nnz);
 void MAT_set_owns_rowcol(Mat* m, BOOL flag);
+void MAT_set_data_view(Mat* m, REAL* data);
 void MAT_show(Mat* m);
 
 #endif
@@ -56,6 +56,8 @@ void NET_clear_flags(Net* net);
 void NET_clear_outages(Net* net);
 void NET_clear_properties(Net* net);
 void NET_clear_sensitivities(Net* net);
+Net* NET_copy(Net* net);
+void NET_copy_state(Net* net, Net* other);
 Bus* NET_create_sorted_bus_list(Net* net, int sort_by, int t);
 Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr);
 void NET_propagate_data_in_time(Net* net);
@@ -64,7 +66,11 @@ void NET_del(Net* net);
 void NET_init(Net* net, int num_periods);
 REAL NET_get_base_power(Net* net);
 Branch* NET_get_branch(Net* net, int index);
+REAL* NET_get_branch_phase_array(Net* net, int t);
+REAL* NET_get_branch_ratio_array(Net* net, int t);
 Bus* NET_get_bus(Net* net, int index);
+REAL* NET_get_bus_v_ang_array(Net* net, int t);
+REAL* NET_get_bus_v_mag_array(Net* net, int t);
 Bus* NET_get_bus_hash_number(Net* net);
 Bus* NET_get_bus_hash_name(Net* net);
 Vargen* NET_get_vargen_hash_name(Net* net);
@@ -105,6 +111,8 @@ int NET_get_num_switched_shunts(Net* net);
 int NET_get_num_vargens(Net* net);
 int NET_get_num_bats(Net* net);
 int NET_get_num_vars(Net* net);
+int NET_get_struc_version(Net* net);
+unsigned long NET_get_struc_fingerprint(Net* net);
 int NET_get_num_fixed(Net* net);
 int NET_get_num_bounded(Net* net);
 int NET_get_num_sparse(Net* net);
@@ -135,6 +143,7 @@ REAL NET_get_vargen_corr_radius(Net* net);
 REAL NET_get_vargen_corr_value(Net* net);
 BOOL NET_has_error(Net* net);
 Net* NET_new(int num_periods);
+void NET_inc_struc_version(Net* net);
 void NET_set_base_power(Net* net, REAL base_power);
 void NET_set_branch_array(Net* net, Branch* branch, int num);
 void NET_set_bus_array(Net* net, Bus* bus, int num);
@@ -153,6 +162,7 @@ char* NET_get_show_components_str(Net* net);
 void NET_show_properties(Net* net, int t);
 char* NET_get_show_properties_str(Net* net, int t);
 void NET_show_buses(Net* net, int number, int sort_by, int t);
+void NET_update_properties_bus_step(Net* net, Bus* bus, int t, Vec* values);
 void NET_update_properties_step(Net* net, Branch* br, int t, Vec* values);
 void NET_update_properties(Net* net, Vec* values);
 void NET_update_set_points(Net* net);
@@ -0,0 +1,67 @@
+/** @file pflow.h
+ *  @brief This file lists the constants and routines associated with the PFlow data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __PFLOW_HEADER__
+#define __PFLOW_HEADER__
+
+#include "net.h"
+#include "problem.h"
+#include "spmat.h"
+#include "splu.h"
+
+// Buffer
+#define PFLOW_BUFFER_SIZE 1024 /**< @brief Default buffer size for strings */
+
+// Methods
+#define PFLOW_METHOD_NR 0   /**< @brief Newton-Raphson */
+#define PFLOW_METHOD_FDXB 1 /**< @brief Fast decoupled, XB variant (resistances ignored in B') */
+#define PFLOW_METHOD_FDBX 2 /**< @brief Fast decoupled, BX variant (resistances ignored in B'') */
+
+// Defaults
+#define PFLOW_TOL 1e-4          /**< @brief Default tolerance on the largest residual entry (per unit) */
+#define PFLOW_MAX_ITERS 20      /**< @brief Default maximum number of iterations */
+#define PFLOW_LS_MAX_STEPS 10   /**< @brief Maximum number of step halvings in the line search */
+#define PFLOW_LS_DECREASE 1e-4  /**< @brief Sufficient decrease parameter of the line search */
+
+// Power flow solver
+typedef struct PFlow PFlow;
+
+// Function prototypes
+void PFLOW_clear_error(PFlow* pf);
+void PFLOW_del(PFlow* pf);
+void PFLOW_eval_residual(Prob* p, Vec* x, Vec* r);
+char* PFLOW_get_error_string(PFlow* pf);
+REAL PFLOW_get_iter_mismatch(PFlow* pf, int k);
+REAL PFLOW_get_iter_step(PFlow* pf, int k);
+REAL PFLOW_get_iter_time(PFlow* pf, int k);
+SpLU* PFLOW_get_LU(PFlow* pf);
+SpLU* PFLOW_get_LU_Bp(PFlow* pf);
+SpLU* PFLOW_get_LU_Bpp(PFlow* pf);
+BOOL PFLOW_get_line_search(PFlow* pf);
+int PFLOW_get_max_iters(PFlow* pf);
+char PFLOW_get_method(PFlow* pf);
+REAL PFLOW_get_mismatch(PFlow* pf);
+int PFLOW_get_num_iters(PFlow* pf);
+BOOL PFLOW_get_pvpq(PFlow* pf);
+REAL PFLOW_get_time(PFlow* pf);
+REAL PFLOW_get_tol(PFlow* pf);
+BOOL PFLOW_has_converged(PFlow* pf);
+BOOL PFLOW_has_error(PFlow* pf);
+PFlow* PFLOW_new(void);
+void PFLOW_set_line_search(PFlow* pf, BOOL flag);
+void PFLOW_set_max_iters(PFlow* pf, int max_iters);
+void PFLOW_set_method(PFlow* pf, char method);
+void PFLOW_set_pvpq(PFlow* pf, BOOL flag);
+void PFLOW_set_tol(PFlow* pf, REAL tol);
+void PFLOW_solve(PFlow* pf, Net* net);
+void PFLOW_solve_FD(PFlow* pf, Net* net);
+void PFLOW_solve_NR(PFlow* pf, Net* net);
+
+#endif
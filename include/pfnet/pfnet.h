@@ -14,7 +14,13 @@
 #include "parser.h"
 #include "net.h"
 #include "problem.h"
+#include "contingency.h"
 #include "graph.h"
+#include "splu.h"
+#include "pflow.h"
+#include "dcflow.h"
+#include "dcscreen.h"
+#include "contana.h"
 
 // Parsers
 #include "parser_MAT.h"
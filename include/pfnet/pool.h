@@ -0,0 +1,36 @@
+/** @file pool.h
+ *  @brief This file lists the constants and routines associated with the Pool data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __POOL_HEADER__
+#define __POOL_HEADER__
+
+#include <stdlib.h>
+#include "types.h"
+
+// Reuse
+#define POOL_MAX_WASTE 2 /**< @brief Largest ratio between the size of a retained buffer and a request it is used for */
+
+// Memory pool
+typedef struct Pool Pool;
+
+// Function prototypes
+void* POOL_alloc(Pool* pool, size_t size);
+void POOL_clear(Pool* pool);
+void POOL_del(Pool* pool);
+void POOL_free(Pool* pool, void* ptr, size_t size);
+size_t POOL_get_max_num_bytes(Pool* pool);
+int POOL_get_num_allocs(Pool* pool);
+int POOL_get_num_buffers(Pool* pool);
+size_t POOL_get_num_bytes(Pool* pool);
+int POOL_get_num_reuses(Pool* pool);
+Pool* POOL_new(void);
+void POOL_reset_stats(Pool* pool);
+
+#endif
@@ -15,6 +15,7 @@
 #include "constr.h"
 #include "func.h"
 #include "heur.h"
+#include "spmat.h"
 
 // Buffer
 #define PROB_BUFFER_SIZE 1024 /**< @brief Default problem buffer size for strings */
@@ -22,6 +23,12 @@
 // Inf
 #define PROB_EXTRA_VAR_INF 1e8 /**< @brief Large constant for lower and upper bounds */
 
+// Kinds of network components of variables
+#define PROB_VAR_NONE 0    /**< @brief Variable not associated with a bus or branch */
+#define PROB_VAR_BUS_V 1   /**< @brief Voltage variable of a bus */
+#define PROB_VAR_BUS_INJ 2 /**< @brief Variable of a device connected to a bus */
+#define PROB_VAR_BRANCH 3  /**< @brief Variable of a branch */
+
 // Problem
 typedef struct Prob Prob;
 
@@ -32,9 +39,23 @@ void PROB_add_heur(Prob* p, int type);
 void PROB_analyze(Prob* p);
 void PROB_apply_heuristics(Prob* p, Vec* point);
 void PROB_eval(Prob* p, Vec* point);
+void PROB_eval_f(Prob* p, Vec* point);
+void PROB_eval_fJ(Prob* p, Vec* point);
+void PROB_eval_with_level(Prob* p, Vec* point, char level);
+void PROB_eval_batch(Prob* p, Vec* points, int num_points, Vec* phi, Vec* f, Vec* J);
+void PROB_eval_product(Prob* p, Vec* point, char type, Vec* coeff, Vec* in, Vec* out);
+void PROB_eval_Jv(Prob* p, Vec* point, Vec* v, Vec* Jv);
+void PROB_eval_JTw(Prob* p, Vec* point, Vec* w, Vec* JTw);
+void PROB_eval_Hv(Prob* p, Vec* point, Vec* coeff, Vec* v, Vec* Hv);
+void PROB_eval_incremental(Prob* p, Vec* point, Vec* prev_point);
+void PROB_eval_changed(Prob* p, Vec* point, int* changed, int num_changed);
+void PROB_eval_partitions(Prob* p, Vec* x, Vec* y);
+void PROB_partition_buses(Prob* p);
 void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);
 void PROB_del(Prob* p);
 void PROB_del_matvec(Prob* p);
+void PROB_del_compressed(Prob* p);
+void PROB_del_merged(Prob* p);
 void PROB_clear(Prob* p);
 void PROB_clear_error(Prob* p);
 void PROB_combine_H(Prob* p, Vec* coeff, BOOL ensure_psd);
@@ -47,17 +68,30 @@ Vec* PROB_get_init_point(Prob* p);
 Vec* PROB_get_upper_limits(Prob* p);
 Vec* PROB_get_lower_limits(Prob* p);
 Net* PROB_get_network(Prob* p);
+Pool* PROB_get_pool(Prob* p);
 REAL PROB_get_phi(Prob* p);
 Vec* PROB_get_gphi(Prob* p);
 Mat* PROB_get_Hphi(Prob* p);
+SpMat* PROB_get_Hphi_csr(Prob* p);
+SpMat* PROB_get_Hphi_csc(Prob* p);
 Vec* PROB_get_b(Prob* p);
 Mat* PROB_get_A(Prob* p);
+SpMat* PROB_get_A_csr(Prob* p);
+SpMat* PROB_get_A_csc(Prob* p);
 Vec* PROB_get_l(Prob* p);
 Vec* PROB_get_u(Prob* p);
 Mat* PROB_get_G(Prob* p);
+SpMat* PROB_get_G_csr(Prob* p);
+SpMat* PROB_get_G_csc(Prob* p);
 Vec* PROB_get_f(Prob* p);
 Mat* PROB_get_J(Prob* p);
+SpMat* PROB_get_J_csr(Prob* p);
+SpMat* PROB_get_J_csc(Prob* p);
 Mat* PROB_get_H_combined(Prob* p);
+SpMat* PROB_get_H_combined_csr(Prob* p);
+SpMat* PROB_get_H_combined_csc(Prob* p);
+SpMat* PROB_get_KKT(Prob* p);
+BOOL PROB_get_merge_duplicates(Prob* p);
 BOOL PROB_has_error(Prob* p);
 void PROB_init(Prob* p);
 Prob* PROB_new(Net* net);
@@ -66,9 +100,18 @@ char* PROB_get_show_str(Prob* p);
 void PROB_update_lin(Prob* p);
 void PROB_update_nonlin_struc(Prob* p);
 void PROB_update_nonlin_data(Prob* p, Vec* point);
+void PROB_update_nonlin_views(Prob* p);
+void PROB_update_compressed_struc(Prob* p);
+void PROB_update_KKT_struc(Prob* p);
+void PROB_update_KKT_data(Prob* p);
+void PROB_update_var_index(Prob* p);
 int PROB_get_num_primal_variables(Prob* p);
 int PROB_get_num_linear_equality_constraints(Prob* p);
 int PROB_get_num_nonlinear_equality_constraints(Prob* p);
 int PROB_get_num_extra_vars(Prob* p);
+int PROB_get_num_threads(Prob* p);
+void PROB_set_num_threads(Prob* p, int num);
+void PROB_set_merge_duplicates(Prob* p, BOOL flag);
+void PROB_set_KKT_regularization(Prob* p, REAL reg_x, REAL reg_c);
 
 #endif
@@ -46,6 +46,8 @@ void SHUNT_array_del(Shunt* shunt_array, int size);
 Shunt* SHUNT_array_new(int size, int num_periods);
 void SHUNT_array_show(Shunt* shunt_array, int size, int t);
 void SHUNT_clear_flags(Shunt* shunt, char flag_type);
+void SHUNT_copy_from_shunt(Shunt* shunt, Shunt* other);
+void SHUNT_copy_state_from_shunt(Shunt* shunt, Shunt* other);
 void SHUNT_propagate_data_in_time(Shunt* shunt);
 int SHUNT_get_num_periods(Shunt* shunt);
 char SHUNT_get_obj_type(void* shunt);
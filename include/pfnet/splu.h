@@ -0,0 +1,53 @@
+/** @file splu.h
+ *  @brief This file lists the constants and routines associated with the SpLU data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __SPLU_HEADER__
+#define __SPLU_HEADER__
+
+#include <stdio.h>
+#include "types.h"
+#include "vector.h"
+#include "spmat.h"
+
+// Buffer
+#define SPLU_BUFFER_SIZE 100 /**< @brief Default buffer size for strings */
+
+// Pivoting
+#define SPLU_PIVOT_TOL 1e-3     /**< @brief Default relative threshold (on row-scaled values) for keeping the matched pivot row */
+#define SPLU_REFACTOR_TOL 1e-8  /**< @brief Smallest relative pivot accepted when reusing a pivot sequence */
+
+// Sparse LU factorization
+typedef struct SpLU SpLU;
+
+// Function prototypes
+void SPLU_analyze(SpLU* lu, SpMat* A);
+void SPLU_clear_error(SpLU* lu);
+void SPLU_del(SpLU* lu);
+void SPLU_factorize(SpLU* lu, SpMat* A);
+char* SPLU_get_error_string(SpLU* lu);
+int SPLU_get_L_nnz(SpLU* lu);
+int SPLU_get_U_nnz(SpLU* lu);
+int SPLU_get_num_factorizations(SpLU* lu);
+int SPLU_get_num_refactorizations(SpLU* lu);
+int* SPLU_get_ordering(SpLU* lu);
+int SPLU_get_size(SpLU* lu);
+BOOL SPLU_has_error(SpLU* lu);
+BOOL SPLU_is_factorized(SpLU* lu);
+BOOL SPLU_matches_pattern(SpLU* lu, SpMat* A);
+SpLU* SPLU_new(void);
+void SPLU_order(SpLU* lu);
+void SPLU_refactorize(SpLU* lu, SpMat* A);
+void SPLU_set_pivot_tol(SpLU* lu, REAL tol);
+void SPLU_set_symmetric(SpLU* lu, BOOL flag);
+void SPLU_solve(SpLU* lu, Vec* b);
+void SPLU_solve_batch(SpLU* lu, Vec* b, int num);
+void SPLU_update_values(SpLU* lu, SpMat* A);
+
+#endif
@@ -0,0 +1,41 @@
+/** @file spmat.h
+ *  @brief This file lists the constants and routines associated with the SpMat data structure.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#ifndef __SPMAT_HEADER__
+#define __SPMAT_HEADER__
+
+#include <stdio.h>
+#include "types.h"
+#include "matrix.h"
+
+// Formats
+#define SPMAT_CSR 0 /**< @brief Compressed sparse row format */
+#define SPMAT_CSC 1 /**< @brief Compressed sparse column format */
+
+// Compressed sparse matrix
+typedef struct SpMat SpMat;
+
+// Function prototypes
+void SPMAT_del(SpMat* s);
+int SPMAT_get_format(SpMat* s);
+int SPMAT_get_size1(SpMat* s);
+int SPMAT_get_size2(SpMat* s);
+int SPMAT_get_nnz(SpMat* s);
+int SPMAT_get_coo_nnz(SpMat* s);
+int* SPMAT_get_ptr_array(SpMat* s);
+int* SPMAT_get_ind_array(SpMat* s);
+REAL* SPMAT_get_data_array(SpMat* s);
+int* SPMAT_get_map_array(SpMat* s);
+SpMat* SPMAT_new_from_mat(Mat* m, int format);
+Mat* SPMAT_new_mat_view(SpMat* s);
+void SPMAT_update(SpMat* s, Mat* m);
+void SPMAT_show(SpMat* s);
+
+#endif
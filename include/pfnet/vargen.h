@@ -59,6 +59,8 @@ void* VARGEN_array_get(void* gen_array, int index);
 Vargen* VARGEN_array_new(int size, int num_periods);
 void VARGEN_array_show(Vargen* gen_array, int size, int t);
 void VARGEN_clear_flags(Vargen* gen, char flag_type);
+void VARGEN_copy_from_vargen(Vargen* gen, Vargen* other);
+void VARGEN_copy_state_from_vargen(Vargen* gen, Vargen* other);
 void VARGEN_propagate_data_in_time(Vargen* gen);
 int VARGEN_get_num_periods(Vargen* gen);
 char* VARGEN_get_name(Vargen* gen);
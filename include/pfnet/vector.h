@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <math.h>
 #include "types.h"
+#include "pool.h"
 
 // Vector
 typedef struct Vec Vec;
@@ -21,14 +22,19 @@ typedef struct Vec Vec;
 // Function prototypes
 void VEC_add_to_entry(Vec* v, int index, REAL value);
 void VEC_del(Vec* v);
+void VEC_del_to_pool(Pool* pool, Vec* v);
+void VEC_detach_view(Vec* v);
 REAL VEC_get(Vec* v, int index);
 REAL* VEC_get_data(Vec* v);
 REAL VEC_get_max(Vec* v);
 REAL VEC_get_min(Vec* v);
 int VEC_get_size(Vec* v);
+BOOL VEC_is_view(Vec* v);
 Vec* VEC_new(int size);
 Vec* VEC_new_from_array(REAL* data, int size);
+Vec* VEC_new_from_pool(Pool* pool, int size);
 void VEC_set(Vec* v, int index, REAL value);
+void VEC_set_data_view(Vec* v, REAL* data);
 void VEC_set_zero(Vec* v);
 void VEC_show(Vec* v);
 void VEC_sub_inplace(Vec* v,Vec* w);
@@ -17,6 +17,8 @@ cdef extern from "pfnet/contingency.h":
     void CONT_add_branch_outage(Cont* cont, Branch* br)
     void CONT_add_gen_outage(Cont* cont, Gen* gen)
     void CONT_del(Cont* cont)
+    Branch* CONT_get_branch_outage(Cont* cont, int k)
+    Gen* CONT_get_gen_outage(Cont* cont, int k)
     void CONT_init(Cont* cont)
     int CONT_get_num_gen_outages(Cont* cont)
     int CONT_get_num_branch_outages(Cont* cont)
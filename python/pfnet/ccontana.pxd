@@ -0,0 +1,38 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cpflow
+cimport ccont
+
+cdef extern from "pfnet/contana.h":
+
+    ctypedef struct ContAna
+    ctypedef struct Net
+    ctypedef double REAL
+
+    void CONTANA_add_worker(ContAna* ca, Net* net)
+    void CONTANA_clear_error(ContAna* ca)
+    void CONTANA_del(ContAna* ca)
+    REAL CONTANA_get_branch_max_loading(ContAna* ca, int k)
+    int CONTANA_get_branch_num_overloads(ContAna* ca, int k)
+    int CONTANA_get_branch_worst(ContAna* ca, int k)
+    REAL CONTANA_get_bus_v_vio(ContAna* ca, int k)
+    char* CONTANA_get_error_string(ContAna* ca)
+    REAL CONTANA_get_gen_Q_vio(ContAna* ca, int k)
+    REAL CONTANA_get_mismatch(ContAna* ca, int k)
+    int CONTANA_get_num_conts(ContAna* ca)
+    int CONTANA_get_num_iters(ContAna* ca, int k)
+    int CONTANA_get_num_threads(ContAna* ca)
+    int CONTANA_get_num_workers(ContAna* ca)
+    cpflow.PFlow* CONTANA_get_pflow(ContAna* ca)
+    REAL CONTANA_get_time(ContAna* ca)
+    bint CONTANA_has_converged(ContAna* ca, int k)
+    bint CONTANA_has_error(ContAna* ca)
+    ContAna* CONTANA_new()
+    void CONTANA_run(ContAna* ca, Net* net, ccont.Cont** conts, int num_conts)
+    void CONTANA_set_num_threads(ContAna* ca, int num_threads)
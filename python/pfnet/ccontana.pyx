@@ -0,0 +1,174 @@
+#cython: embedsignature=True
+
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport ccontana
+from libc.stdlib cimport malloc, free
+
+class ContingencyAnalysisError(Exception):
+    """
+    AC contingency analysis error exception.
+    """
+
+    pass
+
+cdef class ContingencyAnalysis:
+    """
+    AC contingency analysis class.
+    """
+
+    cdef ccontana.ContAna* _c_contana
+    cdef list _workers
+
+    def __init__(self):
+        """
+        AC contingency analysis class.
+        """
+
+        pass
+
+    def __cinit__(self):
+
+        self._c_contana = ccontana.CONTANA_new()
+        self._workers = []
+
+    def __dealloc__(self):
+        """
+        Frees AC contingency analysis C data structure.
+        """
+
+        ccontana.CONTANA_del(self._c_contana)
+        self._c_contana = NULL
+
+    def add_worker(self,Network net):
+        """
+        Adds a network equivalent to the base network (e.g. parsed from the
+        same case) to be used by an additional thread.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        """
+
+        self._workers.append(net)
+        ccontana.CONTANA_add_worker(self._c_contana,net._c_net)
+
+    def clear_error(self):
+        """
+        Clears error flag and string.
+        """
+
+        ccontana.CONTANA_clear_error(self._c_contana)
+
+    def has_error(self):
+        """
+        Indicates whether the analysis has the error flag set due to an
+        invalid operation.
+
+        Returns
+        -------
+        flag : {``True``, ``False``}
+        """
+
+        return ccontana.CONTANA_has_error(self._c_contana)
+
+    def run(self,Network net,conts):
+        """
+        Solves the AC power flow equations of the network under each
+        contingency, starting from the current solution of the network,
+        and records the violations. The solution of the network is
+        restored at the end.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        conts : list of :class:`Contingencies <pfnet.Contingency>`
+        """
+
+        cdef Contingency c
+        cdef ccont.Cont** array = <ccont.Cont**>malloc(max(len(conts),1)*sizeof(ccont.Cont*))
+        for k in range(len(conts)):
+            c = conts[k]
+            array[k] = c._c_cont
+        ccontana.CONTANA_run(self._c_contana,net._c_net,array,len(conts))
+        free(array)
+        if ccontana.CONTANA_has_error(self._c_contana):
+            raise ContingencyAnalysisError(ccontana.CONTANA_get_error_string(self._c_contana))
+
+    property method:
+        """ Power flow solution method (:data:`PFLOW_METHOD_NR <pfnet.PFLOW_METHOD_NR>`, :data:`PFLOW_METHOD_FDXB <pfnet.PFLOW_METHOD_FDXB>` or :data:`PFLOW_METHOD_FDBX <pfnet.PFLOW_METHOD_FDBX>`) (int). """
+        def __get__(self): return cpflow.PFLOW_get_method(ccontana.CONTANA_get_pflow(self._c_contana))
+        def __set__(self,method): cpflow.PFLOW_set_method(ccontana.CONTANA_get_pflow(self._c_contana),method)
+
+    property tol:
+        """ Power flow tolerance on the largest residual entry (per unit) (float). """
+        def __get__(self): return cpflow.PFLOW_get_tol(ccontana.CONTANA_get_pflow(self._c_contana))
+        def __set__(self,tol): cpflow.PFLOW_set_tol(ccontana.CONTANA_get_pflow(self._c_contana),tol)
+
+    property max_iters:
+        """ Power flow maximum number of iterations (int). """
+        def __get__(self): return cpflow.PFLOW_get_max_iters(ccontana.CONTANA_get_pflow(self._c_contana))
+        def __set__(self,max_iters): cpflow.PFLOW_set_max_iters(ccontana.CONTANA_get_pflow(self._c_contana),max_iters)
+
+    property num_threads:
+        """ Number of threads, each with one network, with copies of the base network made for threads without one (int). """
+        def __get__(self): return ccontana.CONTANA_get_num_threads(self._c_contana)
+        def __set__(self,num_threads): ccontana.CONTANA_set_num_threads(self._c_contana,num_threads)
+
+    property num_workers:
+        """ Number of networks used, including the base network (int). """
+        def __get__(self): return ccontana.CONTANA_get_num_workers(self._c_contana)
+
+    property num_conts:
+        """ Number of contingencies of the last run (int). """
+        def __get__(self): return ccontana.CONTANA_get_num_conts(self._c_contana)
+
+    property time:
+        """ Time of the last run (seconds) (float). """
+        def __get__(self): return ccontana.CONTANA_get_time(self._c_contana)
+
+    property converged:
+        """ Flags for convergence of each contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_has_converged(self._c_contana,k) for k in range(self.num_conts)],dtype=bool)
+
+    property num_iters:
+        """ Number of iterations of each contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_num_iters(self._c_contana,k) for k in range(self.num_conts)],dtype=int)
+
+    property mismatches:
+        """ Largest final residual entry of each contingency (per unit) (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_mismatch(self._c_contana,k) for k in range(self.num_conts)])
+
+    property bus_v_vio:
+        """ Largest bus voltage magnitude limit violation of each contingency (per unit) (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_bus_v_vio(self._c_contana,k) for k in range(self.num_conts)])
+
+    property gen_Q_vio:
+        """ Largest generator reactive power limit violation of each contingency (per unit) (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_gen_Q_vio(self._c_contana,k) for k in range(self.num_conts)])
+
+    property max_loadings:
+        """ Largest branch loading of each contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_branch_max_loading(self._c_contana,k) for k in range(self.num_conts)])
+
+    property num_overloads:
+        """ Number of overloaded branches of each contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_branch_num_overloads(self._c_contana,k) for k in range(self.num_conts)],dtype=int)
+
+    property worst_branches:
+        """ Branch with the largest loading of each contingency (-1 if none) (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([ccontana.CONTANA_get_branch_worst(self._c_contana,k) for k in range(self.num_conts)],dtype=int)
@@ -0,0 +1,36 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cvec
+
+cdef extern from "pfnet/dcflow.h":
+
+    ctypedef struct DCFlow
+    ctypedef struct Net
+    ctypedef double REAL
+
+    void DCFLOW_analyze(DCFlow* dc, Net* net)
+    void DCFLOW_clear_error(DCFlow* dc)
+    void DCFLOW_clear_PTDF(DCFlow* dc)
+    void DCFLOW_compute_flows(DCFlow* dc, cvec.Vec* w, cvec.Vec* flows, int num)
+    void DCFLOW_compute_PTDF(DCFlow* dc, int* bus_indices, int num)
+    void DCFLOW_compute_transfer_flows(DCFlow* dc, int* br_indices, int num, cvec.Vec* flows)
+    void DCFLOW_del(DCFlow* dc)
+    char* DCFLOW_get_error_string(DCFlow* dc)
+    REAL DCFLOW_get_LODF(DCFlow* dc, int br_index, int out_index)
+    int DCFLOW_get_num_branches(DCFlow* dc)
+    int DCFLOW_get_num_buses(DCFlow* dc)
+    int DCFLOW_get_num_PTDF_columns(DCFlow* dc)
+    REAL DCFLOW_get_OTDF(DCFlow* dc, int br_index, int out_index, int bus_index)
+    REAL DCFLOW_get_PTDF(DCFlow* dc, int br_index, int bus_index)
+    REAL* DCFLOW_get_PTDF_column(DCFlow* dc, int bus_index)
+    bint DCFLOW_has_error(DCFlow* dc)
+    bint DCFLOW_is_analyzed(DCFlow* dc)
+    DCFlow* DCFLOW_new()
+    void DCFLOW_solve(DCFlow* dc, Net* net)
+    void DCFLOW_solve_angles(DCFlow* dc, cvec.Vec* P, cvec.Vec* w, int num)
@@ -0,0 +1,226 @@
+#cython: embedsignature=True
+
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cdcflow
+
+class DCPowerFlowError(Exception):
+    """
+    DC power flow error exception.
+    """
+
+    pass
+
+cdef class DCPowerFlow:
+    """
+    DC power flow solver class.
+    """
+
+    cdef cdcflow.DCFlow* _c_dcflow
+
+    def __init__(self):
+        """
+        DC power flow solver class.
+        """
+
+        pass
+
+    def __cinit__(self):
+
+        self._c_dcflow = cdcflow.DCFLOW_new()
+
+    def __dealloc__(self):
+        """
+        Frees DC power flow C data structure.
+        """
+
+        cdcflow.DCFLOW_del(self._c_dcflow)
+        self._c_dcflow = NULL
+
+    def _check_error(self):
+
+        if cdcflow.DCFLOW_has_error(self._c_dcflow):
+            raise DCPowerFlowError(cdcflow.DCFLOW_get_error_string(self._c_dcflow))
+
+    def analyze(self,Network net):
+        """
+        Builds and factorizes the susceptance matrix of the network without
+        the slack buses. Needs to be called again after outages change.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        """
+
+        cdcflow.DCFLOW_analyze(self._c_dcflow,net._c_net)
+        self._check_error()
+
+    def clear_error(self):
+        """
+        Clears error flag and string.
+        """
+
+        cdcflow.DCFLOW_clear_error(self._c_dcflow)
+
+    def clear_PTDF(self):
+        """
+        Clears the cached PTDF columns.
+        """
+
+        cdcflow.DCFLOW_clear_PTDF(self._c_dcflow)
+
+    def has_error(self):
+        """
+        Indicates whether the DC power flow solver has the error flag set due
+        to an invalid operation.
+
+        Returns
+        -------
+        flag : {``True``, ``False``}
+        """
+
+        return cdcflow.DCFLOW_has_error(self._c_dcflow)
+
+    def solve(self,Network net):
+        """
+        Solves the DC power flow equations of the network for all time
+        periods. The voltage angles of non-slack buses and the active powers
+        of slack generators are stored in the network.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        """
+
+        cdcflow.DCFLOW_solve(self._c_dcflow,net._c_net)
+        self._check_error()
+
+    def solve_angles(self,injections):
+        """
+        Computes the voltage angles due to one or more injection vectors,
+        with the angles of the slack buses at zero.
+
+        Parameters
+        ----------
+        injections : :class:`ndarray <numpy.ndarray>` (number of buses or number of vectors by number of buses)
+
+        Returns
+        -------
+        angles : :class:`ndarray <numpy.ndarray>` (same shape as injections)
+        """
+
+        cdef np.ndarray[double,mode='c',ndim=2] P = np.ascontiguousarray(np.atleast_2d(injections),dtype=np.double)
+        cdef np.ndarray[double,mode='c',ndim=2] w = np.zeros((P.shape[0],P.shape[1]))
+        cdef cvec.Vec* vP = cvec.VEC_new_from_array(<double*>P.data,P.size)
+        cdef cvec.Vec* vw = cvec.VEC_new_from_array(<double*>w.data,w.size)
+        cdcflow.DCFLOW_solve_angles(self._c_dcflow,vP,vw,P.shape[0])
+        self._check_error()
+        return w.reshape(np.shape(injections))
+
+    def compute_flows(self,angles):
+        """
+        Computes the active power flows from bus "k" to bus "m" of the
+        branches, ignoring phase shifts, for one or more angle vectors.
+
+        Parameters
+        ----------
+        angles : :class:`ndarray <numpy.ndarray>` (number of buses or number of vectors by number of buses)
+
+        Returns
+        -------
+        flows : :class:`ndarray <numpy.ndarray>` (number of branches or number of vectors by number of branches)
+        """
+
+        cdef np.ndarray[double,mode='c',ndim=2] w = np.ascontiguousarray(np.atleast_2d(angles),dtype=np.double)
+        cdef np.ndarray[double,mode='c',ndim=2] f = np.zeros((w.shape[0],self.num_branches))
+        cdef cvec.Vec* vw = cvec.VEC_new_from_array(<double*>w.data,w.size)
+        cdef cvec.Vec* vf = cvec.VEC_new_from_array(<double*>f.data,f.size)
+        cdcflow.DCFLOW_compute_flows(self._c_dcflow,vw,vf,w.shape[0])
+        self._check_error()
+        return f if np.ndim(angles) == 2 else f[0]
+
+    def get_PTDF(self,bus_indices):
+        """
+        Gets the PTDF columns of the given buses, computing and caching those
+        that are not cached. Each column has the changes of the branch flows
+        due to a unit injection at the bus withdrawn at the slack buses.
+
+        Parameters
+        ----------
+        bus_indices : list of ints
+
+        Returns
+        -------
+        PTDF : :class:`ndarray <numpy.ndarray>` (number of branches by number of given buses)
+        """
+
+        cdef np.ndarray[int,mode='c'] indices = np.ascontiguousarray(bus_indices,dtype=np.intc)
+        cdef np.ndarray[double,mode='c',ndim=2] ptdf = np.zeros((self.num_branches,indices.size))
+        cdef cdcflow.REAL* column
+        cdef int i
+        cdef int j
+        if indices.size:
+            cdcflow.DCFLOW_compute_PTDF(self._c_dcflow,<int*>indices.data,indices.size)
+        self._check_error()
+        for j in range(indices.size):
+            column = cdcflow.DCFLOW_get_PTDF_column(self._c_dcflow,indices[j])
+            for i in range(self.num_branches):
+                ptdf[i,j] = column[i]
+        return ptdf
+
+    def get_LODF(self,br_index,out_index):
+        """
+        Gets the change of the flow of a branch per unit of pre-outage flow
+        of an outaged branch. It is zero if the outage islands the network.
+
+        Parameters
+        ----------
+        br_index : int
+        out_index : int
+
+        Returns
+        -------
+        LODF : float
+        """
+
+        return cdcflow.DCFLOW_get_LODF(self._c_dcflow,br_index,out_index)
+
+    def get_OTDF(self,br_index,out_index,bus_index):
+        """
+        Gets the change of the flow of a branch due to a unit injection at a
+        bus, withdrawn at the slack buses, after the outage of another branch.
+
+        Parameters
+        ----------
+        br_index : int
+        out_index : int
+        bus_index : int
+
+        Returns
+        -------
+        OTDF : float
+        """
+
+        return cdcflow.DCFLOW_get_OTDF(self._c_dcflow,br_index,out_index,bus_index)
+
+    property num_buses:
+        """ Number of buses of the analyzed network (int). """
+        def __get__(self): return cdcflow.DCFLOW_get_num_buses(self._c_dcflow)
+
+    property num_branches:
+        """ Number of branches of the analyzed network (int). """
+        def __get__(self): return cdcflow.DCFLOW_get_num_branches(self._c_dcflow)
+
+    property num_PTDF_columns:
+        """ Number of cached PTDF columns (int). """
+        def __get__(self): return cdcflow.DCFLOW_get_num_PTDF_columns(self._c_dcflow)
+
+    property analyzed:
+        """ Flag that indicates whether the susceptance matrix is factorized (bool). """
+        def __get__(self): return cdcflow.DCFLOW_is_analyzed(self._c_dcflow)
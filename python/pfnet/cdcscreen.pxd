@@ -0,0 +1,46 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cdcflow
+cimport ccont
+
+cdef extern from "pfnet/dcscreen.h":
+
+    ctypedef struct DCScreen
+    ctypedef struct Net
+    ctypedef double REAL
+
+    cdef char DCSCREEN_RATING_A
+    cdef char DCSCREEN_RATING_B
+    cdef char DCSCREEN_RATING_C
+    cdef int DCSCREEN_TOP
+
+    void DCSCREEN_add_double(DCScreen* s, int br_index1, int br_index2)
+    void DCSCREEN_clear_doubles(DCScreen* s)
+    void DCSCREEN_clear_error(DCScreen* s)
+    void DCSCREEN_del(DCScreen* s)
+    char* DCSCREEN_get_error_string(DCScreen* s)
+    int DCSCREEN_get_num_doubles(DCScreen* s)
+    int DCSCREEN_get_num_islanding(DCScreen* s)
+    int DCSCREEN_get_num_overloaded(DCScreen* s)
+    int DCSCREEN_get_num_results(DCScreen* s)
+    int DCSCREEN_get_num_screened(DCScreen* s)
+    char DCSCREEN_get_rating(DCScreen* s)
+    int DCSCREEN_get_result_branch(DCScreen* s, int k, int j)
+    REAL DCSCREEN_get_result_max_loading(DCScreen* s, int k)
+    REAL DCSCREEN_get_result_severity(DCScreen* s, int k)
+    int DCSCREEN_get_result_worst_branch(DCScreen* s, int k)
+    bint DCSCREEN_get_singles(DCScreen* s)
+    int DCSCREEN_get_top(DCScreen* s)
+    bint DCSCREEN_has_error(DCScreen* s)
+    DCScreen* DCSCREEN_new()
+    ccont.Cont* DCSCREEN_new_cont(DCScreen* s, Net* net, int k)
+    void DCSCREEN_run(DCScreen* s, cdcflow.DCFlow* dc, Net* net, int t)
+    void DCSCREEN_set_rating(DCScreen* s, char rating)
+    void DCSCREEN_set_singles(DCScreen* s, bint flag)
+    void DCSCREEN_set_top(DCScreen* s, int top)
@@ -0,0 +1,190 @@
+#cython: embedsignature=True
+
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cdcscreen
+
+# Ratings
+DCSCREEN_RATING_A = cdcscreen.DCSCREEN_RATING_A
+DCSCREEN_RATING_B = cdcscreen.DCSCREEN_RATING_B
+DCSCREEN_RATING_C = cdcscreen.DCSCREEN_RATING_C
+
+# Defaults
+DCSCREEN_TOP = cdcscreen.DCSCREEN_TOP
+
+class DCScreeningError(Exception):
+    """
+    DC contingency screening error exception.
+    """
+
+    pass
+
+cdef class DCScreening:
+    """
+    DC contingency screening class.
+    """
+
+    cdef cdcscreen.DCScreen* _c_dcscreen
+
+    def __init__(self):
+        """
+        DC contingency screening class.
+        """
+
+        pass
+
+    def __cinit__(self):
+
+        self._c_dcscreen = cdcscreen.DCSCREEN_new()
+
+    def __dealloc__(self):
+        """
+        Frees DC contingency screening C data structure.
+        """
+
+        cdcscreen.DCSCREEN_del(self._c_dcscreen)
+        self._c_dcscreen = NULL
+
+    def add_double(self,br_index1,br_index2):
+        """
+        Adds a double branch outage to be screened.
+
+        Parameters
+        ----------
+        br_index1 : int
+        br_index2 : int
+        """
+
+        cdcscreen.DCSCREEN_add_double(self._c_dcscreen,br_index1,br_index2)
+        if cdcscreen.DCSCREEN_has_error(self._c_dcscreen):
+            raise DCScreeningError(cdcscreen.DCSCREEN_get_error_string(self._c_dcscreen))
+
+    def clear_doubles(self):
+        """
+        Clears the double branch outages to be screened.
+        """
+
+        cdcscreen.DCSCREEN_clear_doubles(self._c_dcscreen)
+
+    def clear_error(self):
+        """
+        Clears error flag and string.
+        """
+
+        cdcscreen.DCSCREEN_clear_error(self._c_dcscreen)
+
+    def has_error(self):
+        """
+        Indicates whether the screening has the error flag set due to an
+        invalid operation.
+
+        Returns
+        -------
+        flag : {``True``, ``False``}
+        """
+
+        return cdcscreen.DCSCREEN_has_error(self._c_dcscreen)
+
+    def run(self,DCPowerFlow dc,Network net,t=0):
+        """
+        Screens the branch outages with the DC model of the network, using
+        the base flows stored in the network, and keeps the top
+        contingencies with overloads.
+
+        Parameters
+        ----------
+        dc : :class:`DCPowerFlow <pfnet.DCPowerFlow>`
+        net : :class:`Network <pfnet.Network>`
+        t : int (time period)
+        """
+
+        cdcscreen.DCSCREEN_run(self._c_dcscreen,dc._c_dcflow,net._c_net,t)
+        if cdcscreen.DCSCREEN_has_error(self._c_dcscreen):
+            raise DCScreeningError(cdcscreen.DCSCREEN_get_error_string(self._c_dcscreen))
+
+    def get_contingency(self,Network net,k):
+        """
+        Gets a contingency with the branch outages of a kept contingency.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        k : int (rank)
+
+        Returns
+        -------
+        cont : :class:`Contingency <pfnet.Contingency>`
+        """
+
+        return Contingency(branches=[net.get_branch(i) for i in self.get_result_branches(k)])
+
+    def get_result_branches(self,k):
+        """
+        Gets the indices of the outaged branches of a kept contingency.
+
+        Parameters
+        ----------
+        k : int (rank)
+
+        Returns
+        -------
+        indices : list of ints
+        """
+
+        return [i for i in [cdcscreen.DCSCREEN_get_result_branch(self._c_dcscreen,k,j) for j in range(2)] if i >= 0]
+
+    property rating:
+        """ Branch rating used for overloads (:data:`DCSCREEN_RATING_A <pfnet.DCSCREEN_RATING_A>`, :data:`DCSCREEN_RATING_B <pfnet.DCSCREEN_RATING_B>` or :data:`DCSCREEN_RATING_C <pfnet.DCSCREEN_RATING_C>`) (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_rating(self._c_dcscreen)
+        def __set__(self,rating): cdcscreen.DCSCREEN_set_rating(self._c_dcscreen,rating)
+
+    property top:
+        """ Number of contingencies kept (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_top(self._c_dcscreen)
+        def __set__(self,top): cdcscreen.DCSCREEN_set_top(self._c_dcscreen,top)
+
+    property singles:
+        """ Flag for screening the outage of every branch (bool). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_singles(self._c_dcscreen)
+        def __set__(self,flag): cdcscreen.DCSCREEN_set_singles(self._c_dcscreen,flag)
+
+    property num_doubles:
+        """ Number of double branch outages to be screened (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_num_doubles(self._c_dcscreen)
+
+    property num_screened:
+        """ Number of contingencies screened by the last run (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_num_screened(self._c_dcscreen)
+
+    property num_islanding:
+        """ Number of contingencies of the last run that island the network (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_num_islanding(self._c_dcscreen)
+
+    property num_overloaded:
+        """ Number of contingencies of the last run with overloads (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_num_overloaded(self._c_dcscreen)
+
+    property num_results:
+        """ Number of contingencies kept (int). """
+        def __get__(self): return cdcscreen.DCSCREEN_get_num_results(self._c_dcscreen)
+
+    property severities:
+        """ Sum of relative overloads of each kept contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cdcscreen.DCSCREEN_get_result_severity(self._c_dcscreen,k) for k in range(self.num_results)])
+
+    property max_loadings:
+        """ Largest post-contingency loading of each kept contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cdcscreen.DCSCREEN_get_result_max_loading(self._c_dcscreen,k) for k in range(self.num_results)])
+
+    property worst_branches:
+        """ Index of the branch with the largest loading of each kept contingency (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cdcscreen.DCSCREEN_get_result_worst_branch(self._c_dcscreen,k) for k in range(self.num_results)],dtype=int)
@@ -21,4 +21,20 @@ cdef extern from "pfnet/matrix.h":
     REAL* MAT_get_data_array(Mat* m)
     Mat* MAT_new_from_arrays(int size1, int size2, int nnz, int* row, int* col, REAL* data)
 
+cdef extern from "pfnet/spmat.h":
+
+    ctypedef struct SpMat:
+        pass
+
+    int SPMAT_CSR
+    int SPMAT_CSC
+
+    int SPMAT_get_format(SpMat* s)
+    int SPMAT_get_size1(SpMat* s)
+    int SPMAT_get_size2(SpMat* s)
+    int SPMAT_get_nnz(SpMat* s)
+    int* SPMAT_get_ptr_array(SpMat* s)
+    int* SPMAT_get_ind_array(SpMat* s)
+    REAL* SPMAT_get_data_array(SpMat* s)
+
     
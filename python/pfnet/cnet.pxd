@@ -31,6 +31,8 @@ cdef extern from "pfnet/net.h":
     void NET_clear_flags(Net* net)
     void NET_clear_properties(Net* net)
     void NET_clear_sensitivities(Net* net)
+    Net* NET_copy(Net* net)
+    void NET_copy_state(Net* net, Net* other)
     cbus.Bus* NET_create_sorted_bus_list(Net* net, int sort_by, int t)
     cmat.Mat* NET_create_vargen_P_sigma(Net* net, int spread, REAL corr)
     void NET_del(Net* net)
@@ -75,6 +77,7 @@ cdef extern from "pfnet/net.h":
     int NET_get_num_vargens(Net* net)
     int NET_get_num_bats(Net* net)
     int NET_get_num_vars(Net* net)
+    int NET_get_struc_version(Net* net)
     int NET_get_num_fixed(Net* net)
     int NET_get_num_bounded(Net* net)
     int NET_get_num_sparse(Net* net)
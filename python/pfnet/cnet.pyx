@@ -153,6 +153,34 @@ cdef class Network:
 
         cnet.NET_clear_sensitivities(self._c_net)
 
+    def copy(self):
+        """
+        Creates a deep copy of the network.
+
+        Returns
+        -------
+        net : :class:`Network <pfnet.Network>`
+        """
+
+        cdef Network net = new_Network(cnet.NET_copy(self._c_net))
+        net.alloc = True
+        return net
+
+    def copy_state(self,Network other):
+        """
+        Copies the outages, per-period data, flags and variable indices of
+        the components of an equivalent network (e.g. a copy) to this
+        network, keeping the remaining data and the connections.
+
+        Parameters
+        ----------
+        other : :class:`Network <pfnet.Network>`
+        """
+
+        cnet.NET_copy_state(self._c_net,other._c_net)
+        if cnet.NET_has_error(self._c_net):
+            raise NetworkError(cnet.NET_get_error_string(self._c_net))
+
     def create_sorted_bus_list(self,sort_by,t=0):
         """
         Creates list of buses sorted in descending order according to a specific quantity.
@@ -980,6 +1008,10 @@ cdef class Network:
         """ Number of network control quantities that have been set to sparse (int). """
         def __get__(self): return cnet.NET_get_num_sparse(self._c_net)
 
+    property struc_version:
+        """ Counter of structural changes (flags, components and connections) of the network (int). """
+        def __get__(self): return cnet.NET_get_struc_version(self._c_net)
+
     property total_load_P:
         """ Total load active power (MW) (float or array). """
         def __get__(self):
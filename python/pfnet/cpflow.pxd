@@ -0,0 +1,44 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cdef extern from "pfnet/pflow.h":
+
+    ctypedef struct PFlow
+    ctypedef struct Net
+    ctypedef double REAL
+
+    cdef char PFLOW_METHOD_NR
+    cdef char PFLOW_METHOD_FDXB
+    cdef char PFLOW_METHOD_FDBX
+
+    cdef double PFLOW_TOL
+    cdef int PFLOW_MAX_ITERS
+
+    void PFLOW_clear_error(PFlow* pf)
+    void PFLOW_del(PFlow* pf)
+    char* PFLOW_get_error_string(PFlow* pf)
+    REAL PFLOW_get_iter_mismatch(PFlow* pf, int k)
+    REAL PFLOW_get_iter_step(PFlow* pf, int k)
+    REAL PFLOW_get_iter_time(PFlow* pf, int k)
+    bint PFLOW_get_line_search(PFlow* pf)
+    int PFLOW_get_max_iters(PFlow* pf)
+    char PFLOW_get_method(PFlow* pf)
+    REAL PFLOW_get_mismatch(PFlow* pf)
+    int PFLOW_get_num_iters(PFlow* pf)
+    bint PFLOW_get_pvpq(PFlow* pf)
+    REAL PFLOW_get_time(PFlow* pf)
+    REAL PFLOW_get_tol(PFlow* pf)
+    bint PFLOW_has_converged(PFlow* pf)
+    bint PFLOW_has_error(PFlow* pf)
+    PFlow* PFLOW_new()
+    void PFLOW_set_line_search(PFlow* pf, bint flag)
+    void PFLOW_set_max_iters(PFlow* pf, int max_iters)
+    void PFLOW_set_method(PFlow* pf, char method)
+    void PFLOW_set_pvpq(PFlow* pf, bint flag)
+    void PFLOW_set_tol(PFlow* pf, REAL tol)
+    void PFLOW_solve(PFlow* pf, Net* net)
@@ -0,0 +1,139 @@
+#cython: embedsignature=True
+
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+cimport cpflow
+
+# Methods
+PFLOW_METHOD_NR = cpflow.PFLOW_METHOD_NR
+PFLOW_METHOD_FDXB = cpflow.PFLOW_METHOD_FDXB
+PFLOW_METHOD_FDBX = cpflow.PFLOW_METHOD_FDBX
+
+class PowerFlowError(Exception):
+    """
+    Power flow error exception.
+    """
+
+    pass
+
+cdef class PowerFlow:
+    """
+    AC power flow solver class.
+    """
+
+    cdef cpflow.PFlow* _c_pflow
+
+    def __init__(self):
+        """
+        AC power flow solver class.
+        """
+
+        pass
+
+    def __cinit__(self):
+
+        self._c_pflow = cpflow.PFLOW_new()
+
+    def __dealloc__(self):
+        """
+        Frees power flow C data structure.
+        """
+
+        cpflow.PFLOW_del(self._c_pflow)
+        self._c_pflow = NULL
+
+    def clear_error(self):
+        """
+        Clears error flag and string.
+        """
+
+        cpflow.PFLOW_clear_error(self._c_pflow)
+
+    def has_error(self):
+        """
+        Indicates whether the power flow solver has the error flag set due to an
+        invalid operation.
+
+        Returns
+        -------
+        flag : {``True``, ``False``}
+        """
+
+        return cpflow.PFLOW_has_error(self._c_pflow)
+
+    def solve(self,Network net):
+        """
+        Solves the AC power flow equations of the network. The network flags
+        are replaced by the power flow variables and the solution is stored
+        in the network.
+
+        Parameters
+        ----------
+        net : :class:`Network <pfnet.Network>`
+        """
+
+        cpflow.PFLOW_solve(self._c_pflow,net._c_net)
+        if cpflow.PFLOW_has_error(self._c_pflow):
+            raise PowerFlowError(cpflow.PFLOW_get_error_string(self._c_pflow))
+
+    property tol:
+        """ Tolerance on the largest residual entry (per unit) (float). """
+        def __get__(self): return cpflow.PFLOW_get_tol(self._c_pflow)
+        def __set__(self,tol): cpflow.PFLOW_set_tol(self._c_pflow,tol)
+
+    property method:
+        """ Solution method (:data:`PFLOW_METHOD_NR <pfnet.PFLOW_METHOD_NR>`, :data:`PFLOW_METHOD_FDXB <pfnet.PFLOW_METHOD_FDXB>` or :data:`PFLOW_METHOD_FDBX <pfnet.PFLOW_METHOD_FDBX>`) (int). """
+        def __get__(self): return cpflow.PFLOW_get_method(self._c_pflow)
+        def __set__(self,method): cpflow.PFLOW_set_method(self._c_pflow,method)
+
+    property max_iters:
+        """ Maximum number of iterations (int). """
+        def __get__(self): return cpflow.PFLOW_get_max_iters(self._c_pflow)
+        def __set__(self,max_iters): cpflow.PFLOW_set_max_iters(self._c_pflow,max_iters)
+
+    property pvpq:
+        """ Flag for PV-PQ switching of buses regulated by generators (Newton-Raphson only) (bool). """
+        def __get__(self): return cpflow.PFLOW_get_pvpq(self._c_pflow)
+        def __set__(self,flag): cpflow.PFLOW_set_pvpq(self._c_pflow,flag)
+
+    property line_search:
+        """ Flag for backtracking line search on the residual norm (Newton-Raphson only) (bool). """
+        def __get__(self): return cpflow.PFLOW_get_line_search(self._c_pflow)
+        def __set__(self,flag): cpflow.PFLOW_set_line_search(self._c_pflow,flag)
+
+    property converged:
+        """ Flag that indicates whether the last solve converged (bool). """
+        def __get__(self): return cpflow.PFLOW_has_converged(self._c_pflow)
+
+    property num_iters:
+        """ Number of iterations of the last solve (int). """
+        def __get__(self): return cpflow.PFLOW_get_num_iters(self._c_pflow)
+
+    property mismatch:
+        """ Largest residual entry at the end of the last solve (per unit) (float). """
+        def __get__(self): return cpflow.PFLOW_get_mismatch(self._c_pflow)
+
+    property time:
+        """ Time of the last solve (seconds) (float). """
+        def __get__(self): return cpflow.PFLOW_get_time(self._c_pflow)
+
+    property iter_mismatch:
+        """ Largest residual entry at the start of each iteration and at the end of the last solve (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cpflow.PFLOW_get_iter_mismatch(self._c_pflow,k) for k in range(self.num_iters+1)])
+
+    property iter_step:
+        """ Step length of each iteration of the last solve (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cpflow.PFLOW_get_iter_step(self._c_pflow,k) for k in range(self.num_iters)])
+
+    property iter_time:
+        """ Time of each iteration of the last solve (seconds) (:class:`ndarray <numpy.ndarray>`). """
+        def __get__(self):
+            return np.array([cpflow.PFLOW_get_iter_time(self._c_pflow,k) for k in range(self.num_iters)])
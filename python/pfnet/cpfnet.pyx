@@ -23,7 +23,7 @@ cimport cgraph
 from scipy import misc
 import tempfile
 
-from scipy.sparse import coo_matrix
+from scipy.sparse import coo_matrix, csr_matrix, csc_matrix
 
 np.import_array()
 
@@ -106,6 +106,29 @@ cdef Matrix(cmat.Mat* m, owndata=False):
     else:
         return coo_matrix(([],([],[])),shape=(0,0))
 
+cdef CompressedMatrix(cmat.SpMat* s, fmt='csr'):
+    cdef np.npy_intp shape[1]
+    cdef np.npy_intp ptr_shape[1]
+    if s is not NULL:
+        shape[0] = <np.npy_intp> cmat.SPMAT_get_nnz(s)
+        size1 = cmat.SPMAT_get_size1(s)
+        size2 = cmat.SPMAT_get_size2(s)
+        if cmat.SPMAT_get_format(s) == cmat.SPMAT_CSC:
+            ptr_shape[0] = <np.npy_intp> (size2+1)
+        else:
+            ptr_shape[0] = <np.npy_intp> (size1+1)
+        ptr = np.PyArray_SimpleNewFromData(1,ptr_shape,np.NPY_INT,cmat.SPMAT_get_ptr_array(s))
+        ind = np.PyArray_SimpleNewFromData(1,shape,np.NPY_INT,cmat.SPMAT_get_ind_array(s))
+        data = np.PyArray_SimpleNewFromData(1,shape,np.NPY_DOUBLE,cmat.SPMAT_get_data_array(s))
+        if cmat.SPMAT_get_format(s) == cmat.SPMAT_CSC:
+            return csc_matrix((data,ind,ptr),shape=(size1,size2),copy=False)
+        else:
+            return csr_matrix((data,ind,ptr),shape=(size1,size2),copy=False)
+    elif fmt == 'csc':
+        return csc_matrix((0,0))
+    else:
+        return csr_matrix((0,0))
+
 # Attribute arrray
 ##################
 
@@ -163,3 +186,7 @@ include "cfunc.pyx"
 include "cconstr.pyx"
 include "cheur.pyx"
 include "cprob.pyx"
+include "cpflow.pyx"
+include "cdcflow.pyx"
+include "cdcscreen.pyx"
+include "ccontana.pyx"
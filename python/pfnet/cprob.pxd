@@ -14,6 +14,8 @@ cdef extern from "pfnet/problem.h":
     ctypedef struct Net
     ctypedef struct Vec
     ctypedef struct Mat
+    ctypedef struct SpMat
+    ctypedef struct Pool
     ctypedef double REAL
         
     void PROB_add_constr(Prob* p, Constr* c)
@@ -22,6 +24,13 @@ cdef extern from "pfnet/problem.h":
     void PROB_analyze(Prob* p)
     void PROB_apply_heuristics(Prob* p, Vec* point)
     void PROB_eval(Prob* p, Vec* point)
+    void PROB_eval_f(Prob* p, Vec* point)
+    void PROB_eval_fJ(Prob* p, Vec* point)
+    void PROB_eval_batch(Prob* p, Vec* points, int num_points, Vec* phi, Vec* f, Vec* J)
+    void PROB_eval_Jv(Prob* p, Vec* point, Vec* v, Vec* Jv)
+    void PROB_eval_JTw(Prob* p, Vec* point, Vec* w, Vec* JTw)
+    void PROB_eval_Hv(Prob* p, Vec* point, Vec* coeff, Vec* v, Vec* Hv)
+    void PROB_eval_incremental(Prob* p, Vec* point, Vec* prev_point)
     void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl)
     void PROB_del(Prob* p)
     void PROB_clear(Prob* p)
@@ -38,14 +47,25 @@ cdef extern from "pfnet/problem.h":
     REAL PROB_get_phi(Prob* p)
     Vec* PROB_get_gphi(Prob* p)
     Mat* PROB_get_Hphi(Prob* p)
+    SpMat* PROB_get_Hphi_csr(Prob* p)
+    SpMat* PROB_get_Hphi_csc(Prob* p)
     Vec* PROB_get_b(Prob* p)
     Mat* PROB_get_A(Prob* p)
+    SpMat* PROB_get_A_csr(Prob* p)
+    SpMat* PROB_get_A_csc(Prob* p)
     Vec* PROB_get_l(Prob* p)
     Vec* PROB_get_u(Prob* p)
     Mat* PROB_get_G(Prob* p)
+    SpMat* PROB_get_G_csr(Prob* p)
+    SpMat* PROB_get_G_csc(Prob* p)
     Vec* PROB_get_f(Prob* p)
     Mat* PROB_get_J(Prob* p)
+    SpMat* PROB_get_J_csr(Prob* p)
+    SpMat* PROB_get_J_csc(Prob* p)
     Mat* PROB_get_H_combined(Prob* p)
+    SpMat* PROB_get_H_combined_csr(Prob* p)
+    SpMat* PROB_get_H_combined_csc(Prob* p)
+    SpMat* PROB_get_KKT(Prob* p)
     bint PROB_has_error(Prob* p)
     Prob* PROB_new(Net* net)
     void PROB_show(Prob* p)
@@ -55,3 +75,18 @@ cdef extern from "pfnet/problem.h":
     int PROB_get_num_linear_equality_constraints(Prob* p)
     int PROB_get_num_nonlinear_equality_constraints(Prob* p)
     int PROB_get_num_extra_vars(Prob* p)
+    int PROB_get_num_threads(Prob* p)
+    void PROB_set_num_threads(Prob* p, int num)
+    bint PROB_get_merge_duplicates(Prob* p)
+    void PROB_set_merge_duplicates(Prob* p, bint flag)
+    void PROB_set_KKT_regularization(Prob* p, REAL reg_x, REAL reg_c)
+    Pool* PROB_get_pool(Prob* p)
+
+cdef extern from "pfnet/pool.h":
+
+    size_t POOL_get_max_num_bytes(Pool* pool)
+    int POOL_get_num_allocs(Pool* pool)
+    int POOL_get_num_buffers(Pool* pool)
+    size_t POOL_get_num_bytes(Pool* pool)
+    int POOL_get_num_reuses(Pool* pool)
+    void POOL_reset_stats(Pool* pool)
@@ -176,6 +176,172 @@ cdef class Problem:
         if cprob.PROB_has_error(self._c_prob):
             raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
 
+    def eval_f(self,var_values):
+        """
+        Evaluates objective function and constraints using the given variable
+        values, without their derivatives.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef cvec.Vec* v = cvec.VEC_new_from_array(&(x[0]),len(x)) if var_values.size else NULL
+        cprob.PROB_eval_f(self._c_prob,v)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+
+    def eval_fJ(self,var_values):
+        """
+        Evaluates objective function and constraints as well as their first
+        derivatives using the given variable values, without second derivatives.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef cvec.Vec* v = cvec.VEC_new_from_array(&(x[0]),len(x)) if var_values.size else NULL
+        cprob.PROB_eval_fJ(self._c_prob,v)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+
+    def eval_batch(self,points):
+        """
+        Evaluates objective function, constraints and constraint Jacobian at
+        several points, without second derivatives.
+
+        Parameters
+        ----------
+        points : :class:`ndarray <numpy.ndarray>` (one point per row)
+
+        Returns
+        -------
+        phi : :class:`ndarray <numpy.ndarray>` (objective value of each point)
+        f : :class:`ndarray <numpy.ndarray>` (constraint values of each point, one row per point)
+        J : :class:`ndarray <numpy.ndarray>` (Jacobian values of each point in the order of the entries of J, one row per point)
+        """
+
+        cdef np.ndarray[double,mode='c',ndim=2] x = np.ascontiguousarray(points,dtype=np.double)
+        cdef int num_points = x.shape[0]
+        cdef int num_f = cvec.VEC_get_size(cprob.PROB_get_f(self._c_prob))
+        cdef int num_J = cmat.MAT_get_nnz(cprob.PROB_get_J(self._c_prob))
+        cdef np.ndarray[double,mode='c'] phi = np.zeros(num_points)
+        cdef np.ndarray[double,mode='c',ndim=2] f = np.zeros((num_points,num_f))
+        cdef np.ndarray[double,mode='c',ndim=2] J = np.zeros((num_points,num_J))
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<double*>x.data,x.size)
+        cdef cvec.Vec* vphi = cvec.VEC_new_from_array(<double*>phi.data,phi.size)
+        cdef cvec.Vec* vf = cvec.VEC_new_from_array(<double*>f.data,f.size)
+        cdef cvec.Vec* vJ = cvec.VEC_new_from_array(<double*>J.data,J.size)
+        cprob.PROB_eval_batch(self._c_prob,vx,num_points,vphi,vf,vJ)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return phi,f,J
+
+    def eval_Jv(self,var_values,v):
+        """
+        Evaluates the product of the constraint Jacobian and a vector
+        without forming the Jacobian where possible.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        v : :class:`ndarray <numpy.ndarray>`
+
+        Returns
+        -------
+        Jv : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = np.ascontiguousarray(var_values,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] y = np.ascontiguousarray(v,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] Jv = np.zeros(cvec.VEC_get_size(cprob.PROB_get_f(self._c_prob)))
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<double*>x.data,x.size)
+        cdef cvec.Vec* vy = cvec.VEC_new_from_array(<double*>y.data,y.size)
+        cdef cvec.Vec* vJv = cvec.VEC_new_from_array(<double*>Jv.data,Jv.size)
+        cprob.PROB_eval_Jv(self._c_prob,vx,vy,vJv)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return Jv
+
+    def eval_JTw(self,var_values,w):
+        """
+        Evaluates the product of the transposed constraint Jacobian and a
+        vector without forming the Jacobian where possible.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        w : :class:`ndarray <numpy.ndarray>`
+
+        Returns
+        -------
+        JTw : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = np.ascontiguousarray(var_values,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] y = np.ascontiguousarray(w,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] JTw = np.zeros(x.size)
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<double*>x.data,x.size)
+        cdef cvec.Vec* vy = cvec.VEC_new_from_array(<double*>y.data,y.size)
+        cdef cvec.Vec* vJTw = cvec.VEC_new_from_array(<double*>JTw.data,JTw.size)
+        cprob.PROB_eval_JTw(self._c_prob,vx,vy,vJTw)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return JTw
+
+    def eval_Hv(self,var_values,coeff,v):
+        """
+        Evaluates the product of the linear combination of the constraint
+        Hessians and a vector without forming the Hessians where possible.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        coeff : :class:`ndarray <numpy.ndarray>` (one coefficient per constraint)
+        v : :class:`ndarray <numpy.ndarray>`
+
+        Returns
+        -------
+        Hv : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = np.ascontiguousarray(var_values,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] c = np.ascontiguousarray(coeff,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] y = np.ascontiguousarray(v,dtype=np.double)
+        cdef np.ndarray[double,mode='c'] Hv = np.zeros(x.size)
+        cdef cvec.Vec* vx = cvec.VEC_new_from_array(<double*>x.data,x.size)
+        cdef cvec.Vec* vc = cvec.VEC_new_from_array(<double*>c.data,c.size)
+        cdef cvec.Vec* vy = cvec.VEC_new_from_array(<double*>y.data,y.size)
+        cdef cvec.Vec* vHv = cvec.VEC_new_from_array(<double*>Hv.data,Hv.size)
+        cprob.PROB_eval_Hv(self._c_prob,vx,vc,vy,vHv)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+        return Hv
+
+    def eval_incremental(self,var_values,prev_values):
+        """
+        Evaluates objective function and constraints as well as their first and
+        second derivatives using the given variable values, re-evaluating only
+        the contributions that depend on the variables that differ from the
+        previously evaluated values. Network properties are not updated.
+
+        Parameters
+        ----------
+        var_values : :class:`ndarray <numpy.ndarray>`
+        prev_values : :class:`ndarray <numpy.ndarray>`
+        """
+
+        cdef np.ndarray[double,mode='c'] x = var_values
+        cdef np.ndarray[double,mode='c'] x_prev = prev_values
+        cdef cvec.Vec* v = cvec.VEC_new_from_array(&(x[0]),len(x)) if var_values.size else NULL
+        cdef cvec.Vec* v_prev = cvec.VEC_new_from_array(&(x_prev[0]),len(x_prev)) if prev_values.size else NULL
+        cprob.PROB_eval_incremental(self._c_prob,v,v_prev)
+        if cprob.PROB_has_error(self._c_prob):
+            raise ProblemError(cprob.PROB_get_error_string(self._c_prob))
+
     def store_sensitivities(self,sA,sf,sGu,sGl):
         """
         Stores Lagrange multiplier estimates of the constraints in
@@ -265,6 +431,27 @@ cdef class Problem:
 
         return new_Network(cprob.PROB_get_network(self._c_prob))
 
+    def reset_pool_stats(self):
+        """
+        Resets the statistics of the memory pool that reuses the buffers
+        of the problem matrices and vectors across analyses.
+        """
+
+        cprob.POOL_reset_stats(cprob.PROB_get_pool(self._c_prob))
+
+    def set_KKT_regularization(self,reg_x,reg_c):
+        """
+        Adds diagonal entries to the KKT matrix and sets their values
+        to reg_x (primal rows) and -reg_c (constraint rows).
+
+        Parameters
+        ----------
+        reg_x : float
+        reg_c : float
+        """
+
+        cprob.PROB_set_KKT_regularization(self._c_prob,reg_x,reg_c)
+
     def show(self):
         """
         Shows information about this optimization problem.
@@ -340,6 +527,14 @@ cdef class Problem:
         """ Constraint matrix of linear equality constraints (:class:`coo_matrix <scipy.sparse.coo_matrix>`). """
         def __get__(self): return Matrix(cprob.PROB_get_A(self._c_prob))
 
+    property A_csr:
+        """ Constraint matrix of linear equality constraints in compressed form, updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_A_csr(self._c_prob),'csr')
+
+    property A_csc:
+        """ Constraint matrix of linear equality constraints in compressed form, updated in place after each evaluation (:class:`csc_matrix <scipy.sparse.csc_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_A_csc(self._c_prob),'csc')
+
     property b:
         """ Right hand side vectors of the linear equality constraints (:class:`ndarray <numpy.ndarray>`). """
         def __get__(self): return Vector(cprob.PROB_get_b(self._c_prob))
@@ -348,6 +543,14 @@ cdef class Problem:
         """ Constraint matrix of linear inequality constraints (:class:`coo_matrix <scipy.sparse.coo_matrix>`). """
         def __get__(self): return Matrix(cprob.PROB_get_G(self._c_prob))
 
+    property G_csr:
+        """ Constraint matrix of linear inequality constraints in compressed form, updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_G_csr(self._c_prob),'csr')
+
+    property G_csc:
+        """ Constraint matrix of linear inequality constraints in compressed form, updated in place after each evaluation (:class:`csc_matrix <scipy.sparse.csc_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_G_csc(self._c_prob),'csc')
+
     property l:
         """ Lower bound for linear inequality constraints (:class:`ndarray <numpy.ndarray>`). """
         def __get__(self): return Vector(cprob.PROB_get_l(self._c_prob))
@@ -360,6 +563,14 @@ cdef class Problem:
         """ Jacobian matrix of the nonlinear equality constraints (:class:`coo_matrix <scipy.sparse.coo_matrix>`). """
         def __get__(self): return Matrix(cprob.PROB_get_J(self._c_prob))
 
+    property J_csr:
+        """ Jacobian matrix of the nonlinear equality constraints in compressed form, updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_J_csr(self._c_prob),'csr')
+
+    property J_csc:
+        """ Jacobian matrix of the nonlinear equality constraints in compressed form, updated in place after each evaluation (:class:`csc_matrix <scipy.sparse.csc_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_J_csc(self._c_prob),'csc')
+
     property f:
         """ Vector of nonlinear equality constraints violations (:class:`ndarray <numpy.ndarray>`). """
         def __get__(self): return Vector(cprob.PROB_get_f(self._c_prob))
@@ -376,10 +587,30 @@ cdef class Problem:
         """ Objective function Hessian matrix (only the lower triangular part) (:class:`coo_matrix <scipy.sparse.coo_matrix>`). """
         def __get__(self): return Matrix(cprob.PROB_get_Hphi(self._c_prob))
 
+    property Hphi_csr:
+        """ Objective function Hessian matrix (only the lower triangular part) in compressed form, updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_Hphi_csr(self._c_prob),'csr')
+
+    property Hphi_csc:
+        """ Objective function Hessian matrix (only the lower triangular part) in compressed form, updated in place after each evaluation (:class:`csc_matrix <scipy.sparse.csc_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_Hphi_csc(self._c_prob),'csc')
+
     property H_combined:
         """ Linear combination of Hessian matrices of individual nonlinear equality constraints (only the lower triangular part) (:class:`coo_matrix <scipy.sparse.coo_matrix>`). """
         def __get__(self): return Matrix(cprob.PROB_get_H_combined(self._c_prob))
 
+    property H_combined_csr:
+        """ Linear combination of Hessian matrices of individual nonlinear equality constraints (only the lower triangular part) in compressed form, updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_H_combined_csr(self._c_prob),'csr')
+
+    property H_combined_csc:
+        """ Linear combination of Hessian matrices of individual nonlinear equality constraints (only the lower triangular part) in compressed form, updated in place after each evaluation (:class:`csc_matrix <scipy.sparse.csc_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_H_combined_csc(self._c_prob),'csc')
+
+    property KKT:
+        """ KKT matrix [Hphi+H_combined, J^T, A^T, G^T; J, 0, 0, 0; A, 0, 0, 0; G, 0, 0, 0] (only the lower triangular part) in compressed form, structure built once and values updated in place after each evaluation (:class:`csr_matrix <scipy.sparse.csr_matrix>`). """
+        def __get__(self): return CompressedMatrix(cprob.PROB_get_KKT(self._c_prob),'csr')
+
     property x:
         """ Initial primal point (:class:`ndarray <numpy.ndarray>`). """
         def __get__(self): return self.get_init_point()
@@ -407,3 +638,23 @@ cdef class Problem:
     property num_extra_vars:
         """ Number of extra varaibles (set during analyze) (int). """
         def __get__(self): return cprob.PROB_get_num_extra_vars(self._c_prob)
+
+    property num_threads:
+        """ Number of threads for evaluating constraints by periods and bus partitions (results are identical to the serial evaluation) (int). """
+        def __get__(self): return cprob.PROB_get_num_threads(self._c_prob)
+        def __set__(self,num): cprob.PROB_set_num_threads(self._c_prob,num)
+
+    property merge_duplicates:
+        """ Flag for returning J, Hphi and H_combined with duplicate entries merged (default) instead of the concatenated constraint and function layout (bool). """
+        def __get__(self): return cprob.PROB_get_merge_duplicates(self._c_prob)
+        def __set__(self,flag): cprob.PROB_set_merge_duplicates(self._c_prob,flag)
+
+    property pool_stats:
+        """ Statistics of the memory pool that reuses the buffers of the matrices and vectors when the problem is analyzed again (dict with keys 'num_allocs', 'num_reuses', 'num_buffers', 'num_bytes' and 'max_num_bytes'). """
+        def __get__(self):
+            cdef cprob.Pool* pool = cprob.PROB_get_pool(self._c_prob)
+            return {'num_allocs': cprob.POOL_get_num_allocs(pool),
+                    'num_reuses': cprob.POOL_get_num_reuses(pool),
+                    'num_buffers': cprob.POOL_get_num_buffers(pool),
+                    'num_bytes': cprob.POOL_get_num_bytes(pool),
+                    'max_num_bytes': cprob.POOL_get_max_num_bytes(pool)}
@@ -3773,6 +3773,46 @@ class TestNetwork(unittest.TestCase):
                     else:
                         self.assertLess(np.abs(d - corr*vg1.P_std[t]*vg2.P_std[t]),1e-12)
 
+    def test_copy(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case,self.T)
+            net.set_flags('bus','variable','any',['voltage magnitude','voltage angle'])
+
+            copy = net.copy()
+            self.assertEqual(copy.num_periods,net.num_periods)
+            self.assertEqual(copy.num_buses,net.num_buses)
+            self.assertEqual(copy.num_branches,net.num_branches)
+            self.assertEqual(copy.num_generators,net.num_generators)
+            self.assertEqual(copy.num_vars,net.num_vars)
+            self.assertTrue(np.all(copy.get_var_values() == net.get_var_values()))
+            for bus,bus_copy in zip(net.buses,copy.buses):
+                self.assertEqual(bus_copy.number,bus.number)
+                self.assertEqual(bus_copy.degree,bus.degree)
+                self.assertEqual([g.index for g in bus_copy.generators],[g.index for g in bus.generators])
+                self.assertEqual(copy.get_bus_by_number(bus.number).index,bus.index)
+            for br,br_copy in zip(net.branches,copy.branches):
+                self.assertEqual(br_copy.bus_k.index,br.bus_k.index)
+                self.assertEqual(br_copy.b,br.b)
+
+            for t in range(self.T):
+                copy.buses[0].set_v_mag(2.,t)
+            self.assertFalse(np.any(net.buses[0].v_mag == 2.))
+            copy.copy_state(net)
+            self.assertTrue(np.all(copy.buses[0].v_mag == net.buses[0].v_mag))
+
+            cont = pf.Contingency([net.get_generator(0)],[net.get_branch(0)])
+            cont.apply()
+            copy.copy_state(net)
+            self.assertTrue(copy.get_generator(0).outage)
+            self.assertTrue(copy.get_branch(0).outage)
+            self.assertEqual(copy.get_num_gens_not_on_outage(),net.get_num_gens_not_on_outage())
+            cont.clear()
+            copy.copy_state(net)
+            self.assertFalse(copy.get_generator(0).outage)
+            self.assertFalse(copy.get_branch(0).outage)
+
     def tearDown(self):
 
         pass
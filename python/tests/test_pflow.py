@@ -0,0 +1,206 @@
+#***************************************************#
+# This file is part of PFNET.                       #
+#                                                   #
+# Copyright (c) 2015-2017, Tomas Tinoco De Rubira.  #
+#                                                   #
+# PFNET is released under the BSD 2-clause license. #
+#***************************************************#
+
+import pfnet as pf
+import unittest
+from . import test_cases
+import numpy as np
+
+class TestPowerFlow(unittest.TestCase):
+
+    def setUp(self):
+
+        pass
+
+    def test_NR(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case)
+            self.assertEqual(net.num_periods,1)
+
+            solver = pf.PowerFlow()
+            self.assertTrue(solver.pvpq)
+            self.assertTrue(solver.line_search)
+            self.assertFalse(solver.converged)
+
+            solver.tol = 1e-8
+            solver.solve(net)
+
+            self.assertFalse(solver.has_error())
+            self.assertEqual(solver.iter_mismatch.size,solver.num_iters+1)
+            self.assertEqual(solver.iter_step.size,solver.num_iters)
+            self.assertEqual(solver.iter_time.size,solver.num_iters)
+            self.assertEqual(solver.iter_mismatch[-1],solver.mismatch)
+            self.assertTrue(np.all(solver.iter_step > 0))
+            self.assertTrue(np.all(solver.iter_step <= 1))
+
+            # Dispatch examples (loads cannot be served by the slack)
+            if 'sys_problem' in case:
+                self.assertFalse(solver.converged)
+                continue
+
+            self.assertTrue(solver.converged)
+            self.assertLess(solver.mismatch,1e-8)
+            self.assertLess(net.bus_P_mis,1e-8*net.base_power*1e3)
+            self.assertLess(net.bus_Q_mis,1e-8*net.base_power*1e3)
+
+            # Reactive power limits of regulating generators
+            for gen in net.generators:
+                if gen.is_regulator() and not gen.is_slack():
+                    self.assertLessEqual(gen.Q,gen.Q_max+1e-8)
+                    self.assertGreaterEqual(gen.Q,gen.Q_min-1e-8)
+
+    def test_FD(self):
+
+        for case in test_cases.CASES:
+
+            if 'sys_problem' in case:
+                continue
+
+            net_NR = pf.Parser(case).parse(case)
+            solver = pf.PowerFlow()
+            self.assertEqual(solver.method,pf.PFLOW_METHOD_NR)
+            solver.tol = 1e-8
+            solver.pvpq = False
+            solver.solve(net_NR)
+            if not solver.converged:
+                continue
+
+            for method in [pf.PFLOW_METHOD_FDXB,pf.PFLOW_METHOD_FDBX]:
+
+                net = pf.Parser(case).parse(case)
+                solver.method = method
+                self.assertEqual(solver.method,method)
+                solver.max_iters = 100
+                try:
+                    solver.solve(net)
+                except pf.PowerFlowError:
+                    continue
+
+                self.assertFalse(solver.has_error())
+                self.assertTrue(np.all(solver.iter_step == 1.))
+                if not solver.converged:
+                    continue
+                self.assertLess(solver.mismatch,1e-8)
+                for bus in net.buses:
+                    self.assertLess(abs(bus.v_mag-net_NR.get_bus(bus.index).v_mag),1e-6)
+                    self.assertLess(abs(bus.v_ang-net_NR.get_bus(bus.index).v_ang),1e-6)
+
+    def test_DC(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case)
+
+            solver = pf.DCPowerFlow()
+            self.assertFalse(solver.analyzed)
+            solver.solve(net)
+            self.assertTrue(solver.analyzed)
+            self.assertEqual(solver.num_buses,net.num_buses)
+            self.assertEqual(solver.num_branches,net.num_branches)
+
+            # Power balance
+            for bus in net.buses:
+                mis = sum([g.P for g in bus.generators])-sum([l.P for l in bus.loads])
+                mis += sum([g.P for g in bus.var_generators])-sum([b.P for b in bus.batteries])
+                mis -= sum([br.P_km_DC for br in bus.branches_k])
+                mis -= sum([br.P_mk_DC for br in bus.branches_m])
+                self.assertLess(abs(mis),1e-8)
+
+            # PTDF and batches
+            indices = list(range(min(net.num_buses,20)))
+            PTDF = solver.get_PTDF(indices)
+            self.assertEqual(PTDF.shape,(net.num_branches,len(indices)))
+            self.assertEqual(solver.num_PTDF_columns,len(indices))
+            P = np.zeros((len(indices),net.num_buses))
+            for j,i in enumerate(indices):
+                P[j,i] = 1.
+            flows = solver.compute_flows(solver.solve_angles(P))
+            self.assertLess(np.max(np.abs(flows.T-PTDF)),1e-10)
+            solver.clear_PTDF()
+            self.assertEqual(solver.num_PTDF_columns,0)
+
+    def test_DC_screening(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case)
+
+            dc = pf.DCPowerFlow()
+            dc.solve(net)
+            for br in net.branches:
+                br.ratingA = 1.1*abs(br.P_km_DC) if abs(br.P_km_DC) > 1e-3 else 0.
+
+            screening = pf.DCScreening()
+            self.assertEqual(screening.top,pf.DCSCREEN_TOP)
+            self.assertEqual(screening.rating,pf.DCSCREEN_RATING_A)
+            if net.num_branches > 1:
+                screening.add_double(0,1)
+            screening.run(dc,net)
+            self.assertEqual(screening.num_screened,net.num_branches+screening.num_doubles)
+            self.assertLessEqual(screening.num_results,screening.top)
+            self.assertLessEqual(screening.num_results,screening.num_overloaded)
+            self.assertTrue(np.all(np.diff(screening.severities) <= 0))
+            self.assertTrue(np.all(screening.max_loadings > 1.))
+            for k in range(screening.num_results):
+                indices = screening.get_result_branches(k)
+                if len(indices) == 1:
+                    c = indices[0]
+                    l = screening.worst_branches[k]
+                    self.assertNotEqual(l,c)
+                    post = net.get_branch(l).P_km_DC+dc.get_LODF(l,c)*net.get_branch(c).P_km_DC
+                    self.assertGreater(abs(post),net.get_branch(l).ratingA)
+                cont = screening.get_contingency(net,k)
+                self.assertEqual(cont.num_branch_outages,len(indices))
+
+    def test_AC_contingencies(self):
+
+        for case in test_cases.CASES:
+
+            parser = pf.Parser(case)
+            net = parser.parse(case)
+            worker = parser.parse(case)
+
+            pflow = pf.PowerFlow()
+            pflow.solve(net)
+            for br,wbr in zip(net.branches,worker.branches):
+                S = abs(br.P_km+1j*br.Q_km)
+                br.ratingA = 1.1*S if S > 1e-3 else 0.
+                wbr.ratingA = br.ratingA
+            v_mag = np.array([bus.v_mag for bus in net.buses])
+
+            conts = [pf.Contingency(branches=[br]) for br in net.branches[:10]]
+
+            analysis = pf.ContingencyAnalysis()
+            self.assertEqual(analysis.num_workers,1)
+            analysis.num_threads = 1
+            analysis.run(net,conts)
+            self.assertEqual(analysis.num_conts,len(conts))
+            self.assertTrue(np.all(np.array([bus.v_mag for bus in net.buses]) == v_mag))
+            converged = analysis.converged
+            max_loadings = analysis.max_loadings
+            self.assertTrue(np.all(analysis.mismatches[converged] < analysis.tol))
+            self.assertTrue(np.all((analysis.num_overloads > 0) == (max_loadings > 1.)))
+
+            analysis = pf.ContingencyAnalysis()
+            analysis.add_worker(worker)
+            self.assertEqual(analysis.num_workers,2)
+            analysis.run(net,conts)
+            self.assertTrue(np.all(analysis.converged == converged))
+            self.assertLess(np.max(np.abs(analysis.max_loadings-max_loadings)[converged],initial=0),1e-6)
+
+            analysis = pf.ContingencyAnalysis()
+            analysis.num_threads = 3
+            analysis.run(net,conts)
+            self.assertTrue(np.all(analysis.converged == converged))
+            self.assertLess(np.max(np.abs(analysis.max_loadings-max_loadings)[converged],initial=0),1e-6)
+
+    def tearDown(self):
+
+        pass
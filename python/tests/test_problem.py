@@ -702,6 +702,55 @@ class TestProblem(unittest.TestCase):
                     flags[bus.index] = True
             self.assertEqual(offset,p.num_extra_vars)
 
+    def test_problem_pool(self):
+
+        for case in test_cases.CASES:
+
+            net = pf.Parser(case).parse(case)
+
+            net.set_flags('bus',
+                          'variable',
+                          'any',
+                          ['voltage magnitude','voltage angle'])
+
+            p = pf.Problem(net)
+            p.add_constraint(pf.Constraint('AC power balance',net))
+            p.add_function(pf.Function('voltage magnitude regularization',1.,net))
+            p.analyze()
+
+            stats = p.pool_stats
+            self.assertEqual(stats['num_reuses'],0)
+            self.assertEqual(stats['num_buffers'],0)
+            self.assertEqual(stats['num_bytes'],0)
+            J_nnz = p.J.nnz
+
+            # Structural change
+            net.set_flags('generator',
+                          'variable',
+                          'any',
+                          'active power')
+            p.reset_pool_stats()
+            p.analyze()
+            stats = p.pool_stats
+            self.assertGreater(stats['num_reuses'],0)
+            self.assertGreater(stats['max_num_bytes'],0)
+            self.assertEqual(stats['num_buffers'],0)
+            self.assertEqual(stats['num_bytes'],0)
+            self.assertGreater(p.J.nnz,J_nnz)
+
+            # Compare with new problem
+            q = pf.Problem(net)
+            q.add_constraint(pf.Constraint('AC power balance',net))
+            q.add_function(pf.Function('voltage magnitude regularization',1.,net))
+            q.analyze()
+            x = q.get_init_point()
+            p.eval(x)
+            q.eval(x)
+            self.assertEqual(p.phi,q.phi)
+            self.assertLess(norm(p.f-q.f),1e-12)
+            self.assertEqual(p.J.nnz,q.J.nnz)
+            self.assertLess(norm((p.J-q.J).data),1e-12)
+
     def test_problem_Glu_construction(self):
 
         for case in test_cases.CASES:
@@ -778,6 +827,7 @@ class TestProblem(unittest.TestCase):
             self.assertEqual(net.num_periods,1)
             
             p = pf.Problem(net)
+            p.merge_duplicates = False # concatenated layout of J
 
             for branch in net.branches:
                 if branch.ratingA == 0.:
@@ -1218,6 +1268,7 @@ class TestProblem(unittest.TestCase):
             self.assertEqual(net.num_periods,1)
             
             p = pf.Problem(net)
+            p.merge_duplicates = False # concatenated layout of J
 
             for branch in net.branches:
                 if branch.ratingA == 0.:
@@ -113,6 +113,10 @@ Graph* GRAPH_new(Net* net) {
 
     br = NET_get_branch(net,i);
 
+    // Outage
+    if (BRANCH_is_on_outage(br))
+      continue;
+
     busk = BRANCH_get_bus_k(br);
     sprintf(buffer,"%d",BUS_get_number(busk));
     nodek = agnode(g->G,strdup(buffer),TRUE);
@@ -208,6 +212,10 @@ void GRAPH_set_edges_property(Graph* g, char* prop, char* value) {
 
       branch = NET_get_branch(g->net,i);
 
+      // Outage
+      if (BRANCH_is_on_outage(branch))
+	continue;
+
       busk = BRANCH_get_bus_k(branch);
       sprintf(buffer,"%d",BUS_get_number(busk));
       nodek = agnode(g->G,buffer,FALSE);
@@ -23,6 +23,9 @@ struct Mat {
   int nnz;
   
   BOOL owns_rowcol;
+  BOOL owns_data;
+
+  int block_nnz; // values in the block of a block array (first matrix only)
 };
 
 void MAT_add_to_dentry(Mat* m, int index, REAL value) {
@@ -38,7 +41,8 @@ void MAT_array_del(Mat* m, int size) {
 	free(m[i].row);
 	free(m[i].col);
       }
-      free(m[i].data);
+      if (m[i].owns_data)
+	free(m[i].data);
     }
     free(m);
   }
@@ -59,11 +63,128 @@ Mat* MAT_array_new(int size) {
   return m;  
 }
 
+void MAT_array_del_to_pool(Pool* pool, Mat* m, int size) {
+  /* This function frees an array of matrices like MAT_array_del but
+     gives the arrays owned by the matrices back to the pool. */
+  int pattern_nnz;
+  int i;
+  int k;
+  if (m) {
+    k = 0;
+    if (size > 0 && m[0].block_nnz > 0) { // blocks owned by first matrix
+      pattern_nnz = 0;
+      for (i = 0; i < size; i++) {
+	if ((int)(m[i].row-m[0].row)+m[i].nnz > pattern_nnz)
+	  pattern_nnz = (int)(m[i].row-m[0].row)+m[i].nnz;
+      }
+      if (m[0].owns_rowcol) {
+	POOL_free(pool,m[0].row,pattern_nnz*sizeof(int));
+	POOL_free(pool,m[0].col,pattern_nnz*sizeof(int));
+      }
+      if (m[0].owns_data)
+	POOL_free(pool,m[0].data,m[0].block_nnz*sizeof(REAL));
+      k = 1;
+    }
+    for (i = k; i < size; i++) {
+      if (m[i].owns_rowcol) {
+	POOL_free(pool,m[i].row,m[i].nnz*sizeof(int));
+	POOL_free(pool,m[i].col,m[i].nnz*sizeof(int));
+      }
+      if (m[i].owns_data)
+	POOL_free(pool,m[i].data,m[i].nnz*sizeof(REAL));
+    }
+    free(m);
+  }
+}
+
+Mat* MAT_array_new_block(int size, int size1, int size2, int* nnz, int* pattern) {
+  return MAT_array_new_block_from_pool(NULL,size,size1,size2,nnz,pattern);
+}
+
+Mat* MAT_array_new_block_from_pool(Pool* pool, int size, int size1, int size2, int* nnz, int* pattern) {
+  /* This function creates an array of size matrices whose data arrays
+     are consecutive segments of a single block of values, and whose
+     row and column arrays are segments of a single pattern block.
+     Matrix k shares the row and column arrays of matrix pattern[k]
+     if pattern[k] < k (both must have the same nnz), and has its own
+     otherwise or if pattern is NULL. The blocks are owned by the first
+     matrix, so the array is freed with MAT_array_del, and are taken
+     from the pool if one is given. */
+
+  // Local variables
+  Mat* m;
+  int* row;
+  int* col;
+  REAL* data;
+  int* offset;
+  int pattern_nnz;
+  int block_nnz;
+  int i;
+
+  // Array
+  m = MAT_array_new(size);
+  if (size <= 0)
+    return m;
+
+  // Pattern offsets
+  pattern_nnz = 0;
+  block_nnz = 0;
+  ARRAY_alloc(offset,int,size);
+  for (i = 0; i < size; i++) {
+    if (pattern && 0 <= pattern[i] && pattern[i] < i)
+      offset[i] = offset[pattern[i]];
+    else {
+      offset[i] = pattern_nnz;
+      pattern_nnz += nnz[i];
+    }
+    block_nnz += nnz[i];
+  }
+
+  // Blocks
+  row = (int*)POOL_alloc(pool,pattern_nnz*sizeof(int));
+  col = (int*)POOL_alloc(pool,pattern_nnz*sizeof(int));
+  data = (REAL*)POOL_alloc(pool,block_nnz*sizeof(REAL));
+
+  // Views
+  block_nnz = 0;
+  for (i = 0; i < size; i++) {
+    m[i].size1 = size1;
+    m[i].size2 = size2;
+    m[i].nnz = nnz[i];
+    m[i].row = &(row[offset[i]]);
+    m[i].col = &(col[offset[i]]);
+    m[i].data = &(data[block_nnz]);
+    m[i].owns_rowcol = FALSE;
+    m[i].owns_data = FALSE;
+    block_nnz += nnz[i];
+  }
+  m[0].owns_rowcol = TRUE;
+  m[0].owns_data = TRUE;
+  m[0].block_nnz = block_nnz;
+
+  // Clean up
+  free(offset);
+
+  return m;
+}
+
+REAL* MAT_array_get_block_data(Mat* m, int size) {
+  if (m && size > 0 && m[0].block_nnz > 0)
+    return m[0].data;
+  else
+    return NULL;
+}
+
 void MAT_array_set_zero_d(Mat* m, int size) {
   int i;
   if (m) {
-    for (i = 0; i < size; i++) 
-      MAT_set_zero_d(&(m[i]));
+    if (size > 0 && m[0].block_nnz > 0) {
+      ARRAY_clear(m[0].data,REAL,m[0].block_nnz);
+    }
+    else {
+      for (i = 0; i < size; i++)
+	MAT_set_zero_d(&(m[i]));
+    }
   }
 }
 
@@ -91,11 +212,34 @@ void MAT_del(Mat* m) {
       free(m->row);
       free(m->col);
     }
-    free(m->data);
+    if (m->owns_data)
+      free(m->data);
     free(m);
   }
 }
 
+void MAT_del_to_pool(Pool* pool, Mat* m) {
+  if (m) {
+    if (m->owns_rowcol) {
+      POOL_free(pool,m->row,m->nnz*sizeof(int));
+      POOL_free(pool,m->col,m->nnz*sizeof(int));
+    }
+    if (m->owns_data)
+      POOL_free(pool,m->data,m->nnz*sizeof(REAL));
+    free(m);
+  }
+}
+
+void MAT_detach_view(Mat* m) {
+  REAL* data;
+  if (m && !m->owns_data) {
+    data = (REAL*)malloc(m->nnz*sizeof(REAL));
+    memcpy(data,m->data,m->nnz*sizeof(REAL));
+    m->data = data;
+    m->owns_data = TRUE;
+  }
+}
+
 int MAT_get_i(Mat* m, int index) {
   return m->row[index];
 }
@@ -159,6 +303,8 @@ void MAT_init(Mat* m) {
     m->data = NULL;
     m->nnz = 0;
     m->owns_rowcol = TRUE;
+    m->owns_data = TRUE;
+    m->block_nnz = 0;
   }
 }
 
@@ -186,6 +332,18 @@ Mat* MAT_new_from_arrays(int size1, int size2, int nnz, int* row, int* col, REAL
   return m;
 }
 
+Mat* MAT_new_from_pool(Pool* pool, int size1, int size2, int nnz) {
+  Mat* m = (Mat*)malloc(sizeof(Mat));
+  MAT_init(m);
+  m->size1 = size1;
+  m->size2 = size2;
+  m->row = (int*)POOL_alloc(pool,nnz*sizeof(int));
+  m->col = (int*)POOL_alloc(pool,nnz*sizeof(int));
+  m->data = (REAL*)POOL_alloc(pool,nnz*sizeof(REAL));
+  m->nnz = nnz;
+  return m;
+}
+
 Vec* MAT_rmul_by_vec(Mat* m, Vec* v) {
   
   int k;
@@ -272,6 +430,16 @@ void MAT_set_owns_rowcol(Mat* m, BOOL flag) {
     m->owns_rowcol = flag;
 }
 
+void MAT_set_data_view(Mat* m, REAL* data) {
+  if (m && data && m->data != data) {
+    memcpy(data,m->data,m->nnz*sizeof(REAL));
+    if (m->owns_data)
+      free(m->data);
+    m->data = data;
+    m->owns_data = FALSE;
+  }
+}
+
 void MAT_show(Mat* m) {
   if (m) {
     printf("\nMatrix\n");
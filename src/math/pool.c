@@ -0,0 +1,171 @@
+/** @file pool.c
+ *  @brief This file defines the Pool data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <pfnet/array.h>
+#include <pfnet/pool.h>
+
+struct Pool {
+
+  // Retained buffers
+  void** buffers;     /**< @brief Buffers given back to the pool */
+  size_t* sizes;      /**< @brief Size in bytes of each retained buffer */
+  int num_buffers;    /**< @brief Number of retained buffers */
+  int max_buffers;    /**< @brief Allocated length of buffers and sizes */
+  size_t num_bytes;   /**< @brief Bytes in retained buffers */
+
+  // Statistics
+  size_t max_num_bytes; /**< @brief High-water mark of bytes in retained buffers */
+  int num_allocs;       /**< @brief Requests served with new buffers */
+  int num_reuses;       /**< @brief Requests served with retained buffers */
+};
+
+void* POOL_alloc(Pool* pool, size_t size) {
+  /* This function returns a zeroed buffer of at least size bytes. The
+     smallest retained buffer that is large enough is used if it is not
+     more than POOL_MAX_WASTE times larger than size, and a new buffer
+     is allocated otherwise. Buffers obtained from the pool may be
+     given back with POOL_free or released with free. */
+
+  // Local variables
+  void* ptr;
+  int best;
+  int i;
+
+  // No pool or empty request
+  if (!pool || size == 0)
+    return calloc(1,size);
+
+  // Best fit
+  best = -1;
+  for (i = 0; i < pool->num_buffers; i++) {
+    if (pool->sizes[i] >= size &&
+	pool->sizes[i] <= POOL_MAX_WASTE*size &&
+	(best < 0 || pool->sizes[i] < pool->sizes[best]))
+      best = i;
+  }
+
+  // New
+  if (best < 0) {
+    pool->num_allocs++;
+    return calloc(1,size);
+  }
+
+  // Reuse
+  ptr = pool->buffers[best];
+  pool->num_bytes -= pool->sizes[best];
+  pool->num_buffers--;
+  pool->buffers[best] = pool->buffers[pool->num_buffers];
+  pool->sizes[best] = pool->sizes[pool->num_buffers];
+  pool->num_reuses++;
+  memset(ptr,0,size);
+  return ptr;
+}
+
+void POOL_clear(Pool* pool) {
+  int i;
+  if (pool) {
+    for (i = 0; i < pool->num_buffers; i++)
+      free(pool->buffers[i]);
+    pool->num_buffers = 0;
+    pool->num_bytes = 0;
+  }
+}
+
+void POOL_del(Pool* pool) {
+  if (pool) {
+    POOL_clear(pool);
+    free(pool->buffers);
+    free(pool->sizes);
+    free(pool);
+  }
+}
+
+void POOL_free(Pool* pool, void* ptr, size_t size) {
+  /* This function gives back to the pool a buffer of at least size
+     bytes so that it can be reused by later requests. Without a pool,
+     the buffer is released. */
+
+  // Nothing to retain
+  if (!ptr)
+    return;
+  if (!pool || size == 0) {
+    free(ptr);
+    return;
+  }
+
+  // Grow
+  if (pool->num_buffers == pool->max_buffers) {
+    pool->max_buffers = 2*pool->max_buffers+16;
+    pool->buffers = (void**)realloc(pool->buffers,pool->max_buffers*sizeof(void*));
+    pool->sizes = (size_t*)realloc(pool->sizes,pool->max_buffers*sizeof(size_t));
+  }
+
+  // Retain
+  pool->buffers[pool->num_buffers] = ptr;
+  pool->sizes[pool->num_buffers] = size;
+  pool->num_buffers++;
+  pool->num_bytes += size;
+  if (pool->num_bytes > pool->max_num_bytes)
+    pool->max_num_bytes = pool->num_bytes;
+}
+
+size_t POOL_get_max_num_bytes(Pool* pool) {
+  if (pool)
+    return pool->max_num_bytes;
+  else
+    return 0;
+}
+
+int POOL_get_num_allocs(Pool* pool) {
+  if (pool)
+    return pool->num_allocs;
+  else
+    return 0;
+}
+
+int POOL_get_num_buffers(Pool* pool) {
+  if (pool)
+    return pool->num_buffers;
+  else
+    return 0;
+}
+
+size_t POOL_get_num_bytes(Pool* pool) {
+  if (pool)
+    return pool->num_bytes;
+  else
+    return 0;
+}
+
+int POOL_get_num_reuses(Pool* pool) {
+  if (pool)
+    return pool->num_reuses;
+  else
+    return 0;
+}
+
+Pool* POOL_new(void) {
+  Pool* pool = (Pool*)malloc(sizeof(Pool));
+  pool->buffers = NULL;
+  pool->sizes = NULL;
+  pool->num_buffers = 0;
+  pool->max_buffers = 0;
+  pool->num_bytes = 0;
+  POOL_reset_stats(pool);
+  return pool;
+}
+
+void POOL_reset_stats(Pool* pool) {
+  if (pool) {
+    pool->max_num_bytes = pool->num_bytes;
+    pool->num_allocs = 0;
+    pool->num_reuses = 0;
+  }
+}
@@ -0,0 +1,1103 @@
+/** @file splu.c
+ *  @brief This file defines the SpLU data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <pfnet/array.h>
+#include <pfnet/splu.h>
+
+struct SpLU {
+
+  // Error
+  BOOL error_flag;                      /**< @brief Error flag */
+  char error_string[SPLU_BUFFER_SIZE];  /**< @brief Error string */
+
+  // Options
+  BOOL sym;        /**< @brief Flag for symmetric matrices given by their lower triangular part */
+  REAL pivot_tol;  /**< @brief Relative threshold for keeping the matched pivot row */
+
+  // Pattern of the analyzed matrix
+  BOOL analyzed;              /**< @brief Flag that indicates that a pattern has been analyzed */
+  int n;                      /**< @brief Matrix size */
+  int format;                 /**< @brief Storage format of the analyzed matrix */
+  int in_nnz;                 /**< @brief Number of stored entries of the analyzed matrix */
+  int* in_ptr;                /**< @brief Compressed pointers of the analyzed matrix */
+  int* in_ind;                /**< @brief Compressed indices of the analyzed matrix */
+
+  // Matrix (compressed columns, both triangles)
+  int* Ap;    /**< @brief Start of each column */
+  int* Ai;    /**< @brief Row index of each entry */
+  int* Asrc;  /**< @brief Stored entry of the analyzed matrix that holds the value of each entry */
+  REAL* Ax;   /**< @brief Value of each entry (scaled by row) */
+  REAL* Rs;   /**< @brief Scale factor of each row (inverse of its largest entry) */
+
+  // Ordering
+  int* Q;     /**< @brief Column eliminated at each step */
+  int* R;     /**< @brief Row matched to each column (preferred pivot row) */
+
+  // Factors (P*A*Q = L*U)
+  BOOL factorized;  /**< @brief Flag that indicates that the factors are valid */
+  int* pinv;        /**< @brief Step at which each row is pivotal */
+  int* Lp;          /**< @brief Start of each column of L */
+  int* Li;          /**< @brief Row (step) of each entry of L (unit diagonal first) */
+  REAL* Lx;         /**< @brief Value of each entry of L */
+  int L_cap;        /**< @brief Allocated entries of L */
+  int* Up;          /**< @brief Start of each column of U */
+  int* Ui;          /**< @brief Row (step) of each entry of U (topological order, diagonal last) */
+  REAL* Ux;         /**< @brief Value of each entry of U */
+  int U_cap;        /**< @brief Allocated entries of U */
+
+  // Workspace
+  REAL* x;      /**< @brief Dense work vector (kept zero between calls) */
+  int* xi;      /**< @brief Reach of the current column in topological order */
+  int* stack;   /**< @brief Depth-first search stack */
+  int* pstack;  /**< @brief Position in the columns of the search stack */
+  int* mark;    /**< @brief Step at which each row was last visited */
+
+  // Counters
+  int num_factor;    /**< @brief Number of factorizations with pivoting */
+  int num_refactor;  /**< @brief Number of factorizations that reused the pivot sequence */
+};
+
+void SPLU_analyze(SpLU* lu, SpMat* A) {
+  /* This function builds the compressed column pattern of A (both
+     triangles if the matrix is symmetric and only its lower triangular
+     part is given), allocates the factors and workspace, and computes
+     a fill-reducing ordering. Numeric factorizations of matrices with
+     the same pattern reuse all of this. */
+
+  // Local variables
+  int* ptr;
+  int* ind;
+  int num_major;
+  int row;
+  int col;
+  int nnz;
+  int i;
+  int p;
+
+  // Check
+  if (!lu || !A)
+    return;
+  if (SPMAT_get_size1(A) != SPMAT_get_size2(A)) {
+    sprintf(lu->error_string,"matrix must be square");
+    lu->error_flag = TRUE;
+    return;
+  }
+
+  // Free
+  free(lu->in_ptr);
+  free(lu->in_ind);
+  free(lu->Ap);
+  free(lu->Ai);
+  free(lu->Asrc);
+  free(lu->Ax);
+  free(lu->Rs);
+  free(lu->Q);
+  free(lu->R);
+  free(lu->pinv);
+  free(lu->Lp);
+  free(lu->Li);
+  free(lu->Lx);
+  free(lu->Up);
+  free(lu->Ui);
+  free(lu->Ux);
+  free(lu->x);
+  free(lu->xi);
+  free(lu->stack);
+  free(lu->pstack);
+  free(lu->mark);
+
+  // Pattern
+  lu->n = SPMAT_get_size1(A);
+  lu->format = SPMAT_get_format(A);
+  lu->in_nnz = SPMAT_get_nnz(A);
+  ptr = SPMAT_get_ptr_array(A);
+  ind = SPMAT_get_ind_array(A);
+  num_major = lu->n;
+
+  // Workspace
+  ARRAY_zalloc(lu->x,REAL,lu->n);
+  ARRAY_zalloc(lu->xi,int,lu->n);
+  ARRAY_zalloc(lu->stack,int,lu->n);
+  ARRAY_zalloc(lu->pstack,int,lu->n);
+  ARRAY_zalloc(lu->mark,int,lu->n);
+
+  // Count entries of each column
+  ARRAY_zalloc(lu->Ap,int,lu->n+1);
+  for (i = 0; i < num_major; i++) {
+    for (p = ptr[i]; p < ptr[i+1]; p++) {
+      row = (lu->format == SPMAT_CSC) ? ind[p] : i;
+      col = (lu->format == SPMAT_CSC) ? i : ind[p];
+      if (lu->sym && col > row)
+	continue;
+      lu->Ap[col+1]++;
+      if (lu->sym && row != col)
+	lu->Ap[row+1]++;
+    }
+  }
+  for (i = 0; i < lu->n; i++) {
+    lu->Ap[i+1] += lu->Ap[i];
+    lu->xi[i] = lu->Ap[i];
+  }
+  nnz = lu->Ap[lu->n];
+
+  // Entries
+  ARRAY_zalloc(lu->Ai,int,nnz);
+  ARRAY_zalloc(lu->Asrc,int,nnz);
+  ARRAY_zalloc(lu->Ax,REAL,nnz);
+  ARRAY_zalloc(lu->Rs,REAL,lu->n);
+  for (i = 0; i < num_major; i++) {
+    for (p = ptr[i]; p < ptr[i+1]; p++) {
+      row = (lu->format == SPMAT_CSC) ? ind[p] : i;
+      col = (lu->format == SPMAT_CSC) ? i : ind[p];
+      if (lu->sym && col > row)
+	continue;
+      lu->Ai[lu->xi[col]] = row;
+      lu->Asrc[lu->xi[col]++] = p;
+      if (lu->sym && row != col) {
+	lu->Ai[lu->xi[row]] = col;
+	lu->Asrc[lu->xi[row]++] = p;
+      }
+    }
+  }
+
+  // Analyzed structure
+  ARRAY_alloc(lu->in_ptr,int,num_major+1);
+  ARRAY_alloc(lu->in_ind,int,lu->in_nnz);
+  memcpy(lu->in_ptr,ptr,(num_major+1)*sizeof(int));
+  memcpy(lu->in_ind,ind,lu->in_nnz*sizeof(int));
+
+  // Factors
+  lu->L_cap = 2*nnz+lu->n;
+  lu->U_cap = 2*nnz+lu->n;
+  ARRAY_zalloc(lu->pinv,int,lu->n);
+  ARRAY_zalloc(lu->Lp,int,lu->n+1);
+  ARRAY_zalloc(lu->Up,int,lu->n+1);
+  ARRAY_zalloc(lu->Li,int,lu->L_cap);
+  ARRAY_zalloc(lu->Lx,REAL,lu->L_cap);
+  ARRAY_zalloc(lu->Ui,int,lu->U_cap);
+  ARRAY_zalloc(lu->Ux,REAL,lu->U_cap);
+
+  // Ordering (uses the scaled values of A)
+  lu->analyzed = TRUE;
+  lu->factorized = FALSE;
+  ARRAY_zalloc(lu->Q,int,lu->n);
+  ARRAY_zalloc(lu->R,int,lu->n);
+  SPLU_update_values(lu,A);
+  SPLU_order(lu);
+}
+
+void SPLU_clear_error(SpLU* lu) {
+  if (lu) {
+    lu->error_flag = FALSE;
+    strcpy(lu->error_string,"");
+  }
+}
+
+void SPLU_del(SpLU* lu) {
+  if (lu) {
+    free(lu->in_ptr);
+    free(lu->in_ind);
+    free(lu->Ap);
+    free(lu->Ai);
+    free(lu->Asrc);
+    free(lu->Ax);
+    free(lu->Rs);
+    free(lu->Q);
+    free(lu->R);
+    free(lu->pinv);
+    free(lu->Lp);
+    free(lu->Li);
+    free(lu->Lx);
+    free(lu->Up);
+    free(lu->Ui);
+    free(lu->Ux);
+    free(lu->x);
+    free(lu->xi);
+    free(lu->stack);
+    free(lu->pstack);
+    free(lu->mark);
+    free(lu);
+  }
+}
+
+void SPLU_factorize(SpLU* lu, SpMat* A) {
+  /* This function computes P*A*Q = L*U with the left-looking algorithm
+     of Gilbert and Peierls. The nonzero pattern of each column of L\A is
+     found by a depth-first search over the columns of L computed so far,
+     and the pivot is chosen by threshold partial pivoting (the row matched
+     to the column by the ordering is kept when it is within pivot_tol of
+     the largest candidate). A is analyzed first if its pattern changed. */
+
+  // Local variables
+  int* Ap;
+  int* Ai;
+  REAL* Ax;
+  int* Li;
+  REAL* Lx;
+  int* Ui;
+  REAL* Ux;
+  REAL* x;
+  REAL pivot;
+  REAL a;
+  int n;
+  int lnz;
+  int unz;
+  int top;
+  int head;
+  int col;
+  int ipiv;
+  int jnew;
+  int p2;
+  int i;
+  int j;
+  int k;
+  int p;
+  int q;
+  int t;
+  BOOL done;
+
+  // Check
+  if (!lu || !A)
+    return;
+
+  // Analyze
+  if (!SPLU_matches_pattern(lu,A)) {
+    SPLU_analyze(lu,A);
+    if (lu->error_flag)
+      return;
+  }
+
+  // Values
+  SPLU_update_values(lu,A);
+
+  // Init
+  n = lu->n;
+  Ap = lu->Ap;
+  Ai = lu->Ai;
+  Ax = lu->Ax;
+  x = lu->x;
+  lu->factorized = FALSE;
+  for (i = 0; i < n; i++) {
+    lu->pinv[i] = -1;
+    lu->mark[i] = 0;
+  }
+
+  // Columns
+  lnz = 0;
+  unz = 0;
+  for (k = 0; k < n; k++) {
+
+    lu->Lp[k] = lnz;
+    lu->Up[k] = unz;
+
+    // Grow factors
+    if (lnz+n > lu->L_cap) {
+      lu->L_cap = 2*lu->L_cap+n;
+      lu->Li = (int*)realloc(lu->Li,lu->L_cap*sizeof(int));
+      lu->Lx = (REAL*)realloc(lu->Lx,lu->L_cap*sizeof(REAL));
+    }
+    if (unz+n > lu->U_cap) {
+      lu->U_cap = 2*lu->U_cap+n;
+      lu->Ui = (int*)realloc(lu->Ui,lu->U_cap*sizeof(int));
+      lu->Ux = (REAL*)realloc(lu->Ux,lu->U_cap*sizeof(REAL));
+    }
+    Li = lu->Li;
+    Lx = lu->Lx;
+    Ui = lu->Ui;
+    Ux = lu->Ux;
+    col = lu->Q[k];
+
+    // Reach of A(:,col) in the graph of L (topological order in xi[top..n-1])
+    top = n;
+    for (p = Ap[col]; p < Ap[col+1]; p++) {
+      if (lu->mark[Ai[p]] == k+1)
+	continue;
+      head = 0;
+      lu->stack[0] = Ai[p];
+      while (head >= 0) {
+	j = lu->stack[head];
+	jnew = lu->pinv[j];
+	if (lu->mark[j] != k+1) {
+	  lu->mark[j] = k+1;
+	  lu->pstack[head] = (jnew < 0) ? 0 : lu->Lp[jnew];
+	}
+	done = TRUE;
+	p2 = (jnew < 0) ? 0 : lu->Lp[jnew+1];
+	for (q = lu->pstack[head]; q < p2; q++) {
+	  i = Li[q];
+	  if (lu->mark[i] == k+1)
+	    continue;
+	  lu->pstack[head] = q;
+	  lu->stack[++head] = i;
+	  done = FALSE;
+	  break;
+	}
+	if (done) {
+	  head--;
+	  lu->xi[--top] = j;
+	}
+      }
+    }
+
+    // x = L\A(:,col)
+    for (p = Ap[col]; p < Ap[col+1]; p++)
+      x[Ai[p]] = Ax[p];
+    for (t = top; t < n; t++) {
+      j = lu->xi[t];
+      jnew = lu->pinv[j];
+      if (jnew < 0)
+	continue;
+      for (q = lu->Lp[jnew]+1; q < lu->Lp[jnew+1]; q++)
+	x[Li[q]] -= Lx[q]*x[j];
+    }
+
+    // Pivot and U(:,k)
+    ipiv = -1;
+    a = -1;
+    for (t = top; t < n; t++) {
+      i = lu->xi[t];
+      if (lu->pinv[i] < 0) {
+	if (fabs(x[i]) > a) {
+	  a = fabs(x[i]);
+	  ipiv = i;
+	}
+      }
+      else {
+	Ui[unz] = lu->pinv[i];
+	Ux[unz++] = x[i];
+      }
+    }
+    if (ipiv < 0 || a <= 0) {
+      ARRAY_clear(x,REAL,n);
+      sprintf(lu->error_string,"matrix is singular");
+      lu->error_flag = TRUE;
+      return;
+    }
+    i = lu->R[col];
+    if (lu->pinv[i] < 0 && fabs(x[i]) >= a*lu->pivot_tol)
+      ipiv = i;
+    pivot = x[ipiv];
+    Ui[unz] = k;
+    Ux[unz++] = pivot;
+    lu->pinv[ipiv] = k;
+
+    // L(:,k)
+    Li[lnz] = ipiv;
+    Lx[lnz++] = 1.;
+    for (t = top; t < n; t++) {
+      i = lu->xi[t];
+      if (lu->pinv[i] < 0) {
+	Li[lnz] = i;
+	Lx[lnz++] = x[i]/pivot;
+      }
+      x[i] = 0;
+    }
+  }
+  lu->Lp[n] = lnz;
+  lu->Up[n] = unz;
+
+  // Rows of L in pivot order
+  for (p = 0; p < lnz; p++)
+    lu->Li[p] = lu->pinv[lu->Li[p]];
+
+  lu->factorized = TRUE;
+  lu->num_factor++;
+}
+
+char* SPLU_get_error_string(SpLU* lu) {
+  if (lu)
+    return lu->error_string;
+  else
+    return NULL;
+}
+
+int SPLU_get_L_nnz(SpLU* lu) {
+  if (lu && lu->factorized)
+    return lu->Lp[lu->n];
+  else
+    return 0;
+}
+
+int SPLU_get_U_nnz(SpLU* lu) {
+  if (lu && lu->factorized)
+    return lu->Up[lu->n];
+  else
+    return 0;
+}
+
+int SPLU_get_num_factorizations(SpLU* lu) {
+  if (lu)
+    return lu->num_factor;
+  else
+    return 0;
+}
+
+int SPLU_get_num_refactorizations(SpLU* lu) {
+  if (lu)
+    return lu->num_refactor;
+  else
+    return 0;
+}
+
+int* SPLU_get_ordering(SpLU* lu) {
+  if (lu)
+    return lu->Q;
+  else
+    return NULL;
+}
+
+int SPLU_get_size(SpLU* lu) {
+  if (lu)
+    return lu->n;
+  else
+    return 0;
+}
+
+BOOL SPLU_has_error(SpLU* lu) {
+  if (lu)
+    return lu->error_flag;
+  else
+    return FALSE;
+}
+
+BOOL SPLU_is_factorized(SpLU* lu) {
+  if (lu)
+    return lu->factorized;
+  else
+    return FALSE;
+}
+
+BOOL SPLU_matches_pattern(SpLU* lu, SpMat* A) {
+
+  // Check
+  if (!lu || !A || !lu->analyzed)
+    return FALSE;
+  if (SPMAT_get_size1(A) != lu->n ||
+      SPMAT_get_size2(A) != lu->n ||
+      SPMAT_get_format(A) != lu->format ||
+      SPMAT_get_nnz(A) != lu->in_nnz)
+    return FALSE;
+
+  // Structure
+  return (memcmp(SPMAT_get_ptr_array(A),lu->in_ptr,(lu->n+1)*sizeof(int)) == 0 &&
+	  memcmp(SPMAT_get_ind_array(A),lu->in_ind,lu->in_nnz*sizeof(int)) == 0);
+}
+
+SpLU* SPLU_new(void) {
+  SpLU* lu = (SpLU*)malloc(sizeof(SpLU));
+  lu->error_flag = FALSE;
+  strcpy(lu->error_string,"");
+  lu->sym = FALSE;
+  lu->pivot_tol = SPLU_PIVOT_TOL;
+  lu->analyzed = FALSE;
+  lu->n = 0;
+  lu->format = SPMAT_CSC;
+  lu->in_nnz = 0;
+  lu->in_ptr = NULL;
+  lu->in_ind = NULL;
+  lu->Ap = NULL;
+  lu->Ai = NULL;
+  lu->Asrc = NULL;
+  lu->Ax = NULL;
+  lu->Rs = NULL;
+  lu->Q = NULL;
+  lu->R = NULL;
+  lu->factorized = FALSE;
+  lu->pinv = NULL;
+  lu->Lp = NULL;
+  lu->Li = NULL;
+  lu->Lx = NULL;
+  lu->L_cap = 0;
+  lu->Up = NULL;
+  lu->Ui = NULL;
+  lu->Ux = NULL;
+  lu->U_cap = 0;
+  lu->x = NULL;
+  lu->xi = NULL;
+  lu->stack = NULL;
+  lu->pstack = NULL;
+  lu->mark = NULL;
+  lu->num_factor = 0;
+  lu->num_refactor = 0;
+  return lu;
+}
+
+void SPLU_order(SpLU* lu) {
+  /* This function computes the fill-reducing ordering. Rows are first
+     matched to columns, greedily by the largest scaled entries and then
+     with a maximum transversal (augmenting paths), so that the matched
+     entries form a zero-free diagonal of the row-permuted matrix B.
+     Then a minimum degree ordering of the graph of B+B^T is computed.
+     The elimination graph is kept explicitly: eliminating a node
+     connects its neighbors into a clique, and nodes are kept in lists by
+     degree so that a node of minimum degree is found in constant time.
+     During factorization, the matched rows are the preferred pivots. */
+
+  // Local variables
+  int** adj;
+  int* len;
+  int* cap;
+  int* head;
+  int* next;
+  int* prev;
+  int* mark;
+  int* jmatch;
+  int* cheap;
+  int* js;
+  int* is;
+  int* ps;
+  char* elim;
+  REAL* cval;
+  REAL* rval;
+  REAL val;
+  BOOL found;
+  int pass;
+  int stamp;
+  int mindeg;
+  int top;
+  int n;
+  int u;
+  int v;
+  int w;
+  int m;
+  int a;
+  int b;
+  int i;
+  int j;
+  int k;
+  int p;
+
+  // Check
+  if (!lu || !lu->Q || !lu->R)
+    return;
+
+  // Allocate
+  n = lu->n;
+  ARRAY_zalloc(adj,int*,n);
+  ARRAY_zalloc(len,int,n);
+  ARRAY_zalloc(cap,int,n);
+  ARRAY_zalloc(head,int,n);
+  ARRAY_zalloc(next,int,n);
+  ARRAY_zalloc(prev,int,n);
+  ARRAY_zalloc(mark,int,n);
+  ARRAY_zalloc(jmatch,int,n);
+  ARRAY_zalloc(cheap,int,n);
+  ARRAY_zalloc(js,int,n);
+  ARRAY_zalloc(is,int,n);
+  ARRAY_zalloc(ps,int,n);
+  ARRAY_zalloc(elim,char,n);
+  ARRAY_zalloc(cval,REAL,n);
+  ARRAY_zalloc(rval,REAL,n);
+
+  // Matching of large unscaled entries (jmatch[i] is the column matched to row i)
+  // Each round matches the pairs whose entry is the largest unmatched one
+  // of both its row and its column (js and is hold the best row of each
+  // column and the best column of each row)
+  for (i = 0; i < n; i++) {
+    jmatch[i] = -1;
+    lu->R[i] = -1;
+    mark[i] = -1;
+  }
+  found = TRUE;
+  while (found) {
+    found = FALSE;
+    for (k = 0; k < n; k++) {
+      js[k] = -1;
+      is[k] = -1;
+      cval[k] = 0;
+      rval[k] = 0;
+    }
+    for (j = 0; j < n; j++) {
+      if (lu->R[j] >= 0)
+	continue;
+      for (p = lu->Ap[j]; p < lu->Ap[j+1]; p++) {
+	i = lu->Ai[p];
+	if (jmatch[i] >= 0)
+	  continue;
+	val = fabs(lu->Ax[p])/lu->Rs[i];
+	if (val > cval[j]) {
+	  cval[j] = val;
+	  js[j] = i;
+	}
+	if (val > rval[i]) {
+	  rval[i] = val;
+	  is[i] = j;
+	}
+      }
+    }
+    for (j = 0; j < n; j++) {
+      i = js[j];
+      if (i >= 0 && is[i] == j) {
+	jmatch[i] = j;
+	lu->R[j] = i;
+	found = TRUE;
+      }
+    }
+  }
+
+  // Maximum transversal (augmenting paths from the unmatched columns)
+  // The first pass only uses nonzero entries, so that explicit zeros
+  // kept in the pattern are not preferred
+  for (pass = 0; pass < 2; pass++) {
+    for (j = 0; j < n; j++)
+      cheap[j] = lu->Ap[j];
+    for (k = 0; k < n; k++) {
+
+      // Matched
+      if (lu->R[k] >= 0)
+	continue;
+
+      // Augmenting path from column k (depth-first)
+      stamp = pass*n+k;
+      found = FALSE;
+      i = -1;
+      top = 0;
+      js[0] = k;
+      while (top >= 0) {
+	j = js[top];
+	if (mark[j] != stamp) {
+	  mark[j] = stamp;
+	  for (p = cheap[j]; p < lu->Ap[j+1] && !found; p++) {
+	    i = lu->Ai[p];
+	    found = (jmatch[i] < 0 && (pass || lu->Ax[p] != 0.));
+	  }
+	  cheap[j] = p;
+	  if (found) {
+	    is[top] = i;
+	    break;
+	  }
+	  ps[top] = lu->Ap[j];
+	}
+	for (p = ps[top]; p < lu->Ap[j+1]; p++) {
+	  i = lu->Ai[p];
+	  if ((!pass && lu->Ax[p] == 0.) || jmatch[i] < 0 || mark[jmatch[i]] == stamp)
+	    continue;
+	  ps[top] = p+1;
+	  is[top] = i;
+	  js[++top] = jmatch[i];
+	  break;
+	}
+	if (p == lu->Ap[j+1])
+	  top--;
+      }
+      if (found) {
+	for (p = top; p >= 0; p--) {
+	  jmatch[is[p]] = js[p];
+	  lu->R[js[p]] = is[p];
+	}
+      }
+    }
+  }
+  for (i = 0; i < n; i++) {
+    if (jmatch[i] >= 0)
+      lu->R[jmatch[i]] = i;
+  }
+
+  // Unmatched rows and columns (structurally singular) paired in order
+  j = 0;
+  for (i = 0; i < n; i++) {
+    if (jmatch[i] >= 0)
+      continue;
+    while (lu->R[j] >= 0)
+      j++;
+    lu->R[j] = i;
+    jmatch[i] = j;
+  }
+
+  // Adjacency of B+B^T (no diagonal, no duplicates)
+  for (j = 0; j < n; j++) {
+    mark[j] = 0;
+    for (p = lu->Ap[j]; p < lu->Ap[j+1]; p++) {
+      i = jmatch[lu->Ai[p]];
+      if (i != j) {
+	cap[i]++;
+	cap[j]++;
+      }
+    }
+  }
+  for (v = 0; v < n; v++) {
+    cap[v] = cap[v] > 0 ? cap[v] : 1;
+    ARRAY_alloc(adj[v],int,cap[v]);
+  }
+  for (j = 0; j < n; j++) {
+    for (p = lu->Ap[j]; p < lu->Ap[j+1]; p++) {
+      i = jmatch[lu->Ai[p]];
+      if (i != j) {
+	adj[i][len[i]++] = j;
+	adj[j][len[j]++] = i;
+      }
+    }
+  }
+  for (v = 0; v < n; v++) {
+    m = 0;
+    for (a = 0; a < len[v]; a++) {
+      w = adj[v][a];
+      if (mark[w] != v+1) {
+	mark[w] = v+1;
+	adj[v][m++] = w;
+      }
+    }
+    len[v] = m;
+  }
+  stamp = n;
+
+  // Degree lists
+  for (v = 0; v < n; v++)
+    head[v] = -1;
+  for (v = n-1; v >= 0; v--) {
+    prev[v] = -1;
+    next[v] = head[len[v]];
+    if (head[len[v]] >= 0)
+      prev[head[len[v]]] = v;
+    head[len[v]] = v;
+  }
+
+  // Eliminate
+  mindeg = 0;
+  for (k = 0; k < n; k++) {
+
+    // Node of minimum degree
+    while (head[mindeg] < 0)
+      mindeg++;
+    v = head[mindeg];
+    head[mindeg] = next[v];
+    if (next[v] >= 0)
+      prev[next[v]] = -1;
+    lu->Q[k] = v;
+    elim[v] = 1;
+
+    // Neighbors become a clique
+    for (a = 0; a < len[v]; a++) {
+      u = adj[v][a];
+
+      // Remove from degree list
+      if (prev[u] >= 0)
+	next[prev[u]] = next[u];
+      else
+	head[len[u]] = next[u];
+      if (next[u] >= 0)
+	prev[next[u]] = prev[u];
+
+      // New neighbors
+      stamp++;
+      mark[u] = stamp;
+      mark[v] = stamp;
+      m = 0;
+      for (b = 0; b < len[u]; b++) {
+	w = adj[u][b];
+	if (!elim[w] && mark[w] != stamp) {
+	  mark[w] = stamp;
+	  adj[u][m++] = w;
+	}
+      }
+      if (m+len[v] > cap[u]) {
+	cap[u] = 2*(m+len[v]);
+	adj[u] = (int*)realloc(adj[u],cap[u]*sizeof(int));
+      }
+      for (b = 0; b < len[v]; b++) {
+	w = adj[v][b];
+	if (mark[w] != stamp) {
+	  mark[w] = stamp;
+	  adj[u][m++] = w;
+	}
+      }
+      len[u] = m;
+
+      // Insert in degree list
+      prev[u] = -1;
+      next[u] = head[m];
+      if (head[m] >= 0)
+	prev[head[m]] = u;
+      head[m] = u;
+      if (m < mindeg)
+	mindeg = m;
+    }
+    free(adj[v]);
+    adj[v] = NULL;
+  }
+
+  // Clean up
+  free(adj);
+  free(len);
+  free(cap);
+  free(head);
+  free(next);
+  free(prev);
+  free(mark);
+  free(jmatch);
+  free(cheap);
+  free(js);
+  free(is);
+  free(ps);
+  free(elim);
+  free(cval);
+  free(rval);
+}
+
+void SPLU_refactorize(SpLU* lu, SpMat* A) {
+  /* This function recomputes the values of the factors of A reusing the
+     pivot sequence and the patterns of L and U of the last factorization,
+     so no search, pivoting or allocation is done. It falls back to
+     SPLU_factorize if there are no factors of the same pattern or if a
+     pivot becomes too small. */
+
+  // Local variables
+  int* Li;
+  REAL* Lx;
+  int* Ui;
+  REAL* Ux;
+  REAL* x;
+  REAL pivot;
+  REAL xj;
+  REAL a;
+  int n;
+  int col;
+  int j;
+  int k;
+  int p;
+  int q;
+
+  // Check
+  if (!lu || !A)
+    return;
+
+  // No factors to reuse
+  if (!lu->factorized || !SPLU_matches_pattern(lu,A)) {
+    SPLU_factorize(lu,A);
+    return;
+  }
+
+  // Values
+  SPLU_update_values(lu,A);
+
+  // Columns
+  n = lu->n;
+  Li = lu->Li;
+  Lx = lu->Lx;
+  Ui = lu->Ui;
+  Ux = lu->Ux;
+  x = lu->x;
+  for (k = 0; k < n; k++) {
+
+    // Scatter A(:,col) in pivot order
+    col = lu->Q[k];
+    for (p = lu->Ap[col]; p < lu->Ap[col+1]; p++)
+      x[lu->pinv[lu->Ai[p]]] = lu->Ax[p];
+
+    // U(:,k) (rows in topological order)
+    for (p = lu->Up[k]; p < lu->Up[k+1]-1; p++) {
+      j = Ui[p];
+      xj = x[j];
+      Ux[p] = xj;
+      x[j] = 0;
+      for (q = lu->Lp[j]+1; q < lu->Lp[j+1]; q++)
+	x[Li[q]] -= Lx[q]*xj;
+    }
+    pivot = x[k];
+    Ux[lu->Up[k+1]-1] = pivot;
+    x[k] = 0;
+
+    // Pivot check
+    a = fabs(pivot);
+    for (q = lu->Lp[k]+1; q < lu->Lp[k+1]; q++)
+      a = fabs(x[Li[q]]) > a ? fabs(x[Li[q]]) : a;
+    if (pivot == 0 || fabs(pivot) < SPLU_REFACTOR_TOL*a) {
+      ARRAY_clear(x,REAL,n);
+      SPLU_factorize(lu,A);
+      return;
+    }
+
+    // L(:,k)
+    for (q = lu->Lp[k]+1; q < lu->Lp[k+1]; q++) {
+      Lx[q] = x[Li[q]]/pivot;
+      x[Li[q]] = 0;
+    }
+  }
+
+  lu->num_refactor++;
+}
+
+void SPLU_set_pivot_tol(SpLU* lu, REAL tol) {
+  if (lu)
+    lu->pivot_tol = tol;
+}
+
+void SPLU_set_symmetric(SpLU* lu, BOOL flag) {
+  /* This function indicates that the matrices are symmetric and given by
+     their lower triangular part (e.g. KKT matrices). Entries above the
+     diagonal are then ignored. */
+  if (lu && lu->sym != flag) {
+    lu->sym = flag;
+    lu->analyzed = FALSE;
+    lu->factorized = FALSE;
+  }
+}
+
+void SPLU_solve(SpLU* lu, Vec* b) {
+  /* This function overwrites b with the solution of A*x = b */
+
+  // Local variables
+  REAL* bd;
+  REAL* x;
+  int n;
+  int j;
+  int k;
+  int q;
+
+  // Check
+  if (!lu || !b)
+    return;
+  if (!lu->factorized) {
+    sprintf(lu->error_string,"matrix is not factorized");
+    lu->error_flag = TRUE;
+    return;
+  }
+  if (VEC_get_size(b) != lu->n) {
+    sprintf(lu->error_string,"invalid vector size");
+    lu->error_flag = TRUE;
+    return;
+  }
+
+  // Scale and permute rows
+  n = lu->n;
+  x = lu->x;
+  bd = VEC_get_data(b);
+  for (k = 0; k < n; k++)
+    x[lu->pinv[k]] = lu->Rs[k]*bd[k];
+
+  // Solve L
+  for (j = 0; j < n; j++) {
+    for (q = lu->Lp[j]+1; q < lu->Lp[j+1]; q++)
+      x[lu->Li[q]] -= lu->Lx[q]*x[j];
+  }
+
+  // Solve U
+  for (j = n-1; j >= 0; j--) {
+    x[j] /= lu->Ux[lu->Up[j+1]-1];
+    for (q = lu->Up[j]; q < lu->Up[j+1]-1; q++)
+      x[lu->Ui[q]] -= lu->Ux[q]*x[j];
+  }
+
+  // Permute columns
+  for (k = 0; k < n; k++) {
+    bd[lu->Q[k]] = x[k];
+    x[k] = 0;
+  }
+}
+
+void SPLU_solve_batch(SpLU* lu, Vec* b, int num) {
+  /* This function overwrites each of the num right-hand sides stored one
+     after the other in b with the solution of A*x = b. The right-hand
+     sides are interleaved in a work array so that each entry of L and U
+     is loaded once for all of them. Unlike SPLU_solve, the workspace of
+     the factorization is not used, so concurrent calls are safe. */
+
+  // Local variables
+  REAL* bd;
+  REAL* X;
+  REAL* xj;
+  REAL l;
+  int n;
+  int j;
+  int k;
+  int q;
+  int r;
+
+  // Check
+  if (!lu || !b || num <= 0)
+    return;
+  if (!lu->factorized) {
+    sprintf(lu->error_string,"matrix is not factorized");
+    lu->error_flag = TRUE;
+    return;
+  }
+  if (VEC_get_size(b) != lu->n*num) {
+    sprintf(lu->error_string,"invalid vector size");
+    lu->error_flag = TRUE;
+    return;
+  }
+
+  // Scale, permute and interleave rows
+  n = lu->n;
+  bd = VEC_get_data(b);
+  ARRAY_zalloc(X,REAL,n*num);
+  for (r = 0; r < num; r++) {
+    for (k = 0; k < n; k++)
+      X[lu->pinv[k]*num+r] = lu->Rs[k]*bd[r*n+k];
+  }
+
+  // Solve L
+  for (j = 0; j < n; j++) {
+    xj = X+j*num;
+    for (q = lu->Lp[j]+1; q < lu->Lp[j+1]; q++) {
+      l = lu->Lx[q];
+      for (r = 0; r < num; r++)
+	X[lu->Li[q]*num+r] -= l*xj[r];
+    }
+  }
+
+  // Solve U
+  for (j = n-1; j >= 0; j--) {
+    xj = X+j*num;
+    l = lu->Ux[lu->Up[j+1]-1];
+    for (r = 0; r < num; r++)
+      xj[r] /= l;
+    for (q = lu->Up[j]; q < lu->Up[j+1]-1; q++) {
+      l = lu->Ux[q];
+      for (r = 0; r < num; r++)
+	X[lu->Ui[q]*num+r] -= l*xj[r];
+    }
+  }
+
+  // Permute columns
+  for (r = 0; r < num; r++) {
+    for (k = 0; k < n; k++)
+      bd[r*n+lu->Q[k]] = X[k*num+r];
+  }
+
+  // Clean up
+  free(X);
+}
+
+void SPLU_update_values(SpLU* lu, SpMat* A) {
+  /* This function gathers the values of A and scales each row by the
+     inverse of its largest entry, so that the pivot threshold compares
+     entries of rows of very different magnitudes fairly. */
+
+  // Local variables
+  REAL* data;
+  REAL a;
+  int nnz;
+  int i;
+  int p;
+
+  // Check
+  if (!lu || !A || !lu->analyzed || SPMAT_get_nnz(A) != lu->in_nnz)
+    return;
+
+  // Gather
+  data = SPMAT_get_data_array(A);
+  nnz = lu->Ap[lu->n];
+  for (i = 0; i < lu->n; i++)
+    lu->Rs[i] = 0;
+  for (p = 0; p < nnz; p++) {
+    lu->Ax[p] = data[lu->Asrc[p]];
+    a = fabs(lu->Ax[p]);
+    if (a > lu->Rs[lu->Ai[p]])
+      lu->Rs[lu->Ai[p]] = a;
+  }
+
+  // Scale
+  for (i = 0; i < lu->n; i++)
+    lu->Rs[i] = (lu->Rs[i] > 0) ? 1./lu->Rs[i] : 1.;
+  for (p = 0; p < nnz; p++)
+    lu->Ax[p] *= lu->Rs[lu->Ai[p]];
+}
@@ -0,0 +1,287 @@
+/** @file spmat.c
+ *  @brief This file defines the SpMat data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <pfnet/array.h>
+#include <pfnet/spmat.h>
+
+struct SpMat {
+
+  int format;   /**< @brief Storage format (SPMAT_CSR or SPMAT_CSC) */
+  int size1;    /**< @brief Number of rows */
+  int size2;    /**< @brief Number of columns */
+
+  int nnz;      /**< @brief Number of stored entries (duplicates merged) */
+  int* ptr;     /**< @brief Start of each row (CSR) or column (CSC) in ind and data */
+  int* ind;     /**< @brief Column (CSR) or row (CSC) index of each stored entry */
+  REAL* data;   /**< @brief Value of each stored entry */
+
+  int coo_nnz;  /**< @brief Number of entries of the source coordinate matrix */
+  int* map;     /**< @brief Stored entry of each source entry (-1 if out of range) */
+};
+
+void SPMAT_del(SpMat* s) {
+  if (s) {
+    free(s->ptr);
+    free(s->ind);
+    free(s->data);
+    free(s->map);
+    free(s);
+  }
+}
+
+int SPMAT_get_format(SpMat* s) {
+  if (s)
+    return s->format;
+  else
+    return SPMAT_CSR;
+}
+
+int SPMAT_get_size1(SpMat* s) {
+  if (s)
+    return s->size1;
+  else
+    return 0;
+}
+
+int SPMAT_get_size2(SpMat* s) {
+  if (s)
+    return s->size2;
+  else
+    return 0;
+}
+
+int SPMAT_get_nnz(SpMat* s) {
+  if (s)
+    return s->nnz;
+  else
+    return 0;
+}
+
+int SPMAT_get_coo_nnz(SpMat* s) {
+  if (s)
+    return s->coo_nnz;
+  else
+    return 0;
+}
+
+int* SPMAT_get_ptr_array(SpMat* s) {
+  if (s)
+    return s->ptr;
+  else
+    return NULL;
+}
+
+int* SPMAT_get_ind_array(SpMat* s) {
+  if (s)
+    return s->ind;
+  else
+    return NULL;
+}
+
+REAL* SPMAT_get_data_array(SpMat* s) {
+  if (s)
+    return s->data;
+  else
+    return NULL;
+}
+
+int* SPMAT_get_map_array(SpMat* s) {
+  if (s)
+    return s->map;
+  else
+    return NULL;
+}
+
+SpMat* SPMAT_new_from_mat(Mat* m, int format) {
+  /* This function builds the compressed structure of m and the map
+     from the entries of m to the compressed entries. Entries are sorted
+     by major index with two stable counting sorts (minor index first),
+     and duplicates are merged. */
+
+  // Local variables
+  SpMat* s;
+  int* major;
+  int* minor;
+  int* next;
+  int* order_minor;
+  int* order;
+  int num_major;
+  int num_minor;
+  int num_valid;
+  int start;
+  int end;
+  int i;
+  int k;
+  int q;
+
+  // No m
+  if (!m)
+    return NULL;
+
+  // Allocate
+  s = (SpMat*)malloc(sizeof(SpMat));
+  s->format = format;
+  s->size1 = MAT_get_size1(m);
+  s->size2 = MAT_get_size2(m);
+  s->coo_nnz = MAT_get_nnz(m);
+  s->nnz = 0;
+  if (format == SPMAT_CSC) {
+    major = MAT_get_col_array(m);
+    minor = MAT_get_row_array(m);
+    num_major = s->size2;
+    num_minor = s->size1;
+  }
+  else {
+    s->format = SPMAT_CSR;
+    major = MAT_get_row_array(m);
+    minor = MAT_get_col_array(m);
+    num_major = s->size1;
+    num_minor = s->size2;
+  }
+  ARRAY_zalloc(s->ptr,int,num_major+1);
+  ARRAY_alloc(s->map,int,s->coo_nnz);
+  ARRAY_alloc(order_minor,int,s->coo_nnz);
+  ARRAY_alloc(order,int,s->coo_nnz);
+  ARRAY_zalloc(next,int,(num_major > num_minor ? num_major : num_minor)+1);
+
+  // Sort by minor index
+  num_valid = 0;
+  for (k = 0; k < s->coo_nnz; k++) {
+    if (major[k] >= 0 && major[k] < num_major &&
+	minor[k] >= 0 && minor[k] < num_minor) {
+      next[minor[k]+1]++;
+      num_valid++;
+    }
+    s->map[k] = -1;
+  }
+  for (i = 0; i < num_minor; i++)
+    next[i+1] += next[i];
+  for (k = 0; k < s->coo_nnz; k++) {
+    if (major[k] >= 0 && major[k] < num_major &&
+	minor[k] >= 0 && minor[k] < num_minor)
+      order_minor[next[minor[k]]++] = k;
+  }
+
+  // Stable sort by major index
+  for (q = 0; q < num_valid; q++)
+    s->ptr[major[order_minor[q]]+1]++;
+  for (i = 0; i < num_major; i++) {
+    s->ptr[i+1] += s->ptr[i];
+    next[i] = s->ptr[i];
+  }
+  for (q = 0; q < num_valid; q++) {
+    k = order_minor[q];
+    order[next[major[k]]++] = k;
+  }
+
+  // Merge duplicates
+  ARRAY_alloc(s->ind,int,num_valid);
+  start = 0;
+  for (i = 0; i < num_major; i++) {
+    end = s->ptr[i+1];
+    s->ptr[i] = s->nnz;
+    for (q = start; q < end; q++) {
+      k = order[q];
+      if (s->nnz > s->ptr[i] && s->ind[s->nnz-1] == minor[k])
+	s->map[k] = s->nnz-1;
+      else {
+	s->ind[s->nnz] = minor[k];
+	s->map[k] = s->nnz;
+	s->nnz++;
+      }
+    }
+    start = end;
+  }
+  s->ptr[num_major] = s->nnz;
+  ARRAY_zalloc(s->data,REAL,s->nnz);
+
+  // Clean up
+  free(next);
+  free(order_minor);
+  free(order);
+
+  // Values
+  SPMAT_update(s,m);
+
+  return s;
+}
+
+Mat* SPMAT_new_mat_view(SpMat* s) {
+  /* This function returns a coordinate matrix with the stored entries
+     of s in storage order. Its values are a view of the values of s,
+     so they follow every SPMAT_update of s. */
+
+  // Local variables
+  Mat* m;
+  int* row;
+  int* col;
+  int num_major;
+  int i;
+  int q;
+
+  // No s
+  if (!s)
+    return NULL;
+
+  // Structure
+  m = MAT_new(s->size1,s->size2,s->nnz);
+  row = MAT_get_row_array(m);
+  col = MAT_get_col_array(m);
+  num_major = (s->format == SPMAT_CSC) ? s->size2 : s->size1;
+  for (i = 0; i < num_major; i++) {
+    for (q = s->ptr[i]; q < s->ptr[i+1]; q++) {
+      if (s->format == SPMAT_CSC) {
+	row[q] = s->ind[q];
+	col[q] = i;
+      }
+      else {
+	row[q] = i;
+	col[q] = s->ind[q];
+      }
+    }
+  }
+
+  // Values
+  if (s->nnz > 0) {
+    memcpy(MAT_get_data_array(m),s->data,s->nnz*sizeof(REAL));
+    MAT_set_data_view(m,s->data);
+  }
+
+  return m;
+}
+
+void SPMAT_update(SpMat* s, Mat* m) {
+
+  // Local variables
+  REAL* d;
+  int k;
+
+  // Check
+  if (!s || !m || MAT_get_nnz(m) != s->coo_nnz)
+    return;
+
+  // Scatter
+  d = MAT_get_data_array(m);
+  ARRAY_clear(s->data,REAL,s->nnz);
+  for (k = 0; k < s->coo_nnz; k++) {
+    if (s->map[k] >= 0)
+      s->data[s->map[k]] += d[k];
+  }
+}
+
+void SPMAT_show(SpMat* s) {
+  if (s) {
+    printf("\nCompressed Matrix\n");
+    printf("format : %s\n",s->format == SPMAT_CSC ? "csc" : "csr");
+    printf("size1  : %d\n",s->size1);
+    printf("size2  : %d\n",s->size2);
+    printf("nnz    : %d\n",s->nnz);
+  }
+}
@@ -14,6 +14,7 @@
 struct Vec {
   int size;
   REAL* data;
+  BOOL owns_data;
 };
 
 void VEC_add_to_entry(Vec* v, int index, REAL value) {
@@ -23,12 +24,20 @@ void VEC_add_to_entry(Vec* v, int index, REAL value) {
 
 void VEC_del(Vec* v) {
   if (v) {
-    if (v->data)
+    if (v->data && v->owns_data)
       free(v->data);
     free(v);
   }
 }
 
+void VEC_del_to_pool(Pool* pool, Vec* v) {
+  if (v) {
+    if (v->owns_data)
+      POOL_free(pool,v->data,v->size*sizeof(REAL));
+    free(v);
+  }
+}
+
 REAL VEC_get(Vec* v, int index) {
   if (v)
     return v->data[index];
@@ -82,6 +91,7 @@ Vec* VEC_new(int size) {
   Vec* v = (Vec*)malloc(sizeof(Vec));
   v->size = size;
   v->data = (REAL*)calloc(size,sizeof(REAL));
+  v->owns_data = TRUE;
   return v;
 }
 
@@ -89,9 +99,45 @@ Vec* VEC_new_from_array(REAL* data, int size) {
   Vec* v = (Vec*)malloc(sizeof(Vec));
   v->size = size;
   v->data = data;
+  v->owns_data = TRUE;
   return v;
 }
 
+Vec* VEC_new_from_pool(Pool* pool, int size) {
+  Vec* v = (Vec*)malloc(sizeof(Vec));
+  v->size = size;
+  v->data = (REAL*)POOL_alloc(pool,size*sizeof(REAL));
+  v->owns_data = TRUE;
+  return v;
+}
+
+void VEC_detach_view(Vec* v) {
+  REAL* data;
+  if (v && !v->owns_data) {
+    data = (REAL*)malloc(v->size*sizeof(REAL));
+    memcpy(data,v->data,v->size*sizeof(REAL));
+    v->data = data;
+    v->owns_data = TRUE;
+  }
+}
+
+BOOL VEC_is_view(Vec* v) {
+  if (v)
+    return !v->owns_data;
+  else
+    return FALSE;
+}
+
+void VEC_set_data_view(Vec* v, REAL* data) {
+  if (v && data && v->data != data) {
+    memcpy(data,v->data,v->size*sizeof(REAL));
+    if (v->owns_data)
+      free(v->data);
+    v->data = data;
+    v->owns_data = FALSE;
+  }
+}
+
 void VEC_set(Vec* v, int index, REAL value) {
   if (v)
     v->data[index] = value;
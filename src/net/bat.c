@@ -59,27 +59,71 @@ void* BAT_array_get(void* bat_array, int index) {
 }
 
 void BAT_array_del(Bat* bat_array, int size) {
-  int i;
-  Bat* bat;
   if (bat_array) {
-    for (i = 0; i < size; i++) {
-      bat = &(bat_array[i]);
-      free(bat->P);
-      free(bat->E);
-      free(bat->index_Pc);
-      free(bat->index_Pd);
-      free(bat->index_E);
-    }
+    if (size > 0)
+      free(bat_array->P); // per-period arrays
     free(bat_array);
   }  
 }
 
-Bat* BAT_array_new(int size, int num_periods) { 
+static size_t BAT_set_data(Bat* bat, int num_periods, char* data) {
+  /* Points the per-period arrays of the battery to consecutive regions
+     of data and returns their size in bytes. With data NULL, only the
+     size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(bat->P,REAL,num_periods,data,offset);
+  ARRAY_carve(bat->E,REAL,num_periods,data,offset);
+  ARRAY_carve(bat->index_Pc,int,num_periods,data,offset);
+  ARRAY_carve(bat->index_Pd,int,num_periods,data,offset);
+  ARRAY_carve(bat->index_E,int,num_periods,data,offset);
+  return offset;
+}
+
+static void BAT_init_data(Bat* bat, int num_periods, char* data) {
+  /* Initializes the battery using data for its per-period arrays. */
+
+  // Local vars
+  int T;
+  
+  T = num_periods;
+  bat->num_periods = num_periods;
+  
+  bat->bus = NULL;
+  
+  bat->fixed = 0x00;
+  bat->bounded = 0x00;
+  bat->sparse = 0x00;
+  bat->vars = 0x00;
+   
+  bat->P_max = 0;
+  bat->P_min = 0;
+  
+  bat->E_init = 0;
+  bat->E_final = 0;
+  bat->E_max = 0;
+  
+  bat->eta_c = 1.;
+  bat->eta_d = 1.;
+  
+  bat->index = 0;
+
+  BAT_set_data(bat,T,data);
+
+  bat->next = NULL;
+}
+
+Bat* BAT_array_new(int size, int num_periods) {
+  /* The per-period arrays of all the batteries are carved out of one block. */
   int i;
+  size_t num_bytes;
+  char* data = NULL;
   if (num_periods > 0) {
     Bat* bat_array = (Bat*)malloc(sizeof(Bat)*size);
+    num_bytes = BAT_set_data(bat_array,num_periods,NULL);
+    if (size > 0)
+      ARRAY_zalloc(data,char,size*num_bytes);
     for (i = 0; i < size; i++) {
-      BAT_init(&(bat_array[i]),num_periods);
+      BAT_init_data(&(bat_array[i]),num_periods,data+i*num_bytes);
       BAT_set_index(&(bat_array[i]),i);
     }
     return bat_array;
@@ -109,6 +153,58 @@ void BAT_clear_flags(Bat* bat, char flag_type) {
   }
 }
 
+void BAT_copy_from_bat(Bat* bat, Bat* other) {
+  /* This function copies the data of other to bat, that is, everything
+     except its connection to a bus, its index, and its list handle. The
+     batteries must have the same number of periods. */
+
+  // Check
+  if (!bat || !other || bat->num_periods != other->num_periods)
+    return;
+
+  // Charging power limits
+  bat->P_max = other->P_max;
+  bat->P_min = other->P_min;
+
+  // Efficiencies
+  bat->eta_c = other->eta_c;
+  bat->eta_d = other->eta_d;
+
+  // Energy levels
+  bat->E_init = other->E_init;
+  bat->E_final = other->E_final;
+  bat->E_max = other->E_max;
+
+  // State
+  BAT_copy_state_from_bat(bat,other);
+}
+
+void BAT_copy_state_from_bat(Bat* bat, Bat* other) {
+  /* This function copies the per-period data, flags and variable indices
+     of other to bat. The batteries must have the same number of periods. */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!bat || !other || bat->num_periods != other->num_periods)
+    return;
+  T = bat->num_periods;
+
+  // Flags
+  bat->fixed = other->fixed;
+  bat->bounded = other->bounded;
+  bat->vars = other->vars;
+  bat->sparse = other->sparse;
+
+  // Per-period data
+  memcpy(bat->P,other->P,T*sizeof(REAL));
+  memcpy(bat->E,other->E,T*sizeof(REAL));
+  memcpy(bat->index_Pc,other->index_Pc,T*sizeof(int));
+  memcpy(bat->index_Pd,other->index_Pd,T*sizeof(int));
+  memcpy(bat->index_E,other->index_E,T*sizeof(int));
+}
+
 int BAT_get_num_periods(Bat* bat) {
   if (bat)
     return bat->num_periods;
@@ -385,44 +481,17 @@ BOOL BAT_has_properties(void* vbat, char prop) {
   return TRUE;
 }
 
-void BAT_init(Bat* bat, int num_periods) { 
+void BAT_init(Bat* bat, int num_periods) {
 
   // Local vars
-  int T;
-  
+  char* data;
+
   // No gen
   if (!bat)
     return;
-  
-  T = num_periods;
-  bat->num_periods = num_periods;
-  
-  bat->bus = NULL;
-  
-  bat->fixed = 0x00;
-  bat->bounded = 0x00;
-  bat->sparse = 0x00;
-  bat->vars = 0x00;
-   
-  bat->P_max = 0;
-  bat->P_min = 0;
-  
-  bat->E_init = 0;
-  bat->E_final = 0;
-  bat->E_max = 0;
-  
-  bat->eta_c = 1.;
-  bat->eta_d = 1.;
-  
-  bat->index = 0;
 
-  ARRAY_zalloc(bat->P,REAL,T);
-  ARRAY_zalloc(bat->E,REAL,T);
-  ARRAY_zalloc(bat->index_Pc,int,T);
-  ARRAY_zalloc(bat->index_Pd,int,T);
-  ARRAY_zalloc(bat->index_E,int,T);
-  
-  bat->next = NULL;
+  ARRAY_zalloc(data,char,BAT_set_data(bat,num_periods,NULL));
+  BAT_init_data(bat,num_periods,data);
 }
 
 Bat* BAT_list_add(Bat* bat_list, Bat* bat) {
@@ -20,6 +20,7 @@ struct Branch {
 
   // Times
   int num_periods;   /**< @brief Number of time periods. */
+  int stride;        /**< @brief Distance between time periods in ratio, phase and index arrays */
 
   // Buses
   Bus* bus_k;        /**< @brief Bus connected to the "k" side */
@@ -89,30 +90,150 @@ void* BRANCH_array_get(void* br_array, int index) {
 }
 
 void BRANCH_array_del(Branch* br_array, int size) {
-  int i;
-  Branch* br;
   if (br_array) {
-    for (i = 0; i < size; i++) {
-      br = &(br_array[i]);
-      free(br->ratio);
-      free(br->phase);
-      free(br->index_ratio);
-      free(br->index_phase);
-      free(br->sens_P_u_bound);
-      free(br->sens_P_l_bound);
-    }
+    if (size > 0)
+      free(br_array->ratio); // per-period arrays
     free(br_array);
   }
 }
 
+static size_t BRANCH_set_data(Branch* br, int num_periods, char* data) {
+  /* Points the per-period arrays of the branch that are not shared with
+     the rest of the array to consecutive regions of data and returns
+     their size in bytes. With data NULL, only the size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(br->sens_P_u_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(br->sens_P_l_bound,REAL,num_periods,data,offset);
+  return offset;
+}
+
+static void BRANCH_init_data(Branch* br, int num_periods, REAL* ratio, REAL* phase, int* index_ratio, int* index_phase, int stride, char* data) {
+  /* This function initializes the branch using the given ratio, phase and
+     index arrays, where the data of time period t is at t*stride, and
+     using data for its other per-period arrays. */
+
+  // Local vars
+  int T;
+  int t;
+
+  T = num_periods;
+  br->num_periods = num_periods;
+  br->stride = stride;
+
+  br->type = BRANCH_TYPE_LINE;
+
+  br->bus_k = NULL;
+  br->bus_m = NULL;
+  br->reg_bus = NULL;
+
+  br->g = 0;
+  br->g_k = 0;
+  br->g_m = 0;
+  br->b = 0;
+  br->b_k = 0;
+  br->b_m = 0;
+
+  br->ratio_max = 1;
+  br->ratio_min = 1;
+  br->num_ratios = 1;
+
+  br->phase_max = 0;
+  br->phase_min = 0;
+
+  br->P_max = 0;
+  br->P_min = 0;
+  br->Q_max = 0;
+  br->Q_min = 0;
+
+  br->ratingA = 0;
+  br->ratingB = 0;
+  br->ratingC = 0;
+
+  br->outage = FALSE;
+  br->pos_ratio_v_sens = TRUE;
+  br->vars = 0x00;
+  br->fixed = 0x00;
+  br->bounded = 0x00;
+  br->sparse = 0x00;
+
+  br->index = 0;
+
+  br->ratio = ratio;
+  br->phase = phase;
+
+  br->index_ratio = index_ratio;
+  br->index_phase = index_phase;
+
+  BRANCH_set_data(br,T,data);
+
+  for (t = 0; t < br->num_periods; t++)
+    br->ratio[t*br->stride] = 1.;
+
+  br->reg_next = NULL;
+  br->next_k = NULL;
+  br->next_m = NULL;
+};
+
+static void BRANCH_array_init(Branch* br_array, int size, int num_periods) {
+  /* All the per-period arrays of the branches are carved out of one
+     block. The ratios, phase shifts and their indices come first and are
+     shared by the array, where the values of all the branches for a
+     given time period are contiguous, i.e., ratio[t*size+i]. */
+
+  // Local vars
+  int i;
+  size_t num_bytes;
+  size_t offset;
+  char* data = NULL;
+  REAL* ratio = NULL;
+  REAL* phase = NULL;
+  int* index_ratio = NULL;
+  int* index_phase = NULL;
+
+  // Sizes
+  num_bytes = BRANCH_set_data(br_array,num_periods,NULL);
+  offset = (2*ARRAY_size(REAL,size*num_periods)+
+            2*ARRAY_size(int,size*num_periods));
+
+  // Block
+  ARRAY_zalloc(data,char,offset+size*num_bytes);
+  offset = 0;
+  ARRAY_carve(ratio,REAL,size*num_periods,data,offset);
+  ARRAY_carve(phase,REAL,size*num_periods,data,offset);
+  ARRAY_carve(index_ratio,int,size*num_periods,data,offset);
+  ARRAY_carve(index_phase,int,size*num_periods,data,offset);
+
+  // Init
+  for (i = 0; i < size; i++)
+    BRANCH_init_data(&(br_array[i]),num_periods,ratio+i,phase+i,index_ratio+i,index_phase+i,size,data+offset+i*num_bytes);
+}
+
+BOOL BRANCH_is_equal(Branch* br, Branch* other) {
+  return br == other;
+}
+
+REAL* BRANCH_array_get_phase(Branch* br_array, int size, int t) {
+  if (br_array && size > 0 && t >= 0 && t < br_array->num_periods)
+    return br_array->phase+t*br_array->stride;
+  else
+    return NULL;
+}
+
+REAL* BRANCH_array_get_ratio(Branch* br_array, int size, int t) {
+  if (br_array && size > 0 && t >= 0 && t < br_array->num_periods)
+    return br_array->ratio+t*br_array->stride;
+  else
+    return NULL;
+}
+
 Branch* BRANCH_array_new(int size, int num_periods) {
   int i;
   if (num_periods > 0) {
     Branch* br_array = (Branch*)malloc(sizeof(Branch)*size);
-    for (i = 0; i < size; i++) {
-      BRANCH_init(&(br_array[i]),num_periods);
+    if (size > 0)
+      BRANCH_array_init(br_array,size,num_periods);
+    for (i = 0; i < size; i++)
       BRANCH_set_index(&(br_array[i]),i);
-    }
     return br_array;
   }
   else
@@ -150,6 +271,83 @@ void BRANCH_clear_sensitivities(Branch* br) {
   }
 }
 
+void BRANCH_copy_from_branch(Branch* br, Branch* other) {
+  /* This function copies the data of other to br, that is, everything
+     except its connections to buses, its index, and its list handles.
+     The branches must have the same number of periods. */
+
+  // Check
+  if (!br || !other || br->num_periods != other->num_periods)
+    return;
+
+  // Properties
+  br->type = other->type;
+
+  // Conductance and susceptance
+  br->g = other->g;
+  br->g_k = other->g_k;
+  br->g_m = other->g_m;
+  br->b = other->b;
+  br->b_k = other->b_k;
+  br->b_m = other->b_m;
+
+  // Tap ratio and phase shift limits
+  br->ratio_max = other->ratio_max;
+  br->ratio_min = other->ratio_min;
+  br->num_ratios = other->num_ratios;
+  br->phase_max = other->phase_max;
+  br->phase_min = other->phase_min;
+
+  // Flow bounds and ratings
+  br->P_max = other->P_max;
+  br->P_min = other->P_min;
+  br->Q_max = other->Q_max;
+  br->Q_min = other->Q_min;
+  br->ratingA = other->ratingA;
+  br->ratingB = other->ratingB;
+  br->ratingC = other->ratingC;
+
+  // Flags
+  br->pos_ratio_v_sens = other->pos_ratio_v_sens;
+
+  // State
+  BRANCH_copy_state_from_branch(br,other);
+}
+
+void BRANCH_copy_state_from_branch(Branch* br, Branch* other) {
+  /* This function copies the outage, per-period data, flags and variable
+     indices of other to br. The branches must have the same number of
+     periods. */
+
+  // Local variables
+  int T;
+  int t;
+
+  // Check
+  if (!br || !other || br->num_periods != other->num_periods)
+    return;
+  T = br->num_periods;
+
+  // Outage
+  br->outage = other->outage;
+
+  // Flags
+  br->vars = other->vars;
+  br->fixed = other->fixed;
+  br->bounded = other->bounded;
+  br->sparse = other->sparse;
+
+  // Per-period data
+  for (t = 0; t < T; t++) {
+    br->ratio[t*br->stride] = other->ratio[t*other->stride];
+    br->phase[t*br->stride] = other->phase[t*other->stride];
+    br->index_ratio[t*br->stride] = other->index_ratio[t*other->stride];
+    br->index_phase[t*br->stride] = other->index_phase[t*other->stride];
+  }
+  memcpy(br->sens_P_u_bound,other->sens_P_u_bound,T*sizeof(REAL));
+  memcpy(br->sens_P_l_bound,other->sens_P_l_bound,T*sizeof(REAL));
+}
+
 int BRANCH_get_num_periods(Branch* br) {
   if (br)
     return br->num_periods;
@@ -158,7 +356,9 @@ int BRANCH_get_num_periods(Branch* br) {
 }
 
 char BRANCH_get_type(Branch* br) {
-  if (br)
+  if (br && br->outage && br->type != BRANCH_TYPE_LINE)
+    return BRANCH_TYPE_TRAN_FIXED; // outaged transformers do not regulate
+  else if (br)
     return br->type;
   else
     return BRANCH_TYPE_LINE;
@@ -194,21 +394,21 @@ int BRANCH_get_index(Branch* br) {
 
 int BRANCH_get_index_ratio(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    return br->index_ratio[t];
+    return br->index_ratio[t*br->stride];
   else
     return 0;
 }
 
 int BRANCH_get_index_phase(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    return br->index_phase[t];
+    return br->index_phase[t*br->stride];
   else
     return 0;
 }
 
 REAL BRANCH_get_ratio(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    return br->ratio[t];
+    return br->ratio[t*br->stride];
   else
     return 0;
 }
@@ -291,29 +491,35 @@ Bus* BRANCH_get_reg_bus(Branch* br) {
 }
 
 Branch* BRANCH_get_reg_next(Branch* br) {
-  if (br)
-    return br->reg_next;
+  if (br) {
+    for (br = br->reg_next; br != NULL && br->outage; br = br->reg_next); // skip outages
+    return br;
+  }
   else
     return NULL;
 }
 
 Branch* BRANCH_get_next_k(Branch* br) {
-  if (br)
-    return br->next_k;
+  if (br) {
+    for (br = br->next_k; br != NULL && br->outage; br = br->next_k); // skip outages
+    return br;
+  }
   else
     return NULL;
 }
 
 Branch* BRANCH_get_next_m(Branch* br) {
-  if (br)
-    return br->next_m;
+  if (br) {
+    for (br = br->next_m; br != NULL && br->outage; br = br->next_m); // skip outages
+    return br;
+  }
   else
     return NULL;
 }
 
 REAL BRANCH_get_phase(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    return br->phase[t];
+    return br->phase[t*br->stride];
   else
     return 0;
 }
@@ -622,7 +828,7 @@ REAL BRANCH_get_P_km_DC(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods) {
     return -(br->b)*(BUS_get_v_ang(br->bus_k,t)-
 		     BUS_get_v_ang(br->bus_m,t)-
-		     br->phase[t]);
+		     br->phase[t*br->stride]);
   }
   else
     return 0;
@@ -637,7 +843,7 @@ REAL BRANCH_get_P_mk_DC(Branch* br, int t) {
   if (br && t >= 0 && t < br->num_periods) {
     return -(br->b)*(BUS_get_v_ang(br->bus_m,t)-
 		     BUS_get_v_ang(br->bus_k,t)+
-		     br->phase[t]);
+		     br->phase[t*br->stride]);
   }
   else
     return 0;
@@ -660,20 +866,20 @@ void BRANCH_get_var_values(Branch* br, Vec* values, int code) {
 	
       case UPPER_LIMITS:
 	if (br->bounded & BRANCH_VAR_RATIO)
-	  VEC_set(values,br->index_ratio[t],br->ratio_max);
+	  VEC_set(values,br->index_ratio[t*br->stride],br->ratio_max);
 	else
-	  VEC_set(values,br->index_ratio[t],BRANCH_INF_RATIO);
+	  VEC_set(values,br->index_ratio[t*br->stride],BRANCH_INF_RATIO);
 	break;
 
       case LOWER_LIMITS:
 	if (br->bounded & BRANCH_VAR_RATIO)
-	  VEC_set(values,br->index_ratio[t],br->ratio_min);
+	  VEC_set(values,br->index_ratio[t*br->stride],br->ratio_min);
 	else
-	  VEC_set(values,br->index_ratio[t],-BRANCH_INF_RATIO);
+	  VEC_set(values,br->index_ratio[t*br->stride],-BRANCH_INF_RATIO);
 	break;
 
       default:
-	VEC_set(values,br->index_ratio[t],br->ratio[t]);
+	VEC_set(values,br->index_ratio[t*br->stride],br->ratio[t*br->stride]);
       }
     }
     if (br->vars & BRANCH_VAR_PHASE) { // phase shift
@@ -681,20 +887,20 @@ void BRANCH_get_var_values(Branch* br, Vec* values, int code) {
 
       case UPPER_LIMITS:
 	if (br->bounded & BRANCH_VAR_PHASE)
-	  VEC_set(values,br->index_phase[t],br->phase_max);
+	  VEC_set(values,br->index_phase[t*br->stride],br->phase_max);
 	else
-	  VEC_set(values,br->index_phase[t],BRANCH_INF_PHASE);
+	  VEC_set(values,br->index_phase[t*br->stride],BRANCH_INF_PHASE);
 	break;
 
       case LOWER_LIMITS:
 	if (br->bounded & BRANCH_VAR_PHASE)
-	  VEC_set(values,br->index_phase[t],br->phase_min);
+	  VEC_set(values,br->index_phase[t*br->stride],br->phase_min);
 	else
-	  VEC_set(values,br->index_phase[t],-BRANCH_INF_PHASE);
+	  VEC_set(values,br->index_phase[t*br->stride],-BRANCH_INF_PHASE);
 	break;
 
       default:
-	VEC_set(values,br->index_phase[t],br->phase[t]);
+	VEC_set(values,br->index_phase[t*br->stride],br->phase[t*br->stride]);
       }
     }
   }
@@ -744,13 +950,13 @@ Vec* BRANCH_get_var_indices(void* vbr, unsigned char var, int t_start, int t_end
   indices = VEC_new(BRANCH_get_num_vars(vbr,var,t_start,t_end));
   if ((var & BRANCH_VAR_RATIO) && (br->vars & BRANCH_VAR_RATIO)) { // taps ratio
     for (t = t_start; t <= t_end; t++) {
-      VEC_set(indices,offset,br->index_ratio[t]);
+      VEC_set(indices,offset,br->index_ratio[t*br->stride]);
       offset++;
     }
   }
   if ((var & BRANCH_VAR_PHASE) && (br->vars & BRANCH_VAR_PHASE)) { // phase shift
     for (t = t_start; t <= t_end; t++) {
-      VEC_set(indices,offset,br->index_phase[t]);
+      VEC_set(indices,offset,br->index_phase[t*br->stride]);
       offset++;
     }
   }
@@ -800,74 +1006,11 @@ BOOL BRANCH_has_properties(void* vbr, char prop) {
 
 void BRANCH_init(Branch* br, int num_periods) {
 
-  // Local vars
-  int T;
-  int t;
-
   // No branch
   if (!br)
     return;
 
-  T = num_periods;
-  br->num_periods = num_periods;
-
-  br->type = BRANCH_TYPE_LINE;
-
-  br->bus_k = NULL;
-  br->bus_m = NULL;
-  br->reg_bus = NULL;
-
-  br->g = 0;
-  br->g_k = 0;
-  br->g_m = 0;
-  br->b = 0;
-  br->b_k = 0;
-  br->b_m = 0;
-
-  br->ratio_max = 1;
-  br->ratio_min = 1;
-  br->num_ratios = 1;
-
-  br->phase_max = 0;
-  br->phase_min = 0;
-
-  br->P_max = 0;
-  br->P_min = 0;
-  br->Q_max = 0;
-  br->Q_min = 0;
-
-  br->ratingA = 0;
-  br->ratingB = 0;
-  br->ratingC = 0;
-
-  br->outage = FALSE;
-  br->pos_ratio_v_sens = TRUE;
-  br->vars = 0x00;
-  br->fixed = 0x00;
-  br->bounded = 0x00;
-  br->sparse = 0x00;
-
-  br->index = 0;
-
-  ARRAY_zalloc(br->ratio,REAL,T);
-  ARRAY_zalloc(br->phase,REAL,T);
-
-  ARRAY_zalloc(br->index_ratio,int,T);
-  ARRAY_zalloc(br->index_phase,int,T);
-
-  ARRAY_zalloc(br->sens_P_u_bound,REAL,T);
-  ARRAY_zalloc(br->sens_P_l_bound,REAL,T);
-
-  for (t = 0; t < br->num_periods; t++)
-    br->ratio[t] = 1.;
-
-  br->reg_next = NULL;
-  br->next_k = NULL;
-  br->next_m = NULL;
-};
-
-BOOL BRANCH_is_equal(Branch* br, Branch* other) {
-  return br == other;
+  BRANCH_array_init(br,1,num_periods);
 }
 
 BOOL BRANCH_is_on_outage(Branch* br) {
@@ -879,7 +1022,7 @@ BOOL BRANCH_is_on_outage(Branch* br) {
 
 BOOL BRANCH_is_fixed_tran(Branch* br) {
   if (br)
-    return br->type == BRANCH_TYPE_TRAN_FIXED;
+    return BRANCH_get_type(br) == BRANCH_TYPE_TRAN_FIXED;
   else
     return FALSE;
 }
@@ -893,7 +1036,7 @@ BOOL BRANCH_is_line(Branch* br) {
 
 BOOL BRANCH_is_phase_shifter(Branch* br) {
   if (br)
-    return br->type == BRANCH_TYPE_TRAN_PHASE;
+    return BRANCH_get_type(br) == BRANCH_TYPE_TRAN_PHASE;
   else
     return FALSE;
 }
@@ -907,14 +1050,14 @@ BOOL BRANCH_is_tap_changer(Branch* br) {
 
 BOOL BRANCH_is_tap_changer_v(Branch* br) {
   if (br)
-    return (br->type == BRANCH_TYPE_TRAN_TAP_V);
+    return BRANCH_get_type(br) == BRANCH_TYPE_TRAN_TAP_V;
   else
     return FALSE;
 }
 
 BOOL BRANCH_is_tap_changer_Q(Branch* br) {
   if (br)
-    return (br->type == BRANCH_TYPE_TRAN_TAP_Q);
+    return BRANCH_get_type(br) == BRANCH_TYPE_TRAN_TAP_Q;
   else
     return FALSE;
 }
@@ -930,8 +1073,12 @@ Branch* BRANCH_list_reg_del(Branch* reg_br_list, Branch* reg_br) {
 }
 
 int BRANCH_list_reg_len(Branch* reg_br_list) {
-  int len;
-  LIST_len(Branch,reg_br_list,reg_next,len);
+  Branch* br;
+  int len = 0;
+  for (br = reg_br_list; br != NULL; br = br->reg_next) {
+    if (!br->outage)
+      len++;
+  }
   return len;
 }
 
@@ -946,8 +1093,12 @@ Branch* BRANCH_list_k_del(Branch* k_br_list, Branch* br) {
 }
 
 int BRANCH_list_k_len(Branch* k_br_list) {
-  int len;
-  LIST_len(Branch,k_br_list,next_k,len);
+  Branch* br;
+  int len = 0;
+  for (br = k_br_list; br != NULL; br = br->next_k) {
+    if (!br->outage)
+      len++;
+  }
   return len;
 }
 
@@ -962,8 +1113,12 @@ Branch* BRANCH_list_m_del(Branch* m_br_list, Branch* br) {
 }
 
 int BRANCH_list_m_len(Branch* m_br_list) {
-  int len;
-  LIST_len(Branch,m_br_list,next_m,len);
+  Branch* br;
+  int len = 0;
+  for (br = m_br_list; br != NULL; br = br->next_m) {
+    if (!br->outage)
+      len++;
+  }
   return len;
 }
 
@@ -1044,7 +1199,7 @@ void BRANCH_set_b_m(Branch* br, REAL b_m) {
 
 void BRANCH_set_ratio(Branch* br, REAL ratio, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    br->ratio[t] = ratio;
+    br->ratio[t*br->stride] = ratio;
 }
 
 void BRANCH_set_ratio_max(Branch* br, REAL ratio) {
@@ -1069,7 +1224,7 @@ void BRANCH_set_outage(Branch* br, BOOL outage) {
 
 void BRANCH_set_phase(Branch* br, REAL phase, int t) {
   if (br && t >= 0 && t < br->num_periods)
-    br->phase[t] = phase;
+    br->phase[t*br->stride] = phase;
 }
 
 void BRANCH_set_phase_max(Branch* br, REAL phase) {
@@ -1131,9 +1286,9 @@ void BRANCH_set_var_values(Branch* br, Vec* values) {
 
     // Ratio and phase
     if (br->vars & BRANCH_VAR_RATIO)    // taps ratio
-      br->ratio[t] = VEC_get(values,br->index_ratio[t]);
+      br->ratio[t*br->stride] = VEC_get(values,br->index_ratio[t*br->stride]);
     if (br->vars & BRANCH_VAR_PHASE)    // phase shift
-      br->phase[t] = VEC_get(values,br->index_phase[t]);
+      br->phase[t*br->stride] = VEC_get(values,br->index_phase[t*br->stride]);
   }
 }
 
@@ -1164,7 +1319,7 @@ int BRANCH_set_flags(void* vbr, char flag_type, unsigned char mask, int index) {
   if (!((*flags_ptr) & BRANCH_VAR_RATIO) && (mask & BRANCH_VAR_RATIO)) { // taps ratio
     if (flag_type == FLAG_VARS) {
       for (t = 0; t < br->num_periods; t++)
-	br->index_ratio[t] = index+t;
+	br->index_ratio[t*br->stride] = index+t;
     }
     (*flags_ptr) |= BRANCH_VAR_RATIO;
     index += br->num_periods;
@@ -1172,7 +1327,7 @@ int BRANCH_set_flags(void* vbr, char flag_type, unsigned char mask, int index) {
   if (!((*flags_ptr) & BRANCH_VAR_PHASE) && (mask & BRANCH_VAR_PHASE)) { // phase shift
     if (flag_type == FLAG_VARS) {
       for (t = 0; t < br->num_periods; t++)
-	br->index_phase[t] = index+t;
+	br->index_phase[t*br->stride] = index+t;
     }
     (*flags_ptr) |= BRANCH_VAR_PHASE;
     index += br->num_periods;
@@ -1191,8 +1346,8 @@ void BRANCH_propagate_data_in_time(Branch* br) {
   int t;
   if (br) {
     for (t = 1; t < br->num_periods; t++) {
-      br->ratio[t] = br->ratio[0];
-      br->phase[t] = br->phase[0];
+      br->ratio[t*br->stride] = br->ratio[0];
+      br->phase[t*br->stride] = br->phase[0];
     }
   }
 }
@@ -25,6 +25,7 @@ struct Bus {
 
   // Times
   int num_periods;   /**< @brief Number of time periods. */
+  int stride;        /**< @brief Distance between time periods in voltage and index arrays */
 
   // Voltage
   REAL* v_mag;        /**< @brief Voltage magnitude (p.u.) */
@@ -173,29 +174,9 @@ BOOL BUS_array_check(Bus* bus_array, int size, BOOL verbose) {
 }
 
 void BUS_array_del(Bus* bus_array, int size) {
-  int i;
-  Bus* bus;
   if (bus_array) {
-    for (i = 0; i < size; i++) {
-      bus = &(bus_array[i]);
-      free(bus->v_mag);
-      free(bus->v_ang);
-      free(bus->v_set);
-      free(bus->price);
-      free(bus->index_v_mag);
-      free(bus->index_v_ang);
-      free(bus->sens_P_balance);
-      free(bus->sens_Q_balance);
-      free(bus->sens_v_mag_u_bound);
-      free(bus->sens_v_mag_l_bound);
-      free(bus->sens_v_ang_u_bound);
-      free(bus->sens_v_ang_l_bound);
-      free(bus->sens_v_reg_by_gen);
-      free(bus->sens_v_reg_by_tran);
-      free(bus->sens_v_reg_by_shunt);
-      free(bus->P_mis);
-      free(bus->Q_mis);
-    }
+    if (size > 0)
+      free(bus_array->v_mag); // per-period arrays
     free(bus_array);
   }
 }
@@ -207,14 +188,143 @@ void* BUS_array_get(void* bus_array, int index) {
     return NULL;
 }
 
+static size_t BUS_set_data(Bus* bus, int num_periods, char* data) {
+  /* Points the per-period arrays of the bus that are not shared with
+     the rest of the array to consecutive regions of data and returns
+     their size in bytes. With data NULL, only the size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(bus->v_set,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->price,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_P_balance,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_Q_balance,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_mag_u_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_mag_l_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_ang_u_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_ang_l_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_reg_by_gen,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_reg_by_tran,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->sens_v_reg_by_shunt,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->P_mis,REAL,num_periods,data,offset);
+  ARRAY_carve(bus->Q_mis,REAL,num_periods,data,offset);
+  return offset;
+}
+
+static void BUS_init_data(Bus* bus, int num_periods, REAL* v_mag, REAL* v_ang, int* index_v_mag, int* index_v_ang, int stride, char* data) {
+  /* This function initializes the bus using the given voltage and voltage
+     index arrays, where the data of time period t is at t*stride, and
+     using data for its other per-period arrays. */
+
+  // Local vars
+  int i;
+  int T;
+  int t;
+
+  T = num_periods;
+  bus->num_periods = num_periods;
+  bus->stride = stride;
+
+  bus->number = 0;
+  for (i = 0; i < BUS_NAME_BUFFER_SIZE; i++)
+    bus->name[i] = 0;
+
+  bus->index = 0;
+
+  bus->v_max_reg = BUS_DEFAULT_V_MAX;
+  bus->v_min_reg = BUS_DEFAULT_V_MIN;
+  bus->v_max_norm = BUS_DEFAULT_V_MAX;
+  bus->v_min_norm = BUS_DEFAULT_V_MIN;
+  bus->v_max_emer = BUS_DEFAULT_V_MAX;
+  bus->v_min_emer = BUS_DEFAULT_V_MIN;
+
+  bus->slack = FALSE;
+  bus->fixed = 0x00;
+  bus->bounded = 0x00;
+  bus->sparse = 0x00;
+  bus->vars = 0x00;
+
+  bus->gen = NULL;
+  bus->reg_gen = NULL;
+  bus->reg_tran = NULL;
+  bus->reg_shunt = NULL;
+  bus->load = NULL;
+  bus->shunt = NULL;
+  bus->branch_k = NULL;
+  bus->branch_m = NULL;
+  bus->vargen = NULL;
+  bus->bat = NULL;
+
+  bus->v_mag = v_mag;
+  bus->v_ang = v_ang;
+
+  bus->index_v_mag = index_v_mag;
+  bus->index_v_ang = index_v_ang;
+
+  BUS_set_data(bus,T,data);
+
+  for (t = 0; t < bus->num_periods; t++) {
+    bus->v_mag[t*bus->stride] = 1.;
+    bus->v_set[t] = 1.;
+  }
+
+  bus->next = NULL;
+}
+
+static void BUS_array_init(Bus* bus_array, int size, int num_periods) {
+  /* All the per-period arrays of the buses are carved out of one block.
+     The voltages and voltage indices come first and are shared by the
+     array, where the values of all the buses for a given time period
+     are contiguous, i.e., v_mag[t*size+i]. */
+
+  // Local vars
+  int i;
+  size_t num_bytes;
+  size_t offset;
+  char* data = NULL;
+  REAL* v_mag = NULL;
+  REAL* v_ang = NULL;
+  int* index_v_mag = NULL;
+  int* index_v_ang = NULL;
+
+  // Sizes
+  num_bytes = BUS_set_data(bus_array,num_periods,NULL);
+  offset = (2*ARRAY_size(REAL,size*num_periods)+
+            2*ARRAY_size(int,size*num_periods));
+
+  // Block
+  ARRAY_zalloc(data,char,offset+size*num_bytes);
+  offset = 0;
+  ARRAY_carve(v_mag,REAL,size*num_periods,data,offset);
+  ARRAY_carve(v_ang,REAL,size*num_periods,data,offset);
+  ARRAY_carve(index_v_mag,int,size*num_periods,data,offset);
+  ARRAY_carve(index_v_ang,int,size*num_periods,data,offset);
+
+  // Init
+  for (i = 0; i < size; i++)
+    BUS_init_data(&(bus_array[i]),num_periods,v_mag+i,v_ang+i,index_v_mag+i,index_v_ang+i,size,data+offset+i*num_bytes);
+}
+
+REAL* BUS_array_get_v_ang(Bus* bus_array, int size, int t) {
+  if (bus_array && size > 0 && t >= 0 && t < bus_array->num_periods)
+    return bus_array->v_ang+t*bus_array->stride;
+  else
+    return NULL;
+}
+
+REAL* BUS_array_get_v_mag(Bus* bus_array, int size, int t) {
+  if (bus_array && size > 0 && t >= 0 && t < bus_array->num_periods)
+    return bus_array->v_mag+t*bus_array->stride;
+  else
+    return NULL;
+}
+
 Bus* BUS_array_new(int size, int num_periods) {
   int i;
   if (num_periods > 0) {
     Bus* bus_array = (Bus*)malloc(sizeof(Bus)*size);
-    for (i = 0; i < size; i++) {
-      BUS_init(&(bus_array[i]),num_periods);
+    if (size > 0)
+      BUS_array_init(bus_array,size,num_periods);
+    for (i = 0; i < size; i++)
       BUS_set_index(&(bus_array[i]),i);
-    }
     return bus_array;
   }
   else
@@ -343,6 +453,75 @@ void BUS_clear_bat(Bus* bus) {
     bus->bat = NULL;
 }
 
+void BUS_copy_from_bus(Bus* bus, Bus* other) {
+  /* This function copies the data of other to bus, that is, everything
+     except its connections to other components, its index, and its hash
+     and list handles. The buses must have the same number of periods. */
+
+  // Check
+  if (!bus || !other || bus->num_periods != other->num_periods)
+    return;
+
+  // Properties
+  bus->number = other->number;
+  memcpy(bus->name,other->name,BUS_NAME_BUFFER_SIZE*sizeof(char));
+
+  // Voltage limits
+  bus->v_max_reg = other->v_max_reg;
+  bus->v_min_reg = other->v_min_reg;
+  bus->v_max_norm = other->v_max_norm;
+  bus->v_min_norm = other->v_min_norm;
+  bus->v_max_emer = other->v_max_emer;
+  bus->v_min_emer = other->v_min_emer;
+
+  // Slack
+  bus->slack = other->slack;
+
+  // State
+  BUS_copy_state_from_bus(bus,other);
+}
+
+void BUS_copy_state_from_bus(Bus* bus, Bus* other) {
+  /* This function copies the per-period data, flags and variable indices
+     of other to bus. The buses must have the same number of periods. */
+
+  // Local variables
+  int T;
+  int t;
+
+  // Check
+  if (!bus || !other || bus->num_periods != other->num_periods)
+    return;
+  T = bus->num_periods;
+
+  // Flags
+  bus->fixed = other->fixed;
+  bus->bounded = other->bounded;
+  bus->sparse = other->sparse;
+  bus->vars = other->vars;
+
+  // Per-period data
+  for (t = 0; t < T; t++) {
+    bus->v_mag[t*bus->stride] = other->v_mag[t*other->stride];
+    bus->v_ang[t*bus->stride] = other->v_ang[t*other->stride];
+    bus->index_v_mag[t*bus->stride] = other->index_v_mag[t*other->stride];
+    bus->index_v_ang[t*bus->stride] = other->index_v_ang[t*other->stride];
+  }
+  memcpy(bus->v_set,other->v_set,T*sizeof(REAL));
+  memcpy(bus->price,other->price,T*sizeof(REAL));
+  memcpy(bus->sens_P_balance,other->sens_P_balance,T*sizeof(REAL));
+  memcpy(bus->sens_Q_balance,other->sens_Q_balance,T*sizeof(REAL));
+  memcpy(bus->sens_v_mag_u_bound,other->sens_v_mag_u_bound,T*sizeof(REAL));
+  memcpy(bus->sens_v_mag_l_bound,other->sens_v_mag_l_bound,T*sizeof(REAL));
+  memcpy(bus->sens_v_ang_u_bound,other->sens_v_ang_u_bound,T*sizeof(REAL));
+  memcpy(bus->sens_v_ang_l_bound,other->sens_v_ang_l_bound,T*sizeof(REAL));
+  memcpy(bus->sens_v_reg_by_gen,other->sens_v_reg_by_gen,T*sizeof(REAL));
+  memcpy(bus->sens_v_reg_by_tran,other->sens_v_reg_by_tran,T*sizeof(REAL));
+  memcpy(bus->sens_v_reg_by_shunt,other->sens_v_reg_by_shunt,T*sizeof(REAL));
+  memcpy(bus->P_mis,other->P_mis,T*sizeof(REAL));
+  memcpy(bus->Q_mis,other->Q_mis,T*sizeof(REAL));
+}
+
 char BUS_get_obj_type(void* bus) {
   if (bus)
     return OBJ_BUS;
@@ -373,14 +552,14 @@ int BUS_get_index(Bus* bus) {
 
 int BUS_get_index_v_mag(Bus* bus, int t) {
   if (bus && t >= 0 && t < bus->num_periods)
-    return bus->index_v_mag[t];
+    return bus->index_v_mag[t*bus->stride];
   else
     return 0;
 }
 
 int BUS_get_index_v_ang(Bus* bus, int t) {
   if (bus && t >= 0 && t < bus->num_periods)
-    return bus->index_v_ang[t];
+    return bus->index_v_ang[t*bus->stride];
   else
     return 0;
 }
@@ -484,7 +663,9 @@ int BUS_get_num_bats(Bus* bus) {
 }
 
 Gen* BUS_get_gen(Bus* bus) {
-  if (bus)
+  if (bus && GEN_is_on_outage(bus->gen))
+    return GEN_get_next(bus->gen); // skip outages
+  else if (bus)
     return bus->gen;
   else
     return NULL;
@@ -498,14 +679,18 @@ Load* BUS_get_load(Bus* bus) {
 }
 
 Gen* BUS_get_reg_gen(Bus* bus) {
-  if (bus)
+  if (bus && GEN_is_on_outage(bus->reg_gen))
+    return GEN_get_reg_next(bus->reg_gen); // skip outages
+  else if (bus)
     return bus->reg_gen;
   else
     return NULL;
 }
 
 Branch* BUS_get_reg_tran(Bus* bus) {
-  if (bus)
+  if (bus && BRANCH_is_on_outage(bus->reg_tran))
+    return BRANCH_get_reg_next(bus->reg_tran); // skip outages
+  else if (bus)
     return bus->reg_tran;
   else
     return NULL;
@@ -526,14 +711,18 @@ Shunt* BUS_get_reg_shunt(Bus* bus) {
 }
 
 Branch* BUS_get_branch_k(Bus* bus) {
-  if (bus)
+  if (bus && BRANCH_is_on_outage(bus->branch_k))
+    return BRANCH_get_next_k(bus->branch_k); // skip outages
+  else if (bus)
     return bus->branch_k;
   else
     return NULL;
 }
 
 Branch* BUS_get_branch_m(Bus* bus) {
-  if (bus)
+  if (bus && BRANCH_is_on_outage(bus->branch_m))
+    return BRANCH_get_next_m(bus->branch_m); // skip outages
+  else if (bus)
     return bus->branch_m;
   else
     return NULL;
@@ -572,7 +761,7 @@ REAL BUS_get_total_gen_P(Bus* bus, int t) {
   REAL P = 0;
   if (!bus || t < 0 || t >= bus->num_periods)
     return 0;
-  for (gen = bus->gen; gen != NULL; gen = GEN_get_next(gen))
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
     P += GEN_get_P(gen,t);
   return P;
 }
@@ -582,7 +771,7 @@ REAL BUS_get_total_gen_Q(Bus* bus, int t) {
   REAL Q = 0;
   if (!bus || t < 0 || t >= bus->num_periods)
     return 0;
-  for (gen = bus->gen; gen != NULL; gen = GEN_get_next(gen))
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
     Q += GEN_get_Q(gen,t);
   return Q;
 }
@@ -592,7 +781,7 @@ REAL BUS_get_total_gen_Q_max(Bus* bus) {
   REAL Qmax = 0;
   if (!bus)
     return 0;
-  for (gen = bus->gen; gen != NULL; gen = GEN_get_next(gen))
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
     Qmax += GEN_get_Q_max(gen);
   return Qmax;
 }
@@ -602,7 +791,7 @@ REAL BUS_get_total_gen_Q_min(Bus* bus) {
   REAL Qmin = 0;
   if (!bus)
     return 0;
-  for (gen = bus->gen; gen != NULL; gen = GEN_get_next(gen))
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
     Qmin += GEN_get_Q_min(gen);
   return Qmin;
 }
@@ -612,7 +801,7 @@ REAL BUS_get_total_reg_gen_Qmax(Bus* bus) {
   REAL Qmax = 0;
   if (!bus)
     return 0;
-  for (gen = bus->reg_gen; gen != NULL; gen = GEN_get_reg_next(gen))
+  for (gen = BUS_get_reg_gen(bus); gen != NULL; gen = GEN_get_reg_next(gen))
     Qmax += GEN_get_Q_max(gen);
   return Qmax;
 }
@@ -622,7 +811,7 @@ REAL BUS_get_total_reg_gen_Qmin(Bus* bus) {
   REAL Qmin = 0;
   if (!bus)
     return 0;
-  for (gen = bus->reg_gen; gen != NULL; gen = GEN_get_reg_next(gen))
+  for (gen = BUS_get_reg_gen(bus); gen != NULL; gen = GEN_get_reg_next(gen))
     Qmin += GEN_get_Q_min(gen);
   return Qmin;
 }
@@ -671,14 +860,14 @@ REAL BUS_get_v_mag(Bus* bus, int t) {
   if (!bus || t < 0 || t >= bus->num_periods)
     return 0;
   else
-    return bus->v_mag[t];
+    return bus->v_mag[t*bus->stride];
 }
 
 REAL BUS_get_v_ang(Bus* bus, int t) {
   if (!bus || t < 0 || t >= bus->num_periods)
     return 0;
   else
-    return bus->v_ang[t];
+    return bus->v_ang[t*bus->stride];
 }
 
 REAL BUS_get_v_set(Bus* bus, int t) {
@@ -747,20 +936,20 @@ void BUS_get_var_values(Bus* bus, Vec* values, int code) {
 
       case UPPER_LIMITS:
 	if (bus->bounded & BUS_VAR_VMAG)
-	  VEC_set(values,bus->index_v_mag[t],bus->v_max_norm);
+	  VEC_set(values,bus->index_v_mag[t*bus->stride],bus->v_max_norm);
 	else
-	  VEC_set(values,bus->index_v_mag[t],BUS_INF_V_MAG);
+	  VEC_set(values,bus->index_v_mag[t*bus->stride],BUS_INF_V_MAG);
 	break;
 
       case LOWER_LIMITS:
 	if (bus->bounded & BUS_VAR_VMAG)
-	  VEC_set(values,bus->index_v_mag[t],bus->v_min_norm);
+	  VEC_set(values,bus->index_v_mag[t*bus->stride],bus->v_min_norm);
 	else
-	  VEC_set(values,bus->index_v_mag[t],-BUS_INF_V_MAG);
+	  VEC_set(values,bus->index_v_mag[t*bus->stride],-BUS_INF_V_MAG);
 	break;
 
       default:
-	VEC_set(values,bus->index_v_mag[t],bus->v_mag[t]);
+	VEC_set(values,bus->index_v_mag[t*bus->stride],bus->v_mag[t*bus->stride]);
       }
     }
 
@@ -769,15 +958,15 @@ void BUS_get_var_values(Bus* bus, Vec* values, int code) {
       switch(code) {
 	
       case UPPER_LIMITS:
-	VEC_set(values,bus->index_v_ang[t],BUS_INF_V_ANG);
+	VEC_set(values,bus->index_v_ang[t*bus->stride],BUS_INF_V_ANG);
 	break;
 
       case LOWER_LIMITS:
-	VEC_set(values,bus->index_v_ang[t],-BUS_INF_V_ANG);
+	VEC_set(values,bus->index_v_ang[t*bus->stride],-BUS_INF_V_ANG);
 	break;
 
       default:
-	VEC_set(values,bus->index_v_ang[t],bus->v_ang[t]);
+	VEC_set(values,bus->index_v_ang[t*bus->stride],bus->v_ang[t*bus->stride]);
       }
     }
   }
@@ -827,13 +1016,13 @@ Vec* BUS_get_var_indices(void* vbus, unsigned char var, int t_start, int t_end)
   indices = VEC_new(BUS_get_num_vars(vbus,var,t_start,t_end));
   if ((var & BUS_VAR_VMAG) && (bus->vars & BUS_VAR_VMAG)) { // v mag
     for (t = t_start; t <= t_end; t++) {
-      VEC_set(indices,offset,bus->index_v_mag[t]);
+      VEC_set(indices,offset,bus->index_v_mag[t*bus->stride]);
       offset++;
     }
   }
   if ((var & BUS_VAR_VANG) && (bus->vars & BUS_VAR_VANG)) { // v ang
     for (t = t_start; t <= t_end; t++) {
-      VEC_set(indices,offset,bus->index_v_ang[t]);
+      VEC_set(indices,offset,bus->index_v_ang[t*bus->stride]);
       offset++;
     }
   }
@@ -1143,76 +1332,11 @@ int BUS_hash_name_len(Bus* bus_hash) {
 
 void BUS_init(Bus* bus, int num_periods) {
 
-  // Local vars
-  int i;
-  int T;
-  int t;
-
   // No bus
   if (!bus)
     return;
 
-  T = num_periods;
-  bus->num_periods = num_periods;
-
-  bus->number = 0;
-  for (i = 0; i < BUS_NAME_BUFFER_SIZE; i++)
-    bus->name[i] = 0;
-
-  bus->index = 0;
-
-  bus->v_max_reg = BUS_DEFAULT_V_MAX;
-  bus->v_min_reg = BUS_DEFAULT_V_MIN;
-  bus->v_max_norm = BUS_DEFAULT_V_MAX;
-  bus->v_min_norm = BUS_DEFAULT_V_MIN;
-  bus->v_max_emer = BUS_DEFAULT_V_MAX;
-  bus->v_min_emer = BUS_DEFAULT_V_MIN;
-
-  bus->slack = FALSE;
-  bus->fixed = 0x00;
-  bus->bounded = 0x00;
-  bus->sparse = 0x00;
-  bus->vars = 0x00;
-
-  bus->gen = NULL;
-  bus->reg_gen = NULL;
-  bus->reg_tran = NULL;
-  bus->reg_shunt = NULL;
-  bus->load = NULL;
-  bus->shunt = NULL;
-  bus->branch_k = NULL;
-  bus->branch_m = NULL;
-  bus->vargen = NULL;
-  bus->bat = NULL;
-
-  ARRAY_zalloc(bus->v_mag,REAL,T);
-  ARRAY_zalloc(bus->v_ang,REAL,T);
-  ARRAY_zalloc(bus->v_set,REAL,T);
-
-  ARRAY_zalloc(bus->price,REAL,T);
-
-  ARRAY_zalloc(bus->index_v_mag,int,T);
-  ARRAY_zalloc(bus->index_v_ang,int,T);
-
-  ARRAY_zalloc(bus->sens_P_balance,REAL,T);
-  ARRAY_zalloc(bus->sens_Q_balance,REAL,T);
-  ARRAY_zalloc(bus->sens_v_mag_u_bound,REAL,T);
-  ARRAY_zalloc(bus->sens_v_mag_l_bound,REAL,T);
-  ARRAY_zalloc(bus->sens_v_ang_u_bound,REAL,T);
-  ARRAY_zalloc(bus->sens_v_ang_l_bound,REAL,T);
-  ARRAY_zalloc(bus->sens_v_reg_by_gen,REAL,T);
-  ARRAY_zalloc(bus->sens_v_reg_by_tran,REAL,T);
-  ARRAY_zalloc(bus->sens_v_reg_by_shunt,REAL,T);
-
-  ARRAY_zalloc(bus->P_mis,REAL,T);
-  ARRAY_zalloc(bus->Q_mis,REAL,T);
-
-  for (t = 0; t < bus->num_periods; t++) {
-    bus->v_mag[t] = 1.;
-    bus->v_set[t] = 1.;
-  }
-
-  bus->next = NULL;
+  BUS_array_init(bus,1,num_periods);
 }
 
 void BUS_inject_P(Bus* bus, REAL P, int t) {
@@ -1229,16 +1353,31 @@ BOOL BUS_is_equal(Bus* bus, Bus* other) {
   return bus == other;
 }
 
+BOOL BUS_is_isolated(Bus* bus) {
+  Branch* br;
+  if (!bus)
+    return TRUE;
+  for (br = bus->branch_k; br != NULL; br = BRANCH_get_next_k(br)) {
+    if (!BRANCH_is_on_outage(br))
+      return FALSE;
+  }
+  for (br = bus->branch_m; br != NULL; br = BRANCH_get_next_m(br)) {
+    if (!BRANCH_is_on_outage(br))
+      return FALSE;
+  }
+  return TRUE;
+}
+
 BOOL BUS_is_regulated_by_gen(Bus* bus) {
   if (bus)
-    return GEN_is_regulator(bus->reg_gen);
+    return GEN_is_regulator(BUS_get_reg_gen(bus));
   else
     return FALSE;
 }
 
 BOOL BUS_is_regulated_by_tran(Bus* bus) {
   if (bus)
-    return BRANCH_is_tap_changer_v(bus->reg_tran);
+    return BRANCH_is_tap_changer_v(BUS_get_reg_tran(bus));
   else
     return FALSE;
 }
@@ -1329,12 +1468,12 @@ void BUS_set_price(Bus* bus, REAL price, int t) {
 
 void BUS_set_v_mag(Bus* bus, REAL v_mag, int t) {
   if (bus && t >= 0 && t < bus->num_periods)
-    bus->v_mag[t] = v_mag;
+    bus->v_mag[t*bus->stride] = v_mag;
 }
 
 void BUS_set_v_ang(Bus* bus, REAL v_ang, int t) {
   if (bus && t >= 0 && t < bus->num_periods)
-    bus->v_ang[t] = v_ang;
+    bus->v_ang[t*bus->stride] = v_ang;
 }
 
 void BUS_set_v_set(Bus* bus, REAL v_set, int t) {
@@ -1409,7 +1548,7 @@ int BUS_set_flags(void* vbus, char flag_type, unsigned char mask, int index) {
   if (!((*flags_ptr) & BUS_VAR_VMAG) && (mask & BUS_VAR_VMAG)) { // voltage magnitude
     if (flag_type == FLAG_VARS) {
       for (t = 0; t < bus->num_periods; t++)
-	bus->index_v_mag[t] = index+t;
+	bus->index_v_mag[t*bus->stride] = index+t;
     }
     (*flags_ptr) |= BUS_VAR_VMAG;
     index += bus->num_periods;
@@ -1417,7 +1556,7 @@ int BUS_set_flags(void* vbus, char flag_type, unsigned char mask, int index) {
   if (!((*flags_ptr) & BUS_VAR_VANG) && (mask & BUS_VAR_VANG)) { // voltage angle
     if (flag_type == FLAG_VARS) {
       for (t = 0; t < bus->num_periods; t++)
-	bus->index_v_ang[t] = index+t;
+	bus->index_v_ang[t*bus->stride] = index+t;
     }
     (*flags_ptr) |= BUS_VAR_VANG;
     index += bus->num_periods;
@@ -1439,9 +1578,9 @@ void BUS_set_var_values(Bus* bus, Vec* values) {
 
     // Voltage
     if (bus->vars & BUS_VAR_VMAG)      // voltage magnitude (p.u.)
-      bus->v_mag[t] = VEC_get(values,bus->index_v_mag[t]);
+      bus->v_mag[t*bus->stride] = VEC_get(values,bus->index_v_mag[t*bus->stride]);
     if (bus->vars & BUS_VAR_VANG)      // voltage angle (radians)
-      bus->v_ang[t] = VEC_get(values,bus->index_v_ang[t]);
+      bus->v_ang[t*bus->stride] = VEC_get(values,bus->index_v_ang[t*bus->stride]);
   }
 }
 
@@ -1505,8 +1644,8 @@ void BUS_propagate_data_in_time(Bus* bus) {
   int t;
   if (bus) {
     for (t = 1; t < bus->num_periods; t++) {
-      bus->v_mag[t] = bus->v_mag[0];
-      bus->v_ang[t] = bus->v_ang[0];
+      bus->v_mag[t*bus->stride] = bus->v_mag[0];
+      bus->v_ang[t*bus->stride] = bus->v_ang[0];
       bus->v_set[t] = bus->v_set[0];
     }
   }
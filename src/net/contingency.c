@@ -16,18 +16,12 @@
 // Gen outage
 struct Gen_outage {
   Gen* gen;
-  Bus* bus;
-  Bus* reg_bus;
   struct Gen_outage* next;
 };
 
 // Branch outage
 struct Branch_outage {
   Branch* br;
-  Bus* bus_k;
-  Bus* bus_m;
-  Bus* reg_bus;
-  char br_type;
   struct Branch_outage* next;
 };
 
@@ -48,6 +42,9 @@ struct Cont {
   Branch_outage* br_outage;           /**< @brief List of branch outages */
 };
 
+/* Outages are masks over the generator and branch arrays. The bus lists
+ * are left untouched and their iterators skip components on outage, so
+ * applying or clearing a contingency only costs one flag per outage. */
 
 void CONT_apply(Cont* cont) {
 
@@ -58,40 +55,12 @@ void CONT_apply(Cont* cont) {
   if (cont) {
 
     // Generators
-    for (go = cont->gen_outage; go != NULL; go = go->next) {
-
-      // Outage flag
+    for (go = cont->gen_outage; go != NULL; go = go->next)
       GEN_set_outage(go->gen,TRUE);
 
-      // Connection
-      GEN_set_bus(go->gen,NULL);    // disconnect bus from gen
-      BUS_del_gen(go->bus,go->gen); // disconnect gen from bus
-
-      // Regulation
-      GEN_set_reg_bus(go->gen,NULL);        // gen does not regulate reg_bus
-      BUS_del_reg_gen(go->reg_bus,go->gen); // reg_bus is not regulated by gen
-    }
-
     // Branches
-    for (bo = cont->br_outage; bo != NULL; bo = bo->next) {
-
-      // Outage flag
+    for (bo = cont->br_outage; bo != NULL; bo = bo->next)
       BRANCH_set_outage(bo->br,TRUE);
-
-      // Connection
-      BRANCH_set_bus_k(bo->br,NULL);            // disconnect bus_k from branch
-      BRANCH_set_bus_m(bo->br,NULL);           // disconnect bus_m from branch
-      BUS_del_branch_k(bo->bus_k,bo->br);       // disconnect branch from bus_k
-      BUS_del_branch_m(bo->bus_m,bo->br);     // disconnect branch from bus_m
-
-      // Regulation
-      BRANCH_set_reg_bus(bo->br,NULL);      // branch does not regulate reg_bus
-      BUS_del_reg_tran(bo->reg_bus,bo->br); // reg_bus is not regulated by branch
-
-      // Type
-      if (BRANCH_get_type(bo->br) != BRANCH_TYPE_LINE)
-	BRANCH_set_type(bo->br,BRANCH_TYPE_TRAN_FIXED);
-    }
   }
 }
 
@@ -104,39 +73,12 @@ void CONT_clear(Cont* cont) {
   if (cont) {
 
     // Generators
-    for (go = cont->gen_outage; go != NULL; go = go->next) {
-
-      // Outage flag
+    for (go = cont->gen_outage; go != NULL; go = go->next)
       GEN_set_outage(go->gen,FALSE);
 
-      // Connections
-      GEN_set_bus(go->gen,go->bus); // connect bus to gen
-      BUS_add_gen(go->bus,go->gen); // connect gen to bus
-
-      // Regulation
-      GEN_set_reg_bus(go->gen,go->reg_bus); // gen does regulates reg_bus
-      BUS_add_reg_gen(go->reg_bus,go->gen); // reg_bus is regulated by gen
-    }
-
     // Branches
-    for (bo = cont->br_outage; bo != NULL; bo = bo->next) {
-
-      // Outage flag
+    for (bo = cont->br_outage; bo != NULL; bo = bo->next)
       BRANCH_set_outage(bo->br,FALSE);
-
-      // Connection
-      BRANCH_set_bus_k(bo->br,bo->bus_k);     // connect bus_k from branch
-      BRANCH_set_bus_m(bo->br,bo->bus_m);     // connect bus_m from branch
-      BUS_add_branch_k(bo->bus_k,bo->br);     // connect branch from bus_k
-      BUS_add_branch_m(bo->bus_m,bo->br);     // connect branch from bus_m
-
-      // Regulation
-      BRANCH_set_reg_bus(bo->br,bo->reg_bus); // branch regulates reg_bus
-      BUS_add_reg_tran(bo->reg_bus,bo->br);   // reg_bus is regulated by branch
-
-      // Type
-      BRANCH_set_type(bo->br,bo->br_type);
-    }
   }
 }
 
@@ -156,6 +98,30 @@ void CONT_del(Cont* cont) {
   }
 }
 
+Branch* CONT_get_branch_outage(Cont* cont, int k) {
+  Branch_outage* bo;
+  int i = 0;
+  if (!cont)
+    return NULL;
+  for (bo = cont->br_outage; bo != NULL; bo = bo->next) {
+    if (i++ == k)
+      return bo->br;
+  }
+  return NULL;
+}
+
+Gen* CONT_get_gen_outage(Cont* cont, int k) {
+  Gen_outage* go;
+  int i = 0;
+  if (!cont)
+    return NULL;
+  for (go = cont->gen_outage; go != NULL; go = go->next) {
+    if (i++ == k)
+      return go->gen;
+  }
+  return NULL;
+}
+
 int CONT_get_num_gen_outages(Cont* cont) {
   int len;
   if (cont) {
@@ -185,8 +151,6 @@ void CONT_add_gen_outage(Cont* cont, Gen* gen) {
     }
     go = (Gen_outage*)malloc(sizeof(Gen_outage));
     go->gen = gen;
-    go->bus = GEN_get_bus(gen);
-    go->reg_bus = GEN_get_reg_bus(gen);
     go->next = NULL;
     LIST_add(Gen_outage,cont->gen_outage,go,next);
   }
@@ -201,10 +165,6 @@ void CONT_add_branch_outage(Cont* cont, Branch* br) {
     }
     bo = (Branch_outage*)malloc(sizeof(Branch_outage));
     bo->br = br;
-    bo->bus_k = BRANCH_get_bus_k(br);
-    bo->bus_m = BRANCH_get_bus_m(br);
-    bo->reg_bus = BRANCH_get_reg_bus(br);
-    bo->br_type = BRANCH_get_type(br);
     bo->next = NULL;
     LIST_add(Branch_outage,cont->br_outage,bo,next);
   }
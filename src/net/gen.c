@@ -67,28 +67,78 @@ void* GEN_array_get(void* gen_array, int index) {
 }
 
 void GEN_array_del(Gen* gen_array, int size) {
-  int i;
-  Gen* gen;
   if (gen_array) {
-    for (i = 0; i < size; i++) {
-      gen = &(gen_array[i]);
-      free(gen->P);
-      free(gen->Q);
-      free(gen->index_P);
-      free(gen->index_Q);
-      free(gen->sens_P_u_bound);
-      free(gen->sens_P_l_bound);
-    }
+    if (size > 0)
+      free(gen_array->P); // per-period arrays
     free(gen_array);
   }  
 }
 
+static size_t GEN_set_data(Gen* gen, int num_periods, char* data) {
+  /* Points the per-period arrays of the generator to consecutive regions
+     of data and returns their size in bytes. With data NULL, only the
+     size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(gen->P,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->Q,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->index_P,int,num_periods,data,offset);
+  ARRAY_carve(gen->index_Q,int,num_periods,data,offset);
+  ARRAY_carve(gen->sens_P_u_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->sens_P_l_bound,REAL,num_periods,data,offset);
+  return offset;
+}
+
+static void GEN_init_data(Gen* gen, int num_periods, char* data) {
+  /* Initializes the generator using data for its per-period arrays. */
+
+  // Local vars
+  int T;
+
+  T = num_periods;
+  gen->num_periods = num_periods;
+        
+  gen->bus = NULL;
+  gen->reg_bus = NULL;
+  
+  gen->outage = FALSE;
+  gen->fixed = 0x00;
+  gen->bounded = 0x00;
+  gen->sparse = 0x00;
+  gen->vars = 0x00;
+  
+  gen->dP_max = 0;
+  gen->P_max = 0;
+  gen->P_min = 0;
+  gen->P_prev = 0;
+    
+  gen->Q_max = 0;
+  gen->Q_min = 0;
+  
+  gen->cost_coeff_Q0 = 0;
+  gen->cost_coeff_Q1 = 2000.;
+  gen->cost_coeff_Q2 = 100.;
+  
+  gen->index = 0;
+
+  GEN_set_data(gen,T,data);
+
+  gen->next = NULL;
+  gen->reg_next = NULL;
+}
+
 Gen* GEN_array_new(int size, int num_periods) {
+  /* The per-period arrays of all the generators
+     are carved out of one block. */
   int i;
+  size_t num_bytes;
+  char* data = NULL;
   if (num_periods > 0) {
     Gen* gen_array = (Gen*)malloc(sizeof(Gen)*size);
+    num_bytes = GEN_set_data(gen_array,num_periods,NULL);
+    if (size > 0)
+      ARRAY_zalloc(data,char,size*num_bytes);
     for (i = 0; i < size; i++) {
-      GEN_init(&(gen_array[i]),num_periods);
+      GEN_init_data(&(gen_array[i]),num_periods,data+i*num_bytes);
       GEN_set_index(&(gen_array[i]),i);
     }
     return gen_array;
@@ -128,6 +178,65 @@ void GEN_clear_flags(Gen* gen, char flag_type) {
   }
 }
 
+void GEN_copy_from_gen(Gen* gen, Gen* other) {
+  /* This function copies the data of other to gen, that is, everything
+     except its connections to buses, its index, and its list handles.
+     The generators must have the same number of periods. */
+
+  // Check
+  if (!gen || !other || gen->num_periods != other->num_periods)
+    return;
+
+  // Active power
+  gen->P_max = other->P_max;
+  gen->P_min = other->P_min;
+  gen->dP_max = other->dP_max;
+  gen->P_prev = other->P_prev;
+
+  // Reactive power
+  gen->Q_max = other->Q_max;
+  gen->Q_min = other->Q_min;
+
+  // Cost
+  gen->cost_coeff_Q0 = other->cost_coeff_Q0;
+  gen->cost_coeff_Q1 = other->cost_coeff_Q1;
+  gen->cost_coeff_Q2 = other->cost_coeff_Q2;
+
+  // State
+  GEN_copy_state_from_gen(gen,other);
+}
+
+void GEN_copy_state_from_gen(Gen* gen, Gen* other) {
+  /* This function copies the outage, per-period data, flags and variable
+     indices of other to gen. The generators must have the same number of
+     periods. */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!gen || !other || gen->num_periods != other->num_periods)
+    return;
+  T = gen->num_periods;
+
+  // Outage
+  gen->outage = other->outage;
+
+  // Flags
+  gen->fixed = other->fixed;
+  gen->bounded = other->bounded;
+  gen->vars = other->vars;
+  gen->sparse = other->sparse;
+
+  // Per-period data
+  memcpy(gen->P,other->P,T*sizeof(REAL));
+  memcpy(gen->Q,other->Q,T*sizeof(REAL));
+  memcpy(gen->index_P,other->index_P,T*sizeof(int));
+  memcpy(gen->index_Q,other->index_Q,T*sizeof(int));
+  memcpy(gen->sens_P_u_bound,other->sens_P_u_bound,T*sizeof(REAL));
+  memcpy(gen->sens_P_l_bound,other->sens_P_l_bound,T*sizeof(REAL));
+}
+
 int GEN_get_num_periods(Gen* gen) {
   if (gen)
     return gen->num_periods;
@@ -229,15 +338,19 @@ int GEN_get_index_Q(Gen* gen, int t) {
 }
 
 Gen* GEN_get_next(Gen* gen) {
-  if (gen)
-    return gen->next;
+  if (gen) {
+    for (gen = gen->next; gen != NULL && gen->outage; gen = gen->next); // skip outages
+    return gen;
+  }
   else
     return NULL;
 }
 
 Gen* GEN_get_reg_next(Gen* gen) {
-  if (gen)
-    return gen->reg_next;
+  if (gen) {
+    for (gen = gen->reg_next; gen != NULL && gen->outage; gen = gen->reg_next); // skip outages
+    return gen;
+  }
   else
     return NULL;
 }
@@ -451,47 +564,14 @@ BOOL GEN_has_properties(void* vgen, char prop) {
 void GEN_init(Gen* gen, int num_periods) {
 
   // Local vars
-  int T;
+  char* data;
 
   // No gen
   if (!gen)
     return;
 
-  T = num_periods;
-  gen->num_periods = num_periods;
-        
-  gen->bus = NULL;
-  gen->reg_bus = NULL;
-  
-  gen->outage = FALSE;
-  gen->fixed = 0x00;
-  gen->bounded = 0x00;
-  gen->sparse = 0x00;
-  gen->vars = 0x00;
-  
-  gen->dP_max = 0;
-  gen->P_max = 0;
-  gen->P_min = 0;
-  gen->P_prev = 0;
-    
-  gen->Q_max = 0;
-  gen->Q_min = 0;
-  
-  gen->cost_coeff_Q0 = 0;
-  gen->cost_coeff_Q1 = 2000.;
-  gen->cost_coeff_Q2 = 100.;
-  
-  gen->index = 0;
-
-  ARRAY_zalloc(gen->P,REAL,T);
-  ARRAY_zalloc(gen->Q,REAL,T);
-  ARRAY_zalloc(gen->index_P,int,T);
-  ARRAY_zalloc(gen->index_Q,int,T);
-  ARRAY_zalloc(gen->sens_P_u_bound,REAL,T);
-  ARRAY_zalloc(gen->sens_P_l_bound,REAL,T);
-  
-  gen->next = NULL;
-  gen->reg_next = NULL;
+  ARRAY_zalloc(data,char,GEN_set_data(gen,num_periods,NULL));
+  GEN_init_data(gen,num_periods,data);
 }
 
 BOOL GEN_is_equal(Gen* gen, Gen* other) {
@@ -514,14 +594,14 @@ BOOL GEN_is_P_adjustable(Gen* gen) {
 
 BOOL GEN_is_regulator(Gen* gen) {
   if (gen)
-    return gen->reg_bus != NULL;
+    return gen->reg_bus != NULL && !gen->outage;
   else
     return FALSE;
 }
 
 BOOL GEN_is_slack(Gen* gen) {
   if (gen)
-    return BUS_is_slack(gen->bus);
+    return BUS_is_slack(gen->bus) && !gen->outage;
   else
     return FALSE;
 }
@@ -537,8 +617,12 @@ Gen* GEN_list_del(Gen* gen_list, Gen* gen) {
 }
 
 int GEN_list_len(Gen* gen_list) {
-  int len;
-  LIST_len(Gen,gen_list,next,len);
+  Gen* gen;
+  int len = 0;
+  for (gen = gen_list; gen != NULL; gen = gen->next) {
+    if (!gen->outage)
+      len++;
+  }
   return len;
 }
 
@@ -553,8 +637,12 @@ Gen* GEN_list_reg_del(Gen* reg_gen_list, Gen* reg_gen) {
 }
 
 int GEN_list_reg_len(Gen* reg_gen_list) {
-  int len;
-  LIST_len(Gen,reg_gen_list,reg_next,len);
+  Gen* gen;
+  int len = 0;
+  for (gen = reg_gen_list; gen != NULL; gen = gen->reg_next) {
+    if (!gen->outage)
+      len++;
+  }
   return len;
 }
 
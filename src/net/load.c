@@ -63,30 +63,70 @@ void* LOAD_array_get(void* load_array, int index) {
 }
 
 void LOAD_array_del(Load* load_array, int size) {
-  int i;
-  Load* load;
   if (load_array) {
-    for (i = 0; i < size; i++) {
-      load = &(load_array[i]);
-      free(load->P);
-      free(load->P_max);
-      free(load->P_min);
-      free(load->Q);
-      free(load->index_P);
-      free(load->index_Q);
-      free(load->sens_P_u_bound);
-      free(load->sens_P_l_bound);
-    }
+    if (size > 0)
+      free(load_array->P); // per-period arrays
     free(load_array);
   }  
 }
 
-Load* LOAD_array_new(int size, int num_periods) { 
+static size_t LOAD_set_data(Load* load, int num_periods, char* data) {
+  /* Points the per-period arrays of the load to consecutive regions
+     of data and returns their size in bytes. With data NULL, only the
+     size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(load->P,REAL,num_periods,data,offset);
+  ARRAY_carve(load->P_max,REAL,num_periods,data,offset);
+  ARRAY_carve(load->P_min,REAL,num_periods,data,offset);
+  ARRAY_carve(load->Q,REAL,num_periods,data,offset);
+  ARRAY_carve(load->index_P,int,num_periods,data,offset);
+  ARRAY_carve(load->index_Q,int,num_periods,data,offset);
+  ARRAY_carve(load->sens_P_u_bound,REAL,num_periods,data,offset);
+  ARRAY_carve(load->sens_P_l_bound,REAL,num_periods,data,offset);
+  return offset;
+}
+
+static void LOAD_init_data(Load* load, int num_periods, char* data) {
+  /* Initializes the load using data for its per-period arrays. */
+
+  // Local vars
+  int T;
+
+  T = num_periods;
+  load->num_periods = num_periods;
+    
+  load->bus = NULL;
+  
+  load->fixed = 0x00;
+  load->bounded = 0x00;
+  load->sparse = 0x00;
+  load->vars = 0x00;
+    
+  load->util_coeff_Q0 = 0;
+  load->util_coeff_Q1 = 20000.;
+  load->util_coeff_Q2 = -100.;
+  
+  load->index = 0;
+
+  LOAD_set_data(load,T,data);
+
+  load->target_power_factor = 1.;
+  
+  load->next = NULL;
+}
+
+Load* LOAD_array_new(int size, int num_periods) {
+  /* The per-period arrays of all the loads are carved out of one block. */
   int i;
+  size_t num_bytes;
+  char* data = NULL;
   if (num_periods > 0) {
     Load* load_array = (Load*)malloc(sizeof(Load)*size);
+    num_bytes = LOAD_set_data(load_array,num_periods,NULL);
+    if (size > 0)
+      ARRAY_zalloc(data,char,size*num_bytes);
     for (i = 0; i < size; i++) {
-      LOAD_init(&(load_array[i]),num_periods);
+      LOAD_init_data(&(load_array[i]),num_periods,data+i*num_bytes);
       LOAD_set_index(&(load_array[i]),i);
     }
     return load_array;
@@ -126,6 +166,56 @@ void LOAD_clear_flags(Load* load, char flag_type) {
   }
 }
 
+void LOAD_copy_from_load(Load* load, Load* other) {
+  /* This function copies the data of other to load, that is, everything
+     except its connection to a bus, its index, and its list handle. The
+     loads must have the same number of periods. */
+
+  // Check
+  if (!load || !other || load->num_periods != other->num_periods)
+    return;
+
+  // Power factor
+  load->target_power_factor = other->target_power_factor;
+
+  // Utility
+  load->util_coeff_Q0 = other->util_coeff_Q0;
+  load->util_coeff_Q1 = other->util_coeff_Q1;
+  load->util_coeff_Q2 = other->util_coeff_Q2;
+
+  // State
+  LOAD_copy_state_from_load(load,other);
+}
+
+void LOAD_copy_state_from_load(Load* load, Load* other) {
+  /* This function copies the per-period data, flags and variable indices
+     of other to load. The loads must have the same number of periods. */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!load || !other || load->num_periods != other->num_periods)
+    return;
+  T = load->num_periods;
+
+  // Flags
+  load->fixed = other->fixed;
+  load->bounded = other->bounded;
+  load->vars = other->vars;
+  load->sparse = other->sparse;
+
+  // Per-period data
+  memcpy(load->P,other->P,T*sizeof(REAL));
+  memcpy(load->P_max,other->P_max,T*sizeof(REAL));
+  memcpy(load->P_min,other->P_min,T*sizeof(REAL));
+  memcpy(load->Q,other->Q,T*sizeof(REAL));
+  memcpy(load->index_P,other->index_P,T*sizeof(int));
+  memcpy(load->index_Q,other->index_Q,T*sizeof(int));
+  memcpy(load->sens_P_u_bound,other->sens_P_u_bound,T*sizeof(REAL));
+  memcpy(load->sens_P_l_bound,other->sens_P_l_bound,T*sizeof(REAL));
+}
+
 int LOAD_get_num_periods(Load* load) {
   if (load)
     return load->num_periods;
@@ -412,40 +502,14 @@ BOOL LOAD_has_properties(void* vload, char prop) {
 void LOAD_init(Load* load, int num_periods) {
 
   // Local vars
-  int T;
+  char* data;
 
   // No load
   if (!load)
     return;
 
-  T = num_periods;
-  load->num_periods = num_periods;
-    
-  load->bus = NULL;
-  
-  load->fixed = 0x00;
-  load->bounded = 0x00;
-  load->sparse = 0x00;
-  load->vars = 0x00;
-    
-  load->util_coeff_Q0 = 0;
-  load->util_coeff_Q1 = 20000.;
-  load->util_coeff_Q2 = -100.;
-  
-  load->index = 0;
-
-  ARRAY_zalloc(load->P,REAL,T);
-  ARRAY_zalloc(load->P_max,REAL,T);
-  ARRAY_zalloc(load->P_min,REAL,T);
-  ARRAY_zalloc(load->Q,REAL,T);
-  ARRAY_zalloc(load->index_P,int,T);
-  ARRAY_zalloc(load->index_Q,int,T);
-  ARRAY_zalloc(load->sens_P_u_bound,REAL,T);
-  ARRAY_zalloc(load->sens_P_l_bound,REAL,T);
-
-  load->target_power_factor = 1.;
-  
-  load->next = NULL;
+  ARRAY_zalloc(data,char,LOAD_set_data(load,num_periods,NULL));
+  LOAD_init_data(load,num_periods,data);
 }
 
 BOOL LOAD_is_P_adjustable(Load* load) {
@@ -85,6 +85,9 @@ struct Net {
 
   // Utils
   char* bus_counted;  /**< @brief Flags for processing buses */
+
+  // Structure
+  int struc_version;  /**< @brief Counter of changes of flags, components and connections */
 };
 
 void NET_add_vargens(Net* net, Bus* bus_list, REAL power_capacity, REAL power_base, REAL power_std, REAL corr_radius, REAL corr_value) {
@@ -385,6 +388,9 @@ BOOL NET_check(Net* net, BOOL verbose) {
 
 void NET_clear_data(Net* net) {
 
+  // Local variables
+  int version;
+
   // No net
   if (!net)
     return;
@@ -426,7 +432,9 @@ void NET_clear_data(Net* net) {
   free(net->bus_counted);
 
   // Re-initialize
+  version = net->struc_version;
   NET_init(net,net->num_periods);
+  net->struc_version = version+1;
 }
 
 void NET_clear_error(Net* net) {
@@ -518,6 +526,9 @@ void NET_clear_flags(Net* net) {
   net->num_fixed = 0;
   net->num_bounded = 0;
   net->num_sparse = 0;
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_clear_outages(Net* net) {
@@ -536,6 +547,9 @@ void NET_clear_outages(Net* net) {
   // Branches
   for (i = 0; i < net->num_branches; i++)
     BRANCH_set_outage(NET_get_branch(net,i),FALSE);
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_clear_properties(Net* net) {
@@ -623,6 +637,218 @@ void NET_clear_sensitivities(Net* net) {
   // Batteries
 }
 
+static void NET_copy_properties(Net* net, Net* other) {
+  /* This function copies the properties of other to net. The networks
+     must have the same number of periods. */
+
+  // Local variables
+  int T;
+
+  T = net->num_periods;
+  memcpy(net->bus_v_max,other->bus_v_max,T*sizeof(REAL));
+  memcpy(net->bus_v_min,other->bus_v_min,T*sizeof(REAL));
+  memcpy(net->bus_v_vio,other->bus_v_vio,T*sizeof(REAL));
+  memcpy(net->bus_P_mis,other->bus_P_mis,T*sizeof(REAL));
+  memcpy(net->bus_Q_mis,other->bus_Q_mis,T*sizeof(REAL));
+  memcpy(net->gen_P_cost,other->gen_P_cost,T*sizeof(REAL));
+  memcpy(net->gen_v_dev,other->gen_v_dev,T*sizeof(REAL));
+  memcpy(net->gen_Q_vio,other->gen_Q_vio,T*sizeof(REAL));
+  memcpy(net->gen_P_vio,other->gen_P_vio,T*sizeof(REAL));
+  memcpy(net->tran_v_vio,other->tran_v_vio,T*sizeof(REAL));
+  memcpy(net->tran_r_vio,other->tran_r_vio,T*sizeof(REAL));
+  memcpy(net->tran_p_vio,other->tran_p_vio,T*sizeof(REAL));
+  memcpy(net->shunt_v_vio,other->shunt_v_vio,T*sizeof(REAL));
+  memcpy(net->shunt_b_vio,other->shunt_b_vio,T*sizeof(REAL));
+  memcpy(net->load_P_util,other->load_P_util,T*sizeof(REAL));
+  memcpy(net->load_P_vio,other->load_P_vio,T*sizeof(REAL));
+  memcpy(net->num_actions,other->num_actions,T*sizeof(int));
+}
+
+static Bus* NET_copy_get_bus(Net* copy, Bus* bus) {
+  /* This function returns the bus of the copy with the index of bus. */
+  if (bus)
+    return NET_get_bus(copy,BUS_get_index(bus));
+  else
+    return NULL;
+}
+
+Net* NET_copy(Net* net) {
+  /* This function returns a deep copy of the network. The components are
+     allocated in one array per type and their data is copied, and the
+     connections of the copy, i.e., component lists of buses, buses of
+     components and hash tables, mirror those of the network by index.
+     Generator and branch lists are rebuilt in index order since bus
+     lists only expose components that are not on outage. Outages
+     applied by contingencies are also present in the copy, but the
+     contingencies refer to the components of the network. */
+
+  // Local variables
+  Net* copy;
+  Bus* bus;
+  Bus* bus_copy;
+  Branch* br;
+  Gen* gen;
+  Load* load;
+  Shunt* shunt;
+  Vargen* vargen;
+  Bat* bat;
+  int i;
+
+  // No net
+  if (!net)
+    return NULL;
+
+  // Net
+  copy = NET_new(net->num_periods);
+  copy->base_power = net->base_power;
+  copy->vargen_corr_radius = net->vargen_corr_radius;
+  copy->vargen_corr_value = net->vargen_corr_value;
+  copy->num_vars = net->num_vars;
+  copy->num_fixed = net->num_fixed;
+  copy->num_bounded = net->num_bounded;
+  copy->num_sparse = net->num_sparse;
+  NET_copy_properties(copy,net);
+
+  // Components
+  NET_set_bus_array(copy,BUS_array_new(net->num_buses,net->num_periods),net->num_buses);
+  NET_set_branch_array(copy,BRANCH_array_new(net->num_branches,net->num_periods),net->num_branches);
+  NET_set_gen_array(copy,GEN_array_new(net->num_gens,net->num_periods),net->num_gens);
+  NET_set_load_array(copy,LOAD_array_new(net->num_loads,net->num_periods),net->num_loads);
+  NET_set_shunt_array(copy,SHUNT_array_new(net->num_shunts,net->num_periods),net->num_shunts);
+  NET_set_vargen_array(copy,VARGEN_array_new(net->num_vargens,net->num_periods),net->num_vargens);
+  NET_set_bat_array(copy,BAT_array_new(net->num_bats,net->num_periods),net->num_bats);
+
+  // Buses
+  for (i = 0; i < net->num_buses; i++) {
+    bus = NET_get_bus(net,i);
+    bus_copy = NET_get_bus(copy,i);
+    BUS_copy_from_bus(bus_copy,bus);
+    for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load))
+      BUS_add_load(bus_copy,NET_get_load(copy,LOAD_get_index(load)));
+    for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt))
+      BUS_add_shunt(bus_copy,NET_get_shunt(copy,SHUNT_get_index(shunt)));
+    for (shunt = BUS_get_reg_shunt(bus); shunt != NULL; shunt = SHUNT_get_reg_next(shunt))
+      BUS_add_reg_shunt(bus_copy,NET_get_shunt(copy,SHUNT_get_index(shunt)));
+    for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen))
+      BUS_add_vargen(bus_copy,NET_get_vargen(copy,VARGEN_get_index(vargen)));
+    for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat))
+      BUS_add_bat(bus_copy,NET_get_bat(copy,BAT_get_index(bat)));
+    if (NET_bus_hash_number_find(net,BUS_get_number(bus)) == bus)
+      NET_bus_hash_number_add(copy,bus_copy);
+    if (NET_bus_hash_name_find(net,BUS_get_name(bus)) == bus)
+      NET_bus_hash_name_add(copy,bus_copy);
+  }
+
+  // Branches
+  for (i = 0; i < net->num_branches; i++) {
+    br = NET_get_branch(net,i);
+    BRANCH_copy_from_branch(NET_get_branch(copy,i),br);
+    BRANCH_set_bus_k(NET_get_branch(copy,i),NET_copy_get_bus(copy,BRANCH_get_bus_k(br)));
+    BRANCH_set_bus_m(NET_get_branch(copy,i),NET_copy_get_bus(copy,BRANCH_get_bus_m(br)));
+    BRANCH_set_reg_bus(NET_get_branch(copy,i),NET_copy_get_bus(copy,BRANCH_get_reg_bus(br)));
+    BUS_add_branch_k(BRANCH_get_bus_k(NET_get_branch(copy,i)),NET_get_branch(copy,i));
+    BUS_add_branch_m(BRANCH_get_bus_m(NET_get_branch(copy,i)),NET_get_branch(copy,i));
+    BUS_add_reg_tran(BRANCH_get_reg_bus(NET_get_branch(copy,i)),NET_get_branch(copy,i));
+  }
+
+  // Generators
+  for (i = 0; i < net->num_gens; i++) {
+    gen = NET_get_gen(net,i);
+    GEN_copy_from_gen(NET_get_gen(copy,i),gen);
+    GEN_set_bus(NET_get_gen(copy,i),NET_copy_get_bus(copy,GEN_get_bus(gen)));
+    GEN_set_reg_bus(NET_get_gen(copy,i),NET_copy_get_bus(copy,GEN_get_reg_bus(gen)));
+    BUS_add_gen(GEN_get_bus(NET_get_gen(copy,i)),NET_get_gen(copy,i));
+    BUS_add_reg_gen(GEN_get_reg_bus(NET_get_gen(copy,i)),NET_get_gen(copy,i));
+  }
+
+  // Loads
+  for (i = 0; i < net->num_loads; i++) {
+    load = NET_get_load(net,i);
+    LOAD_copy_from_load(NET_get_load(copy,i),load);
+    LOAD_set_bus(NET_get_load(copy,i),NET_copy_get_bus(copy,LOAD_get_bus(load)));
+  }
+
+  // Shunts
+  for (i = 0; i < net->num_shunts; i++) {
+    shunt = NET_get_shunt(net,i);
+    SHUNT_copy_from_shunt(NET_get_shunt(copy,i),shunt);
+    SHUNT_set_bus(NET_get_shunt(copy,i),NET_copy_get_bus(copy,SHUNT_get_bus(shunt)));
+    SHUNT_set_reg_bus(NET_get_shunt(copy,i),NET_copy_get_bus(copy,SHUNT_get_reg_bus(shunt)));
+  }
+
+  // Variable generators
+  for (i = 0; i < net->num_vargens; i++) {
+    vargen = NET_get_vargen(net,i);
+    VARGEN_copy_from_vargen(NET_get_vargen(copy,i),vargen);
+    VARGEN_set_bus(NET_get_vargen(copy,i),NET_copy_get_bus(copy,VARGEN_get_bus(vargen)));
+    if (NET_vargen_hash_name_find(net,VARGEN_get_name(vargen)) == vargen)
+      NET_vargen_hash_name_add(copy,NET_get_vargen(copy,i));
+  }
+
+  // Batteries
+  for (i = 0; i < net->num_bats; i++) {
+    bat = NET_get_bat(net,i);
+    BAT_copy_from_bat(NET_get_bat(copy,i),bat);
+    BAT_set_bus(NET_get_bat(copy,i),NET_copy_get_bus(copy,BAT_get_bus(bat)));
+  }
+
+  return copy;
+}
+
+void NET_copy_state(Net* net, Net* other) {
+  /* This function copies the outages, per-period data, flags and
+     variable indices of the components of other to those of net,
+     together with the numbers of flagged quantities and the properties.
+     The networks must be equivalent, e.g. one a copy of the other, and
+     the remaining data and the connections of net are kept. This is much
+     cheaper than a new copy for synchronizing the state of copies. */
+
+  // Local variables
+  int i;
+
+  // Check
+  if (!net || !other)
+    return;
+  if (net->num_periods != other->num_periods ||
+      net->num_buses != other->num_buses ||
+      net->num_branches != other->num_branches ||
+      net->num_gens != other->num_gens ||
+      net->num_loads != other->num_loads ||
+      net->num_shunts != other->num_shunts ||
+      net->num_vargens != other->num_vargens ||
+      net->num_bats != other->num_bats) {
+    sprintf(net->error_string,"networks are not equivalent");
+    net->error_flag = TRUE;
+    return;
+  }
+
+  // Components
+  for (i = 0; i < net->num_buses; i++)
+    BUS_copy_state_from_bus(NET_get_bus(net,i),NET_get_bus(other,i));
+  for (i = 0; i < net->num_branches; i++)
+    BRANCH_copy_state_from_branch(NET_get_branch(net,i),NET_get_branch(other,i));
+  for (i = 0; i < net->num_gens; i++)
+    GEN_copy_state_from_gen(NET_get_gen(net,i),NET_get_gen(other,i));
+  for (i = 0; i < net->num_loads; i++)
+    LOAD_copy_state_from_load(NET_get_load(net,i),NET_get_load(other,i));
+  for (i = 0; i < net->num_shunts; i++)
+    SHUNT_copy_state_from_shunt(NET_get_shunt(net,i),NET_get_shunt(other,i));
+  for (i = 0; i < net->num_vargens; i++)
+    VARGEN_copy_state_from_vargen(NET_get_vargen(net,i),NET_get_vargen(other,i));
+  for (i = 0; i < net->num_bats; i++)
+    BAT_copy_state_from_bat(NET_get_bat(net,i),NET_get_bat(other,i));
+
+  // Flags
+  net->num_vars = other->num_vars;
+  net->num_fixed = other->num_fixed;
+  net->num_bounded = other->num_bounded;
+  net->num_sparse = other->num_sparse;
+  net->struc_version++;
+
+  // Properties
+  NET_copy_properties(net,other);
+}
+
 Bus* NET_create_sorted_bus_list(Net* net, int sort_by, int t) {
 
   // Local variables
@@ -933,6 +1159,9 @@ void NET_init(Net* net, int num_periods) {
 
   // Utils
   net->bus_counted = NULL;
+
+  // Structure
+  net->struc_version = 0;
 }
 
 REAL NET_get_base_power(Net* net) {
@@ -942,6 +1171,20 @@ REAL NET_get_base_power(Net* net) {
     return NET_BASE_POWER;
 }
 
+REAL* NET_get_branch_phase_array(Net* net, int t) {
+  if (net)
+    return BRANCH_array_get_phase(net->branch,net->num_branches,t);
+  else
+    return NULL;
+}
+
+REAL* NET_get_branch_ratio_array(Net* net, int t) {
+  if (net)
+    return BRANCH_array_get_ratio(net->branch,net->num_branches,t);
+  else
+    return NULL;
+}
+
 Branch* NET_get_branch(Net* net, int index) {
   if (!net || index < 0 || index >= net->num_branches)
     return NULL;
@@ -956,6 +1199,20 @@ Bus* NET_get_bus(Net* net, int index) {
     return BUS_array_get(net->bus,index);
 }
 
+REAL* NET_get_bus_v_ang_array(Net* net, int t) {
+  if (net)
+    return BUS_array_get_v_ang(net->bus,net->num_buses,t);
+  else
+    return NULL;
+}
+
+REAL* NET_get_bus_v_mag_array(Net* net, int t) {
+  if (net)
+    return BUS_array_get_v_mag(net->bus,net->num_buses,t);
+  else
+    return NULL;
+}
+
 Bus* NET_get_bus_hash_number(Net* net) {
   if (!net)
     return NULL;
@@ -1385,6 +1642,69 @@ int NET_get_num_vars(Net* net) {
     return 0;
 }
 
+int NET_get_struc_version(Net* net) {
+  if (net)
+    return net->struc_version;
+  else
+    return 0;
+}
+
+unsigned long NET_get_struc_fingerprint(Net* net) {
+  /* This function hashes the parts of the network structure that are
+     changed without going through the network, namely outages and
+     connections of components (e.g. by contingencies), and the branches
+     with zero ratings. Together with the structural version, it tells
+     whether a problem can reuse its sparsity structure. */
+
+  // Local variables
+  unsigned long h;
+  Branch* br;
+  Gen* gen;
+  Shunt* shunt;
+  Bus* bus;
+  int key[6];
+  int i;
+  int k;
+
+  // No net
+  if (!net)
+    return 0;
+
+  // Hash (FNV-1a)
+  h = 2166136261UL;
+  for (i = 0; i < net->num_buses; i++) {
+    bus = BUS_array_get(net->bus,i);
+    h = (h^(unsigned long)BUS_is_slack(bus))*16777619UL;
+  }
+  for (i = 0; i < net->num_branches; i++) {
+    br = BRANCH_array_get(net->branch,i);
+    key[0] = BRANCH_is_on_outage(br);
+    key[1] = BRANCH_get_type(br);
+    key[2] = BRANCH_get_bus_k(br) ? BUS_get_index(BRANCH_get_bus_k(br)) : -1;
+    key[3] = BRANCH_get_bus_m(br) ? BUS_get_index(BRANCH_get_bus_m(br)) : -1;
+    key[4] = BRANCH_get_reg_bus(br) ? BUS_get_index(BRANCH_get_reg_bus(br)) : -1;
+    key[5] = BRANCH_get_ratingA(br) == 0.;
+    for (k = 0; k < 6; k++)
+      h = (h^(unsigned long)key[k])*16777619UL;
+  }
+  for (i = 0; i < net->num_gens; i++) {
+    gen = GEN_array_get(net->gen,i);
+    key[0] = GEN_is_on_outage(gen);
+    key[1] = GEN_get_bus(gen) ? BUS_get_index(GEN_get_bus(gen)) : -1;
+    key[2] = GEN_get_reg_bus(gen) ? BUS_get_index(GEN_get_reg_bus(gen)) : -1;
+    for (k = 0; k < 3; k++)
+      h = (h^(unsigned long)key[k])*16777619UL;
+  }
+  for (i = 0; i < net->num_shunts; i++) {
+    shunt = SHUNT_array_get(net->shunt,i);
+    key[0] = SHUNT_get_bus(shunt) ? BUS_get_index(SHUNT_get_bus(shunt)) : -1;
+    key[1] = SHUNT_get_reg_bus(shunt) ? BUS_get_index(SHUNT_get_reg_bus(shunt)) : -1;
+    for (k = 0; k < 2; k++)
+      h = (h^(unsigned long)key[k])*16777619UL;
+  }
+  return h;
+}
+
 REAL NET_get_total_gen_P(Net* net, int t) {
   int i;
   REAL P = 0;
@@ -1776,6 +2096,11 @@ Net* NET_new(int num_periods) {
     return NULL;
 }
 
+void NET_inc_struc_version(Net* net) {
+  if (net)
+    net->struc_version++;
+}
+
 void NET_set_base_power(Net* net, REAL base_power) {
   if (net)
     net->base_power = base_power;
@@ -1785,6 +2110,7 @@ void NET_set_branch_array(Net* net, Branch* branch, int num) {
   if (net) {
     net->branch = branch;
     net->num_branches = num;
+    net->struc_version++;
   }
 }
 
@@ -1792,6 +2118,7 @@ void NET_set_load_array(Net* net, Load* load, int num) {
   if (net) {
     net->load = load;
     net->num_loads = num;
+    net->struc_version++;
   }
 }
 
@@ -1799,6 +2126,7 @@ void NET_set_shunt_array(Net* net, Shunt* shunt, int num) {
   if (net) {
     net->shunt = shunt;
     net->num_shunts = num;
+    net->struc_version++;
   }
 }
 
@@ -1807,6 +2135,7 @@ void NET_set_bus_array(Net* net, Bus* bus, int num) {
     net->bus = bus;
     net->num_buses = num;
     ARRAY_zalloc(net->bus_counted,char,net->num_buses*net->num_periods);
+    net->struc_version++;
   }
 }
 
@@ -1814,6 +2143,7 @@ void NET_set_gen_array(Net* net, Gen* gen, int num) {
   if (net) {
     net->gen = gen;
     net->num_gens = num;
+    net->struc_version++;
   }
 }
 
@@ -1847,6 +2177,7 @@ void NET_set_vargen_array(Net* net, Vargen* gen, int num) {
     // Set
     net->vargen = gen;         // array
     net->num_vargens = num;    // number
+    net->struc_version++;
   }
 }
 
@@ -1854,6 +2185,7 @@ void NET_set_bat_array(Net* net, Bat* bat, int num) {
   if (net) {
     net->bat = bat;
     net->num_bats = num;
+    net->struc_version++;
   }
 }
 
@@ -1881,6 +2213,9 @@ void NET_set_vargen_buses(Net* net, Bus* bus_list) {
     bus = BUS_get_next(bus);
     i++;
   }
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_set_bat_buses(Net* net, Bus* bus_list) {
@@ -1907,6 +2242,9 @@ void NET_set_bat_buses(Net* net, Bus* bus_list) {
     bus = BUS_get_next(bus);
     i++;
   }
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_set_flags(Net* net, char obj_type, char flag_mask, char prop_mask, unsigned char val_mask) {
@@ -1995,6 +2333,9 @@ void NET_set_flags(Net* net, char obj_type, char flag_mask, char prop_mask, unsi
 	net->num_sparse = set_flags(obj,FLAG_SPARSE,val_mask,net->num_sparse);
     }
   }
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_mask, unsigned char val_mask) {
@@ -2059,6 +2400,9 @@ void NET_set_flags_of_component(Net* net, void* obj, char obj_type, char flag_ma
     net->num_bounded = set_flags(obj,FLAG_BOUNDED,val_mask,net->num_bounded);
   if (flag_mask & FLAG_SPARSE)
     net->num_sparse = set_flags(obj,FLAG_SPARSE,val_mask,net->num_sparse);
+
+  // Structure
+  net->struc_version++;
 }
 
 void NET_set_var_values(Net* net, Vec* values) {
@@ -2289,6 +2633,7 @@ void NET_show_buses(Net* net, int number, int sort_by, int t) {
 void NET_update_properties(Net* net, Vec* values) {
 
   // Local variables
+  Bus* bus;
   int i;
   int t;
 
@@ -2297,16 +2642,19 @@ void NET_update_properties(Net* net, Vec* values) {
 
   // Update
   for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      bus = NET_get_bus(net,i);
+      if (!BUS_is_isolated(bus))
+	NET_update_properties_bus_step(net,bus,t,values);
+    }
     for (i = 0; i < NET_get_num_branches(net); i++)
       NET_update_properties_step(net,NET_get_branch(net,i),t,values);
   }
 }
 
-void NET_update_properties_step(Net* net, Branch* br, int t, Vec* var_values) {
+void NET_update_properties_bus_step(Net* net, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
   Gen* gen;
   Vargen* vargen;
   Load* load;
@@ -2318,20 +2666,260 @@ void NET_update_properties_step(Net* net, Branch* br, int t, Vec* var_values) {
   REAL dQ;
   REAL dP;
 
-  REAL v[2];
+  REAL v;
   REAL dv;
 
+  REAL shunt_b;
+  REAL shunt_db;
+  REAL shunt_g;
+
+  int T;
+
+  // Check pointers
+  if (!net || !bus)
+    return;
+
+  // Periods
+  T = net->num_periods;
+
+  // Skip if already counted
+  if (net->bus_counted[BUS_get_index(bus)*T+t])
+    return;
+  else
+    net->bus_counted[BUS_get_index(bus)*T+t] = TRUE;
+
+  // Voltage magnitude
+  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG) && var_values)
+    v = VEC_get(var_values,BUS_get_index_v_mag(bus,t));
+  else
+    v = BUS_get_v_mag(bus,t);
+
+  // Maximum and minimum voltage magnitudes
+  //***************************************
+  if (net->bus_v_max[t] == 0 && net->bus_v_min[t] == 0) {
+    net->bus_v_max[t] = v;
+    net->bus_v_min[t] = v;
+  }
+  else {
+    if (v > net->bus_v_max[t])
+      net->bus_v_max[t] = v;
+    if (v < net->bus_v_min[t])
+      net->bus_v_min[t] = v;
+  }
+
+  // Normal voltage magnitude limit violations
+  //************************************
+  dv = 0;
+  if (v > BUS_get_v_max_norm(bus))
+    dv = v-BUS_get_v_max_norm(bus);
+  if (v < BUS_get_v_min_norm(bus))
+    dv = BUS_get_v_min_norm(bus)-v;
+  if (dv > net->bus_v_vio[t])
+    net->bus_v_vio[t] = dv;
+
+  // Regulation voltage magntiude limit violations
+  //**********************************************
+  dv = 0;
+  if (v > BUS_get_v_max_reg(bus))
+    dv = v-BUS_get_v_max_reg(bus);
+  if (v < BUS_get_v_min_reg(bus))
+    dv = BUS_get_v_min_reg(bus)-v;
+  if (BUS_is_regulated_by_tran(bus)) {
+    if (dv > net->tran_v_vio[t])
+      net->tran_v_vio[t] = dv;
+  }
+  if (BUS_is_regulated_by_shunt(bus)) {
+    if (dv > net->shunt_v_vio[t])
+      net->shunt_v_vio[t] = dv;
+  }
+
+  // Bus regulated by gen
+  if (BUS_is_regulated_by_gen(bus)) {
+
+    // Voltage set point deviation
+    //****************************
+    if (fabs(v-BUS_get_v_set(bus,t)) > net->gen_v_dev[t])
+      net->gen_v_dev[t] = fabs(v-BUS_get_v_set(bus,t));
+
+    // Voltage set point action
+    //*************************
+    dv = BUS_get_v_max_reg(bus)-BUS_get_v_min_reg(bus);
+    if (dv < NET_CONTROL_EPS)
+      dv = NET_CONTROL_EPS;
+    if (100.*fabs(v-BUS_get_v_set(bus,t))/dv > NET_CONTROL_ACTION_PCT)
+      net->num_actions[t]++;
+  }
+
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P) && var_values)
+      P = VEC_get(var_values,GEN_get_index_P(gen,t));
+    else
+      P = GEN_get_P(gen,t);
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q) && var_values)
+      Q = VEC_get(var_values,GEN_get_index_Q(gen,t));
+    else
+      Q = GEN_get_Q(gen,t);
+
+    // Injections
+    BUS_inject_P(bus,P,t);
+    BUS_inject_Q(bus,Q,t);
+
+    // Active power generation cost
+    //*****************************
+    net->gen_P_cost[t] += GEN_get_P_cost_for(gen,P);
+
+    // Reacive power
+    if (GEN_is_regulator(gen)) { // Should this be done for all generators?
+
+      // Reactive power limit violations
+      //********************************
+      dQ = 0;
+      if (Q > GEN_get_Q_max(gen))
+	dQ = (Q-GEN_get_Q_max(gen))*net->base_power; // MVAr
+      if (Q < GEN_get_Q_min(gen))
+	dQ = (GEN_get_Q_min(gen)-Q)*net->base_power; // MVAr
+      if (dQ > net->gen_Q_vio[t])
+	net->gen_Q_vio[t] = dQ;
+    }
+
+    // Active power limit violations
+    //******************************
+    dP = 0;
+    if (P > GEN_get_P_max(gen))
+      dP = (P-GEN_get_P_max(gen))*net->base_power; // MW
+    if (P < GEN_get_P_min(gen))
+      dP = (GEN_get_P_min(gen)-P)*net->base_power; // MW
+    if (dP > net->gen_P_vio[t])
+      net->gen_P_vio[t] = dP;
+
+    // Active power actions
+    //*********************
+    dP = GEN_get_P_max(gen)-GEN_get_P_min(gen);
+    if (dP < NET_CONTROL_EPS)
+      dP = NET_CONTROL_EPS;
+    if (100.*fabs(P-GEN_get_P(gen,t))/dP > NET_CONTROL_ACTION_PCT)
+      net->num_actions[t]++;
+  }
+
+  // Loads
+  for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
+
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P) && var_values)
+      P = VEC_get(var_values,LOAD_get_index_P(load,t));
+    else
+      P = LOAD_get_P(load,t);
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q) && var_values)
+      Q = VEC_get(var_values,LOAD_get_index_Q(load,t));
+    else
+      Q = LOAD_get_Q(load,t);
+
+    // Injections
+    BUS_inject_P(bus,-P,t);
+    BUS_inject_Q(bus,-Q,t);
+
+    // Active power consumption utility
+    //*********************************
+    net->load_P_util[t] += LOAD_get_P_util_for(load,P);
+
+    // Active power limit violations
+    //******************************
+    dP = 0;
+    if (P > LOAD_get_P_max(load,t))
+      dP = (P-LOAD_get_P_max(load,t))*net->base_power; // MW
+    if (P < LOAD_get_P_min(load,t))
+      dP = (LOAD_get_P_min(load,t)-P)*net->base_power; // MW
+    if (dP > net->load_P_vio[t])
+      net->load_P_vio[t] = dP;
+
+    // Active power actions
+    //*********************
+    dP = LOAD_get_P_max(load,t)-LOAD_get_P_min(load,t);
+    if (dP < NET_CONTROL_EPS)
+      dP = NET_CONTROL_EPS;
+    if (100.*fabs(P-LOAD_get_P(load,t))/dP > NET_CONTROL_ACTION_PCT)
+      net->num_actions[t]++;
+  }
+
+  // Batteries
+  for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
+
+    if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P) && var_values)
+      P = VEC_get(var_values,BAT_get_index_Pc(bat,t))-VEC_get(var_values,BAT_get_index_Pd(bat,t));
+    else
+      P = BAT_get_P(bat,t);
+
+    // Injections
+    BUS_inject_P(bus,-P,t);
+  }
+
+  // Variable generators
+  for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P) && var_values)
+      P = VEC_get(var_values,VARGEN_get_index_P(vargen,t));
+    else
+      P = VARGEN_get_P(vargen,t);
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q) && var_values)
+      Q = VEC_get(var_values,VARGEN_get_index_Q(vargen,t));
+    else
+      Q = VARGEN_get_Q(vargen,t);
+
+    // Injections
+    BUS_inject_P(bus,P,t);
+    BUS_inject_Q(bus,Q,t);
+  }
+
+  // Shunts
+  for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+
+    shunt_g = SHUNT_get_g(shunt);
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC) && var_values)
+      shunt_b = VEC_get(var_values,SHUNT_get_index_b(shunt,t));
+    else
+      shunt_b = SHUNT_get_b(shunt,t);
+
+    // Flows
+    BUS_inject_P(bus,-shunt_g*v*v,t);
+    BUS_inject_Q(bus,shunt_b*v*v,t);
+
+    // Switched shunts
+    if (SHUNT_is_switched_v(shunt)) {
+
+      // Switched shunt susceptance violations
+      //**************************************
+      shunt_db = 0;
+      if (shunt_b > SHUNT_get_b_max(shunt))
+	shunt_db = (shunt_b-SHUNT_get_b_max(shunt));
+      if (shunt_b < SHUNT_get_b_min(shunt))
+	shunt_db = (SHUNT_get_b_min(shunt)-shunt_b);
+      if (shunt_db > net->shunt_b_vio[t])
+	net->shunt_b_vio[t] = shunt_db;
+
+      // Swtiched shunt susceptance actions
+      //***********************************
+      shunt_db = SHUNT_get_b_max(shunt)-SHUNT_get_b_min(shunt);
+      if (shunt_db < NET_CONTROL_EPS)
+	shunt_db = NET_CONTROL_EPS;
+      if (100.*fabs(shunt_b-SHUNT_get_b(shunt,t))/shunt_db > NET_CONTROL_ACTION_PCT)
+	net->num_actions[t]++;
+    }
+  }
+}
+
+void NET_update_properties_step(Net* net, Branch* br, int t, Vec* var_values) {
+
+  // Local variables
+  Bus* buses[2];
+  Bus* bus;
+
   REAL a;
   REAL da;
   REAL phi;
   REAL dphi;
 
-  REAL shunt_b;
-  REAL shunt_db;
-  REAL shunt_g;
-
   int k;
-  int T;
 
   // Check pointers
   if (!net || !br)
@@ -2345,18 +2933,6 @@ void NET_update_properties_step(Net* net, Branch* br, int t, Vec* var_values) {
   buses[0] = BRANCH_get_bus_k(br);
   buses[1] = BRANCH_get_bus_m(br);
 
-  // Periods
-  T = net->num_periods;
-
-  // Voltage magnitudes
-  for (k = 0; k < 2; k++) {
-    bus = buses[k];
-    if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG) && var_values)
-      v[k] = VEC_get(var_values,BUS_get_index_v_mag(bus,t));
-    else
-      v[k] = BUS_get_v_mag(bus,t);
-  }
-
   // Branch data
   if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO) && var_values)
     a = VEC_get(var_values,BRANCH_get_index_ratio(br,t));
@@ -2427,231 +3003,6 @@ void NET_update_properties_step(Net* net, Branch* br, int t, Vec* var_values) {
     }
   }
 
-  // Other flows
-  for (k = 0; k < 2; k++) {
-
-    bus = buses[k];
-
-    // Skip if already counted
-    if (net->bus_counted[BUS_get_index(bus)*T+t])
-      continue;
-    else
-      net->bus_counted[BUS_get_index(bus)*T+t] = TRUE;
-
-    // Maximum and minimum voltage magnitudes
-    //***************************************
-    if (net->bus_v_max[t] == 0 && net->bus_v_min[t] == 0) {
-      net->bus_v_max[t] = v[k];
-      net->bus_v_min[t] = v[k];
-    }
-    else {
-      if (v[k] > net->bus_v_max[t])
-	net->bus_v_max[t] = v[k];
-      if (v[k] < net->bus_v_min[t])
-	net->bus_v_min[t] = v[k];
-    }
-
-    // Normal voltage magnitude limit violations
-    //************************************
-    dv = 0;
-    if (v[k] > BUS_get_v_max_norm(bus))
-      dv = v[k]-BUS_get_v_max_norm(bus);
-    if (v[k] < BUS_get_v_min_norm(bus))
-      dv = BUS_get_v_min_norm(bus)-v[k];
-    if (dv > net->bus_v_vio[t])
-      net->bus_v_vio[t] = dv;
-
-    // Regulation voltage magntiude limit violations
-    //**********************************************
-    dv = 0;
-    if (v[k] > BUS_get_v_max_reg(bus))
-      dv = v[k]-BUS_get_v_max_reg(bus);
-    if (v[k] < BUS_get_v_min_reg(bus))
-      dv = BUS_get_v_min_reg(bus)-v[k];
-    if (BUS_is_regulated_by_tran(bus)) {
-      if (dv > net->tran_v_vio[t])
-	net->tran_v_vio[t] = dv;
-    }
-    if (BUS_is_regulated_by_shunt(bus)) {
-      if (dv > net->shunt_v_vio[t])
-	net->shunt_v_vio[t] = dv;
-    }
-
-    // Bus regulated by gen
-    if (BUS_is_regulated_by_gen(bus)) {
-
-      // Voltage set point deviation
-      //****************************
-      if (fabs(v[k]-BUS_get_v_set(bus,t)) > net->gen_v_dev[t])
-	net->gen_v_dev[t] = fabs(v[k]-BUS_get_v_set(bus,t));
-
-      // Voltage set point action
-      //*************************
-      dv = BUS_get_v_max_reg(bus)-BUS_get_v_min_reg(bus);
-      if (dv < NET_CONTROL_EPS)
-	dv = NET_CONTROL_EPS;
-      if (100.*fabs(v[k]-BUS_get_v_set(bus,t))/dv > NET_CONTROL_ACTION_PCT)
-	net->num_actions[t]++;
-    }
-
-    // Generators
-    for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
-
-      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P) && var_values)
-	P = VEC_get(var_values,GEN_get_index_P(gen,t));
-      else
-	P = GEN_get_P(gen,t);
-      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q) && var_values)
-	Q = VEC_get(var_values,GEN_get_index_Q(gen,t));
-      else
-	Q = GEN_get_Q(gen,t);
-
-      // Injections
-      BUS_inject_P(bus,P,t);
-      BUS_inject_Q(bus,Q,t);
-
-      // Active power generation cost
-      //*****************************
-      net->gen_P_cost[t] += GEN_get_P_cost_for(gen,P);
-
-      // Reacive power
-      if (GEN_is_regulator(gen)) { // Should this be done for all generators?
-
-	// Reactive power limit violations
-	//********************************
-	dQ = 0;
-	if (Q > GEN_get_Q_max(gen))
-	  dQ = (Q-GEN_get_Q_max(gen))*net->base_power; // MVAr
-	if (Q < GEN_get_Q_min(gen))
-	  dQ = (GEN_get_Q_min(gen)-Q)*net->base_power; // MVAr
-	if (dQ > net->gen_Q_vio[t])
-	  net->gen_Q_vio[t] = dQ;
-      }
-
-      // Active power limit violations
-      //******************************
-      dP = 0;
-      if (P > GEN_get_P_max(gen))
-	dP = (P-GEN_get_P_max(gen))*net->base_power; // MW
-      if (P < GEN_get_P_min(gen))
-	dP = (GEN_get_P_min(gen)-P)*net->base_power; // MW
-      if (dP > net->gen_P_vio[t])
-	net->gen_P_vio[t] = dP;
-
-      // Active power actions
-      //*********************
-      dP = GEN_get_P_max(gen)-GEN_get_P_min(gen);
-      if (dP < NET_CONTROL_EPS)
-	dP = NET_CONTROL_EPS;
-      if (100.*fabs(P-GEN_get_P(gen,t))/dP > NET_CONTROL_ACTION_PCT)
-	net->num_actions[t]++;
-    }
-
-    // Loads
-    for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
-
-      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P) && var_values)
-	P = VEC_get(var_values,LOAD_get_index_P(load,t));
-      else
-	P = LOAD_get_P(load,t);
-      if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q) && var_values)
-	Q = VEC_get(var_values,LOAD_get_index_Q(load,t));
-      else
-	Q = LOAD_get_Q(load,t);
-
-      // Injections
-      BUS_inject_P(bus,-P,t);
-      BUS_inject_Q(bus,-Q,t);
-
-      // Active power consumption utility
-      //*********************************
-      net->load_P_util[t] += LOAD_get_P_util_for(load,P);
-
-      // Active power limit violations
-      //******************************
-      dP = 0;
-      if (P > LOAD_get_P_max(load,t))
-	dP = (P-LOAD_get_P_max(load,t))*net->base_power; // MW
-      if (P < LOAD_get_P_min(load,t))
-	dP = (LOAD_get_P_min(load,t)-P)*net->base_power; // MW
-      if (dP > net->load_P_vio[t])
-	net->load_P_vio[t] = dP;
-
-      // Active power actions
-      //*********************
-      dP = LOAD_get_P_max(load,t)-LOAD_get_P_min(load,t);
-      if (dP < NET_CONTROL_EPS)
-	dP = NET_CONTROL_EPS;
-      if (100.*fabs(P-LOAD_get_P(load,t))/dP > NET_CONTROL_ACTION_PCT)
-	net->num_actions[t]++;
-    }
-
-    // Batteries
-    for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
-
-      if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P) && var_values)
-	P = VEC_get(var_values,BAT_get_index_Pc(bat,t))-VEC_get(var_values,BAT_get_index_Pd(bat,t));
-      else
-	P = BAT_get_P(bat,t);
-
-      // Injections
-      BUS_inject_P(bus,-P,t);
-    }
-
-    // Variable generators
-    for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
-
-      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P) && var_values)
-	P = VEC_get(var_values,VARGEN_get_index_P(vargen,t));
-      else
-	P = VARGEN_get_P(vargen,t);
-      if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q) && var_values)
-	Q = VEC_get(var_values,VARGEN_get_index_Q(vargen,t));
-      else
-	Q = VARGEN_get_Q(vargen,t);
-
-      // Injections
-      BUS_inject_P(bus,P,t);
-      BUS_inject_Q(bus,Q,t);
-    }
-
-    // Shunts
-    for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
-
-      shunt_g = SHUNT_get_g(shunt);
-      if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC) && var_values)
-	shunt_b = VEC_get(var_values,SHUNT_get_index_b(shunt,t));
-      else
-	shunt_b = SHUNT_get_b(shunt,t);
-
-      // Flows
-      BUS_inject_P(bus,-shunt_g*v[k]*v[k],t);
-      BUS_inject_Q(bus,shunt_b*v[k]*v[k],t);
-
-      // Switched shunts
-      if (SHUNT_is_switched_v(shunt)) {
-
-	// Switched shunt susceptance violations
-	//**************************************
-	shunt_db = 0;
-	if (shunt_b > SHUNT_get_b_max(shunt))
-	  shunt_db = (shunt_b-SHUNT_get_b_max(shunt));
-	if (shunt_b < SHUNT_get_b_min(shunt))
-	  shunt_db = (SHUNT_get_b_min(shunt)-shunt_b);
-	if (shunt_db > net->shunt_b_vio[t])
-	  net->shunt_b_vio[t] = shunt_db;
-
-	// Swtiched shunt susceptance actions
-	//***********************************
-	shunt_db = SHUNT_get_b_max(shunt)-SHUNT_get_b_min(shunt);
-	if (shunt_db < NET_CONTROL_EPS)
-	  shunt_db = NET_CONTROL_EPS;
-	if (100.*fabs(shunt_b-SHUNT_get_b(shunt,t))/shunt_db > NET_CONTROL_ACTION_PCT)
-	  net->num_actions[t]++;
-      }
-    }
-  }
-
   // Power mismatches
   if (BRANCH_get_index(br) == net->num_branches-1) {
     BUS_array_get_max_mismatches(net->bus,
@@ -60,19 +60,63 @@ void SHUNT_array_del(Shunt* shunt_array, int size) {
     for (i = 0; i < size; i++) {
       shunt = &(shunt_array[i]);
       free(shunt->b_values);
-      free(shunt->b);
-      free(shunt->index_b);
     }
+    if (size > 0)
+      free(shunt_array->b); // per-period arrays
     free(shunt_array);
   }
 }
 
-Shunt* SHUNT_array_new(int size, int num_periods) { 
+static size_t SHUNT_set_data(Shunt* shunt, int num_periods, char* data) {
+  /* Points the per-period arrays of the shunt to consecutive regions
+     of data and returns their size in bytes. With data NULL, only the
+     size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(shunt->b,REAL,num_periods,data,offset);
+  ARRAY_carve(shunt->index_b,int,num_periods,data,offset);
+  return offset;
+}
+
+static void SHUNT_init_data(Shunt* shunt, int num_periods, char* data) {
+  /* Initializes the shunt using data for its per-period arrays. */
+
+  // Local vars
+  int T;
+  
+  T = num_periods;
+  shunt->num_periods = num_periods;
+ 
+  shunt->bus = NULL;
+  shunt->reg_bus = NULL;
+  shunt->g = 0;
+  shunt->b_max = 0;
+  shunt->b_min = 0;
+  shunt->b_values = NULL;
+  shunt->num_b = 0;
+  shunt->vars = 0x00;
+  shunt->fixed = 0x00;
+  shunt->bounded = 0x00;
+  shunt->sparse = 0x00;
+  shunt->index = 0;
+
+  SHUNT_set_data(shunt,T,data);
+
+  shunt->next = NULL;
+  shunt->reg_next = NULL;
+}
+
+Shunt* SHUNT_array_new(int size, int num_periods) {
+  /* The per-period arrays of all the shunts are carved out of one block. */
   int i;
+  size_t num_bytes;
+  char* data = NULL;
   if (num_periods > 0) {
     Shunt* shunt_array = (Shunt*)malloc(sizeof(Shunt)*size);
+    num_bytes = SHUNT_set_data(shunt_array,num_periods,NULL);
+    if (size > 0)
+      ARRAY_zalloc(data,char,size*num_bytes);
     for (i = 0; i < size; i++) {
-      SHUNT_init(&(shunt_array[i]),num_periods);
+      SHUNT_init_data(&(shunt_array[i]),num_periods,data+i*num_bytes);
       SHUNT_set_index(&(shunt_array[i]),i);
     }
     return shunt_array;
@@ -102,6 +146,56 @@ void SHUNT_clear_flags(Shunt* shunt, char flag_type) {
   }
 }
 
+void SHUNT_copy_from_shunt(Shunt* shunt, Shunt* other) {
+  /* This function copies the data of other to shunt, that is, everything
+     except its connections to buses, its index, and its list handles.
+     The shunts must have the same number of periods. */
+
+  // Check
+  if (!shunt || !other || shunt->num_periods != other->num_periods)
+    return;
+
+  // Conductance
+  shunt->g = other->g;
+
+  // Susceptance
+  shunt->b_max = other->b_max;
+  shunt->b_min = other->b_min;
+  free(shunt->b_values);
+  shunt->b_values = NULL;
+  shunt->num_b = other->num_b;
+  if (other->b_values) {
+    ARRAY_alloc(shunt->b_values,REAL,other->num_b);
+    memcpy(shunt->b_values,other->b_values,other->num_b*sizeof(REAL));
+  }
+
+  // State
+  SHUNT_copy_state_from_shunt(shunt,other);
+}
+
+void SHUNT_copy_state_from_shunt(Shunt* shunt, Shunt* other) {
+  /* This function copies the per-period data, flags and variable indices
+     of other to shunt. The shunts must have the same number of periods. */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!shunt || !other || shunt->num_periods != other->num_periods)
+    return;
+  T = shunt->num_periods;
+
+  // Flags
+  shunt->vars = other->vars;
+  shunt->fixed = other->fixed;
+  shunt->bounded = other->bounded;
+  shunt->sparse = other->sparse;
+
+  // Per-period data
+  memcpy(shunt->b,other->b,T*sizeof(REAL));
+  memcpy(shunt->index_b,other->index_b,T*sizeof(int));
+}
+
 int SHUNT_get_num_periods(Shunt* shunt) {
   if (shunt)
     return shunt->num_periods;
@@ -299,33 +393,14 @@ BOOL SHUNT_has_properties(void* vshunt, char prop) {
 void SHUNT_init(Shunt* shunt, int num_periods) {
 
   // Local vars
-  int T;
-  
+  char* data;
+
   // No gen
   if (!shunt)
     return;
 
-  T = num_periods;
-  shunt->num_periods = num_periods;
- 
-  shunt->bus = NULL;
-  shunt->reg_bus = NULL;
-  shunt->g = 0;
-  shunt->b_max = 0;
-  shunt->b_min = 0;
-  shunt->b_values = NULL;
-  shunt->num_b = 0;
-  shunt->vars = 0x00;
-  shunt->fixed = 0x00;
-  shunt->bounded = 0x00;
-  shunt->sparse = 0x00;
-  shunt->index = 0;
-
-  ARRAY_zalloc(shunt->b,REAL,T);
-  ARRAY_zalloc(shunt->index_b,int,T);
-
-  shunt->next = NULL;
-  shunt->reg_next = NULL;
+  ARRAY_zalloc(data,char,SHUNT_set_data(shunt,num_periods,NULL));
+  SHUNT_init_data(shunt,num_periods,data);
 }
 
 BOOL SHUNT_is_fixed(Shunt* shunt) {
@@ -62,28 +62,67 @@ void* VARGEN_array_get(void* gen_array, int index) {
 }
 
 void VARGEN_array_del(Vargen* gen_array, int size) {
-  int i;
-  Vargen* gen;
   if (gen_array) {    
-    for (i = 0; i < size; i++) {
-      gen = &(gen_array[i]);
-      free(gen->P);
-      free(gen->P_ava);
-      free(gen->P_std);
-      free(gen->Q);
-      free(gen->index_P);
-      free(gen->index_Q);
-    }
+    if (size > 0)
+      free(gen_array->P); // per-period arrays
     free(gen_array);
   }  
 }
 
+static size_t VARGEN_set_data(Vargen* gen, int num_periods, char* data) {
+  /* Points the per-period arrays of the variable generator to
+     consecutive regions of data and returns their size in bytes. With
+     data NULL, only the size is computed. */
+  size_t offset = 0;
+  ARRAY_carve(gen->P,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->P_ava,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->P_std,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->Q,REAL,num_periods,data,offset);
+  ARRAY_carve(gen->index_P,int,num_periods,data,offset);
+  ARRAY_carve(gen->index_Q,int,num_periods,data,offset);
+  return offset;
+}
+
+static void VARGEN_init_data(Vargen* gen, int num_periods, char* data) {
+  /* Initializes the variable generator using data for its per-period arrays. */
+
+  // Local variables
+  int T;
+
+  T = num_periods;
+  gen->num_periods = num_periods;
+
+  gen->bus = NULL;
+  gen->type = VARGEN_TYPE_WIND;
+  ARRAY_clear(gen->name,char,VARGEN_NAME_BUFFER_SIZE);
+  gen->fixed = 0x00;
+  gen->bounded = 0x00;
+  gen->sparse = 0x00;
+  gen->vars = 0x00;
+  gen->P_max = 0;
+  gen->P_min = 0;
+  gen->Q_max = 0;
+  gen->Q_min = 0;
+  gen->index = 0;
+
+  VARGEN_set_data(gen,T,data);
+
+  gen->next = NULL;
+}
+
 Vargen* VARGEN_array_new(int size, int num_periods) {
+  /* The per-period arrays of all the variable generators
+     are carved out of one block. */
   int i;
+  size_t num_bytes;
+  char* data = NULL;
   if (num_periods > 0) {
     Vargen* gen_array = (Vargen*)malloc(sizeof(Vargen)*size);
+    num_bytes = VARGEN_set_data(gen_array,num_periods,NULL);
+    if (size > 0)
+      ARRAY_zalloc(data,char,size*num_bytes);
     for (i = 0; i < size; i++) {
-      VARGEN_init(&(gen_array[i]),num_periods);
+      VARGEN_init_data(&(gen_array[i]),num_periods,data+i*num_bytes);
       VARGEN_set_index(&(gen_array[i]),i);
       snprintf(gen_array[i].name,(size_t)(VARGEN_NAME_BUFFER_SIZE-1),"VARGEN %d",i+1);
     }
@@ -114,6 +153,58 @@ void VARGEN_clear_flags(Vargen* gen, char flag_type) {
   }
 }
 
+void VARGEN_copy_from_vargen(Vargen* gen, Vargen* other) {
+  /* This function copies the data of other to gen, that is, everything
+     except its connection to a bus, its index, and its hash and list
+     handles. The variable generators must have the same number of
+     periods. */
+
+  // Check
+  if (!gen || !other || gen->num_periods != other->num_periods)
+    return;
+
+  // Properties
+  memcpy(gen->name,other->name,VARGEN_NAME_BUFFER_SIZE*sizeof(char));
+  gen->type = other->type;
+
+  // Limits
+  gen->P_max = other->P_max;
+  gen->P_min = other->P_min;
+  gen->Q_max = other->Q_max;
+  gen->Q_min = other->Q_min;
+
+  // State
+  VARGEN_copy_state_from_vargen(gen,other);
+}
+
+void VARGEN_copy_state_from_vargen(Vargen* gen, Vargen* other) {
+  /* This function copies the per-period data, flags and variable indices
+     of other to gen. The variable generators must have the same number
+     of periods. */
+
+  // Local variables
+  int T;
+
+  // Check
+  if (!gen || !other || gen->num_periods != other->num_periods)
+    return;
+  T = gen->num_periods;
+
+  // Flags
+  gen->fixed = other->fixed;
+  gen->bounded = other->bounded;
+  gen->vars = other->vars;
+  gen->sparse = other->sparse;
+
+  // Per-period data
+  memcpy(gen->P,other->P,T*sizeof(REAL));
+  memcpy(gen->P_ava,other->P_ava,T*sizeof(REAL));
+  memcpy(gen->P_std,other->P_std,T*sizeof(REAL));
+  memcpy(gen->Q,other->Q,T*sizeof(REAL));
+  memcpy(gen->index_P,other->index_P,T*sizeof(int));
+  memcpy(gen->index_Q,other->index_Q,T*sizeof(int));
+}
+
 int VARGEN_get_num_periods(Vargen* gen) {
   if (gen)
     return gen->num_periods;
@@ -388,45 +479,16 @@ int VARGEN_hash_name_len(Vargen* vargen_hash) {
 }
 
 void VARGEN_init(Vargen* gen, int num_periods) {
-  
-  // Local variables
-  int T;
+
+  // Local vars
+  char* data;
 
   // No vargen
   if (!gen)
     return;
 
-  T = num_periods;
-  gen->num_periods = num_periods;
-
-  gen->bus = NULL;
-  gen->type = VARGEN_TYPE_WIND;
-  ARRAY_clear(gen->name,char,VARGEN_NAME_BUFFER_SIZE);
-  gen->fixed = 0x00;
-  gen->bounded = 0x00;
-  gen->sparse = 0x00;
-  gen->vars = 0x00;
-  gen->P_max = 0;
-  gen->P_min = 0;
-  gen->Q_max = 0;
-  gen->Q_min = 0;
-  gen->index = 0;
-
-  gen->P = NULL;
-  gen->P_ava = NULL;
-  gen->P_std = NULL;
-  gen->Q = NULL;
-  gen->index_P = NULL;
-  gen->index_Q = NULL;
-
-  ARRAY_zalloc(gen->P,REAL,T);
-  ARRAY_zalloc(gen->P_ava,REAL,T);
-  ARRAY_zalloc(gen->P_std,REAL,T);
-  ARRAY_zalloc(gen->Q,REAL,T);
-  ARRAY_zalloc(gen->index_P,int,T);
-  ARRAY_zalloc(gen->index_Q,int,T);
-  
-  gen->next = NULL;
+  ARRAY_zalloc(data,char,VARGEN_set_data(gen,num_periods,NULL));
+  VARGEN_init_data(gen,num_periods,data);
 }
 
 BOOL VARGEN_is_wind(Vargen* gen) {
@@ -0,0 +1,471 @@
+/** @file contana.c
+ *  @brief This file defines the ContAna data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <pfnet/array.h>
+#include <pfnet/contana.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#define CONTANA_WTIME() omp_get_wtime()
+#else
+#include <time.h>
+#define CONTANA_WTIME() ((REAL)clock()/CLOCKS_PER_SEC)
+#endif
+
+struct ContAna {
+
+  // Error
+  BOOL error_flag;                        /**< @brief Error flag */
+  char error_string[CONTANA_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Options
+  PFlow* pf;       /**< @brief Power flow solver whose options are used for every contingency */
+  int num_threads; /**< @brief Number of threads (one network each) */
+
+  // Workers
+  Net** workers;   /**< @brief Networks equivalent to the base network, one per additional thread */
+  int num_workers; /**< @brief Number of additional networks */
+
+  // Results
+  int num_conts;       /**< @brief Number of contingencies of the last run */
+  REAL time;           /**< @brief Time of the last run (seconds) */
+  char* res_converged; /**< @brief Flag for convergence of each contingency */
+  int* res_iters;      /**< @brief Number of iterations of each contingency */
+  REAL* res_mismatch;  /**< @brief Largest final residual entry of each contingency */
+  REAL* res_v_vio;     /**< @brief Largest bus voltage magnitude limit violation of each contingency (per unit) */
+  REAL* res_Q_vio;     /**< @brief Largest generator reactive power limit violation of each contingency (per unit) */
+  REAL* res_loading;   /**< @brief Largest branch loading of each contingency */
+  int* res_overloads;  /**< @brief Number of overloaded branches of each contingency */
+  int* res_worst;      /**< @brief Branch with the largest loading of each contingency */
+};
+
+static void CONTANA_set_solution(Net* net, REAL* v_mag, REAL* v_ang, REAL* P, REAL* Q) {
+  /* This function stores the given bus voltages and generator powers of
+     every time period in the network. */
+
+  // Local variables
+  Gen* gen;
+  int num_buses;
+  int T;
+  int i;
+  int t;
+
+  T = NET_get_num_periods(net);
+  num_buses = NET_get_num_buses(net);
+  for (t = 0; t < T && num_buses > 0; t++) {
+    memcpy(NET_get_bus_v_mag_array(net,t),v_mag+t*num_buses,num_buses*sizeof(REAL));
+    memcpy(NET_get_bus_v_ang_array(net,t),v_ang+t*num_buses,num_buses*sizeof(REAL));
+  }
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    for (t = 0; t < T; t++) {
+      GEN_set_P(gen,P[i*T+t],t);
+      GEN_set_Q(gen,Q[i*T+t],t);
+    }
+  }
+}
+
+void CONTANA_add_worker(ContAna* ca, Net* net) {
+  if (!ca || !net)
+    return;
+  ca->workers = (Net**)realloc(ca->workers,(ca->num_workers+1)*sizeof(Net*));
+  ca->workers[ca->num_workers] = net;
+  ca->num_workers++;
+}
+
+void CONTANA_clear_error(ContAna* ca) {
+  if (ca) {
+    ca->error_flag = FALSE;
+    strcpy(ca->error_string,"");
+  }
+}
+
+void CONTANA_del(ContAna* ca) {
+  if (ca) {
+    PFLOW_del(ca->pf);
+    free(ca->workers);
+    free(ca->res_converged);
+    free(ca->res_iters);
+    free(ca->res_mismatch);
+    free(ca->res_v_vio);
+    free(ca->res_Q_vio);
+    free(ca->res_loading);
+    free(ca->res_overloads);
+    free(ca->res_worst);
+    free(ca);
+  }
+}
+
+REAL CONTANA_get_branch_max_loading(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_loading[k];
+  else
+    return 0;
+}
+
+int CONTANA_get_branch_num_overloads(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_overloads[k];
+  else
+    return 0;
+}
+
+int CONTANA_get_branch_worst(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_worst[k];
+  else
+    return -1;
+}
+
+REAL CONTANA_get_bus_v_vio(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_v_vio[k];
+  else
+    return 0;
+}
+
+char* CONTANA_get_error_string(ContAna* ca) {
+  if (ca)
+    return ca->error_string;
+  else
+    return NULL;
+}
+
+REAL CONTANA_get_gen_Q_vio(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_Q_vio[k];
+  else
+    return 0;
+}
+
+REAL CONTANA_get_mismatch(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_mismatch[k];
+  else
+    return 0;
+}
+
+int CONTANA_get_num_conts(ContAna* ca) {
+  if (ca)
+    return ca->num_conts;
+  else
+    return 0;
+}
+
+int CONTANA_get_num_iters(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_iters[k];
+  else
+    return 0;
+}
+
+int CONTANA_get_num_threads(ContAna* ca) {
+  if (ca)
+    return ca->num_threads;
+  else
+    return 0;
+}
+
+int CONTANA_get_num_workers(ContAna* ca) {
+  if (ca)
+    return ca->num_workers+1;
+  else
+    return 0;
+}
+
+PFlow* CONTANA_get_pflow(ContAna* ca) {
+  if (ca)
+    return ca->pf;
+  else
+    return NULL;
+}
+
+REAL CONTANA_get_time(ContAna* ca) {
+  if (ca)
+    return ca->time;
+  else
+    return 0;
+}
+
+BOOL CONTANA_has_converged(ContAna* ca, int k) {
+  if (ca && k >= 0 && k < ca->num_conts)
+    return ca->res_converged[k];
+  else
+    return FALSE;
+}
+
+BOOL CONTANA_has_error(ContAna* ca) {
+  if (ca)
+    return ca->error_flag;
+  else
+    return FALSE;
+}
+
+ContAna* CONTANA_new(void) {
+
+  ContAna* ca = (ContAna*)malloc(sizeof(ContAna));
+
+  // Error
+  ca->error_flag = FALSE;
+  strcpy(ca->error_string,"");
+
+  // Options
+  ca->pf = PFLOW_new();
+#ifdef _OPENMP
+  ca->num_threads = omp_get_max_threads();
+#else
+  ca->num_threads = 1;
+#endif
+
+  // Workers
+  ca->workers = NULL;
+  ca->num_workers = 0;
+
+  // Results
+  ca->num_conts = 0;
+  ca->time = 0;
+  ca->res_converged = NULL;
+  ca->res_iters = NULL;
+  ca->res_mismatch = NULL;
+  ca->res_v_vio = NULL;
+  ca->res_Q_vio = NULL;
+  ca->res_loading = NULL;
+  ca->res_overloads = NULL;
+  ca->res_worst = NULL;
+
+  return ca;
+}
+
+void CONTANA_run(ContAna* ca, Net* net, Cont** conts, int num_conts) {
+  /* This function solves the AC power flow equations of the network under
+     each of the given contingencies, which refer to components of the
+     network. Every contingency is solved from the current solution of the
+     network with the options of the power flow solver of the analysis.
+     The network and each additional network, which must be equivalent
+     to it (e.g. parsed from the same case), are used by one thread each,
+     and copies of the network are made for the remaining threads. The
+     contingencies are translated to the components of each network by
+     index, and the threads take the next contingency as they become
+     free. For each contingency, the largest bus voltage magnitude and
+     generator reactive power limit violations and the largest branch
+     loading, that is, the largest apparent power flow at either end
+     divided by rating A, among branches with nonzero rating A, are
+     recorded over all time periods. The solution of the network is
+     restored at the end, and its flags are those set by the power flow
+     solver. */
+
+  // Local variables
+  Net* wnet;
+  Net** nets;
+  PFlow** pfs;
+  PFlow* pf;
+  Cont* cont;
+  Branch* br;
+  Gen* gen;
+  REAL* v_mag;
+  REAL* v_ang;
+  REAL* P;
+  REAL* Q;
+  REAL flows[BRANCH_FLOW_SIZE];
+  REAL rating;
+  REAL load;
+  REAL start;
+  int num_threads;
+  int num_buses;
+  int num_gens;
+  int num_branches;
+  int T;
+  int w;
+  int c;
+  int i;
+  int l;
+  int t;
+
+  // Check
+  if (!ca || !net)
+    return;
+  if (num_conts < 0 || (num_conts > 0 && !conts)) {
+    sprintf(ca->error_string,"invalid contingencies");
+    ca->error_flag = TRUE;
+    return;
+  }
+  num_buses = NET_get_num_buses(net);
+  num_gens = NET_get_num_gens(net);
+  num_branches = NET_get_num_branches(net);
+  T = NET_get_num_periods(net);
+  for (w = 0; w < ca->num_workers; w++) {
+    wnet = ca->workers[w];
+    if (wnet == net ||
+	NET_get_num_buses(wnet) != num_buses ||
+	NET_get_num_gens(wnet) != num_gens ||
+	NET_get_num_branches(wnet) != num_branches ||
+	NET_get_num_periods(wnet) != T) {
+      sprintf(ca->error_string,"network %d is not equivalent to the base network",w);
+      ca->error_flag = TRUE;
+      return;
+    }
+  }
+
+  // Results
+  start = CONTANA_WTIME();
+  free(ca->res_converged);
+  free(ca->res_iters);
+  free(ca->res_mismatch);
+  free(ca->res_v_vio);
+  free(ca->res_Q_vio);
+  free(ca->res_loading);
+  free(ca->res_overloads);
+  free(ca->res_worst);
+  ca->num_conts = num_conts;
+  ARRAY_zalloc(ca->res_converged,char,num_conts);
+  ARRAY_zalloc(ca->res_iters,int,num_conts);
+  ARRAY_zalloc(ca->res_mismatch,REAL,num_conts);
+  ARRAY_zalloc(ca->res_v_vio,REAL,num_conts);
+  ARRAY_zalloc(ca->res_Q_vio,REAL,num_conts);
+  ARRAY_zalloc(ca->res_loading,REAL,num_conts);
+  ARRAY_zalloc(ca->res_overloads,int,num_conts);
+  ARRAY_alloc(ca->res_worst,int,num_conts);
+
+  // Base solution
+  ARRAY_alloc(v_mag,REAL,num_buses*T);
+  ARRAY_alloc(v_ang,REAL,num_buses*T);
+  ARRAY_alloc(P,REAL,num_gens*T);
+  ARRAY_alloc(Q,REAL,num_gens*T);
+  for (t = 0; t < T && num_buses > 0; t++) {
+    memcpy(v_mag+t*num_buses,NET_get_bus_v_mag_array(net,t),num_buses*sizeof(REAL));
+    memcpy(v_ang+t*num_buses,NET_get_bus_v_ang_array(net,t),num_buses*sizeof(REAL));
+  }
+  for (i = 0; i < num_gens; i++) {
+    for (t = 0; t < T; t++) {
+      P[i*T+t] = GEN_get_P(NET_get_gen(net,i),t);
+      Q[i*T+t] = GEN_get_Q(NET_get_gen(net,i),t);
+    }
+  }
+
+  // Networks
+  num_threads = ca->num_threads > ca->num_workers+1 ? ca->num_threads : ca->num_workers+1;
+  ARRAY_alloc(nets,Net*,num_threads);
+  nets[0] = net;
+  for (w = 1; w < num_threads; w++)
+    nets[w] = w <= ca->num_workers ? ca->workers[w-1] : NET_copy(net);
+
+  // Solvers (one per network)
+  ARRAY_alloc(pfs,PFlow*,num_threads);
+  for (w = 0; w < num_threads; w++) {
+    pfs[w] = PFLOW_new();
+    PFLOW_set_method(pfs[w],PFLOW_get_method(ca->pf));
+    PFLOW_set_tol(pfs[w],PFLOW_get_tol(ca->pf));
+    PFLOW_set_max_iters(pfs[w],PFLOW_get_max_iters(ca->pf));
+    PFLOW_set_pvpq(pfs[w],PFLOW_get_pvpq(ca->pf));
+    PFLOW_set_line_search(pfs[w],PFLOW_get_line_search(ca->pf));
+  }
+
+  // Contingencies
+#ifdef _OPENMP
+#pragma omp parallel for private(wnet,pf,cont,br,gen,flows,rating,load,w,i,l,t) schedule(dynamic,1) num_threads(num_threads)
+#endif
+  for (c = 0; c < num_conts; c++) {
+
+    // Network and solver of the thread
+#ifdef _OPENMP
+    w = omp_get_thread_num();
+#else
+    w = 0;
+#endif
+    wnet = nets[w];
+    pf = pfs[w];
+
+    // Warm start
+    CONTANA_set_solution(wnet,v_mag,v_ang,P,Q);
+
+    // Outages
+    cont = CONT_new();
+    for (i = 0; i < CONT_get_num_gen_outages(conts[c]); i++) {
+      gen = CONT_get_gen_outage(conts[c],i);
+      CONT_add_gen_outage(cont,NET_get_gen(wnet,GEN_get_index(gen)));
+    }
+    for (i = 0; i < CONT_get_num_branch_outages(conts[c]); i++) {
+      br = CONT_get_branch_outage(conts[c],i);
+      CONT_add_branch_outage(cont,NET_get_branch(wnet,BRANCH_get_index(br)));
+    }
+    CONT_apply(cont);
+
+    // Properties of the warm start (kept if the solve fails early)
+    NET_update_properties(wnet,NULL);
+
+    // Solve
+    PFLOW_solve(pf,wnet);
+    ca->res_converged[c] = PFLOW_has_converged(pf) && !PFLOW_has_error(pf);
+    ca->res_iters[c] = PFLOW_get_num_iters(pf);
+    ca->res_mismatch[c] = PFLOW_get_mismatch(pf);
+    PFLOW_clear_error(pf);
+
+    // Violations
+    ca->res_worst[c] = -1;
+    for (t = 0; t < T; t++) {
+      if (NET_get_bus_v_vio(wnet,t) > ca->res_v_vio[c])
+	ca->res_v_vio[c] = NET_get_bus_v_vio(wnet,t);
+      if (NET_get_gen_Q_vio(wnet,t) > ca->res_Q_vio[c])
+	ca->res_Q_vio[c] = NET_get_gen_Q_vio(wnet,t);
+    }
+    for (l = 0; l < num_branches; l++) {
+      br = NET_get_branch(wnet,l);
+      rating = BRANCH_get_ratingA(br);
+      if (BRANCH_is_on_outage(br) || rating <= 0)
+	continue;
+      load = 0;
+      for (t = 0; t < T; t++) {
+	BRANCH_compute_flows(br,NULL,t,flows);
+	if (sqrt(flows[BRANCH_P_KM]*flows[BRANCH_P_KM]+flows[BRANCH_Q_KM]*flows[BRANCH_Q_KM]) > load)
+	  load = sqrt(flows[BRANCH_P_KM]*flows[BRANCH_P_KM]+flows[BRANCH_Q_KM]*flows[BRANCH_Q_KM]);
+	if (sqrt(flows[BRANCH_P_MK]*flows[BRANCH_P_MK]+flows[BRANCH_Q_MK]*flows[BRANCH_Q_MK]) > load)
+	  load = sqrt(flows[BRANCH_P_MK]*flows[BRANCH_P_MK]+flows[BRANCH_Q_MK]*flows[BRANCH_Q_MK]);
+      }
+      load /= rating;
+      if (load > ca->res_loading[c]) {
+	ca->res_loading[c] = load;
+	ca->res_worst[c] = l;
+      }
+      if (load > 1.)
+	ca->res_overloads[c]++;
+    }
+
+    // Clear
+    CONT_clear(cont);
+    CONT_del(cont);
+  }
+
+  // Base network
+  CONTANA_set_solution(net,v_mag,v_ang,P,Q);
+  NET_update_properties(net,NULL);
+
+  // Time
+  ca->time = CONTANA_WTIME()-start;
+
+  // Clean up
+  for (w = 0; w < num_threads; w++) {
+    PFLOW_del(pfs[w]);
+    if (w > ca->num_workers)
+      NET_del(nets[w]);
+  }
+  free(pfs);
+  free(nets);
+  free(v_mag);
+  free(v_ang);
+  free(P);
+  free(Q);
+}
+
+void CONTANA_set_num_threads(ContAna* ca, int num_threads) {
+  if (ca && num_threads > 0)
+    ca->num_threads = num_threads;
+}
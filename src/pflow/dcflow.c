@@ -0,0 +1,733 @@
+/** @file dcflow.c
+ *  @brief This file defines the DCFlow data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <pfnet/array.h>
+#include <pfnet/dcflow.h>
+
+struct DCFlow {
+
+  // Error
+  BOOL error_flag;                       /**< @brief Error flag */
+  char error_string[DCFLOW_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Network data
+  BOOL analyzed;     /**< @brief Flag that indicates that the matrix has been built and factorized */
+  int num_buses;     /**< @brief Number of buses */
+  int num_branches;  /**< @brief Number of branches */
+  int num_red;       /**< @brief Number of non-slack buses (size of the reduced matrix) */
+  int* bus_pos;      /**< @brief Position of each bus in the reduced matrix (-1 for slack buses) */
+  int* br_k;         /**< @brief Index of bus "k" of each branch */
+  int* br_m;         /**< @brief Index of bus "m" of each branch */
+  REAL* br_b;        /**< @brief Series susceptance of each branch (zero if on outage) */
+
+  // Factorization
+  SpLU* lu;          /**< @brief Factorization of the reduced susceptance matrix (ordering kept across analyses) */
+
+  // PTDF
+  REAL** ptdf;       /**< @brief Cached PTDF column of each bus (NULL if not computed) */
+  int num_ptdf;      /**< @brief Number of cached PTDF columns */
+};
+
+void DCFLOW_analyze(DCFlow* dc, Net* net) {
+  /* This function builds the susceptance matrix of the network without
+     the rows and columns of the slack buses and factorizes it. Branches
+     on outage are left out, so the analysis has to be repeated after
+     contingencies are applied or cleared, and every bus has to remain
+     connected to a slack bus. The ordering of the
+     factorization is kept if the pattern does not change. */
+
+  // Local variables
+  Branch* br;
+  Mat* B;
+  SpMat* S;
+  int row[4];
+  int col[4];
+  REAL val[4];
+  REAL b;
+  int* adj_ptr;
+  int* adj;
+  int* queue;
+  char* reached;
+  int num_reached;
+  int nnz;
+  int pass;
+  int e;
+  int q;
+  int i;
+
+  // Check
+  if (!dc || !net)
+    return;
+
+  // Clear
+  DCFLOW_clear_PTDF(dc);
+  free(dc->ptdf);
+  free(dc->bus_pos);
+  free(dc->br_k);
+  free(dc->br_m);
+  free(dc->br_b);
+  dc->analyzed = FALSE;
+
+  // Sizes
+  dc->num_buses = NET_get_num_buses(net);
+  dc->num_branches = NET_get_num_branches(net);
+  ARRAY_zalloc(dc->ptdf,REAL*,dc->num_buses);
+  ARRAY_alloc(dc->bus_pos,int,dc->num_buses);
+  ARRAY_alloc(dc->br_k,int,dc->num_branches);
+  ARRAY_alloc(dc->br_m,int,dc->num_branches);
+  ARRAY_alloc(dc->br_b,REAL,dc->num_branches);
+
+  // Buses
+  dc->num_red = 0;
+  for (i = 0; i < dc->num_buses; i++)
+    dc->bus_pos[i] = BUS_is_slack(NET_get_bus(net,i)) ? -1 : dc->num_red++;
+  if (dc->num_red == dc->num_buses) {
+    sprintf(dc->error_string,"network has no slack bus");
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Branches
+  for (i = 0; i < dc->num_branches; i++) {
+    br = NET_get_branch(net,i);
+    dc->br_k[i] = BUS_get_index(BRANCH_get_bus_k(br));
+    dc->br_m[i] = BUS_get_index(BRANCH_get_bus_m(br));
+    dc->br_b[i] = BRANCH_is_on_outage(br) ? 0 : BRANCH_get_b(br);
+  }
+
+  // Buses connected to slack buses (the matrix is singular otherwise)
+  ARRAY_alloc(queue,int,dc->num_buses);
+  ARRAY_zalloc(adj_ptr,int,dc->num_buses+1);
+  ARRAY_alloc(adj,int,2*dc->num_branches);
+  for (i = 0; i < dc->num_branches; i++) {
+    if (dc->br_b[i] != 0) {
+      adj_ptr[dc->br_k[i]+1]++;
+      adj_ptr[dc->br_m[i]+1]++;
+    }
+  }
+  for (i = 0; i < dc->num_buses; i++)
+    adj_ptr[i+1] += adj_ptr[i];
+  for (i = 0; i < dc->num_branches; i++) {
+    if (dc->br_b[i] != 0) {
+      adj[adj_ptr[dc->br_k[i]]++] = dc->br_m[i];
+      adj[adj_ptr[dc->br_m[i]]++] = dc->br_k[i];
+    }
+  }
+  for (i = dc->num_buses; i > 0; i--)
+    adj_ptr[i] = adj_ptr[i-1];
+  adj_ptr[0] = 0;
+  ARRAY_zalloc(reached,char,dc->num_buses);
+  num_reached = 0;
+  for (i = 0; i < dc->num_buses; i++) {
+    if (dc->bus_pos[i] < 0) {
+      reached[i] = TRUE;
+      queue[num_reached++] = i;
+    }
+  }
+  for (q = 0; q < num_reached; q++) {
+    for (e = adj_ptr[queue[q]]; e < adj_ptr[queue[q]+1]; e++) {
+      if (!reached[adj[e]]) {
+	reached[adj[e]] = TRUE;
+	queue[num_reached++] = adj[e];
+      }
+    }
+  }
+  free(queue);
+  free(adj_ptr);
+  free(adj);
+  free(reached);
+  if (num_reached < dc->num_buses) {
+    sprintf(dc->error_string,"%d buses are not connected to a slack bus",dc->num_buses-num_reached);
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Matrix (counted in the first pass and filled in the second)
+  B = NULL;
+  for (pass = 0; pass < 2; pass++) {
+    nnz = 0;
+    for (i = 0; i < dc->num_branches; i++) {
+      if (dc->br_b[i] == 0)
+	continue;
+      b = dc->br_b[i];
+      row[0] = dc->bus_pos[dc->br_k[i]]; col[0] = row[0]; val[0] = -b;
+      row[1] = dc->bus_pos[dc->br_m[i]]; col[1] = row[1]; val[1] = -b;
+      row[2] = row[0]; col[2] = row[1]; val[2] = b;
+      row[3] = row[1]; col[3] = row[0]; val[3] = b;
+      for (e = 0; e < 4; e++) {
+	if (row[e] < 0 || col[e] < 0)
+	  continue;
+	if (pass == 1) {
+	  MAT_set_i(B,nnz,row[e]);
+	  MAT_set_j(B,nnz,col[e]);
+	  MAT_set_d(B,nnz,val[e]);
+	}
+	nnz++;
+      }
+    }
+    if (pass == 0)
+      B = MAT_new(dc->num_red,dc->num_red,nnz);
+  }
+
+  // Factorization
+  S = SPMAT_new_from_mat(B,SPMAT_CSC);
+  SPLU_refactorize(dc->lu,S);
+  if (SPLU_has_error(dc->lu)) {
+    sprintf(dc->error_string,"susceptance matrix factorization failed (%s)",SPLU_get_error_string(dc->lu));
+    SPLU_clear_error(dc->lu);
+    dc->error_flag = TRUE;
+  }
+  else
+    dc->analyzed = TRUE;
+
+  // Clean up
+  SPMAT_del(S);
+  MAT_del(B);
+}
+
+void DCFLOW_clear_error(DCFlow* dc) {
+  if (dc) {
+    dc->error_flag = FALSE;
+    strcpy(dc->error_string,"");
+  }
+}
+
+void DCFLOW_clear_PTDF(DCFlow* dc) {
+
+  // Local variables
+  int i;
+
+  // Check
+  if (!dc || !dc->ptdf)
+    return;
+
+  // Clear
+  for (i = 0; i < dc->num_buses; i++) {
+    free(dc->ptdf[i]);
+    dc->ptdf[i] = NULL;
+  }
+  dc->num_ptdf = 0;
+}
+
+void DCFLOW_compute_flows(DCFlow* dc, Vec* w, Vec* flows, int num) {
+  /* This function computes the active power flows from bus "k" to bus "m"
+     of the branches, ignoring phase shifts, for each of the num angle
+     vectors stored one after the other in w. The flows of angle vector r
+     are stored in flows[r*num_branches,(r+1)*num_branches). */
+
+  // Local variables
+  REAL* wd;
+  REAL* fd;
+  int r;
+  int i;
+
+  // Check
+  if (!dc || !w || !flows)
+    return;
+  if (VEC_get_size(w) != dc->num_buses*num ||
+      VEC_get_size(flows) != dc->num_branches*num) {
+    sprintf(dc->error_string,"invalid vector size");
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Flows
+  wd = VEC_get_data(w);
+  fd = VEC_get_data(flows);
+  for (r = 0; r < num; r++) {
+    for (i = 0; i < dc->num_branches; i++)
+      fd[r*dc->num_branches+i] = -dc->br_b[i]*(wd[r*dc->num_buses+dc->br_k[i]]-
+					       wd[r*dc->num_buses+dc->br_m[i]]);
+  }
+}
+
+void DCFLOW_compute_PTDF(DCFlow* dc, int* bus_indices, int num) {
+  /* This function computes and caches the PTDF columns of the given buses
+     that are not cached yet. The PTDF column of a bus has the changes of
+     the branch flows due to a unit injection at the bus withdrawn at the
+     slack buses. The columns are obtained in blocks of
+     DCFLOW_PTDF_BLOCK_SIZE right-hand sides, and the blocks are solved
+     concurrently. */
+
+  // Local variables
+  int* todo;
+  int num_todo;
+  int num_blocks;
+  int block;
+  int start;
+  int size;
+  Vec* P;
+  Vec* flows;
+  int i;
+  int r;
+
+  // Check
+  if (!dc || !bus_indices)
+    return;
+  if (!dc->analyzed) {
+    sprintf(dc->error_string,"DC power flow has not been analyzed");
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Columns to compute
+  ARRAY_alloc(todo,int,num);
+  num_todo = 0;
+  for (r = 0; r < num; r++) {
+    i = bus_indices[r];
+    if (i < 0 || i >= dc->num_buses) {
+      sprintf(dc->error_string,"invalid bus index");
+      dc->error_flag = TRUE;
+      free(todo);
+      return;
+    }
+    if (!dc->ptdf[i]) {
+      ARRAY_zalloc(dc->ptdf[i],REAL,dc->num_branches);
+      dc->num_ptdf++;
+      if (dc->bus_pos[i] >= 0)
+	todo[num_todo++] = i;
+    }
+  }
+
+  // Blocks
+  num_blocks = (num_todo+DCFLOW_PTDF_BLOCK_SIZE-1)/DCFLOW_PTDF_BLOCK_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for private(start,size,P,flows,i,r) schedule(dynamic)
+#endif
+  for (block = 0; block < num_blocks; block++) {
+
+    start = block*DCFLOW_PTDF_BLOCK_SIZE;
+    size = num_todo-start < DCFLOW_PTDF_BLOCK_SIZE ? num_todo-start : DCFLOW_PTDF_BLOCK_SIZE;
+
+    // Unit injections
+    P = VEC_new(dc->num_buses*size);
+    VEC_set_zero(P);
+    for (r = 0; r < size; r++)
+      VEC_set(P,r*dc->num_buses+todo[start+r],1.);
+
+    // Angles and flows
+    DCFLOW_solve_angles(dc,P,P,size);
+    flows = VEC_new(dc->num_branches*size);
+    DCFLOW_compute_flows(dc,P,flows,size);
+    for (r = 0; r < size; r++)
+      memcpy(dc->ptdf[todo[start+r]],VEC_get_data(flows)+r*dc->num_branches,dc->num_branches*sizeof(REAL));
+
+    // Clean up
+    VEC_del(P);
+    VEC_del(flows);
+  }
+
+  // Clean up
+  free(todo);
+}
+
+void DCFLOW_compute_transfer_flows(DCFlow* dc, int* br_indices, int num, Vec* flows) {
+  /* This function computes the changes of the branch flows due to a unit
+     transfer from bus "k" to bus "m" of each of the num given branches.
+     The changes due to the transfer of branch r are stored in
+     flows[r*num_branches,(r+1)*num_branches). These are differences of
+     PTDF columns, obtained without forming them. */
+
+  // Local variables
+  Vec* P;
+  int r;
+  int i;
+
+  // Check
+  if (!dc || !br_indices || !flows || num <= 0)
+    return;
+  if (!dc->analyzed) {
+    sprintf(dc->error_string,"DC power flow has not been analyzed");
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Transfers
+  P = VEC_new(dc->num_buses*num);
+  VEC_set_zero(P);
+  for (r = 0; r < num; r++) {
+    i = br_indices[r];
+    if (i < 0 || i >= dc->num_branches) {
+      sprintf(dc->error_string,"invalid branch index");
+      dc->error_flag = TRUE;
+      VEC_del(P);
+      return;
+    }
+    VEC_add_to_entry(P,r*dc->num_buses+dc->br_k[i],1.);
+    VEC_add_to_entry(P,r*dc->num_buses+dc->br_m[i],-1.);
+  }
+
+  // Flows
+  DCFLOW_solve_angles(dc,P,P,num);
+  DCFLOW_compute_flows(dc,P,flows,num);
+
+  // Clean up
+  VEC_del(P);
+}
+
+void DCFLOW_del(DCFlow* dc) {
+  if (dc) {
+    DCFLOW_clear_PTDF(dc);
+    free(dc->ptdf);
+    free(dc->bus_pos);
+    free(dc->br_k);
+    free(dc->br_m);
+    free(dc->br_b);
+    SPLU_del(dc->lu);
+    free(dc);
+  }
+}
+
+char* DCFLOW_get_error_string(DCFlow* dc) {
+  if (dc)
+    return dc->error_string;
+  else
+    return NULL;
+}
+
+SpLU* DCFLOW_get_LU(DCFlow* dc) {
+  if (dc)
+    return dc->lu;
+  else
+    return NULL;
+}
+
+REAL DCFLOW_get_LODF(DCFlow* dc, int br_index, int out_index) {
+  /* This function returns the change of the flow of a branch per unit of
+     pre-outage flow of the outaged branch. It is obtained from the PTDF
+     columns of the buses of the outaged branch, and it is zero if the
+     outage islands the network. */
+
+  // Local variables
+  REAL* ptdf_k;
+  REAL* ptdf_m;
+  REAL den;
+
+  // Check
+  if (!dc || br_index < 0 || br_index >= dc->num_branches ||
+      out_index < 0 || out_index >= dc->num_branches || dc->br_b[out_index] == 0)
+    return 0;
+  if (br_index == out_index)
+    return -1.;
+
+  // PTDF
+  ptdf_k = DCFLOW_get_PTDF_column(dc,dc->br_k[out_index]);
+  ptdf_m = DCFLOW_get_PTDF_column(dc,dc->br_m[out_index]);
+  if (!ptdf_k || !ptdf_m)
+    return 0;
+
+  // LODF
+  den = 1.-(ptdf_k[out_index]-ptdf_m[out_index]);
+  if (fabs(den) < DCFLOW_ISLAND_TOL)
+    return 0;
+  return (ptdf_k[br_index]-ptdf_m[br_index])/den;
+}
+
+int DCFLOW_get_num_branches(DCFlow* dc) {
+  if (dc)
+    return dc->num_branches;
+  else
+    return 0;
+}
+
+int DCFLOW_get_num_buses(DCFlow* dc) {
+  if (dc)
+    return dc->num_buses;
+  else
+    return 0;
+}
+
+int DCFLOW_get_num_PTDF_columns(DCFlow* dc) {
+  if (dc)
+    return dc->num_ptdf;
+  else
+    return 0;
+}
+
+REAL DCFLOW_get_OTDF(DCFlow* dc, int br_index, int out_index, int bus_index) {
+  /* This function returns the change of the flow of a branch due to a
+     unit injection at a bus, withdrawn at the slack buses, after the
+     outage of another branch. */
+
+  // Check
+  if (!dc || br_index < 0 || br_index >= dc->num_branches)
+    return 0;
+  if (br_index == out_index)
+    return 0;
+
+  return (DCFLOW_get_PTDF(dc,br_index,bus_index)+
+	  DCFLOW_get_LODF(dc,br_index,out_index)*DCFLOW_get_PTDF(dc,out_index,bus_index));
+}
+
+REAL DCFLOW_get_PTDF(DCFlow* dc, int br_index, int bus_index) {
+
+  // Local variables
+  REAL* column;
+
+  // Check
+  if (!dc || br_index < 0 || br_index >= dc->num_branches)
+    return 0;
+
+  // Column
+  column = DCFLOW_get_PTDF_column(dc,bus_index);
+  if (column)
+    return column[br_index];
+  else
+    return 0;
+}
+
+REAL* DCFLOW_get_PTDF_column(DCFlow* dc, int bus_index) {
+  /* This function returns the PTDF column of the bus, which has one entry
+     per branch, computing it first if it is not cached. The column is
+     owned by the DC power flow solver. */
+
+  // Check
+  if (!dc || !dc->analyzed || bus_index < 0 || bus_index >= dc->num_buses)
+    return NULL;
+
+  // Compute
+  if (!dc->ptdf[bus_index])
+    DCFLOW_compute_PTDF(dc,&bus_index,1);
+
+  return dc->ptdf[bus_index];
+}
+
+BOOL DCFLOW_has_error(DCFlow* dc) {
+  if (dc)
+    return dc->error_flag;
+  else
+    return FALSE;
+}
+
+BOOL DCFLOW_is_analyzed(DCFlow* dc) {
+  if (dc)
+    return dc->analyzed;
+  else
+    return FALSE;
+}
+
+DCFlow* DCFLOW_new(void) {
+
+  DCFlow* dc = (DCFlow*)malloc(sizeof(DCFlow));
+
+  // Error
+  dc->error_flag = FALSE;
+  strcpy(dc->error_string,"");
+
+  // Network data
+  dc->analyzed = FALSE;
+  dc->num_buses = 0;
+  dc->num_branches = 0;
+  dc->num_red = 0;
+  dc->bus_pos = NULL;
+  dc->br_k = NULL;
+  dc->br_m = NULL;
+  dc->br_b = NULL;
+
+  // Factorization
+  dc->lu = SPLU_new();
+
+  // PTDF
+  dc->ptdf = NULL;
+  dc->num_ptdf = 0;
+
+  return dc;
+}
+
+void DCFLOW_solve(DCFlow* dc, Net* net) {
+  /* This function solves the DC power flow equations of the network for
+     all time periods. The injections are given by the active powers of
+     generators, loads, variable generators and batteries, and the slack
+     buses keep their voltage angles. The network is analyzed first if it
+     has not been analyzed or if its size changed. The voltage angles of
+     the non-slack buses and the active powers of the slack generators,
+     shared equally, are stored in the network. */
+
+  // Local variables
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  Load* load;
+  Vargen* vargen;
+  Bat* bat;
+  Vec* P;
+  REAL* Pd;
+  REAL b;
+  REAL* phase;
+  REAL* v_ang;
+  REAL total;
+  int num_buses;
+  int num_periods;
+  int num;
+  int bk;
+  int bm;
+  int i;
+  int t;
+
+  // Check
+  if (!dc || !net)
+    return;
+
+  // Analyze
+  if (!dc->analyzed ||
+      dc->num_buses != NET_get_num_buses(net) ||
+      dc->num_branches != NET_get_num_branches(net))
+    DCFLOW_analyze(dc,net);
+  if (dc->error_flag)
+    return;
+
+  // Sizes
+  num_buses = dc->num_buses;
+  num_periods = NET_get_num_periods(net);
+
+  // Injections
+  P = VEC_new(num_buses*num_periods);
+  Pd = VEC_get_data(P);
+  for (t = 0; t < num_periods; t++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      Pd[t*num_buses+i] = 0;
+      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
+	Pd[t*num_buses+i] += GEN_get_P(gen,t);
+      for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load))
+	Pd[t*num_buses+i] -= LOAD_get_P(load,t);
+      for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen))
+	Pd[t*num_buses+i] += VARGEN_get_P(vargen,t);
+      for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat))
+	Pd[t*num_buses+i] -= BAT_get_P(bat,t);
+    }
+
+    // Phase shifts and slack angles
+    phase = NET_get_branch_phase_array(net,t);
+    v_ang = NET_get_bus_v_ang_array(net,t);
+    for (i = 0; i < dc->num_branches; i++) {
+      b = dc->br_b[i];
+      if (b == 0)
+	continue;
+      bk = dc->br_k[i];
+      bm = dc->br_m[i];
+      Pd[t*num_buses+bk] -= b*phase[i];
+      Pd[t*num_buses+bm] += b*phase[i];
+      if (dc->bus_pos[bk] < 0)
+	Pd[t*num_buses+bm] -= b*v_ang[bk];
+      if (dc->bus_pos[bm] < 0)
+	Pd[t*num_buses+bk] -= b*v_ang[bm];
+    }
+  }
+
+  // Angles
+  DCFLOW_solve_angles(dc,P,P,num_periods);
+  if (dc->error_flag) {
+    VEC_del(P);
+    return;
+  }
+  for (t = 0; t < num_periods; t++) {
+    v_ang = NET_get_bus_v_ang_array(net,t);
+    for (i = 0; i < num_buses; i++) {
+      if (dc->bus_pos[i] >= 0)
+	v_ang[i] = Pd[t*num_buses+i];
+    }
+  }
+
+  // Slack generators
+  for (t = 0; t < num_periods; t++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      if (dc->bus_pos[i] >= 0)
+	continue;
+      total = 0;
+      for (br = BUS_get_branch_k(bus); br != NULL; br = BRANCH_get_next_k(br)) {
+	if (!BRANCH_is_on_outage(br))
+	  total += BRANCH_get_P_km_DC(br,t);
+      }
+      for (br = BUS_get_branch_m(bus); br != NULL; br = BRANCH_get_next_m(br)) {
+	if (!BRANCH_is_on_outage(br))
+	  total += BRANCH_get_P_mk_DC(br,t);
+      }
+      for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load))
+	total += LOAD_get_P(load,t);
+      for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen))
+	total -= VARGEN_get_P(vargen,t);
+      for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat))
+	total += BAT_get_P(bat,t);
+      num = 0;
+      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	if (GEN_is_slack(gen))
+	  num++;
+	else
+	  total -= GEN_get_P(gen,t);
+      }
+      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	if (GEN_is_slack(gen))
+	  GEN_set_P(gen,total/num,t);
+      }
+    }
+  }
+
+  // Clean up
+  VEC_del(P);
+}
+
+void DCFLOW_solve_angles(DCFlow* dc, Vec* P, Vec* w, int num) {
+  /* This function computes the voltage angles due to each of the num
+     injection vectors stored one after the other in P, with the angles of
+     the slack buses at zero. The injections at the slack buses are
+     ignored. The angles of injection vector r are stored in
+     w[r*num_buses,(r+1)*num_buses), and w may be P. All the vectors are
+     solved with a single pass over the factors. */
+
+  // Local variables
+  Vec* x;
+  REAL* xd;
+  REAL* Pd;
+  REAL* wd;
+  int r;
+  int i;
+
+  // Check
+  if (!dc || !P || !w || num <= 0)
+    return;
+  if (!dc->analyzed) {
+    sprintf(dc->error_string,"DC power flow has not been analyzed");
+    dc->error_flag = TRUE;
+    return;
+  }
+  if (VEC_get_size(P) != dc->num_buses*num || VEC_get_size(w) != dc->num_buses*num) {
+    sprintf(dc->error_string,"invalid vector size");
+    dc->error_flag = TRUE;
+    return;
+  }
+
+  // Reduced injections
+  x = VEC_new(dc->num_red*num);
+  xd = VEC_get_data(x);
+  Pd = VEC_get_data(P);
+  for (r = 0; r < num; r++) {
+    for (i = 0; i < dc->num_buses; i++) {
+      if (dc->bus_pos[i] >= 0)
+	xd[r*dc->num_red+dc->bus_pos[i]] = Pd[r*dc->num_buses+i];
+    }
+  }
+
+  // Solve
+  SPLU_solve_batch(dc->lu,x,num);
+
+  // Angles
+  wd = VEC_get_data(w);
+  for (r = 0; r < num; r++) {
+    for (i = 0; i < dc->num_buses; i++)
+      wd[r*dc->num_buses+i] = dc->bus_pos[i] >= 0 ? xd[r*dc->num_red+dc->bus_pos[i]] : 0;
+  }
+
+  // Clean up
+  VEC_del(x);
+}
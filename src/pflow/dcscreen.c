@@ -0,0 +1,491 @@
+/** @file dcscreen.c
+ *  @brief This file defines the DCScreen data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <pfnet/array.h>
+#include <pfnet/dcscreen.h>
+
+struct DCScreen {
+
+  // Error
+  BOOL error_flag;                         /**< @brief Error flag */
+  char error_string[DCSCREEN_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Options
+  char rating;   /**< @brief Branch rating used for overloads */
+  int top;       /**< @brief Number of contingencies kept */
+  BOOL singles;  /**< @brief Flag for screening the outage of every branch */
+
+  // Double outages
+  int* doubles;     /**< @brief Branch indices of the selected double outages (two per outage) */
+  int num_doubles;  /**< @brief Number of selected double outages */
+
+  // Results
+  int num_screened;    /**< @brief Number of contingencies screened by the last run */
+  int num_islanding;   /**< @brief Number of contingencies of the last run that island the network */
+  int num_overloaded;  /**< @brief Number of contingencies of the last run with overloads */
+  int num_results;     /**< @brief Number of contingencies kept */
+  int* res_br;         /**< @brief Outaged branches of each kept contingency (two per contingency, -1 if none) */
+  REAL* res_severity;  /**< @brief Sum of relative overloads of each kept contingency */
+  REAL* res_loading;   /**< @brief Largest post-contingency loading of each kept contingency */
+  int* res_worst;      /**< @brief Branch with the largest loading of each kept contingency */
+};
+
+void DCSCREEN_add_double(DCScreen* s, int br_index1, int br_index2) {
+  if (!s)
+    return;
+  if (br_index1 < 0 || br_index2 < 0 || br_index1 == br_index2) {
+    sprintf(s->error_string,"invalid double outage");
+    s->error_flag = TRUE;
+    return;
+  }
+  s->doubles = (int*)realloc(s->doubles,2*(s->num_doubles+1)*sizeof(int));
+  s->doubles[2*s->num_doubles] = br_index1;
+  s->doubles[2*s->num_doubles+1] = br_index2;
+  s->num_doubles++;
+}
+
+void DCSCREEN_clear_doubles(DCScreen* s) {
+  if (s) {
+    free(s->doubles);
+    s->doubles = NULL;
+    s->num_doubles = 0;
+  }
+}
+
+void DCSCREEN_clear_error(DCScreen* s) {
+  if (s) {
+    s->error_flag = FALSE;
+    strcpy(s->error_string,"");
+  }
+}
+
+void DCSCREEN_del(DCScreen* s) {
+  if (s) {
+    free(s->doubles);
+    free(s->res_br);
+    free(s->res_severity);
+    free(s->res_loading);
+    free(s->res_worst);
+    free(s);
+  }
+}
+
+char* DCSCREEN_get_error_string(DCScreen* s) {
+  if (s)
+    return s->error_string;
+  else
+    return NULL;
+}
+
+int DCSCREEN_get_num_doubles(DCScreen* s) {
+  if (s)
+    return s->num_doubles;
+  else
+    return 0;
+}
+
+int DCSCREEN_get_num_islanding(DCScreen* s) {
+  if (s)
+    return s->num_islanding;
+  else
+    return 0;
+}
+
+int DCSCREEN_get_num_overloaded(DCScreen* s) {
+  if (s)
+    return s->num_overloaded;
+  else
+    return 0;
+}
+
+int DCSCREEN_get_num_results(DCScreen* s) {
+  if (s)
+    return s->num_results;
+  else
+    return 0;
+}
+
+int DCSCREEN_get_num_screened(DCScreen* s) {
+  if (s)
+    return s->num_screened;
+  else
+    return 0;
+}
+
+char DCSCREEN_get_rating(DCScreen* s) {
+  if (s)
+    return s->rating;
+  else
+    return DCSCREEN_RATING_A;
+}
+
+int DCSCREEN_get_result_branch(DCScreen* s, int k, int j) {
+  if (s && k >= 0 && k < s->num_results && j >= 0 && j < 2)
+    return s->res_br[2*k+j];
+  else
+    return -1;
+}
+
+REAL DCSCREEN_get_result_max_loading(DCScreen* s, int k) {
+  if (s && k >= 0 && k < s->num_results)
+    return s->res_loading[k];
+  else
+    return 0;
+}
+
+REAL DCSCREEN_get_result_severity(DCScreen* s, int k) {
+  if (s && k >= 0 && k < s->num_results)
+    return s->res_severity[k];
+  else
+    return 0;
+}
+
+int DCSCREEN_get_result_worst_branch(DCScreen* s, int k) {
+  if (s && k >= 0 && k < s->num_results)
+    return s->res_worst[k];
+  else
+    return -1;
+}
+
+BOOL DCSCREEN_get_singles(DCScreen* s) {
+  if (s)
+    return s->singles;
+  else
+    return FALSE;
+}
+
+int DCSCREEN_get_top(DCScreen* s) {
+  if (s)
+    return s->top;
+  else
+    return 0;
+}
+
+BOOL DCSCREEN_has_error(DCScreen* s) {
+  if (s)
+    return s->error_flag;
+  else
+    return FALSE;
+}
+
+DCScreen* DCSCREEN_new(void) {
+
+  DCScreen* s = (DCScreen*)malloc(sizeof(DCScreen));
+
+  // Error
+  s->error_flag = FALSE;
+  strcpy(s->error_string,"");
+
+  // Options
+  s->rating = DCSCREEN_RATING_A;
+  s->top = DCSCREEN_TOP;
+  s->singles = TRUE;
+
+  // Double outages
+  s->doubles = NULL;
+  s->num_doubles = 0;
+
+  // Results
+  s->num_screened = 0;
+  s->num_islanding = 0;
+  s->num_overloaded = 0;
+  s->num_results = 0;
+  s->res_br = NULL;
+  s->res_severity = NULL;
+  s->res_loading = NULL;
+  s->res_worst = NULL;
+
+  return s;
+}
+
+Cont* DCSCREEN_new_cont(DCScreen* s, Net* net, int k) {
+  /* This function returns a new contingency with the branch outages of
+     the kept contingency k, to be studied with the AC model. */
+
+  // Local variables
+  Cont* cont;
+  int j;
+
+  // Check
+  if (!s || !net || k < 0 || k >= s->num_results)
+    return NULL;
+
+  // Contingency
+  cont = CONT_new();
+  for (j = 0; j < 2; j++) {
+    if (s->res_br[2*k+j] >= 0)
+      CONT_add_branch_outage(cont,NET_get_branch(net,s->res_br[2*k+j]));
+  }
+  return cont;
+}
+
+void DCSCREEN_run(DCScreen* s, DCFlow* dc, Net* net, int t) {
+  /* This function screens the outage of every branch (if enabled) and the
+     selected double outages with the DC model of the network. The
+     post-contingency flows are obtained from the base flows of time
+     period t, stored in the network (e.g. by DCFLOW_solve), and the flows
+     due to transfers between the buses of the outaged branches, that is,
+     from LODF for single outages and their two-branch extension for
+     double outages. The contingencies are processed in blocks, and the
+     blocks concurrently. The severity of a contingency is the sum of the
+     relative overloads of the branches with nonzero rating, and the top
+     contingencies with overloads are kept, by decreasing severity. */
+
+  // Local variables
+  Branch* br;
+  REAL* f0;
+  REAL* rating;
+  int* cont_br;
+  REAL* severity;
+  REAL* loading;
+  int* worst;
+  char* status;
+  int num_branches;
+  int num_conts;
+  int num_blocks;
+  int block;
+  int start;
+  int size;
+  int num_cols;
+  int* cols;
+  Vec* T;
+  REAL* Td;
+  REAL* t1;
+  REAL* t2;
+  REAL m11;
+  REAL m12;
+  REAL m21;
+  REAL m22;
+  REAL det;
+  REAL z1;
+  REAL z2;
+  REAL post;
+  REAL load;
+  int c1;
+  int c2;
+  int c;
+  int k;
+  int l;
+  int j;
+
+  // Check
+  if (!s || !dc || !net)
+    return;
+  if (!DCFLOW_is_analyzed(dc) ||
+      DCFLOW_get_num_buses(dc) != NET_get_num_buses(net) ||
+      DCFLOW_get_num_branches(dc) != NET_get_num_branches(net)) {
+    sprintf(s->error_string,"DC power flow has not been analyzed for the network");
+    s->error_flag = TRUE;
+    return;
+  }
+  if (t < 0 || t >= NET_get_num_periods(net)) {
+    sprintf(s->error_string,"invalid time period");
+    s->error_flag = TRUE;
+    return;
+  }
+
+  // Base flows and ratings
+  num_branches = NET_get_num_branches(net);
+  ARRAY_alloc(f0,REAL,num_branches);
+  ARRAY_alloc(rating,REAL,num_branches);
+  for (l = 0; l < num_branches; l++) {
+    br = NET_get_branch(net,l);
+    f0[l] = BRANCH_is_on_outage(br) ? 0 : BRANCH_get_P_km_DC(br,t);
+    if (s->rating == DCSCREEN_RATING_A)
+      rating[l] = BRANCH_get_ratingA(br);
+    else if (s->rating == DCSCREEN_RATING_B)
+      rating[l] = BRANCH_get_ratingB(br);
+    else
+      rating[l] = BRANCH_get_ratingC(br);
+  }
+
+  // Contingencies (status 0 skipped, 1 screened, 2 islanding)
+  num_conts = (s->singles ? num_branches : 0)+s->num_doubles;
+  ARRAY_alloc(cont_br,int,2*num_conts);
+  ARRAY_zalloc(severity,REAL,num_conts);
+  ARRAY_zalloc(loading,REAL,num_conts);
+  ARRAY_alloc(worst,int,num_conts);
+  ARRAY_zalloc(status,char,num_conts);
+  c = 0;
+  if (s->singles) {
+    for (l = 0; l < num_branches; l++) {
+      cont_br[2*c] = l;
+      cont_br[2*c+1] = -1;
+      c++;
+    }
+  }
+  for (k = 0; k < s->num_doubles; k++) {
+    cont_br[2*c] = s->doubles[2*k];
+    cont_br[2*c+1] = s->doubles[2*k+1];
+    c++;
+  }
+
+  // Blocks
+  num_blocks = (num_conts+DCSCREEN_BLOCK_SIZE-1)/DCSCREEN_BLOCK_SIZE;
+#ifdef _OPENMP
+#pragma omp parallel for private(start,size,num_cols,cols,T,Td,t1,t2,m11,m12,m21,m22,det,z1,z2,post,load,c1,c2,c,l,j) schedule(dynamic)
+#endif
+  for (block = 0; block < num_blocks; block++) {
+
+    start = block*DCSCREEN_BLOCK_SIZE;
+    size = num_conts-start < DCSCREEN_BLOCK_SIZE ? num_conts-start : DCSCREEN_BLOCK_SIZE;
+
+    // Outaged branches of the block
+    cols = (int*)malloc(2*size*sizeof(int));
+    num_cols = 0;
+    for (c = start; c < start+size; c++) {
+      status[c] = 1;
+      for (j = 0; j < 2; j++) {
+	l = cont_br[2*c+j];
+	if (l >= num_branches || (l >= 0 && BRANCH_is_on_outage(NET_get_branch(net,l))))
+	  status[c] = 0;
+      }
+      if (status[c] != 1)
+	continue;
+      for (j = 0; j < 2; j++) {
+	if (cont_br[2*c+j] >= 0)
+	  cols[num_cols++] = cont_br[2*c+j];
+      }
+    }
+
+    // Transfer flows
+    T = VEC_new(num_branches*(num_cols > 0 ? num_cols : 1));
+    if (num_cols > 0)
+      DCFLOW_compute_transfer_flows(dc,cols,num_cols,T);
+    Td = VEC_get_data(T);
+
+    // Post-contingency flows
+    for (c = start, j = 0; c < start+size; c++) {
+      if (status[c] != 1)
+	continue;
+      c1 = cont_br[2*c];
+      c2 = cont_br[2*c+1];
+      t1 = Td+(j++)*num_branches;
+      t2 = c2 >= 0 ? Td+(j++)*num_branches : NULL;
+
+      // Transfers that cancel the flows of the outaged branches
+      if (c2 < 0) {
+	det = 1.-t1[c1];
+	if (fabs(det) < DCFLOW_ISLAND_TOL) {
+	  status[c] = 2;
+	  continue;
+	}
+	z1 = f0[c1]/det;
+	z2 = 0;
+      }
+      else {
+	m11 = 1.-t1[c1];
+	m12 = -t2[c1];
+	m21 = -t1[c2];
+	m22 = 1.-t2[c2];
+	det = m11*m22-m12*m21;
+	if (fabs(det) < DCFLOW_ISLAND_TOL) {
+	  status[c] = 2;
+	  continue;
+	}
+	z1 = (m22*f0[c1]-m12*f0[c2])/det;
+	z2 = (m11*f0[c2]-m21*f0[c1])/det;
+      }
+
+      // Overloads
+      worst[c] = -1;
+      for (l = 0; l < num_branches; l++) {
+	if (l == c1 || l == c2 || rating[l] <= 0)
+	  continue;
+	post = t2 ? f0[l]+t1[l]*z1+t2[l]*z2 : f0[l]+t1[l]*z1;
+	load = fabs(post)/rating[l];
+	if (load > loading[c]) {
+	  loading[c] = load;
+	  worst[c] = l;
+	}
+	if (load > 1.)
+	  severity[c] += load-1.;
+      }
+    }
+
+    // Clean up
+    free(cols);
+    VEC_del(T);
+  }
+
+  // Results
+  free(s->res_br);
+  free(s->res_severity);
+  free(s->res_loading);
+  free(s->res_worst);
+  ARRAY_alloc(s->res_br,int,2*s->top);
+  ARRAY_alloc(s->res_severity,REAL,s->top);
+  ARRAY_alloc(s->res_loading,REAL,s->top);
+  ARRAY_alloc(s->res_worst,int,s->top);
+  s->num_screened = 0;
+  s->num_islanding = 0;
+  s->num_overloaded = 0;
+  s->num_results = 0;
+  for (c = 0; c < num_conts; c++) {
+    if (status[c] == 0)
+      continue;
+    s->num_screened++;
+    if (status[c] == 2) {
+      s->num_islanding++;
+      continue;
+    }
+    if (severity[c] <= 0)
+      continue;
+    s->num_overloaded++;
+
+    // Position among the kept contingencies
+    for (k = s->num_results;
+	 k > 0 && (severity[c] > s->res_severity[k-1] ||
+		   (severity[c] == s->res_severity[k-1] && loading[c] > s->res_loading[k-1]));
+	 k--);
+    if (k >= s->top)
+      continue;
+    if (s->num_results < s->top)
+      s->num_results++;
+    for (j = s->num_results-1; j > k; j--) {
+      s->res_br[2*j] = s->res_br[2*(j-1)];
+      s->res_br[2*j+1] = s->res_br[2*(j-1)+1];
+      s->res_severity[j] = s->res_severity[j-1];
+      s->res_loading[j] = s->res_loading[j-1];
+      s->res_worst[j] = s->res_worst[j-1];
+    }
+    s->res_br[2*k] = cont_br[2*c];
+    s->res_br[2*k+1] = cont_br[2*c+1];
+    s->res_severity[k] = severity[c];
+    s->res_loading[k] = loading[c];
+    s->res_worst[k] = worst[c];
+  }
+
+  // Clean up
+  free(f0);
+  free(rating);
+  free(cont_br);
+  free(severity);
+  free(loading);
+  free(worst);
+  free(status);
+}
+
+void DCSCREEN_set_rating(DCScreen* s, char rating) {
+  if (s && (rating == DCSCREEN_RATING_A || rating == DCSCREEN_RATING_B || rating == DCSCREEN_RATING_C))
+    s->rating = rating;
+}
+
+void DCSCREEN_set_singles(DCScreen* s, BOOL flag) {
+  if (s)
+    s->singles = flag;
+}
+
+void DCSCREEN_set_top(DCScreen* s, int top) {
+  if (s && top >= 0)
+    s->top = top;
+}
@@ -0,0 +1,830 @@
+/** @file pflow.c
+ *  @brief This file defines the PFlow data structure and its associated methods.
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <pfnet/pflow.h>
+#include <pfnet/constr_ACPF.h>
+#include <pfnet/constr_FIX.h>
+#include <pfnet/constr_PAR_GEN_P.h>
+#include <pfnet/constr_PAR_GEN_Q.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#define PFLOW_WTIME() omp_get_wtime()
+#else
+#include <time.h>
+#define PFLOW_WTIME() ((REAL)clock()/CLOCKS_PER_SEC)
+#endif
+
+struct PFlow {
+
+  // Error
+  BOOL error_flag;                      /**< @brief Error flag */
+  char error_string[PFLOW_BUFFER_SIZE]; /**< @brief Error string */
+
+  // Options
+  REAL tol;         /**< @brief Tolerance on the largest residual entry (per unit) */
+  int max_iters;    /**< @brief Maximum number of iterations */
+  BOOL pvpq;        /**< @brief Flag for PV-PQ switching of generator-regulated buses (Newton-Raphson only) */
+  BOOL line_search; /**< @brief Flag for backtracking line search on the residual norm (Newton-Raphson only) */
+  char method;      /**< @brief Solution method */
+
+  // Results
+  BOOL converged;      /**< @brief Flag for convergence of the last solve */
+  int num_iters;       /**< @brief Number of iterations taken by the last solve */
+  REAL time;           /**< @brief Time of the last solve (seconds) */
+  REAL* iter_mismatch; /**< @brief Largest residual entry at the start of each iteration */
+  REAL* iter_step;     /**< @brief Step length of each iteration */
+  REAL* iter_time;     /**< @brief Time of each iteration (seconds) */
+
+  // Factorizations
+  SpLU* lu;            /**< @brief Factorization of the Newton matrix (ordering kept across solves) */
+  SpLU* lu_Bp;         /**< @brief Factorization of the fast decoupled matrix B' */
+  SpLU* lu_Bpp;        /**< @brief Factorization of the fast decoupled matrix B'' */
+};
+
+void PFLOW_clear_error(PFlow* pf) {
+  if (pf) {
+    pf->error_flag = FALSE;
+    strcpy(pf->error_string,"");
+  }
+}
+
+void PFLOW_del(PFlow* pf) {
+  if (pf) {
+    free(pf->iter_mismatch);
+    free(pf->iter_step);
+    free(pf->iter_time);
+    SPLU_del(pf->lu);
+    SPLU_del(pf->lu_Bp);
+    SPLU_del(pf->lu_Bpp);
+    free(pf);
+  }
+}
+
+void PFLOW_eval_residual(Prob* p, Vec* x, Vec* r) {
+  /* This function stores in r the residual [A*x-b;f] of the power flow
+     equations. The constraint functions f must be already evaluated at x. */
+
+  // Local variables
+  Mat* A;
+  Vec* b;
+  Vec* f;
+  REAL* rd;
+  int k;
+
+  // Check
+  if (!p || !x || !r)
+    return;
+
+  // Data
+  A = PROB_get_A(p);
+  b = PROB_get_b(p);
+  f = PROB_get_f(p);
+  rd = VEC_get_data(r);
+
+  // Linear equations
+  for (k = 0; k < MAT_get_size1(A); k++)
+    rd[k] = -VEC_get(b,k);
+  for (k = 0; k < MAT_get_nnz(A); k++)
+    rd[MAT_get_i(A,k)] += MAT_get_d(A,k)*VEC_get(x,MAT_get_j(A,k));
+
+  // Nonlinear equations
+  for (k = 0; k < VEC_get_size(f); k++)
+    rd[MAT_get_size1(A)+k] = VEC_get(f,k);
+}
+
+char* PFLOW_get_error_string(PFlow* pf) {
+  if (pf)
+    return pf->error_string;
+  else
+    return NULL;
+}
+
+REAL PFLOW_get_iter_mismatch(PFlow* pf, int k) {
+  if (pf && k >= 0 && k <= pf->num_iters)
+    return pf->iter_mismatch[k];
+  else
+    return 0;
+}
+
+REAL PFLOW_get_iter_step(PFlow* pf, int k) {
+  if (pf && k >= 0 && k < pf->num_iters)
+    return pf->iter_step[k];
+  else
+    return 0;
+}
+
+REAL PFLOW_get_iter_time(PFlow* pf, int k) {
+  if (pf && k >= 0 && k < pf->num_iters)
+    return pf->iter_time[k];
+  else
+    return 0;
+}
+
+SpLU* PFLOW_get_LU(PFlow* pf) {
+  if (pf)
+    return pf->lu;
+  else
+    return NULL;
+}
+
+SpLU* PFLOW_get_LU_Bp(PFlow* pf) {
+  if (pf)
+    return pf->lu_Bp;
+  else
+    return NULL;
+}
+
+SpLU* PFLOW_get_LU_Bpp(PFlow* pf) {
+  if (pf)
+    return pf->lu_Bpp;
+  else
+    return NULL;
+}
+
+BOOL PFLOW_get_line_search(PFlow* pf) {
+  if (pf)
+    return pf->line_search;
+  else
+    return FALSE;
+}
+
+char PFLOW_get_method(PFlow* pf) {
+  if (pf)
+    return pf->method;
+  else
+    return PFLOW_METHOD_NR;
+}
+
+int PFLOW_get_max_iters(PFlow* pf) {
+  if (pf)
+    return pf->max_iters;
+  else
+    return 0;
+}
+
+REAL PFLOW_get_mismatch(PFlow* pf) {
+  if (pf && pf->iter_mismatch)
+    return pf->iter_mismatch[pf->num_iters];
+  else
+    return 0;
+}
+
+int PFLOW_get_num_iters(PFlow* pf) {
+  if (pf)
+    return pf->num_iters;
+  else
+    return 0;
+}
+
+BOOL PFLOW_get_pvpq(PFlow* pf) {
+  if (pf)
+    return pf->pvpq;
+  else
+    return FALSE;
+}
+
+REAL PFLOW_get_time(PFlow* pf) {
+  if (pf)
+    return pf->time;
+  else
+    return 0;
+}
+
+REAL PFLOW_get_tol(PFlow* pf) {
+  if (pf)
+    return pf->tol;
+  else
+    return 0;
+}
+
+BOOL PFLOW_has_converged(PFlow* pf) {
+  if (pf)
+    return pf->converged;
+  else
+    return FALSE;
+}
+
+BOOL PFLOW_has_error(PFlow* pf) {
+  if (pf)
+    return pf->error_flag;
+  else
+    return FALSE;
+}
+
+PFlow* PFLOW_new(void) {
+
+  PFlow* pf = (PFlow*)malloc(sizeof(PFlow));
+
+  // Error
+  pf->error_flag = FALSE;
+  strcpy(pf->error_string,"");
+
+  // Options
+  pf->tol = PFLOW_TOL;
+  pf->max_iters = PFLOW_MAX_ITERS;
+  pf->pvpq = TRUE;
+  pf->line_search = TRUE;
+  pf->method = PFLOW_METHOD_NR;
+
+  // Results
+  pf->converged = FALSE;
+  pf->num_iters = 0;
+  pf->time = 0;
+  pf->iter_mismatch = NULL;
+  pf->iter_step = NULL;
+  pf->iter_time = NULL;
+
+  // Factorizations
+  pf->lu = SPLU_new();
+  pf->lu_Bp = SPLU_new();
+  pf->lu_Bpp = SPLU_new();
+
+  return pf;
+}
+
+void PFLOW_set_line_search(PFlow* pf, BOOL flag) {
+  if (pf)
+    pf->line_search = flag;
+}
+
+void PFLOW_set_max_iters(PFlow* pf, int max_iters) {
+  if (pf && max_iters >= 0)
+    pf->max_iters = max_iters;
+}
+
+void PFLOW_set_method(PFlow* pf, char method) {
+  if (pf && (method == PFLOW_METHOD_NR || method == PFLOW_METHOD_FDXB || method == PFLOW_METHOD_FDBX))
+    pf->method = method;
+}
+
+void PFLOW_set_pvpq(PFlow* pf, BOOL flag) {
+  if (pf)
+    pf->pvpq = flag;
+}
+
+void PFLOW_set_tol(PFlow* pf, REAL tol) {
+  if (pf && tol > 0)
+    pf->tol = tol;
+}
+
+void PFLOW_solve(PFlow* pf, Net* net) {
+  /* This function solves the AC power flow equations of the network with
+     the selected method. The variables are the voltage magnitudes, the
+     non-slack voltage angles, the active powers of slack generators and the
+     reactive powers of regulating generators, and the voltage magnitudes of
+     buses regulated by generators are kept at their set points. The flags
+     of the network are replaced by these. The solution is stored in the
+     network. */
+
+  // Local variables
+  REAL start;
+
+  // Check
+  if (!pf || !net)
+    return;
+
+  // Results
+  start = PFLOW_WTIME();
+  pf->converged = FALSE;
+  pf->num_iters = 0;
+  pf->time = 0;
+  pf->iter_mismatch = (REAL*)realloc(pf->iter_mismatch,(pf->max_iters+1)*sizeof(REAL));
+  pf->iter_step = (REAL*)realloc(pf->iter_step,(pf->max_iters+1)*sizeof(REAL));
+  pf->iter_time = (REAL*)realloc(pf->iter_time,(pf->max_iters+1)*sizeof(REAL));
+  pf->iter_mismatch[0] = 0;
+
+  // Variables
+  NET_clear_flags(net);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_NOT_SLACK,BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_SLACK,GEN_VAR_P);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_REG,GEN_VAR_Q);
+  NET_set_flags(net,OBJ_BUS,FLAG_FIXED,BUS_PROP_REG_BY_GEN,BUS_VAR_VMAG);
+
+  // Solve
+  if (pf->method == PFLOW_METHOD_NR)
+    PFLOW_solve_NR(pf,net);
+  else
+    PFLOW_solve_FD(pf,net);
+
+  // Time
+  pf->time = PFLOW_WTIME()-start;
+}
+
+void PFLOW_solve_NR(PFlow* pf, Net* net) {
+  /* This function runs the Newton-Raphson iterations of PFLOW_solve. The
+     Newton matrix [A;J] keeps the same pattern for the whole solve, even
+     when buses switch between PV and PQ, so its factorization is only
+     recomputed numerically after the first iteration, and its ordering is
+     kept for later solves of networks with the same structure. */
+
+  // Local variables
+  Prob* p;
+  Mat* A;
+  Mat* J;
+  Mat* M;
+  SpMat* S;
+  Vec* x;
+  Vec* x_trial;
+  Vec* dx;
+  Vec* r;
+  REAL* Md;
+  REAL norm;
+  REAL norm_trial;
+  REAL mis;
+  REAL alpha;
+  REAL iter_start;
+  int nnz_A;
+  int n;
+  int i;
+  int k;
+  int l;
+
+  // Check
+  if (!pf || !net)
+    return;
+
+  // Problem
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_FIX_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_P_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_Q_new(net));
+  if (pf->pvpq)
+    PROB_add_heur(p,HEUR_TYPE_PVPQ);
+  PROB_analyze(p);
+  if (PROB_has_error(p)) {
+    strcpy(pf->error_string,PROB_get_error_string(p));
+    pf->error_flag = TRUE;
+  }
+
+  // Newton matrix pattern
+  A = PROB_get_A(p);
+  J = PROB_get_J(p);
+  n = PROB_get_num_primal_variables(p);
+  nnz_A = MAT_get_nnz(A);
+  if (!pf->error_flag && n != MAT_get_size1(A)+MAT_get_size1(J)) {
+    sprintf(pf->error_string,"power flow system is not square");
+    pf->error_flag = TRUE;
+  }
+  M = MAT_new(n,n,nnz_A+MAT_get_nnz(J));
+  Md = MAT_get_data_array(M);
+  for (k = 0; k < nnz_A; k++) {
+    MAT_set_i(M,k,MAT_get_i(A,k));
+    MAT_set_j(M,k,MAT_get_j(A,k));
+  }
+  for (k = 0; k < MAT_get_nnz(J); k++) {
+    MAT_set_i(M,nnz_A+k,MAT_get_size1(A)+MAT_get_i(J,k));
+    MAT_set_j(M,nnz_A+k,MAT_get_j(J,k));
+  }
+  S = NULL;
+
+  // Vectors
+  x = PROB_get_init_point(p);
+  x_trial = VEC_new(n);
+  dx = VEC_new(n);
+  r = VEC_new(n);
+
+  // Iterations
+  for (k = 0; !pf->error_flag; k++) {
+
+    iter_start = PFLOW_WTIME();
+
+    // PV-PQ switching (updates A, b and x, uses f at x)
+    if (pf->pvpq) {
+      if (k == 0 || !pf->line_search)
+	PROB_eval_f(p,x);
+      PROB_apply_heuristics(p,x);
+    }
+
+    // Residual and Jacobian
+    PROB_eval_fJ(p,x);
+    PFLOW_eval_residual(p,x,r);
+    mis = 0;
+    norm = 0;
+    for (i = 0; i < n; i++) {
+      mis = fabs(VEC_get(r,i)) > mis ? fabs(VEC_get(r,i)) : mis;
+      norm += VEC_get(r,i)*VEC_get(r,i);
+    }
+    norm = sqrt(norm);
+    pf->iter_mismatch[k] = mis;
+
+    // Done
+    if (mis < pf->tol) {
+      pf->converged = TRUE;
+      break;
+    }
+    if (k >= pf->max_iters)
+      break;
+
+    // Newton matrix
+    J = PROB_get_J(p);
+    for (l = 0; l < nnz_A; l++)
+      Md[l] = MAT_get_d(A,l);
+    for (l = 0; l < MAT_get_nnz(J); l++)
+      Md[nnz_A+l] = MAT_get_d(J,l);
+    if (!S)
+      S = SPMAT_new_from_mat(M,SPMAT_CSC);
+    else
+      SPMAT_update(S,M);
+    SPLU_refactorize(pf->lu,S);
+    if (SPLU_has_error(pf->lu)) {
+      sprintf(pf->error_string,"Newton matrix factorization failed (%s)",SPLU_get_error_string(pf->lu));
+      SPLU_clear_error(pf->lu);
+      pf->error_flag = TRUE;
+      break;
+    }
+
+    // Newton step
+    for (i = 0; i < n; i++)
+      VEC_set(dx,i,-VEC_get(r,i));
+    SPLU_solve(pf->lu,dx);
+
+    // Line search
+    alpha = 1.;
+    for (l = 0; pf->line_search && l < PFLOW_LS_MAX_STEPS; l++) {
+      for (i = 0; i < n; i++)
+	VEC_set(x_trial,i,VEC_get(x,i)+alpha*VEC_get(dx,i));
+      PROB_eval_f(p,x_trial);
+      PFLOW_eval_residual(p,x_trial,r);
+      norm_trial = 0;
+      for (i = 0; i < n; i++)
+	norm_trial += VEC_get(r,i)*VEC_get(r,i);
+      norm_trial = sqrt(norm_trial);
+      if (norm_trial <= (1.-PFLOW_LS_DECREASE*alpha)*norm || l == PFLOW_LS_MAX_STEPS-1)
+	break;
+      alpha *= 0.5;
+    }
+
+    // Step
+    for (i = 0; i < n; i++)
+      VEC_add_to_entry(x,i,alpha*VEC_get(dx,i));
+    pf->iter_step[k] = alpha;
+    pf->iter_time[k] = PFLOW_WTIME()-iter_start;
+    pf->num_iters = k+1;
+  }
+
+  // Solution
+  if (!pf->error_flag) {
+    NET_set_var_values(net,x);
+    NET_update_properties(net,x);
+  }
+
+  // Clean up
+  VEC_del(x);
+  VEC_del(x_trial);
+  VEC_del(dx);
+  VEC_del(r);
+  MAT_del(M);
+  SPMAT_del(S);
+  PROB_del(p);
+}
+
+void PFLOW_solve_FD(PFlow* pf, Net* net) {
+  /* This function runs the fast decoupled iterations of PFLOW_solve. The
+     matrices B' and B'' are built from the branch and shunt data and
+     factorized once, and each iteration takes a P-theta half step on the
+     non-slack voltage angles followed by a Q-V half step on the voltage
+     magnitudes of buses not regulated by generators. Only the ACPF
+     mismatches are evaluated, and the network properties are updated once
+     at the end. Branch resistances are ignored in B' by the XB variant and
+     in B'' by the BX variant. After each evaluation, the active powers of
+     slack generators and the reactive powers of regulating generators are
+     set to balance their buses, shared as in PAR_GEN_P and PAR_GEN_Q. Buses
+     do not switch between PV and PQ. */
+
+  // Local variables
+  Prob* p;
+  Constr* c;
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  Shunt* shunt;
+  Mat* B[2];
+  SpMat* S;
+  Vec* x;
+  Vec* dw;
+  Vec* dv;
+  REAL* fd;
+  int* w_pos;
+  int* v_pos;
+  int* q_pos;
+  int row[8];
+  int col[8];
+  REAL val[8];
+  int nnz[2];
+  REAL g;
+  REAL b;
+  REAL a;
+  REAL x_inv;
+  REAL s[2];
+  REAL v;
+  REAL total;
+  REAL Qmin;
+  REAL dQ;
+  REAL dQ_gen;
+  REAL mis;
+  REAL iter_start;
+  BOOL done;
+  int num_buses;
+  int num_periods;
+  int nw;
+  int nv;
+  int nq;
+  int num;
+  int bk;
+  int bm;
+  int bt;
+  int pass;
+  int e;
+  int h;
+  int i;
+  int k;
+  int t;
+
+  // Check
+  if (!pf || !net)
+    return;
+
+  // Sizes
+  num_buses = NET_get_num_buses(net);
+  num_periods = NET_get_num_periods(net);
+
+  // Problem
+  p = PROB_new(net);
+  c = CONSTR_ACPF_new(net);
+  PROB_add_constr(p,c);
+  PROB_analyze(p);
+  CONSTR_set_eval_level(c,EVAL_F);
+  if (PROB_has_error(p)) {
+    strcpy(pf->error_string,PROB_get_error_string(p));
+    pf->error_flag = TRUE;
+  }
+
+  // Positions of angles, magnitudes and reactive power equations
+  w_pos = (int*)malloc(num_buses*num_periods*sizeof(int));
+  v_pos = (int*)malloc(num_buses*num_periods*sizeof(int));
+  q_pos = (int*)malloc(num_buses*num_periods*sizeof(int));
+  nw = 0;
+  nv = 0;
+  nq = 0;
+  for (t = 0; t < num_periods; t++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      bt = i+t*num_buses;
+      w_pos[bt] = BUS_is_slack(bus) ? -1 : nw++;
+      v_pos[bt] = BUS_is_regulated_by_gen(bus) ? -1 : nv++;
+      for (gen = BUS_get_gen(bus); gen != NULL && !GEN_is_regulator(gen); gen = GEN_get_next(gen));
+      q_pos[bt] = gen ? -1 : nq++;
+      if (BUS_is_regulated_by_gen(bus)) {
+	for (gen = BUS_get_reg_gen(bus); gen != NULL; gen = GEN_get_reg_next(gen)) {
+	  if (GEN_get_bus(gen) != GEN_get_bus(BUS_get_reg_gen(bus)) && !pf->error_flag) {
+	    sprintf(pf->error_string,"generators regulating bus %d are not connected to the same bus",BUS_get_number(bus));
+	    pf->error_flag = TRUE;
+	  }
+	}
+      }
+    }
+  }
+  if (!pf->error_flag && nv != nq) {
+    sprintf(pf->error_string,"Q-V system of the fast decoupled method is not square");
+    pf->error_flag = TRUE;
+  }
+
+  // Matrices B' and B'' (counted in the first pass and filled in the second)
+  B[0] = NULL;
+  B[1] = NULL;
+  for (pass = 0; pass < 2 && !pf->error_flag; pass++) {
+    nnz[0] = 0;
+    nnz[1] = 0;
+    for (t = 0; t < num_periods; t++) {
+
+      // Branches
+      for (i = 0; i < NET_get_num_branches(net); i++) {
+	br = NET_get_branch(net,i);
+	if (BRANCH_is_on_outage(br))
+	  continue;
+	bk = BUS_get_index(BRANCH_get_bus_k(br))+t*num_buses;
+	bm = BUS_get_index(BRANCH_get_bus_m(br))+t*num_buses;
+	g = BRANCH_get_g(br);
+	b = BRANCH_get_b(br);
+	a = BRANCH_get_ratio(br,t);
+	x_inv = b != 0 ? -(g*g+b*b)/b : 0; // 1/x
+	if (pf->method == PFLOW_METHOD_FDXB) {
+	  s[0] = x_inv;
+	  s[1] = -b;
+	}
+	else {
+	  s[0] = -b;
+	  s[1] = x_inv;
+	}
+
+	// B' (no shunts, taps or phase shifts)
+	row[0] = w_pos[bk]; col[0] = w_pos[bk]; val[0] = s[0];
+	row[1] = w_pos[bm]; col[1] = w_pos[bm]; val[1] = s[0];
+	row[2] = w_pos[bk]; col[2] = w_pos[bm]; val[2] = -s[0];
+	row[3] = w_pos[bm]; col[3] = w_pos[bk]; val[3] = -s[0];
+
+	// B'' (no phase shifts)
+	row[4] = q_pos[bk]; col[4] = v_pos[bk]; val[4] = a*a*(s[1]-BRANCH_get_b_k(br));
+	row[5] = q_pos[bm]; col[5] = v_pos[bm]; val[5] = s[1]-BRANCH_get_b_m(br);
+	row[6] = q_pos[bk]; col[6] = v_pos[bm]; val[6] = -a*s[1];
+	row[7] = q_pos[bm]; col[7] = v_pos[bk]; val[7] = -a*s[1];
+
+	for (e = 0; e < 8; e++) {
+	  if (row[e] < 0 || col[e] < 0)
+	    continue;
+	  if (pass == 1) {
+	    MAT_set_i(B[e/4],nnz[e/4],row[e]);
+	    MAT_set_j(B[e/4],nnz[e/4],col[e]);
+	    MAT_set_d(B[e/4],nnz[e/4],val[e]);
+	  }
+	  nnz[e/4]++;
+	}
+      }
+
+      // Bus shunts
+      for (i = 0; i < num_buses; i++) {
+	bus = NET_get_bus(net,i);
+	bt = i+t*num_buses;
+	if (q_pos[bt] < 0 || v_pos[bt] < 0)
+	  continue;
+	for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+	  if (pass == 1) {
+	    MAT_set_i(B[1],nnz[1],q_pos[bt]);
+	    MAT_set_j(B[1],nnz[1],v_pos[bt]);
+	    MAT_set_d(B[1],nnz[1],-SHUNT_get_b(shunt,t));
+	  }
+	  nnz[1]++;
+	}
+      }
+    }
+    if (pass == 0) {
+      B[0] = MAT_new(nw,nw,nnz[0]);
+      B[1] = MAT_new(nq,nv,nnz[1]);
+    }
+  }
+
+  // Factorizations
+  for (e = 0; e < 2 && !pf->error_flag; e++) {
+    S = SPMAT_new_from_mat(B[e],SPMAT_CSC);
+    SPLU_refactorize(e == 0 ? pf->lu_Bp : pf->lu_Bpp,S);
+    if (SPLU_has_error(e == 0 ? pf->lu_Bp : pf->lu_Bpp)) {
+      sprintf(pf->error_string,"%s factorization failed (%s)",e == 0 ? "B'" : "B''",
+	      SPLU_get_error_string(e == 0 ? pf->lu_Bp : pf->lu_Bpp));
+      SPLU_clear_error(e == 0 ? pf->lu_Bp : pf->lu_Bpp);
+      pf->error_flag = TRUE;
+    }
+    SPMAT_del(S);
+  }
+
+  // Vectors
+  x = PROB_get_init_point(p);
+  dw = VEC_new(nw);
+  dv = VEC_new(nv);
+  for (t = 0; t < num_periods; t++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      if (BUS_is_regulated_by_gen(bus))
+	VEC_set(x,BUS_get_index_v_mag(bus,t),BUS_get_v_set(bus,t));
+    }
+  }
+
+  // Iterations
+  done = pf->error_flag;
+  for (k = 0; !done; k++) {
+
+    iter_start = PFLOW_WTIME();
+
+    // Half steps
+    for (h = 0; h < 2; h++) {
+
+      // Mismatches
+      CONSTR_eval(c,x,NULL);
+      fd = VEC_get_data(CONSTR_get_f(c));
+
+      // Slack and regulating generators
+      for (t = 0; t < num_periods; t++) {
+	for (i = 0; i < num_buses; i++) {
+	  bus = NET_get_bus(net,i);
+
+	  // Equal active powers
+	  if (BUS_is_slack(bus)) {
+	    bt = BUS_get_index_P(bus)+t*2*num_buses;
+	    total = -fd[bt];
+	    num = 0;
+	    for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+		total += VEC_get(x,GEN_get_index_P(gen,t));
+		num++;
+	      }
+	    }
+	    for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+		VEC_set(x,GEN_get_index_P(gen,t),total/num);
+	    }
+	    if (num > 0)
+	      fd[bt] = 0;
+	  }
+
+	  // Equal fractions of reactive power ranges
+	  if (BUS_is_regulated_by_gen(bus)) {
+	    bt = BUS_get_index_Q(GEN_get_bus(BUS_get_reg_gen(bus)))+t*2*num_buses;
+	    total = -fd[bt];
+	    Qmin = 0;
+	    dQ = 0;
+	    for (gen = BUS_get_reg_gen(bus); gen != NULL; gen = GEN_get_reg_next(gen)) {
+	      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
+		total += VEC_get(x,GEN_get_index_Q(gen,t));
+		Qmin += GEN_get_Q_min(gen);
+		dQ_gen = GEN_get_Q_max(gen)-GEN_get_Q_min(gen);
+		dQ += dQ_gen < CONSTR_PAR_GEN_Q_PARAM ? CONSTR_PAR_GEN_Q_PARAM : dQ_gen;
+	      }
+	    }
+	    for (gen = BUS_get_reg_gen(bus); gen != NULL; gen = GEN_get_reg_next(gen)) {
+	      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
+		dQ_gen = GEN_get_Q_max(gen)-GEN_get_Q_min(gen);
+		dQ_gen = dQ_gen < CONSTR_PAR_GEN_Q_PARAM ? CONSTR_PAR_GEN_Q_PARAM : dQ_gen;
+		VEC_set(x,GEN_get_index_Q(gen,t),GEN_get_Q_min(gen)+dQ_gen*(total-Qmin)/dQ);
+	      }
+	    }
+	    if (dQ > 0)
+	      fd[bt] = 0;
+	  }
+	}
+      }
+
+      // Convergence
+      if (h == 0) {
+	mis = 0;
+	for (i = 0; i < VEC_get_size(CONSTR_get_f(c)); i++)
+	  mis = fabs(fd[i]) > mis ? fabs(fd[i]) : mis;
+	pf->iter_mismatch[k] = mis;
+	if (mis < pf->tol)
+	  pf->converged = TRUE;
+	if (pf->converged || k >= pf->max_iters) {
+	  done = TRUE;
+	  break;
+	}
+      }
+
+      // Half step
+      for (t = 0; t < num_periods; t++) {
+	for (i = 0; i < num_buses; i++) {
+	  bus = NET_get_bus(net,i);
+	  bt = i+t*num_buses;
+	  v = VEC_get(x,BUS_get_index_v_mag(bus,t));
+	  if (h == 0 && w_pos[bt] >= 0)
+	    VEC_set(dw,w_pos[bt],fd[BUS_get_index_P(bus)+t*2*num_buses]/v);
+	  if (h == 1 && q_pos[bt] >= 0)
+	    VEC_set(dv,q_pos[bt],fd[BUS_get_index_Q(bus)+t*2*num_buses]/v);
+	}
+      }
+      SPLU_solve(h == 0 ? pf->lu_Bp : pf->lu_Bpp,h == 0 ? dw : dv);
+      for (t = 0; t < num_periods; t++) {
+	for (i = 0; i < num_buses; i++) {
+	  bus = NET_get_bus(net,i);
+	  bt = i+t*num_buses;
+	  if (h == 0 && w_pos[bt] >= 0)
+	    VEC_add_to_entry(x,BUS_get_index_v_ang(bus,t),VEC_get(dw,w_pos[bt]));
+	  if (h == 1 && v_pos[bt] >= 0)
+	    VEC_add_to_entry(x,BUS_get_index_v_mag(bus,t),VEC_get(dv,v_pos[bt]));
+	}
+      }
+    }
+    if (done)
+      break;
+
+    // Step
+    pf->iter_step[k] = 1.;
+    pf->iter_time[k] = PFLOW_WTIME()-iter_start;
+    pf->num_iters = k+1;
+  }
+
+  // Solution
+  if (!pf->error_flag) {
+    NET_set_var_values(net,x);
+    NET_update_properties(net,x);
+  }
+
+  // Clean up
+  free(w_pos);
+  free(v_pos);
+  free(q_pos);
+  VEC_del(x);
+  VEC_del(dw);
+  VEC_del(dv);
+  MAT_del(B[0]);
+  MAT_del(B[1]);
+  PROB_del(p);
+}
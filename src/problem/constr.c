@@ -22,12 +22,16 @@ struct Constr {
   
   // Network
   Net* net;    /**< @brief Power network */
+
+  // Memory pool
+  Pool* pool;  /**< @brief Pool of the problem that reuses the buffers of the matrices and vectors (not owned) */
   
   // Nonlinear (f(x,y) = 0)
   Vec* f;           /**< @brief Vector of nonlinear constraint violations */
   Mat* J;           /**< @brief Jacobian matrix of nonlinear constraints */
   Mat* H_array;     /**< @brief Array of Hessian matrices of nonlinear constraints */
   int H_array_size; /**< @brief Size of Hessian array */
+  int* H_ptr;       /**< @brief Offset of the entries of each Hessian in the values of H_array and in H_combined */
   Mat* H_combined;  /**< @brief Linear combination of Hessians of the nonlinear constraints */
   
   // Linear equality (A (x,y) = b)
@@ -56,14 +60,34 @@ struct Constr {
   int G_row;             /**< @brief Counter for linear inequality constraints */
   char* bus_counted;     /**< @brief Flag for processing buses */
   int bus_counted_size;  /**< @brief Size of array of flags for processing buses */
+  int* branch_J_nnz;     /**< @brief Values of J_nnz at the start of each branch and period step of the analysis */
+  int* branch_J_row;     /**< @brief Values of J_row at the start of each branch and period step of the analysis */
+  int branch_size;       /**< @brief Size of arrays of branch step counters (num_branches*num_periods+1) */
+  int* bus_J_nnz;        /**< @brief Values of J_nnz at the start of the entries of each bus and period */
+  int* bus_J_row;        /**< @brief Values of J_row at the start of the entries of each bus and period */
+  int bus_size;          /**< @brief Size of arrays of bus counters (num_buses*num_periods) */
+  char eval_level;       /**< @brief Evaluation level (EVAL_F, EVAL_FJ or EVAL_FJH) */
+
+  // Matrix-free products
+  BOOL matrix_free;      /**< @brief Flag for constraints whose evaluation steps can accumulate products */
+  char prod_type;        /**< @brief Product accumulated during evaluation (CONSTR_PROD_*) */
+  Vec* prod_coeff;       /**< @brief Coefficients of the Hessians of the constraint functions */
+  Vec* prod_in;          /**< @brief Vector multiplied by the Jacobian or combined Hessian */
+  Vec* prod_out;         /**< @brief Vector where the product is accumulated */
   
   // Type functions
   void (*func_init)(Constr* c);                                          /**< @brief Initialization function */
   void (*func_count_step)(Constr* c, Branch* br, int t);                 /**< @brief Function for counting nonzero entries */
+  void (*func_count)(Constr* c);                                         /**< @brief Function for counting nonzero entries in closed form (no sweep) */
   void (*func_allocate)(Constr* c);                                      /**< @brief Function for allocating required arrays */
   void (*func_clear)(Constr* c);                                         /**< @brief Function for clearing flags, counters, and function values */
   void (*func_analyze_step)(Constr* c, Branch* br, int t);               /**< @brief Function for analyzing sparsity pattern */
   void (*func_eval_step)(Constr* c, Branch* br, int t, Vec* v, Vec* ve); /**< @brief Function for evaluating constraint */
+  void (*func_eval_branch_step)(Constr* c, Branch* br, int t,
+				Vec* v, Vec* ve, char sides);            /**< @brief Func. for evaluating branch sides of constraint */
+  void (*func_eval_bus_step)(Constr* c, Bus* bus, int t,
+			     Vec* v, Vec* ve);                           /**< @brief Func. for evaluating bus part of constraint */
+  void (*func_clear_bus_step)(Constr* c, Bus* bus, int t);               /**< @brief Func. for clearing entries accumulated by bus and its branch sides */
   void (*func_store_sens_step)(Constr* c, Branch* br, int t,
 			       Vec* sA, Vec* sf, Vec* sGu, Vec* sGl);    /**< @brief Func. for storing sensitivities */
   void (*func_free)(Constr* c);                                          /**< @brief Function for de-allocating any data used */
@@ -92,6 +116,13 @@ void CONSTR_finalize_structure_of_Hessians(Constr* c) {
   if (!c)
     return;
 
+  // Offsets
+  free(c->H_ptr);
+  ARRAY_alloc(c->H_ptr,int,c->H_array_size+1);
+  c->H_ptr[0] = 0;
+  for (k = 0; k < c->H_array_size; k++)
+    c->H_ptr[k+1] = c->H_ptr[k]+MAT_get_nnz(MAT_array_get(c->H_array,k));
+
   // Ensure lower triangular and save struct of H comb
   H_nnz_comb = 0;
   H_array = CONSTR_get_H_array(c);
@@ -130,6 +161,25 @@ void CONSTR_clear_H_nnz(Constr* c) {
     ARRAY_clear(c->H_nnz,int,c->H_nnz_size);
 }
 
+void CONSTR_clear_data(Constr* c) {
+  /* This function zeroes the vectors and matrices of the constraint,
+     leaving them as after allocation so that they can be re-analyzed */
+  if (c) {
+    VEC_set_zero(c->f);
+    MAT_set_zero_d(c->J);
+    MAT_array_set_zero_d(c->H_array,c->H_array_size);
+    MAT_set_zero_d(c->H_combined);
+    VEC_set_zero(c->b);
+    MAT_set_zero_d(c->A);
+    VEC_set_zero(c->l);
+    VEC_set_zero(c->u);
+    MAT_set_zero_d(c->G);
+    VEC_set_zero(c->l_extra_vars);
+    VEC_set_zero(c->u_extra_vars);
+    VEC_set_zero(c->init_extra_vars);
+  }
+}
+
 void CONSTR_clear_bus_counted(Constr* c) {
   if (c)
     ARRAY_clear(c->bus_counted,char,c->bus_counted_size);
@@ -157,10 +207,24 @@ void CONSTR_combine_H(Constr* c, Vec* coeff, BOOL ensure_psd) {
     return;
   }
   
-  // Combine
-  H_nnz_comb = 0;
+  // Combine (single pass over the block of values of H_array)
   coeffd = VEC_get_data(coeff);
   Hd_comb = MAT_get_data_array(c->H_combined);
+  Hd = MAT_array_get_block_data(c->H_array,c->H_array_size);
+  if (Hd && c->H_ptr) {
+    for (k = 0; k < c->H_array_size; k++) {
+      if (ensure_psd)
+	coeffk = 0;
+      else
+	coeffk = coeffd[k];
+      for (m = c->H_ptr[k]; m < c->H_ptr[k+1]; m++)
+	Hd_comb[m] = coeffk*Hd[m];
+    }
+    return;
+  }
+
+  // Combine
+  H_nnz_comb = 0;
   for (k = 0; k < c->H_array_size; k++) {
     Hd = MAT_get_data_array(MAT_array_get(c->H_array,k));
     if (ensure_psd)
@@ -178,18 +242,19 @@ void CONSTR_del_matvec(Constr* c) {
   if (c) {
 
     // Mat and vec
-    VEC_del(c->b);
-    MAT_del(c->A);
-    VEC_del(c->f);
-    MAT_del(c->J);
-    MAT_del(c->G);
-    VEC_del(c->l);
-    VEC_del(c->u);
-    VEC_del(c->l_extra_vars);
-    VEC_del(c->u_extra_vars);
-    VEC_del(c->init_extra_vars);
-    MAT_array_del(c->H_array,c->H_array_size);
-    MAT_del(c->H_combined);
+    VEC_del_to_pool(c->pool,c->b);
+    MAT_del_to_pool(c->pool,c->A);
+    VEC_del_to_pool(c->pool,c->f);
+    MAT_del_to_pool(c->pool,c->J);
+    MAT_del_to_pool(c->pool,c->G);
+    VEC_del_to_pool(c->pool,c->l);
+    VEC_del_to_pool(c->pool,c->u);
+    VEC_del_to_pool(c->pool,c->l_extra_vars);
+    VEC_del_to_pool(c->pool,c->u_extra_vars);
+    VEC_del_to_pool(c->pool,c->init_extra_vars);
+    MAT_array_del_to_pool(c->pool,c->H_array,c->H_array_size);
+    MAT_del_to_pool(c->pool,c->H_combined);
+    free(c->H_ptr);
     c->b = NULL;
     c->A = NULL;
     c->f = NULL;
@@ -202,6 +267,7 @@ void CONSTR_del_matvec(Constr* c) {
     c->init_extra_vars = NULL;
     c->H_array = NULL;
     c->H_array_size = 0;
+    c->H_ptr = NULL;
     c->H_combined = NULL;
   }
 }
@@ -215,6 +281,14 @@ void CONSTR_del(Constr* c) {
     // Utils
     if (c->bus_counted)
       free(c->bus_counted);
+    if (c->branch_J_nnz)
+      free(c->branch_J_nnz);
+    if (c->branch_J_row)
+      free(c->branch_J_row);
+    if (c->bus_J_nnz)
+      free(c->bus_J_nnz);
+    if (c->bus_J_row)
+      free(c->bus_J_row);
     if (c->H_nnz)
       free(c->H_nnz);
 
@@ -444,6 +518,20 @@ void* CONSTR_get_data(Constr* c) {
     return NULL;
 }
 
+char CONSTR_get_product_type(Constr* c) {
+  if (c)
+    return c->prod_type;
+  else
+    return CONSTR_PROD_NONE;
+}
+
+char CONSTR_get_eval_level(Constr* c) {
+  if (c)
+    return c->eval_level;
+  else
+    return EVAL_FJH;
+}
+
 Constr* CONSTR_get_next(Constr* c) {
   if (c)
     return c->next;
@@ -517,6 +605,23 @@ void CONSTR_list_count_step(Constr* clist, Branch* br, int t) {
     CONSTR_count_step(cc,br,t);
 }
 
+void CONSTR_list_count_closed_form(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (cc->func_count && CONSTR_is_safe_to_count(cc))
+      (*(cc->func_count))(cc);
+  }
+}
+
+BOOL CONSTR_list_needs_count_sweep(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (CONSTR_needs_count_sweep(cc))
+      return TRUE;
+  }
+  return FALSE;
+}
+
 void CONSTR_list_allocate(Constr* clist) {
   Constr* cc;
   for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
@@ -529,6 +634,24 @@ void CONSTR_list_clear(Constr* clist) {
     CONSTR_clear(cc);
 }
 
+void CONSTR_list_clear_data(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
+    CONSTR_clear_data(cc);
+}
+
+void CONSTR_list_set_eval_level(Constr* clist, char level) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
+    CONSTR_set_eval_level(cc,level);
+}
+
+void CONSTR_list_clear_bus_counted(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
+    CONSTR_clear_bus_counted(cc);
+}
+
 void CONSTR_list_analyze_step(Constr* clist, Branch* br, int t) {
   Constr* cc;
   for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc))
@@ -546,10 +669,55 @@ void CONSTR_list_eval_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve) {
     else
       ve_c = NULL;
     CONSTR_eval_step(cc,br,t,v,ve_c);
+    free(ve_c);
     offset += CONSTR_get_num_extra_vars(cc);
   }
 }
 
+void CONSTR_list_eval_serial_step(Constr* clist, Branch* br, int t, Vec* v, Vec* ve) {
+  Constr* cc;
+  Vec* ve_c;
+  int offset = 0;
+  REAL* ve_data = VEC_get_data(ve);
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (!CONSTR_has_bus_branch_steps(cc)) {
+      if (offset + CONSTR_get_num_extra_vars(cc) <= VEC_get_size(ve))
+	ve_c = VEC_new_from_array(&(ve_data[offset]),CONSTR_get_num_extra_vars(cc));
+      else
+	ve_c = NULL;
+      CONSTR_eval_step(cc,br,t,v,ve_c);
+      free(ve_c);
+    }
+    offset += CONSTR_get_num_extra_vars(cc);
+  }
+}
+
+void CONSTR_list_eval_bus_step(Constr* clist, Bus* bus, int t, Vec* v, Vec* ve) {
+  Constr* cc;
+  Vec* ve_c;
+  int offset = 0;
+  REAL* ve_data = VEC_get_data(ve);
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (cc->func_eval_bus_step) {
+      if (offset + CONSTR_get_num_extra_vars(cc) <= VEC_get_size(ve))
+	ve_c = VEC_new_from_array(&(ve_data[offset]),CONSTR_get_num_extra_vars(cc));
+      else
+	ve_c = NULL;
+      CONSTR_eval_bus_step(cc,bus,t,v,ve_c);
+      free(ve_c);
+    }
+    offset += CONSTR_get_num_extra_vars(cc);
+  }
+}
+
+void CONSTR_list_sync_eval_counters(Constr* clist) {
+  Constr* cc;
+  for (cc = clist; cc != NULL; cc = CONSTR_get_next(cc)) {
+    if (CONSTR_has_bus_branch_steps(cc))
+      CONSTR_sync_eval_counters(cc);
+  }
+}
+
 void CONSTR_list_store_sens_step(Constr* clist, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
   Constr* cc;
   Vec* vA;
@@ -623,6 +791,9 @@ Constr* CONSTR_new(Net* net) {
   // Network
   c->net = net;
 
+  // Pool
+  c->pool = NULL;
+
   // Vars
   c->num_extra_vars = 0;
 
@@ -631,6 +802,7 @@ Constr* CONSTR_new(Net* net) {
   c->J = NULL;
   c->H_array = NULL;  
   c->H_array_size = 0;
+  c->H_ptr = NULL;
   c->H_combined = NULL;
   c->A = NULL;
   c->b = NULL;
@@ -648,19 +820,41 @@ Constr* CONSTR_new(Net* net) {
   c->A_row = 0;
   c->J_row = 0;
   c->G_row = 0;
+  c->eval_level = EVAL_FJH;
   c->next = NULL;
 
+  // Matrix-free products
+  c->matrix_free = FALSE;
+  c->prod_type = CONSTR_PROD_NONE;
+  c->prod_coeff = NULL;
+  c->prod_in = NULL;
+  c->prod_out = NULL;
+
   // Bus counted flags
   c->bus_counted_size = 0;
   c->bus_counted = NULL;
 
+  // Branch step counters
+  c->branch_J_nnz = NULL;
+  c->branch_J_row = NULL;
+  c->branch_size = 0;
+
+  // Bus counters
+  c->bus_J_nnz = NULL;
+  c->bus_J_row = NULL;
+  c->bus_size = 0;
+
   // Methods
   c->func_init = NULL;
   c->func_count_step = NULL;
+  c->func_count = NULL;
   c->func_allocate = NULL;
   c->func_clear = NULL;
   c->func_analyze_step = NULL;
   c->func_eval_step = NULL;
+  c->func_eval_branch_step = NULL;
+  c->func_eval_bus_step = NULL;
+  c->func_clear_bus_step = NULL;
   c->func_store_sens_step = NULL;
   c->func_free = NULL;
   
@@ -732,6 +926,8 @@ void CONSTR_set_H_array(Constr* c, Mat* array, int size) {
   if (c) {
     c->H_array = array;
     c->H_array_size = size;
+    free(c->H_ptr);
+    c->H_ptr = NULL; // set when the structure is finalized
   }  
 }
 
@@ -788,6 +984,30 @@ void CONSTR_set_bus_counted(Constr* c, char* counted, int size) {
   }
 }
 
+void CONSTR_set_eval_level(Constr* c, char level) {
+  if (c)
+    c->eval_level = level;
+}
+
+void CONSTR_set_matrix_free(Constr* c, BOOL flag) {
+  if (c)
+    c->matrix_free = flag;
+}
+
+void CONSTR_set_product(Constr* c, char type, Vec* coeff, Vec* in, Vec* out) {
+  /* This function sets the product that the evaluation steps of a
+     matrix-free constraint accumulate in out instead of storing J
+     or the Hessians. Rows are those of f and columns those of J
+     (network variables followed by the extra variables of the
+     constraint). Type CONSTR_PROD_NONE goes back to storing them. */
+  if (c) {
+    c->prod_type = type;
+    c->prod_coeff = coeff;
+    c->prod_in = in;
+    c->prod_out = out;
+  }
+}
+
 void CONSTR_set_data(Constr* c, void* data) {
   if (c)
     c->data = data;
@@ -805,6 +1025,12 @@ void CONSTR_count(Constr* c) {
   int t;
   Net* net = CONSTR_get_network(c);
   CONSTR_clear(c);
+  CONSTR_clear_bus_counted(c);
+  if (c && c->func_count) {
+    if (CONSTR_is_safe_to_count(c))
+      (*(c->func_count))(c);
+    return;
+  }
   for (t = 0; t < NET_get_num_periods(net); t++) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_count_step(c,NET_get_branch(net,i),t);
@@ -812,10 +1038,17 @@ void CONSTR_count(Constr* c) {
 }
 
 void CONSTR_count_step(Constr* c, Branch* br, int t) {
-  if (c && c->func_count_step && CONSTR_is_safe_to_count(c))
+  if (c && c->func_count_step && !c->func_count && CONSTR_is_safe_to_count(c))
     (*(c->func_count_step))(c,br,t);
 }
 
+BOOL CONSTR_needs_count_sweep(Constr* c) {
+  if (c)
+    return (c->func_count_step && !c->func_count);
+  else
+    return FALSE;
+}
+
 void CONSTR_allocate(Constr* c) {
   if (c && c->func_allocate && CONSTR_is_safe_to_count(c)) {
     CONSTR_del_matvec(c);
@@ -833,6 +1066,7 @@ void CONSTR_analyze(Constr* c) {
   int t;
   Net* net = CONSTR_get_network(c);
   CONSTR_clear(c);
+  CONSTR_clear_bus_counted(c);
   for (t = 0; t < NET_get_num_periods(net); t++) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_analyze_step(c,NET_get_branch(net,i),t);
@@ -841,8 +1075,27 @@ void CONSTR_analyze(Constr* c) {
 }
 
 void CONSTR_analyze_step(Constr* c, Branch* br, int t) {
-  if (c && c->func_analyze_step && CONSTR_is_safe_to_analyze(c))
+
+  // Local variables
+  int s;
+
+  if (c && c->func_analyze_step && CONSTR_is_safe_to_analyze(c)) {
+
+    // Counters at start of step
+    s = t*NET_get_num_branches(c->net)+BRANCH_get_index(br);
+    if (s+1 < c->branch_size) {
+      c->branch_J_nnz[s] = c->J_nnz;
+      c->branch_J_row[s] = c->J_row;
+    }
+
     (*(c->func_analyze_step))(c,br,t);
+
+    // Counters at end of step
+    if (s+1 < c->branch_size) {
+      c->branch_J_nnz[s+1] = c->J_nnz;
+      c->branch_J_row[s+1] = c->J_row;
+    }
+  }
 }
 
 void CONSTR_eval(Constr* c, Vec* v, Vec* ve) {
@@ -851,14 +1104,200 @@ void CONSTR_eval(Constr* c, Vec* v, Vec* ve) {
   Net* net = CONSTR_get_network(c);
   CONSTR_clear(c);
   for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      if (!BUS_is_isolated(NET_get_bus(net,i)))
+	CONSTR_eval_bus_step(c,NET_get_bus(net,i),t,v,ve);
+    }
     for (i = 0; i < NET_get_num_branches(net); i++)
       CONSTR_eval_step(c,NET_get_branch(net,i),t,v,ve);
   }
+  if (CONSTR_has_bus_branch_steps(c))
+    CONSTR_sync_eval_counters(c);
 }
 
 void CONSTR_eval_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve) {
   if (c && c->func_eval_step && CONSTR_is_safe_to_eval(c,v,ve))
     (*(c->func_eval_step))(c,br,t,v,ve);
+  else if (c && c->func_eval_branch_step && CONSTR_is_safe_to_eval(c,v,ve))
+    (*(c->func_eval_branch_step))(c,br,t,v,ve,CONSTR_SIDE_BOTH);
+}
+
+void CONSTR_eval_branch_step(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides) {
+  if (c && c->func_eval_branch_step && CONSTR_is_safe_to_eval(c,v,ve))
+    (*(c->func_eval_branch_step))(c,br,t,v,ve,sides);
+}
+
+void CONSTR_eval_bus_step(Constr* c, Bus* bus, int t, Vec* v, Vec* ve) {
+  if (c && c->func_eval_bus_step && CONSTR_is_safe_to_eval(c,v,ve))
+    (*(c->func_eval_bus_step))(c,bus,t,v,ve);
+}
+
+void CONSTR_clear_bus_step(Constr* c, Bus* bus, int t) {
+  if (c && c->func_clear_bus_step)
+    (*(c->func_clear_bus_step))(c,bus,t);
+}
+
+BOOL CONSTR_is_matrix_free(Constr* c) {
+  if (c)
+    return c->matrix_free;
+  else
+    return FALSE;
+}
+
+void CONSTR_add_J_product(Constr* c, int row, int col, REAL d) {
+  /* This function adds the contribution of the Jacobian entry (row,col)
+     with value d to the product being accumulated. */
+
+  // Check
+  if (!c)
+    return;
+
+  // Add
+  if (c->prod_type == CONSTR_PROD_JV)
+    VEC_get_data(c->prod_out)[row] += d*VEC_get_data(c->prod_in)[col];
+  else if (c->prod_type == CONSTR_PROD_JTW)
+    VEC_get_data(c->prod_out)[col] += d*VEC_get_data(c->prod_in)[row];
+}
+
+void CONSTR_add_H_product(Constr* c, int row, int i, int j, REAL d) {
+  /* This function adds the contribution of the entry (i,j) with value d
+     of the Hessian of f[row] to the product being accumulated. Entries
+     off the diagonal stand for both (i,j) and (j,i), as in H_array. */
+
+  // Local variables
+  REAL* in;
+  REAL* out;
+
+  // Check
+  if (!c || c->prod_type != CONSTR_PROD_HV)
+    return;
+
+  // Add
+  in = VEC_get_data(c->prod_in);
+  out = VEC_get_data(c->prod_out);
+  d *= VEC_get_data(c->prod_coeff)[row];
+  out[i] += d*in[j];
+  if (i != j)
+    out[j] += d*in[i];
+}
+
+void CONSTR_eval_stored_product(Constr* c) {
+  /* This function accumulates the product set with CONSTR_set_product
+     using the stored values of J or of the Hessians in H_array, for
+     constraints that evaluate them instead of the product. */
+
+  // Local variables
+  Mat* H;
+  int* row;
+  int* col;
+  REAL* d;
+  int nnz;
+  int k;
+  int m;
+
+  // Check
+  if (!c)
+    return;
+
+  // J
+  if (c->prod_type == CONSTR_PROD_JV || c->prod_type == CONSTR_PROD_JTW) {
+    row = MAT_get_row_array(c->J);
+    col = MAT_get_col_array(c->J);
+    d = MAT_get_data_array(c->J);
+    nnz = MAT_get_nnz(c->J);
+    for (k = 0; k < nnz; k++)
+      CONSTR_add_J_product(c,row[k],col[k],d[k]);
+  }
+
+  // H
+  else if (c->prod_type == CONSTR_PROD_HV) {
+    for (k = 0; k < c->H_array_size; k++) {
+      H = MAT_array_get(c->H_array,k);
+      row = MAT_get_row_array(H);
+      col = MAT_get_col_array(H);
+      d = MAT_get_data_array(H);
+      nnz = MAT_get_nnz(H);
+      for (m = 0; m < nnz; m++)
+	CONSTR_add_H_product(c,k,row[m],col[m],d[m]);
+    }
+  }
+}
+
+BOOL CONSTR_has_clear_bus_step(Constr* c) {
+  if (c)
+    return (CONSTR_has_bus_branch_steps(c) && c->func_clear_bus_step != NULL);
+  else
+    return FALSE;
+}
+
+BOOL CONSTR_has_bus_branch_steps(Constr* c) {
+  if (c)
+    return (c->func_eval_step == NULL &&
+	    (c->func_eval_branch_step != NULL || c->func_eval_bus_step != NULL));
+  else
+    return FALSE;
+}
+
+int CONSTR_get_branch_J_nnz(Constr* c, Branch* br, int t) {
+  int s;
+  if (!c)
+    return 0;
+  s = t*NET_get_num_branches(c->net)+BRANCH_get_index(br);
+  if (0 <= s && s < c->branch_size)
+    return c->branch_J_nnz[s];
+  else
+    return 0;
+}
+
+int CONSTR_get_branch_J_row(Constr* c, Branch* br, int t) {
+  int s;
+  if (!c)
+    return 0;
+  s = t*NET_get_num_branches(c->net)+BRANCH_get_index(br);
+  if (0 <= s && s < c->branch_size)
+    return c->branch_J_row[s];
+  else
+    return 0;
+}
+
+void CONSTR_save_bus_counters(Constr* c, Bus* bus, int t) {
+  int s;
+  if (!c)
+    return;
+  s = t*NET_get_num_buses(c->net)+BUS_get_index(bus);
+  if (0 <= s && s < c->bus_size) {
+    c->bus_J_nnz[s] = c->J_nnz;
+    c->bus_J_row[s] = c->J_row;
+  }
+}
+
+int CONSTR_get_bus_J_nnz(Constr* c, Bus* bus, int t) {
+  int s;
+  if (!c)
+    return 0;
+  s = t*NET_get_num_buses(c->net)+BUS_get_index(bus);
+  if (0 <= s && s < c->bus_size)
+    return c->bus_J_nnz[s];
+  else
+    return 0;
+}
+
+int CONSTR_get_bus_J_row(Constr* c, Bus* bus, int t) {
+  int s;
+  if (!c)
+    return 0;
+  s = t*NET_get_num_buses(c->net)+BUS_get_index(bus);
+  if (0 <= s && s < c->bus_size)
+    return c->bus_J_row[s];
+  else
+    return 0;
+}
+
+void CONSTR_sync_eval_counters(Constr* c) {
+  if (c && c->branch_size > 0) {
+    c->J_nnz = c->branch_J_nnz[c->branch_size-1];
+    c->J_row = c->branch_J_row[c->branch_size-1];
+  }
 }
 
 void CONSTR_store_sens(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
@@ -884,6 +1323,7 @@ void CONSTR_store_sens(Constr* c, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Clear
   CONSTR_clear(c);
+  CONSTR_clear_bus_counted(c);
 
   // Store sensitivities
   for (t = 0; t < NET_get_num_periods(net); t++) {
@@ -984,6 +1424,24 @@ void CONSTR_update_network(Constr* c) {
   c->bus_counted_size = NET_get_num_buses(c->net)*NET_get_num_periods(c->net);
   ARRAY_zalloc(c->bus_counted,char,c->bus_counted_size);
 
+  // Branch step counters
+  if (c->branch_J_nnz)
+    free(c->branch_J_nnz);
+  if (c->branch_J_row)
+    free(c->branch_J_row);
+  c->branch_size = NET_get_num_branches(c->net)*NET_get_num_periods(c->net)+1;
+  ARRAY_zalloc(c->branch_J_nnz,int,c->branch_size);
+  ARRAY_zalloc(c->branch_J_row,int,c->branch_size);
+
+  // Bus counters
+  if (c->bus_J_nnz)
+    free(c->bus_J_nnz);
+  if (c->bus_J_row)
+    free(c->bus_J_row);
+  c->bus_size = NET_get_num_buses(c->net)*NET_get_num_periods(c->net);
+  ARRAY_zalloc(c->bus_J_nnz,int,c->bus_size);
+  ARRAY_zalloc(c->bus_J_row,int,c->bus_size);
+
   // Init
   CONSTR_init(c);
 }
@@ -1002,6 +1460,18 @@ Net* CONSTR_get_network(Constr* c) {
     return NULL;
 }
 
+Pool* CONSTR_get_pool(Constr* c) {
+  if (c)
+    return c->pool;
+  else
+    return NULL;
+}
+
+void CONSTR_set_pool(Constr* c, Pool* pool) {
+  if (c)
+    c->pool = pool;
+}
+
 void CONSTR_set_func_init(Constr* c, void (*func)(Constr* c)) {
   if (c)
     c->func_init = func;
@@ -1012,6 +1482,11 @@ void CONSTR_set_func_count_step(Constr* c, void (*func)(Constr* c, Branch* br, i
     c->func_count_step = func;
 }
 
+void CONSTR_set_func_count(Constr* c, void (*func)(Constr* c)) {
+  if (c)
+    c->func_count = func;
+}
+
 void CONSTR_set_func_allocate(Constr* c, void (*func)(Constr* c)) {
   if (c)
     c->func_allocate = func;
@@ -1032,6 +1507,21 @@ void CONSTR_set_func_eval_step(Constr* c, void (*func)(Constr* c, Branch* br, in
     c->func_eval_step = func;
 }
 
+void CONSTR_set_func_eval_branch_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* v, Vec* ve, char sides)) {
+  if (c)
+    c->func_eval_branch_step = func;
+}
+
+void CONSTR_set_func_eval_bus_step(Constr* c, void (*func)(Constr* c, Bus* bus, int t, Vec* v, Vec* ve)) {
+  if (c)
+    c->func_eval_bus_step = func;
+}
+
+void CONSTR_set_func_clear_bus_step(Constr* c, void (*func)(Constr* c, Bus* bus, int t)) {
+  if (c)
+    c->func_clear_bus_step = func;
+}
+
 void CONSTR_set_func_store_sens_step(Constr* c, void (*func)(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl)) {
   if (c)
     c->func_store_sens_step = func;
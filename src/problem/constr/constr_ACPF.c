@@ -25,6 +25,10 @@ struct Constr_ACPF_Data {
   int* dwdw_indices;
   int* dwdv_indices;
   int* dvdv_indices;
+
+  // Hessian counters at start of bus and branch side entries
+  int* bus_H_nnz;
+  int* side_H_nnz;
 };
 
 Constr* CONSTR_ACPF_new(Net* net) {
@@ -34,9 +38,12 @@ Constr* CONSTR_ACPF_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_ACPF_allocate);
   CONSTR_set_func_clear(c, &CONSTR_ACPF_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_ACPF_analyze_step);
-  CONSTR_set_func_eval_step(c, &CONSTR_ACPF_eval_step);
+  CONSTR_set_func_eval_branch_step(c, &CONSTR_ACPF_eval_branch_step);
+  CONSTR_set_func_eval_bus_step(c, &CONSTR_ACPF_eval_bus_step);
+  CONSTR_set_func_clear_bus_step(c, &CONSTR_ACPF_clear_bus_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_ACPF_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_ACPF_free);
+  CONSTR_set_matrix_free(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -46,12 +53,14 @@ void CONSTR_ACPF_init(Constr* c) {
   // Local variables
   Net* net;
   int num_buses;
+  int num_branches;
   int num_periods;
   Constr_ACPF_Data* data;
 
   // Init
   net = CONSTR_get_network(c);
   num_buses = NET_get_num_buses(net);
+  num_branches = NET_get_num_branches(net);
   num_periods = NET_get_num_periods(net);
   CONSTR_set_H_nnz(c,(int*)calloc(num_buses*num_periods,sizeof(int)),num_buses*num_periods);
   data = (Constr_ACPF_Data*)malloc(sizeof(Constr_ACPF_Data));
@@ -63,6 +72,8 @@ void CONSTR_ACPF_init(Constr* c) {
   ARRAY_zalloc(data->dwdw_indices,int,num_buses*num_periods);
   ARRAY_zalloc(data->dwdv_indices,int,num_buses*num_periods);
   ARRAY_zalloc(data->dvdv_indices,int,num_buses*num_periods);
+  ARRAY_zalloc(data->bus_H_nnz,int,num_buses*num_periods);
+  ARRAY_zalloc(data->side_H_nnz,int,2*num_branches*num_periods);
   CONSTR_set_name(c,"AC power balance");
   CONSTR_set_data(c,(void*)data);
 }
@@ -73,17 +84,16 @@ void CONSTR_ACPF_clear(Constr* c) {
   VEC_set_zero(CONSTR_get_f(c));
 
   // J
-  MAT_set_zero_d(CONSTR_get_J(c));
+  if (CONSTR_get_eval_level(c) >= EVAL_FJ)
+    MAT_set_zero_d(CONSTR_get_J(c));
 
   // H
-  MAT_array_set_zero_d(CONSTR_get_H_array(c),CONSTR_get_H_array_size(c));
+  if (CONSTR_get_eval_level(c) >= EVAL_FJH)
+    MAT_array_set_zero_d(CONSTR_get_H_array(c),CONSTR_get_H_array_size(c));
 
   // Counters
   CONSTR_set_J_nnz(c,0);
   CONSTR_clear_H_nnz(c);
-  
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_ACPF_count_step(Constr* c, Branch* br, int t) {
@@ -405,15 +415,15 @@ void CONSTR_ACPF_allocate(Constr* c) {
   int P_index;
   int Q_index;
   Mat* H_array;
-  Mat* HP;
-  Mat* HQ;
-  int* row;
-  int* col;
+  int* nnz;
+  int* pattern;
   int i;
   int t;
   int H_comb_nnz;
   int bus_index_t;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   net = CONSTR_get_network(c);
   num_buses = NET_get_num_buses(net);
   num_periods = NET_get_num_periods(net);
@@ -423,63 +433,47 @@ void CONSTR_ACPF_allocate(Constr* c) {
   H_nnz = CONSTR_get_H_nnz(c);
 
   // A b
-  CONSTR_set_A(c,MAT_new(0,num_vars,0));
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // G l u
-  CONSTR_set_G(c,MAT_new(0,num_vars,0));
-  CONSTR_set_l(c,VEC_new(0));
-  CONSTR_set_u(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
 
   // f
-  CONSTR_set_f(c,VEC_new(num_constr));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,num_constr));
 
   // J
-  CONSTR_set_J(c,MAT_new(num_constr,  // size1 (rows)
-			 num_vars,    // size2 (cols)
-			 J_nnz));  // nnz
+  CONSTR_set_J(c,MAT_new_from_pool(pool,num_constr,  // size1 (rows)
+					 num_vars,    // size2 (cols)
+					 J_nnz));  // nnz
 
-  // H array
+  // H array (Hessians of P and Q mismatches of a bus share their structure)
   H_comb_nnz = 0;
-  H_array = MAT_array_new(num_constr);
-  CONSTR_set_H_array(c,H_array,num_constr);
+  ARRAY_alloc(nnz,int,num_constr);
+  ARRAY_alloc(pattern,int,num_constr);
   for (t = 0; t < num_periods; t++) {
     for (i = 0; i < num_buses; i++) {
       bus_index_t = i+t*num_buses;
       P_index = BUS_get_index_P(NET_get_bus(net,i))+t*2*num_buses;
       Q_index = BUS_get_index_Q(NET_get_bus(net,i))+t*2*num_buses;
-      HP = MAT_array_get(H_array,P_index);
-      HQ = MAT_array_get(H_array,Q_index);
-      MAT_set_nnz(HP,H_nnz[bus_index_t]);
-      MAT_set_nnz(HQ,H_nnz[bus_index_t]);
-      MAT_set_size1(HP,num_vars);
-      MAT_set_size1(HQ,num_vars);
-      MAT_set_size2(HP,num_vars);
-      MAT_set_size2(HQ,num_vars);
-
-      MAT_set_owns_rowcol(HP,TRUE);
-      MAT_set_owns_rowcol(HQ,FALSE);
-
-      ARRAY_zalloc(row,int,H_nnz[bus_index_t]);
-      ARRAY_zalloc(col,int,H_nnz[bus_index_t]);
-
-      MAT_set_row_array(HP,row); // same row array
-      MAT_set_row_array(HQ,row);
-
-      MAT_set_col_array(HP,col); // same col array
-      MAT_set_col_array(HQ,col);
-
-      MAT_set_data_array(HP,(REAL*)malloc(H_nnz[bus_index_t]*sizeof(REAL))); // different data array
-      MAT_set_data_array(HQ,(REAL*)malloc(H_nnz[bus_index_t]*sizeof(REAL)));
-
+      nnz[P_index] = H_nnz[bus_index_t];
+      nnz[Q_index] = H_nnz[bus_index_t];
+      pattern[P_index] = P_index;
+      pattern[Q_index] = P_index;
       H_comb_nnz += 2*H_nnz[bus_index_t];
     }
   }
+  H_array = MAT_array_new_block_from_pool(pool,num_constr,num_vars,num_vars,nnz,pattern);
+  CONSTR_set_H_array(c,H_array,num_constr);
+  free(nnz);
+  free(pattern);
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars,     // size1 (rows)
-				  num_vars,     // size2 (cols)
-				  H_comb_nnz)); // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars,     // size1 (rows)
+						  num_vars,     // size2 (cols)
+						  H_comb_nnz)); // nnz
 }
 
 void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
@@ -509,12 +503,15 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
   BOOL var_phi;
   int a_index;
   int phi_index;
+  Constr_ACPF_Data* data;
   int k;
   int m;
   int num_buses;
+  int num_branches;
 
-  // Num buses
+  // Num buses and branches
   num_buses = NET_get_num_buses(CONSTR_get_network(c));
+  num_branches = NET_get_num_branches(CONSTR_get_network(c));
 
   // Constr data
   J = CONSTR_get_J(c);
@@ -522,9 +519,10 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
   J_nnz = CONSTR_get_J_nnz_ptr(c);
   H_nnz = CONSTR_get_H_nnz(c);
   bus_counted = CONSTR_get_bus_counted(c);
+  data = (Constr_ACPF_Data*)CONSTR_get_data(c);
 
   // Check pointers
-  if (!J_nnz || !H_nnz || !H_array || !bus_counted)
+  if (!J_nnz || !H_nnz || !H_array || !bus_counted || !data)
     return;
 
   // Check outage
@@ -561,6 +559,9 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
     else
       m = 0;
 
+    // H offset
+    data->side_H_nnz[2*(BRANCH_get_index(br)+t*num_branches)+k] = H_nnz[bus_index_t[k]];
+
     //***********
     if (var_w[k]) { // wk var
 
@@ -740,6 +741,10 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
 
     if (!bus_counted[bus_index_t[k]]) {
 
+      // Offsets
+      CONSTR_save_bus_counters(c,bus[k],t);
+      data->bus_H_nnz[bus_index_t[k]] = H_nnz[bus_index_t[k]];
+
       //***********
       if (var_w[k]) { // wk var
 
@@ -896,30 +901,29 @@ void CONSTR_ACPF_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
+void CONSTR_ACPF_eval_branch_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra, char sides) {
 
   // Local variables
   Bus* bus[2];
-  Gen* gen;
-  Vargen* vargen;
-  Load* load;
-  Bat* bat;
-  Shunt* shunt;
   REAL* f;
   REAL* J;
-  int* J_nnz;
+  int J_nnz_val;
   int* H_nnz;
   int H_nnz_val;
-  char* bus_counted;
   Mat* H_array;
   REAL* HP[2];
   REAL* HQ[2];
 
   int bus_index_t[2];
+  int side_index_t[2];
   BOOL var_v[2];
   BOOL var_w[2];
   int P_index[2];
   int Q_index[2];
+  int w_index[2];
+  int v_index[2];
+  int a_index;
+  int phi_index;
 
   REAL w[2];
   REAL v[2];
@@ -943,12 +947,6 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   REAL Q_km[2];
   REAL Q_kk[2];
 
-  REAL P;
-  REAL Q;
-
-  REAL shunt_b;
-  REAL shunt_g;
-
   Constr_ACPF_Data* data;
 
   int k;
@@ -958,23 +956,32 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   REAL indicator_phi;
 
   int num_buses;
+  int num_branches;
 
-  // Num buses
+  BOOL eval_J;
+  BOOL eval_H;
+  char prod;
+
+  // Num buses and branches
   num_buses = NET_get_num_buses(CONSTR_get_network(c));
+  num_branches = NET_get_num_branches(CONSTR_get_network(c));
 
   // Constr data
   f = VEC_get_data(CONSTR_get_f(c));
   J = MAT_get_data_array(CONSTR_get_J(c));
   H_array = CONSTR_get_H_array(c);
-  J_nnz = CONSTR_get_J_nnz_ptr(c);
   H_nnz = CONSTR_get_H_nnz(c);
-  bus_counted = CONSTR_get_bus_counted(c);
   data = (Constr_ACPF_Data*)CONSTR_get_data(c);
 
   // Check pointers
-  if (!f || !J || !J_nnz || !H_nnz || !bus_counted || !data)
+  if (!f || !J || !H_nnz || !data)
     return;
 
+  // Level
+  eval_J = CONSTR_get_eval_level(c) >= EVAL_FJ;
+  eval_H = CONSTR_get_eval_level(c) >= EVAL_FJH;
+  prod = CONSTR_get_product_type(c);
+
   // Check outage
   if (BRANCH_is_on_outage(br))
     return;
@@ -984,18 +991,21 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   bus[1] = BRANCH_get_bus_m(br);
   for (k = 0; k < 2; k++) {
     bus_index_t[k] = BUS_get_index(bus[k])+t*num_buses;
+    side_index_t[k] = 2*(BRANCH_get_index(br)+t*num_branches)+k;
     P_index[k] = BUS_get_index_P(bus[k])+t*2*num_buses; // index in f for active power mismatch
     Q_index[k] = BUS_get_index_Q(bus[k])+t*2*num_buses; // index in f for reactive power mismatch
     var_w[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG);
     var_v[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG);
     HP[k] = MAT_get_data_array(MAT_array_get(H_array,P_index[k]));
     HQ[k] = MAT_get_data_array(MAT_array_get(H_array,Q_index[k]));
+    w_index[k] = BUS_get_index_v_ang(bus[k],t);
+    v_index[k] = BUS_get_index_v_mag(bus[k],t);
     if (var_w[k])
-      w[k] = VEC_get(values,BUS_get_index_v_ang(bus[k],t));
+      w[k] = VEC_get(values,w_index[k]);
     else
       w[k] = BUS_get_v_ang(bus[k],t);
     if (var_v[k])
-      v[k] = VEC_get(values,BUS_get_index_v_mag(bus[k],t));
+      v[k] = VEC_get(values,v_index[k]);
     else
       v[k] = BUS_get_v_mag(bus[k],t);
   }
@@ -1003,6 +1013,8 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   // Branch data
   var_a = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
   var_phi = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
+  a_index = BRANCH_get_index_ratio(br,t);
+  phi_index = BRANCH_get_index_phase(br,t);
   b = BRANCH_get_b(br);
   b_sh[0] = BRANCH_get_b_k(br);
   b_sh[1] = BRANCH_get_b_m(br);
@@ -1010,11 +1022,11 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
   g_sh[0] = BRANCH_get_g_k(br);
   g_sh[1] = BRANCH_get_g_m(br);
   if (var_a)
-    a = VEC_get(values,BRANCH_get_index_ratio(br,t));
+    a = VEC_get(values,a_index);
   else
     a = BRANCH_get_ratio(br,t);
   if (var_phi)
-    phi = VEC_get(values,BRANCH_get_index_phase(br,t));
+    phi = VEC_get(values,phi_index);
   else
     phi = BRANCH_get_phase(br,t);
 
@@ -1053,6 +1065,18 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
 
   for (k = 0; k < 2; k++) {
 
+    // Side
+    if (!(sides & (k == 0 ? CONSTR_SIDE_K : CONSTR_SIDE_M)))
+      continue;
+
+    // J offset (side "m" entries follow those of side "k")
+    J_nnz_val = CONSTR_get_branch_J_nnz(c,br,t);
+    if (k == 1)
+      J_nnz_val += 2*(var_w[0]+var_v[0]+var_a+var_phi);
+
+    // H offset
+    H_nnz_val = data->side_H_nnz[side_index_t[k]];
+
     if (k == 0) {
       m = 1;
       indicator_a = 1.;
@@ -1068,88 +1092,171 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
     f[P_index[k]] -= P_kk[k] + P_km[k]; // Pk
     f[Q_index[k]] -= Q_kk[k] + Q_km[k]; // Qk
 
+    // Products of the Jacobian (instead of storing it)
+    if (prod == CONSTR_PROD_JV || prod == CONSTR_PROD_JTW) {
+      if (var_w[k]) { // wk var
+	CONSTR_add_J_product(c,P_index[m],w_index[k],-Q_km[m]); // dPm/dwk
+	CONSTR_add_J_product(c,Q_index[m],w_index[k],P_km[m]);  // dQm/dwk
+	CONSTR_add_J_product(c,P_index[k],w_index[k],Q_km[k]);  // dPk/dwk
+	CONSTR_add_J_product(c,Q_index[k],w_index[k],-P_km[k]); // dQk/dwk
+      }
+      if (var_v[k]) { // vk var
+	CONSTR_add_J_product(c,P_index[m],v_index[k],-P_km[m]/v[k]);                // dPm/dvk
+	CONSTR_add_J_product(c,Q_index[m],v_index[k],-Q_km[m]/v[k]);                // dQm/dvk
+	CONSTR_add_J_product(c,P_index[k],v_index[k],-2*P_kk[k]/v[k]-P_km[k]/v[k]); // dPk/dvk
+	CONSTR_add_J_product(c,Q_index[k],v_index[k],-2*Q_kk[k]/v[k]-Q_km[k]/v[k]); // dQk/dvk
+      }
+      if (var_a) { // a var
+	CONSTR_add_J_product(c,P_index[k],a_index,indicator_a*(-2.*P_kk[k]/a)-P_km[k]/a); // dPk/da
+	CONSTR_add_J_product(c,Q_index[k],a_index,indicator_a*(-2.*Q_kk[k]/a)-Q_km[k]/a); // dQk/da
+      }
+      if (var_phi) { // phi var
+	CONSTR_add_J_product(c,P_index[k],phi_index,-indicator_phi*Q_km[k]); // dPk/dphi
+	CONSTR_add_J_product(c,Q_index[k],phi_index,indicator_phi*P_km[k]);  // dQk/dphi
+      }
+      continue;
+    }
+
+    // Products of the Hessians (instead of storing them)
+    if (prod == CONSTR_PROD_HV) {
+      if (var_w[k]) { // wk var
+	CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],w_index[k],P_km[k],Q_km[k]);
+	if (var_v[k])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],v_index[k],Q_km[k]/v[k],-P_km[k]/v[k]);
+	if (var_w[m])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],w_index[m],-P_km[k],-Q_km[k]);
+	if (var_v[m])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],v_index[m],Q_km[k]/v[m],-P_km[k]/v[m]);
+	if (var_a)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],a_index,Q_km[k]/a,-P_km[k]/a);
+	if (var_phi)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[k],phi_index,-P_km[k]*indicator_phi,-Q_km[k]*indicator_phi);
+      }
+      if (var_v[k]) { // vk var
+	CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[k],v_index[k],-2.*P_kk[k]/(v[k]*v[k]),-2.*Q_kk[k]/(v[k]*v[k]));
+	if (var_w[m])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[k],w_index[m],-Q_km[k]/v[k],P_km[k]/v[k]);
+	if (var_v[m])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[k],v_index[m],-P_km[k]/(v[k]*v[m]),-Q_km[k]/(v[k]*v[m]));
+	if (var_a)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[k],a_index,
+				    -indicator_a*P_kk[k]*4/(a*v[k])-P_km[k]/(a*v[k]),
+				    -indicator_a*Q_kk[k]*4/(a*v[k])-Q_km[k]/(a*v[k]));
+	if (var_phi)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[k],phi_index,-indicator_phi*Q_km[k]/v[k],indicator_phi*P_km[k]/v[k]);
+      }
+      if (var_w[m]) { // wm var
+	CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[m],w_index[m],P_km[k],Q_km[k]);
+	if (var_v[m])
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[m],v_index[m],-Q_km[k]/v[m],P_km[k]/v[m]);
+	if (var_a)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[m],a_index,-Q_km[k]/a,P_km[k]/a);
+	if (var_phi)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],w_index[m],phi_index,P_km[k]*indicator_phi,Q_km[k]*indicator_phi);
+      }
+      if (var_v[m]) { // vm var
+	if (var_a)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[m],a_index,-P_km[k]/(a*v[m]),-Q_km[k]/(a*v[m]));
+	if (var_phi)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],v_index[m],phi_index,-indicator_phi*Q_km[k]/v[m],indicator_phi*P_km[k]/v[m]);
+      }
+      if (var_a) { // a var
+	if (k == 0)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],a_index,a_index,-P_kk[k]*2./(a*a),-Q_kk[k]*2./(a*a));
+	if (var_phi)
+	  CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],a_index,phi_index,-indicator_phi*Q_km[k]/a,indicator_phi*P_km[k]/a);
+      }
+      if (var_phi) // phi var
+	CONSTR_ACPF_add_H_product(c,P_index[k],Q_index[k],phi_index,phi_index,P_km[k],Q_km[k]);
+      continue;
+    }
+
+    // Values only
+    if (!eval_J)
+      continue;
+
     //***********
     if (var_w[k]) { // wk var
 
       // J
-      J[*J_nnz] = -Q_km[m]; // dPm/dwk
-      (*J_nnz)++;
+      J[J_nnz_val] = -Q_km[m]; // dPm/dwk
+      J_nnz_val++;
 
-      J[*J_nnz] = P_km[m];  // dQm/dwk
-      (*J_nnz)++;
+      J[J_nnz_val] = P_km[m];  // dQm/dwk
+      J_nnz_val++;
 
       J[data->dPdw_indices[bus_index_t[k]]] += Q_km[k];  // dPk/dwk
       J[data->dQdw_indices[bus_index_t[k]]] -= P_km[k]; // dQk/dwk
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      HP[k][data->dwdw_indices[bus_index_t[k]]] += P_km[k]; // wk and wk
-      HQ[k][data->dwdw_indices[bus_index_t[k]]] += Q_km[k];
-      if (var_v[k]) { // wk and vk
-	HP[k][data->dwdv_indices[bus_index_t[k]]] += Q_km[k]/v[k]; // wk and wk
-	HQ[k][data->dwdv_indices[bus_index_t[k]]] -= P_km[k]/v[k];
-      }
-      if (var_w[m]) { // wk and wm
-	HP[k][H_nnz_val] = -P_km[k];
-	HQ[k][H_nnz_val] = -Q_km[k];
-	H_nnz_val++;
-      }
-      if (var_v[m]) { // wk and vm
-	HP[k][H_nnz_val] = Q_km[k]/v[m];
-	HQ[k][H_nnz_val] = -P_km[k]/v[m];
-	H_nnz_val++;
-      }
-      if (var_a) {  // wk and a
-	HP[k][H_nnz_val] = Q_km[k]/a;
-	HQ[k][H_nnz_val] = -P_km[k]/a;
-	H_nnz_val++;
-      }
-      if (var_phi) { // wk and phi
-	HP[k][H_nnz_val] = -P_km[k]*indicator_phi;
-	HQ[k][H_nnz_val] = -Q_km[k]*indicator_phi;
-	H_nnz_val++;
+      if (eval_H) {
+	HP[k][data->dwdw_indices[bus_index_t[k]]] += P_km[k]; // wk and wk
+	HQ[k][data->dwdw_indices[bus_index_t[k]]] += Q_km[k];
+	if (var_v[k]) { // wk and vk
+	  HP[k][data->dwdv_indices[bus_index_t[k]]] += Q_km[k]/v[k]; // wk and wk
+	  HQ[k][data->dwdv_indices[bus_index_t[k]]] -= P_km[k]/v[k];
+	}
+	if (var_w[m]) { // wk and wm
+	  HP[k][H_nnz_val] = -P_km[k];
+	  HQ[k][H_nnz_val] = -Q_km[k];
+	  H_nnz_val++;
+	}
+	if (var_v[m]) { // wk and vm
+	  HP[k][H_nnz_val] = Q_km[k]/v[m];
+	  HQ[k][H_nnz_val] = -P_km[k]/v[m];
+	  H_nnz_val++;
+	}
+	if (var_a) {  // wk and a
+	  HP[k][H_nnz_val] = Q_km[k]/a;
+	  HQ[k][H_nnz_val] = -P_km[k]/a;
+	  H_nnz_val++;
+	}
+	if (var_phi) { // wk and phi
+	  HP[k][H_nnz_val] = -P_km[k]*indicator_phi;
+	  HQ[k][H_nnz_val] = -Q_km[k]*indicator_phi;
+	  H_nnz_val++;
+	}
       }
-      H_nnz[bus_index_t[k]] = H_nnz_val;
     }
 
     //************
     if (var_v[k]) { // vk var
 
       // J
-      J[*J_nnz] = -P_km[m]/v[k]; // dPm/dvk
-      (*J_nnz)++;
+      J[J_nnz_val] = -P_km[m]/v[k]; // dPm/dvk
+      J_nnz_val++;
 
-      J[*J_nnz] = -Q_km[m]/v[k]; // dQm/dvk
-      (*J_nnz)++;
+      J[J_nnz_val] = -Q_km[m]/v[k]; // dQm/dvk
+      J_nnz_val++;
 
       J[data->dPdv_indices[bus_index_t[k]]] -= 2*P_kk[k]/v[k] + P_km[k]/v[k]; // dPk/dvk
       J[data->dQdv_indices[bus_index_t[k]]] -= 2*Q_kk[k]/v[k] + Q_km[k]/v[k]; // dQk/dvk
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      HP[k][data->dvdv_indices[bus_index_t[k]]] -= 2.*P_kk[k]/(v[k]*v[k]); // vk and vk
-      HQ[k][data->dvdv_indices[bus_index_t[k]]] -= 2.*Q_kk[k]/(v[k]*v[k]);
-      if (var_w[m]) { // vk and wm
-	HP[k][H_nnz_val] = -Q_km[k]/v[k];
-	HQ[k][H_nnz_val] = P_km[k]/v[k];
-	H_nnz_val++;
-      }
-      if (var_v[m]) { // vk and vm
-	HP[k][H_nnz_val] = -P_km[k]/(v[k]*v[m]);
-	HQ[k][H_nnz_val] = -Q_km[k]/(v[k]*v[m]);
-	H_nnz_val++;
-      }
-      if (var_a) {   // vk and a
-	HP[k][H_nnz_val] = -indicator_a*P_kk[k]*4/(a*v[k]) - P_km[k]/(a*v[k]);
-	HQ[k][H_nnz_val] = -indicator_a*Q_kk[k]*4/(a*v[k]) - Q_km[k]/(a*v[k]);
-	H_nnz_val++;
-      }
-      if (var_phi) { // vk and phi
-	HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/v[k];
-	HQ[k][H_nnz_val] = indicator_phi*P_km[k]/v[k];
-	H_nnz_val++;
+      if (eval_H) {
+	HP[k][data->dvdv_indices[bus_index_t[k]]] -= 2.*P_kk[k]/(v[k]*v[k]); // vk and vk
+	HQ[k][data->dvdv_indices[bus_index_t[k]]] -= 2.*Q_kk[k]/(v[k]*v[k]);
+	if (var_w[m]) { // vk and wm
+	  HP[k][H_nnz_val] = -Q_km[k]/v[k];
+	  HQ[k][H_nnz_val] = P_km[k]/v[k];
+	  H_nnz_val++;
+	}
+	if (var_v[m]) { // vk and vm
+	  HP[k][H_nnz_val] = -P_km[k]/(v[k]*v[m]);
+	  HQ[k][H_nnz_val] = -Q_km[k]/(v[k]*v[m]);
+	  H_nnz_val++;
+	}
+	if (var_a) {   // vk and a
+	  HP[k][H_nnz_val] = -indicator_a*P_kk[k]*4/(a*v[k]) - P_km[k]/(a*v[k]);
+	  HQ[k][H_nnz_val] = -indicator_a*Q_kk[k]*4/(a*v[k]) - Q_km[k]/(a*v[k]);
+	  H_nnz_val++;
+	}
+	if (var_phi) { // vk and phi
+	  HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/v[k];
+	  HQ[k][H_nnz_val] = indicator_phi*P_km[k]/v[k];
+	  H_nnz_val++;
+	}
       }
-      H_nnz[bus_index_t[k]] = H_nnz_val;
     }
 
     //***********
@@ -1159,26 +1266,26 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
       // Nothing
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      HP[k][H_nnz_val] = P_km[k]; // wm and wm
-      HQ[k][H_nnz_val] = Q_km[k];
-      H_nnz_val++;
-      if (var_v[m]) {   // wm and vm
-	HP[k][H_nnz_val] = -Q_km[k]/v[m];
-	HQ[k][H_nnz_val] = P_km[k]/v[m];
-	H_nnz_val++;
-      }
-      if (var_a) {      // wm and a
-	HP[k][H_nnz_val] = -Q_km[k]/a;
-	HQ[k][H_nnz_val] = P_km[k]/a;
-	H_nnz_val++;
-      }
-      if (var_phi) {    // wm and phi
-	HP[k][H_nnz_val] = P_km[k]*indicator_phi;
-	HQ[k][H_nnz_val] = Q_km[k]*indicator_phi;;
+      if (eval_H) {
+	HP[k][H_nnz_val] = P_km[k]; // wm and wm
+	HQ[k][H_nnz_val] = Q_km[k];
 	H_nnz_val++;
+	if (var_v[m]) {   // wm and vm
+	  HP[k][H_nnz_val] = -Q_km[k]/v[m];
+	  HQ[k][H_nnz_val] = P_km[k]/v[m];
+	  H_nnz_val++;
+	}
+	if (var_a) {      // wm and a
+	  HP[k][H_nnz_val] = -Q_km[k]/a;
+	  HQ[k][H_nnz_val] = P_km[k]/a;
+	  H_nnz_val++;
+	}
+	if (var_phi) {    // wm and phi
+	  HP[k][H_nnz_val] = P_km[k]*indicator_phi;
+	  HQ[k][H_nnz_val] = Q_km[k]*indicator_phi;;
+	  H_nnz_val++;
+	}
       }
-      H_nnz[bus_index_t[k]] = H_nnz_val;
     }
 
     //***********
@@ -1188,276 +1295,439 @@ void CONSTR_ACPF_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* value
       // Nothing
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      if (var_a) {   // vm and a
-	HP[k][H_nnz_val] = -P_km[k]/(a*v[m]);
-	HQ[k][H_nnz_val] = -Q_km[k]/(a*v[m]);
-	H_nnz_val++;
-      }
-      if (var_phi) { // vm and phi
-	HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/v[m];
-	HQ[k][H_nnz_val] = indicator_phi*P_km[k]/v[m];
-	H_nnz_val++;
+      if (eval_H) {
+	if (var_a) {   // vm and a
+	  HP[k][H_nnz_val] = -P_km[k]/(a*v[m]);
+	  HQ[k][H_nnz_val] = -Q_km[k]/(a*v[m]);
+	  H_nnz_val++;
+	}
+	if (var_phi) { // vm and phi
+	  HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/v[m];
+	  HQ[k][H_nnz_val] = indicator_phi*P_km[k]/v[m];
+	  H_nnz_val++;
+	}
       }
-      H_nnz[bus_index_t[k]] = H_nnz_val;
     }
 
     //********
     if (var_a) { // a var
 
       // J
-      J[*J_nnz] = indicator_a*(-2.*P_kk[k]/a) - P_km[k]/a; // dPk/da
-      (*J_nnz)++;
+      J[J_nnz_val] = indicator_a*(-2.*P_kk[k]/a) - P_km[k]/a; // dPk/da
+      J_nnz_val++;
 
-      J[*J_nnz] = indicator_a*(-2.*Q_kk[k]/a) - Q_km[k]/a; // dQk/da
-      (*J_nnz)++;
+      J[J_nnz_val] = indicator_a*(-2.*Q_kk[k]/a) - Q_km[k]/a; // dQk/da
+      J_nnz_val++;
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      if (k == 0) { // a and a (important check k==0)
-	HP[k][H_nnz_val] = -P_kk[k]*2./(a*a);
-	HQ[k][H_nnz_val] = -Q_kk[k]*2./(a*a);
-	H_nnz_val++;
-      }
-      if (var_phi) { // a and phi
-	HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/a;
-	HQ[k][H_nnz_val] = indicator_phi*P_km[k]/a;
-	H_nnz_val++;
+      if (eval_H) {
+	if (k == 0) { // a and a (important check k==0)
+	  HP[k][H_nnz_val] = -P_kk[k]*2./(a*a);
+	  HQ[k][H_nnz_val] = -Q_kk[k]*2./(a*a);
+	  H_nnz_val++;
+	}
+	if (var_phi) { // a and phi
+	  HP[k][H_nnz_val] = -indicator_phi*Q_km[k]/a;
+	  HQ[k][H_nnz_val] = indicator_phi*P_km[k]/a;
+	  H_nnz_val++;
+	}
       }
-      H_nnz[bus_index_t[k]] = H_nnz_val;
     }
 
     //**********
     if (var_phi) { // phi var
 
       // J
-      J[*J_nnz] = -indicator_phi*Q_km[k]; // dPk/dphi
-      (*J_nnz)++;
+      J[J_nnz_val] = -indicator_phi*Q_km[k]; // dPk/dphi
+      J_nnz_val++;
 
-      J[*J_nnz] = indicator_phi*P_km[k]; // dQk/dphi
-      (*J_nnz)++;
+      J[J_nnz_val] = indicator_phi*P_km[k]; // dQk/dphi
+      J_nnz_val++;
 
       // H
-      H_nnz_val = H_nnz[bus_index_t[k]];
-      HP[k][H_nnz_val] = P_km[k];
-      HQ[k][H_nnz_val] = Q_km[k];
-      H_nnz_val++; // phi and phi
-      H_nnz[bus_index_t[k]] = H_nnz_val;
+      if (eval_H) {
+	HP[k][H_nnz_val] = P_km[k];
+	HQ[k][H_nnz_val] = Q_km[k];
+	H_nnz_val++; // phi and phi
+      }
     }
+
+    // Counter
+    H_nnz[bus_index_t[k]] += H_nnz_val-data->side_H_nnz[side_index_t[k]];
   }
+}
 
-  // Buses
-  //******
+void CONSTR_ACPF_eval_bus_step(Constr* c, Bus* bus, int t, Vec* values, Vec* values_extra) {
 
-  for (k = 0; k < 2; k++) {
+  // Local variables
+  Gen* gen;
+  Vargen* vargen;
+  Load* load;
+  Bat* bat;
+  Shunt* shunt;
+  REAL* f;
+  REAL* J;
+  int J_nnz_val;
+  int* H_nnz;
+  int H_nnz_val;
+  Mat* H_array;
+  REAL* HP;
+  REAL* HQ;
+  int bus_index_t;
+  BOOL var_v;
+  BOOL var_w;
+  int P_index;
+  int Q_index;
+  REAL v;
+  REAL P;
+  REAL Q;
+  REAL shunt_b;
+  REAL shunt_g;
+  Constr_ACPF_Data* data;
+  int num_buses;
+  BOOL eval_J;
+  BOOL eval_H;
+  char prod;
 
-    if (!bus_counted[bus_index_t[k]]) {
+  // Num buses
+  num_buses = NET_get_num_buses(CONSTR_get_network(c));
 
-      //***********
-      if (var_w[k]) { // wk var
+  // Constr data
+  f = VEC_get_data(CONSTR_get_f(c));
+  J = MAT_get_data_array(CONSTR_get_J(c));
+  H_array = CONSTR_get_H_array(c);
+  H_nnz = CONSTR_get_H_nnz(c);
+  data = (Constr_ACPF_Data*)CONSTR_get_data(c);
 
-	// J
-	// Nothing // dPk/dwk
-	(*J_nnz)++;
+  // Check pointers
+  if (!f || !J || !H_nnz || !data)
+    return;
 
-	// Nothing // dQk/dwk
-	(*J_nnz)++;
+  // Level
+  eval_J = CONSTR_get_eval_level(c) >= EVAL_FJ;
+  eval_H = CONSTR_get_eval_level(c) >= EVAL_FJH;
+  prod = CONSTR_get_product_type(c);
 
-	// H
-	H_nnz[bus_index_t[k]]++;   // wk and wk
-	if (var_v[k]) {
-	  H_nnz[bus_index_t[k]]++; // wk and vk
-	}
-      }
+  // Bus data
+  bus_index_t = BUS_get_index(bus)+t*num_buses;
+  P_index = BUS_get_index_P(bus)+t*2*num_buses; // index in f for active power mismatch
+  Q_index = BUS_get_index_Q(bus)+t*2*num_buses; // index in f for reactive power mismatch
+  var_w = BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG);
+  var_v = BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG);
+  HP = MAT_get_data_array(MAT_array_get(H_array,P_index));
+  HQ = MAT_get_data_array(MAT_array_get(H_array,Q_index));
+  if (var_v)
+    v = VEC_get(values,BUS_get_index_v_mag(bus,t));
+  else
+    v = BUS_get_v_mag(bus,t);
 
-      //***********
-      if (var_v[k]) { // vk var
+  // J offset
+  J_nnz_val = CONSTR_get_bus_J_nnz(c,bus,t);
 
-	// J
-	// Nothing // dPk/dvk
-	(*J_nnz)++;
+  // H offset
+  H_nnz_val = data->bus_H_nnz[bus_index_t];
 
-	// Nothing // dQk/dvk
-	(*J_nnz)++;
+  //***********
+  if (var_w) { // wk var
 
-	// H
-	H_nnz[bus_index_t[k]]++; // vk and vk
-      }
+    // J
+    // Nothing // dPk/dwk
+    J_nnz_val++;
 
-      // Generators
-      for (gen = BUS_get_gen(bus[k]); gen != NULL; gen = GEN_get_next(gen)) {
+    // Nothing // dQk/dwk
+    J_nnz_val++;
 
-	// Var values
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
-	  P = VEC_get(values,GEN_get_index_P(gen,t)); // p.u.
-	else
-	  P = GEN_get_P(gen,t);                       // p.u.
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q))
-	  Q = VEC_get(values,GEN_get_index_Q(gen,t)); // p.u.
-	else
-	  Q = GEN_get_Q(gen,t);                       // p.u.
+    // H
+    H_nnz_val++;   // wk and wk
+    if (var_v) {
+      H_nnz_val++; // wk and vk
+    }
+  }
 
-	// f
-	f[P_index[k]] += P;
-	f[Q_index[k]] += Q;
+  //***********
+  if (var_v) { // vk var
 
-	//*****************************
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) { // Pg var
+    // J
+    // Nothing // dPk/dvk
+    J_nnz_val++;
 
-	  // J
-	  J[*J_nnz] = 1.; // dPk/dPg
-	  (*J_nnz)++;
-	}
+    // Nothing // dQk/dvk
+    J_nnz_val++;
 
-	//*****************************
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) { // Qg var
+    // H
+    H_nnz_val++; // vk and vk
+  }
 
-	  // J
-	  J[*J_nnz] = 1.; // dQk/dQg
-	  (*J_nnz)++;
-	}
-      }
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
 
-      // Variable generators
-      for (vargen = BUS_get_vargen(bus[k]); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+    // Var values
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+      P = VEC_get(values,GEN_get_index_P(gen,t)); // p.u.
+    else
+      P = GEN_get_P(gen,t);                       // p.u.
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q))
+      Q = VEC_get(values,GEN_get_index_Q(gen,t)); // p.u.
+    else
+      Q = GEN_get_Q(gen,t);                       // p.u.
 
-	// Var values
-	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
-	  P = VEC_get(values,VARGEN_get_index_P(vargen,t)); // p.u.
-	else
-	  P = VARGEN_get_P(vargen,t);                       // p.u.
-	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q))
-	  Q = VEC_get(values,VARGEN_get_index_Q(vargen,t)); // p.u.
-	else
-	  Q = VARGEN_get_Q(vargen,t);                       // p.u.
+    // f
+    f[P_index] += P;
+    f[Q_index] += Q;
 
-	// f
-	f[P_index[k]] += P;
-	f[Q_index[k]] += Q;
+    //*****************************
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) { // Pg var
 
-	//*****************************
-	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P)) { // Pg var
+      // J
+      J[J_nnz_val] = 1.; // dPk/dPg
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,P_index,GEN_get_index_P(gen,t),1.);
+    }
 
-	  // J
-	  J[*J_nnz] = 1.; // dPk/dPg
-	  (*J_nnz)++;
-	}
+    //*****************************
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) { // Qg var
 
-	//*****************************
-	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q)) { // Qg var
+      // J
+      J[J_nnz_val] = 1.; // dQk/dQg
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,Q_index,GEN_get_index_Q(gen,t),1.);
+    }
+  }
 
-	  // J
-	  J[*J_nnz] = 1.; // dQk/dQg
-	  (*J_nnz)++;
-	}
-      }
+  // Variable generators
+  for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
 
-      // Shunts
-      for (shunt = BUS_get_shunt(bus[k]); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+    // Var values
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
+      P = VEC_get(values,VARGEN_get_index_P(vargen,t)); // p.u.
+    else
+      P = VARGEN_get_P(vargen,t);                       // p.u.
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q))
+      Q = VEC_get(values,VARGEN_get_index_Q(vargen,t)); // p.u.
+    else
+      Q = VARGEN_get_Q(vargen,t);                       // p.u.
 
-	// Values
-	shunt_g = SHUNT_get_g(shunt);
-	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
-	  shunt_b = VEC_get(values,SHUNT_get_index_b(shunt,t)); // p.u.
-	else
-	  shunt_b = SHUNT_get_b(shunt,t);
+    // f
+    f[P_index] += P;
+    f[Q_index] += Q;
 
-	// f
-	f[P_index[k]] -= shunt_g*v[k]*v[k]; // p.u.
-	f[Q_index[k]] += shunt_b*v[k]*v[k];  // p.u.
+    //*****************************
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P)) { // Pg var
 
-	//***********
-	if (var_v[k]) { // var v
+      // J
+      J[J_nnz_val] = 1.; // dPk/dPg
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,P_index,VARGEN_get_index_P(vargen,t),1.);
+    }
 
-	  // J
-	  J[data->dPdv_indices[bus_index_t[k]]] -= 2*shunt_g*v[k]; // dPk/dvk
-	  J[data->dQdv_indices[bus_index_t[k]]] += 2*shunt_b*v[k]; // dQk/dvk
+    //*****************************
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q)) { // Qg var
 
-	  // H
-	  HP[k][data->dvdv_indices[bus_index_t[k]]] -= 2*shunt_g; // vk and vk
-	  HQ[k][data->dvdv_indices[bus_index_t[k]]] += 2*shunt_b;
-	}
+      // J
+      J[J_nnz_val] = 1.; // dQk/dQg
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,Q_index,VARGEN_get_index_Q(vargen,t),1.);
+    }
+  }
 
-	//**************************************
-	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // b var
+  // Shunts
+  for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
 
-	  // J
-	  J[*J_nnz] = v[k]*v[k]; // dQk/db
-	  (*J_nnz)++;
+    // Values
+    shunt_g = SHUNT_get_g(shunt);
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC))
+      shunt_b = VEC_get(values,SHUNT_get_index_b(shunt,t)); // p.u.
+    else
+      shunt_b = SHUNT_get_b(shunt,t);
 
-	  // H
-	  if (var_v[k]) {
-	    H_nnz_val = H_nnz[bus_index_t[k]];
-	    HP[k][H_nnz_val] = 0;
-	    HQ[k][H_nnz_val] = 2*v[k];
-	    H_nnz_val++; // b and vk
-	    H_nnz[bus_index_t[k]] = H_nnz_val;
-	  }
+    // f
+    f[P_index] -= shunt_g*v*v; // p.u.
+    f[Q_index] += shunt_b*v*v;  // p.u.
+
+    //***********
+    if (var_v && eval_J) { // var v
+
+      // J
+      J[data->dPdv_indices[bus_index_t]] -= 2*shunt_g*v; // dPk/dvk
+      J[data->dQdv_indices[bus_index_t]] += 2*shunt_b*v; // dQk/dvk
+
+      // H
+      if (eval_H) {
+	HP[data->dvdv_indices[bus_index_t]] -= 2*shunt_g; // vk and vk
+	HQ[data->dvdv_indices[bus_index_t]] += 2*shunt_b;
+      }
+    }
+    if (var_v && prod) { // var v (products)
+      CONSTR_add_J_product(c,P_index,BUS_get_index_v_mag(bus,t),-2*shunt_g*v); // dPk/dvk
+      CONSTR_add_J_product(c,Q_index,BUS_get_index_v_mag(bus,t),2*shunt_b*v);  // dQk/dvk
+      CONSTR_ACPF_add_H_product(c,P_index,Q_index,
+				BUS_get_index_v_mag(bus,t),BUS_get_index_v_mag(bus,t),
+				-2*shunt_g,2*shunt_b); // vk and vk
+    }
+
+    //**************************************
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // b var
+
+      // J
+      J[J_nnz_val] = v*v; // dQk/db
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,Q_index,SHUNT_get_index_b(shunt,t),v*v);
+
+      // H
+      if (var_v) {
+	if (eval_H) {
+	  HP[H_nnz_val] = 0;
+	  HQ[H_nnz_val] = 2*v;
 	}
+	H_nnz_val++; // b and vk
+	if (prod)
+	  CONSTR_ACPF_add_H_product(c,P_index,Q_index,
+				    SHUNT_get_index_b(shunt,t),BUS_get_index_v_mag(bus,t),
+				    0,2*v);
       }
+    }
+  }
 
-      // Loads
-      for (load = BUS_get_load(bus[k]); load != NULL; load = LOAD_get_next(load)) {
+  // Loads
+  for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
 
-	// Var values
-	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
-	  P = VEC_get(values,LOAD_get_index_P(load,t)); // p.u.
-	else
-	  P = LOAD_get_P(load,t);                       // p.u.
-	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q))
-	  Q = VEC_get(values,LOAD_get_index_Q(load,t)); // p.u.
-	else
-	  Q = LOAD_get_Q(load,t);                       // p.u.
+    // Var values
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
+      P = VEC_get(values,LOAD_get_index_P(load,t)); // p.u.
+    else
+      P = LOAD_get_P(load,t);                       // p.u.
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q))
+      Q = VEC_get(values,LOAD_get_index_Q(load,t)); // p.u.
+    else
+      Q = LOAD_get_Q(load,t);                       // p.u.
 
-	// f
-	f[P_index[k]] -= P; // p.u.
-	f[Q_index[k]] -= Q; // p.u.
+    // f
+    f[P_index] -= P; // p.u.
+    f[Q_index] -= Q; // p.u.
 
-	//*****************************
-	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P)) { // Pl var
+    //*****************************
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P)) { // Pl var
 
-	  // J
-	  J[*J_nnz] = -1.; // dPk/dPl
-	  (*J_nnz)++;
-	}
+      // J
+      J[J_nnz_val] = -1.; // dPk/dPl
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,P_index,LOAD_get_index_P(load,t),-1.);
+    }
 
-	//*****************************
-	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q)) { // Ql var
+    //*****************************
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q)) { // Ql var
 
-	  // J
-	  J[*J_nnz] = -1.; // dQk/dQl
-	  (*J_nnz)++;
-	}
-      }
+      // J
+      J[J_nnz_val] = -1.; // dQk/dQl
+      J_nnz_val++;
+      if (prod)
+	CONSTR_add_J_product(c,Q_index,LOAD_get_index_Q(load,t),-1.);
+    }
+  }
 
-      // Batteries
-      for (bat = BUS_get_bat(bus[k]); bat != NULL; bat = BAT_get_next(bat)) {
+  // Batteries
+  for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
 
-	// var values
-	if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P))
-	  P = VEC_get(values,BAT_get_index_Pc(bat,t))-VEC_get(values,BAT_get_index_Pd(bat,t)); // p.u.
-	else
-	  P = BAT_get_P(bat,t);                                                                // p.u.
-	
-	// f
-	f[P_index[k]] -= P; // p.u.
+    // var values
+    if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P))
+      P = VEC_get(values,BAT_get_index_Pc(bat,t))-VEC_get(values,BAT_get_index_Pd(bat,t)); // p.u.
+    else
+      P = BAT_get_P(bat,t);                                                                // p.u.
 
-	//*****************************
-	if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {  // Pc and Pd var
+    // f
+    f[P_index] -= P; // p.u.
 
-	  // J
-	  J[*J_nnz] = -1.; // Pc
-	  (*J_nnz)++;
+    //*****************************
+    if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {  // Pc and Pd var
 
-	  J[*J_nnz] = 1.; // Pd
-	  (*J_nnz)++;
-	}
+      // J
+      J[J_nnz_val] = -1.; // Pc
+      J_nnz_val++;
+
+      J[J_nnz_val] = 1.; // Pd
+      J_nnz_val++;
+
+      if (prod) {
+	CONSTR_add_J_product(c,P_index,BAT_get_index_Pc(bat,t),-1.);
+	CONSTR_add_J_product(c,P_index,BAT_get_index_Pd(bat,t),1.);
       }
     }
+  }
 
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
+  // Counter
+  H_nnz[bus_index_t] += H_nnz_val-data->bus_H_nnz[bus_index_t];
+}
+
+void CONSTR_ACPF_add_H_product(Constr* c, int P_index, int Q_index, int i, int j, REAL HP_val, REAL HQ_val) {
+  /* This function adds the contribution of the (i,j) entries of the
+     Hessians of the active and reactive power mismatches to the
+     product being accumulated by the constraint. */
+  CONSTR_add_H_product(c,P_index,i,j,HP_val);
+  CONSTR_add_H_product(c,Q_index,i,j,HQ_val);
+}
+
+void CONSTR_ACPF_clear_bus_step(Constr* c, Bus* bus, int t) {
+  /* This function clears the power mismatches of the bus, the Jacobian
+     entries accumulated at its key indices, and the Hessians of its
+     mismatches. Re-evaluating the bus and its branch sides afterwards
+     restores them. */
+
+  // Local variables
+  REAL* f;
+  REAL* J;
+  int* H_nnz;
+  Mat* H_array;
+  int bus_index_t;
+  int P_index;
+  int Q_index;
+  Constr_ACPF_Data* data;
+  int num_buses;
+
+  // Num buses
+  num_buses = NET_get_num_buses(CONSTR_get_network(c));
+
+  // Constr data
+  f = VEC_get_data(CONSTR_get_f(c));
+  J = MAT_get_data_array(CONSTR_get_J(c));
+  H_array = CONSTR_get_H_array(c);
+  H_nnz = CONSTR_get_H_nnz(c);
+  data = (Constr_ACPF_Data*)CONSTR_get_data(c);
+
+  // Check pointers
+  if (!f || !J || !H_nnz || !data)
+    return;
+
+  // Bus data
+  bus_index_t = BUS_get_index(bus)+t*num_buses;
+  P_index = BUS_get_index_P(bus)+t*2*num_buses;
+  Q_index = BUS_get_index_Q(bus)+t*2*num_buses;
+
+  // f
+  f[P_index] = 0;
+  f[Q_index] = 0;
+
+  // J
+  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) {
+    J[data->dPdw_indices[bus_index_t]] = 0; // dPk/dwk
+    J[data->dQdw_indices[bus_index_t]] = 0; // dQk/dwk
+  }
+  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
+    J[data->dPdv_indices[bus_index_t]] = 0; // dPk/dvk
+    J[data->dQdv_indices[bus_index_t]] = 0; // dQk/dvk
   }
+
+  // H
+  MAT_set_zero_d(MAT_array_get(H_array,P_index));
+  MAT_set_zero_d(MAT_array_get(H_array,Q_index));
+
+  // Counter
+  H_nnz[bus_index_t] = 0;
 }
 
 void CONSTR_ACPF_store_sens_step(Constr* c, Branch* br, int t, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
@@ -1511,6 +1781,8 @@ void CONSTR_ACPF_free(Constr* c) {
     free(data->dwdw_indices);
     free(data->dwdv_indices);
     free(data->dvdv_indices);
+    free(data->bus_H_nnz);
+    free(data->side_H_nnz);
     free(data);
   }
 
@@ -13,6 +13,10 @@
 
 #define HESSIAN_VAL() -(R*dRdx + I*dIdx)*(R*dRdy + I*dIdy)/sqrterm3+(dRdy*dRdx+dIdy*dIdx+R*d2Rdydx+I*d2Idydx)/sqrterm
 
+// Stores an entry or adds it to the product being accumulated
+#define JACOBIAN_ENTRY(j,val) if (prod) CONSTR_add_J_product(c,J_row_val,j,val); else J[J_nnz_val] = val
+#define HESSIAN_ENTRY(i,j) if (prod) CONSTR_add_H_product(c,J_row_val,i,j,HESSIAN_VAL()); else H[H_nnz_val] = HESSIAN_VAL()
+
 Constr* CONSTR_AC_FLOW_LIM_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c, &CONSTR_AC_FLOW_LIM_init);
@@ -20,9 +24,10 @@ Constr* CONSTR_AC_FLOW_LIM_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_AC_FLOW_LIM_allocate);
   CONSTR_set_func_clear(c, &CONSTR_AC_FLOW_LIM_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_AC_FLOW_LIM_analyze_step);
-  CONSTR_set_func_eval_step(c, &CONSTR_AC_FLOW_LIM_eval_step);
+  CONSTR_set_func_eval_branch_step(c, &CONSTR_AC_FLOW_LIM_eval_branch_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_AC_FLOW_LIM_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_AC_FLOW_LIM_free);
+  CONSTR_set_matrix_free(c, TRUE);
   CONSTR_init(c);
   return c;
 }
@@ -51,10 +56,12 @@ void CONSTR_AC_FLOW_LIM_clear(Constr* c) {
   VEC_set_zero(CONSTR_get_f(c));
   
   // J
-  MAT_set_zero_d(CONSTR_get_J(c));
+  if (CONSTR_get_eval_level(c) >= EVAL_FJ)
+    MAT_set_zero_d(CONSTR_get_J(c));
 
   // H
-  MAT_array_set_zero_d(CONSTR_get_H_array(c),CONSTR_get_H_array_size(c));
+  if (CONSTR_get_eval_level(c) >= EVAL_FJH)
+    MAT_array_set_zero_d(CONSTR_get_H_array(c),CONSTR_get_H_array_size(c));
 
   // Counters
   CONSTR_set_J_nnz(c,0);
@@ -239,12 +246,11 @@ void CONSTR_AC_FLOW_LIM_allocate(Constr* c) {
   int* H_nnz;
   int J_row;
   Mat* H_array;
-  Mat* Hi;
   int H_comb_nnz;
-  int* row;
-  int* col;
   int i;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   // Data
   net = CONSTR_get_network(c);
   num_vars = NET_get_num_vars(net);
@@ -254,51 +260,40 @@ void CONSTR_AC_FLOW_LIM_allocate(Constr* c) {
   J_row = CONSTR_get_J_row(c);
 
   // Extra vars
-  CONSTR_set_l_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_u_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_init_extra_vars(c,VEC_new(num_extra_vars));
+  CONSTR_set_l_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_u_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_init_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
 
   // A b
-  CONSTR_set_A(c,MAT_new(0,                       // rows
-			 num_vars+num_extra_vars, // columnes
-			 0));                     // nnz
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,                       // rows
+					 num_vars+num_extra_vars, // columnes
+					 0));                     // nnz
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // G l u
-  CONSTR_set_G(c,MAT_new(J_row,                   // rows
-			 num_vars+num_extra_vars, // columns
-			 J_row));                 // nnz
-  CONSTR_set_l(c,VEC_new(J_row));
-  CONSTR_set_u(c,VEC_new(J_row));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,J_row,                   // rows
+					 num_vars+num_extra_vars, // columns
+					 J_row));                 // nnz
+  CONSTR_set_l(c,VEC_new_from_pool(pool,J_row));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,J_row));
 
   // f J
-  CONSTR_set_f(c,VEC_new(J_row));
-  CONSTR_set_J(c,MAT_new(J_row,                   // rows
-			 num_vars+num_extra_vars, // cols
-			 J_nnz));                 // nnz
+  CONSTR_set_f(c,VEC_new_from_pool(pool,J_row));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,J_row,                   // rows
+					 num_vars+num_extra_vars, // cols
+					 J_nnz));                 // nnz
 
   // H
   H_comb_nnz = 0;
-  H_array = MAT_array_new(J_row);
+  H_array = MAT_array_new_block_from_pool(pool,J_row,num_vars+num_extra_vars,num_vars+num_extra_vars,H_nnz,NULL);
   CONSTR_set_H_array(c,H_array,J_row);
-  for (i = 0; i < J_row; i++) {
-    Hi = MAT_array_get(H_array,i);
-    MAT_set_nnz(Hi,H_nnz[i]);
-    MAT_set_size1(Hi,num_vars+num_extra_vars);
-    MAT_set_size2(Hi,num_vars+num_extra_vars);
-    MAT_set_owns_rowcol(Hi,TRUE);
-    ARRAY_zalloc(row,int,H_nnz[i]);
-    ARRAY_zalloc(col,int,H_nnz[i]);
-    MAT_set_row_array(Hi,row);
-    MAT_set_col_array(Hi,col);
-    MAT_set_data_array(Hi,(REAL*)malloc(H_nnz[i]*sizeof(REAL)));
+  for (i = 0; i < J_row; i++)
     H_comb_nnz += H_nnz[i];
-  }
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars+num_extra_vars, // rows
-				  num_vars+num_extra_vars, // cols
-				  H_comb_nnz));            // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars+num_extra_vars, // rows
+						  num_vars+num_extra_vars, // cols
+						  H_comb_nnz));            // nnz
 }
 
 void CONSTR_AC_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t) {
@@ -574,13 +569,13 @@ void CONSTR_AC_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
+void CONSTR_AC_FLOW_LIM_eval_branch_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra, char sides) {
   
   // Local variables
-  int* J_nnz;
+  int J_nnz_val;
   int* H_nnz;
   int H_nnz_val;
-  int* J_row;
+  int J_row_val;
   REAL* f;
   REAL* J;
   Mat* H_array;
@@ -590,6 +585,11 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   BOOL var_w[2];
   BOOL var_a;
   BOOL var_phi;
+  int w_index[2];
+  int v_index[2];
+  int a_index;
+  int phi_index;
+  int num_vars;
   int k;
   int m;
 
@@ -626,18 +626,28 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   REAL indicator_a;
   REAL indicator_phi;
 
+  BOOL eval_J;
+  BOOL eval_H;
+  char prod;
+
   // Constr data
   f = VEC_get_data(CONSTR_get_f(c));
   J = MAT_get_data_array(CONSTR_get_J(c));
   H_array = CONSTR_get_H_array(c);
-  J_nnz = CONSTR_get_J_nnz_ptr(c);
   H_nnz = CONSTR_get_H_nnz(c);
-  J_row = CONSTR_get_J_row_ptr(c);
  
   // Check pointers
-  if (!J_nnz || !H_nnz || !J_row || !f || !J || !H_array)
+  if (!H_nnz || !f || !J || !H_array)
     return;
 
+  // Level
+  eval_J = CONSTR_get_eval_level(c) >= EVAL_FJ;
+  eval_H = CONSTR_get_eval_level(c) >= EVAL_FJH;
+  prod = CONSTR_get_product_type(c);
+
+  // Num vars
+  num_vars = NET_get_num_vars(CONSTR_get_network(c));
+
   // Check outage
   if (BRANCH_is_on_outage(br))
     return;
@@ -652,12 +662,14 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   for (k = 0; k < 2; k++) {
     var_v[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VMAG);
     var_w[k] = BUS_has_flags(bus[k],FLAG_VARS,BUS_VAR_VANG);
+    w_index[k] = BUS_get_index_v_ang(bus[k],t);
+    v_index[k] = BUS_get_index_v_mag(bus[k],t);
     if (var_w[k])
-      w[k] = VEC_get(values,BUS_get_index_v_ang(bus[k],t));
+      w[k] = VEC_get(values,w_index[k]);
     else
       w[k] = BUS_get_v_ang(bus[k],t);
     if (var_v[k])
-      v[k] = VEC_get(values,BUS_get_index_v_mag(bus[k],t));
+      v[k] = VEC_get(values,v_index[k]);
     else
       v[k] = BUS_get_v_mag(bus[k],t);
   }
@@ -665,12 +677,14 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   // Branch data
   var_a = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO);
   var_phi = BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE);
+  a_index = BRANCH_get_index_ratio(br,t);
+  phi_index = BRANCH_get_index_phase(br,t);
   if (var_a)
-    a = VEC_get(values,BRANCH_get_index_ratio(br,t));
+    a = VEC_get(values,a_index);
   else
     a = BRANCH_get_ratio(br,t);
   if (var_phi)
-    phi = VEC_get(values,BRANCH_get_index_phase(br,t));
+    phi = VEC_get(values,phi_index);
   else
     phi = BRANCH_get_phase(br,t);
   b = BRANCH_get_b(br);
@@ -684,6 +698,14 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
   //*******
   
   for (k = 0; k < 2; k++) {
+
+    // Side
+    if (!(sides & (k == 0 ? CONSTR_SIDE_K : CONSTR_SIDE_M)))
+      continue;
+
+    // Row and J offset (each direction has the same number of entries)
+    J_row_val = CONSTR_get_branch_J_row(c,br,t)+k;
+    J_nnz_val = CONSTR_get_branch_J_nnz(c,br,t)+k*(var_w[0]+var_v[0]+var_w[1]+var_v[1]+var_a+var_phi+1);
     
     if (k == 0) {
       m = 1;
@@ -710,10 +732,20 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
     sqrterm = sqrt(R*R+I*I+CONSTR_AC_FLOW_LIM_PARAM);
     sqrterm3 = sqrterm*sqrterm*sqrterm;
     
-    H = MAT_get_data_array(MAT_array_get(H_array,*J_row));
+    H = MAT_get_data_array(MAT_array_get(H_array,J_row_val));
+
+    // Extra var
+    if (VEC_get_size(values_extra) > 0)
+      extra_var = VEC_get(values_extra,J_row_val);
+    else
+      extra_var = 0;
 
     // f
-    f[*J_row] = sqrterm;
+    f[J_row_val] = sqrterm-extra_var;
+
+    // Values only
+    if (!eval_J && !prod)
+      continue;
     
     //***********
     if (var_w[k]) { // wk var
@@ -722,60 +754,62 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = -a*v[m]*(-g*costheta+b*sintheta); // dIdwk 
 	
       // J
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/dwk
+      JACOBIAN_ENTRY(w_index[k],(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/dwk
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
-
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
-      d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // wk and wk
-
-      if (var_v[k]) {
-	dRdy = a_temp*a_temp*(g_sh[k]+g);
-	dIdy = a_temp*a_temp*(b_sh[k]+b);
-	d2Rdydx = 0;
-	d2Idydx = 0;
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wk and vk
-      }
-      if (var_w[m]) {
-	dRdy = -a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = -a*v[m]*(g*costheta-b*sintheta);
-	d2Idydx = -a*v[m]*(g*sintheta+b*costheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wk and wm
-      }
-      if (var_v[m]) {
-	dRdy = -a*(g*costheta-b*sintheta);
-	dIdy = -a*(g*sintheta+b*costheta);
-	d2Rdydx = -a*(g*sintheta+b*costheta);
-	d2Idydx = -a*(-g*costheta+b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wk and vm
-      }
-      if (var_a) {
-	dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
-	dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
-	d2Rdydx = -v[m]*(g*sintheta+b*costheta);
-	d2Idydx = -v[m]*(-g*costheta+b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wk and a
-      }
-      if (var_phi) {
-	dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
-	d2Idydx = -indicator_phi*a*v[m]*(g*sintheta+b*costheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wk and phi
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
+
+	dRdy = dRdx;
+	dIdy = dIdx;
+	d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
+	d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
+	HESSIAN_ENTRY(w_index[k],w_index[k]);
+	H_nnz_val++;   // wk and wk
+
+	if (var_v[k]) {
+	  dRdy = a_temp*a_temp*(g_sh[k]+g);
+	  dIdy = a_temp*a_temp*(b_sh[k]+b);
+	  d2Rdydx = 0;
+	  d2Idydx = 0;
+	  HESSIAN_ENTRY(w_index[k],v_index[k]);
+	  H_nnz_val++; // wk and vk
+	}
+	if (var_w[m]) {
+	  dRdy = -a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = -a*v[m]*(g*costheta-b*sintheta);
+	  d2Idydx = -a*v[m]*(g*sintheta+b*costheta);
+	  HESSIAN_ENTRY(w_index[k],w_index[m]);
+	  H_nnz_val++; // wk and wm
+	}
+	if (var_v[m]) {
+	  dRdy = -a*(g*costheta-b*sintheta);
+	  dIdy = -a*(g*sintheta+b*costheta);
+	  d2Rdydx = -a*(g*sintheta+b*costheta);
+	  d2Idydx = -a*(-g*costheta+b*sintheta);
+	  HESSIAN_ENTRY(w_index[k],v_index[m]);
+	  H_nnz_val++; // wk and vm
+	}
+	if (var_a) {
+	  dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
+	  dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
+	  d2Rdydx = -v[m]*(g*sintheta+b*costheta);
+	  d2Idydx = -v[m]*(-g*costheta+b*sintheta);
+	  HESSIAN_ENTRY(w_index[k],a_index);
+	  H_nnz_val++; // wk and a
+	}
+	if (var_phi) {
+	  dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Idydx = -indicator_phi*a*v[m]*(g*sintheta+b*costheta);
+	  HESSIAN_ENTRY(w_index[k],phi_index);
+	  H_nnz_val++; // wk and phi
+	}
+	H_nnz[J_row_val] = H_nnz_val;
       }
-      H_nnz[(*J_row)] = H_nnz_val;
     }
 
     //***********
@@ -785,55 +819,57 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = a_temp*a_temp*(b_sh[k]+b);
 
       // J 
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/dvk
+      JACOBIAN_ENTRY(v_index[k],(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/dvk
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
       
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = 0;
-      d2Idydx = 0;
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // vk and vk
-
-      if (var_w[m]) {
-	dRdy = -a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = 0;
-	d2Idydx = 0;
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vk and wm
-      }
-
-      if (var_v[m]) { 
-	dRdy = -a*(g*costheta-b*sintheta);
-	dIdy = -a*(g*sintheta+b*costheta);
-	d2Rdydx = 0;
-	d2Idydx = 0;
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vk and vm
-      }
-
-      if (var_a) {
-	dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
-	dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
-	d2Rdydx = indicator_a*2.*a_temp*(g_sh[k]+g);
-	d2Idydx = indicator_a*2.*a_temp*(b_sh[k]+b);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vk and a
-      }
-
-      if (var_phi) {  
-	dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	dRdy = dRdx;
+	dIdy = dIdx;
 	d2Rdydx = 0;
 	d2Idydx = 0;
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vk and phi
+	HESSIAN_ENTRY(v_index[k],v_index[k]);
+	H_nnz_val++;   // vk and vk
+
+	if (var_w[m]) {
+	  dRdy = -a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = 0;
+	  d2Idydx = 0;
+	  HESSIAN_ENTRY(v_index[k],w_index[m]);
+	  H_nnz_val++; // vk and wm
+	}
+
+	if (var_v[m]) { 
+	  dRdy = -a*(g*costheta-b*sintheta);
+	  dIdy = -a*(g*sintheta+b*costheta);
+	  d2Rdydx = 0;
+	  d2Idydx = 0;
+	  HESSIAN_ENTRY(v_index[k],v_index[m]);
+	  H_nnz_val++; // vk and vm
+	}
+
+	if (var_a) {
+	  dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
+	  dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
+	  d2Rdydx = indicator_a*2.*a_temp*(g_sh[k]+g);
+	  d2Idydx = indicator_a*2.*a_temp*(b_sh[k]+b);
+	  HESSIAN_ENTRY(v_index[k],a_index);
+	  H_nnz_val++; // vk and a
+	}
+
+	if (var_phi) {  
+	  dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = 0;
+	  d2Idydx = 0;
+	  HESSIAN_ENTRY(v_index[k],phi_index);
+	  H_nnz_val++; // vk and phi
+	}
+	H_nnz[J_row_val] = H_nnz_val;
       }
-      H_nnz[(*J_row)] = H_nnz_val;
     }
 
     //***********
@@ -843,46 +879,48 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = -a*v[m]*(g*costheta-b*sintheta);
       
       // J 
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/dwm
+      JACOBIAN_ENTRY(w_index[m],(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/dwm
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
-
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
-      d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // wm and wm
-
-      if (var_v[m]) {
-	dRdy = -a*(g*costheta-b*sintheta);
-	dIdy = -a*(g*sintheta+b*costheta);
-	d2Rdydx = -a*(-g*sintheta-b*costheta);
-	d2Idydx = -a*(g*costheta-b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wm and vm
-      }
-
-      if (var_a) {
-	dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
-	dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
-	d2Rdydx = -v[m]*(-g*sintheta-b*costheta);
-	d2Idydx = -v[m]*(g*costheta-b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wm and a
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
+
+	dRdy = dRdx;
+	dIdy = dIdx;
+	d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
+	d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
+	HESSIAN_ENTRY(w_index[m],w_index[m]);
+	H_nnz_val++;   // wm and wm
+
+	if (var_v[m]) {
+	  dRdy = -a*(g*costheta-b*sintheta);
+	  dIdy = -a*(g*sintheta+b*costheta);
+	  d2Rdydx = -a*(-g*sintheta-b*costheta);
+	  d2Idydx = -a*(g*costheta-b*sintheta);
+	  HESSIAN_ENTRY(w_index[m],v_index[m]);
+	  H_nnz_val++; // wm and vm
+	}
+
+	if (var_a) {
+	  dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
+	  dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
+	  d2Rdydx = -v[m]*(-g*sintheta-b*costheta);
+	  d2Idydx = -v[m]*(g*costheta-b*sintheta);
+	  HESSIAN_ENTRY(w_index[m],a_index);
+	  H_nnz_val++; // wm and a
+	}
+
+	if (var_phi) {
+	  dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = -indicator_phi*a*v[m]*(-g*costheta+b*sintheta);
+	  d2Idydx = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  HESSIAN_ENTRY(w_index[m],phi_index);
+	  H_nnz_val++; // wm and phi
+	}
+	H_nnz[J_row_val] = H_nnz_val;
       }
-
-      if (var_phi) {
-	dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = -indicator_phi*a*v[m]*(-g*costheta+b*sintheta);
-	d2Idydx = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // wm and phi
-      }
-      H_nnz[(*J_row)] = H_nnz_val;
     }
 
     //***********
@@ -892,37 +930,39 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = -a*(g*sintheta+b*costheta);
 
       // J 
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/dvm
+      JACOBIAN_ENTRY(v_index[m],(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/dvm
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
 
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = 0;
-      d2Idydx = 0;
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // vm and vm
-
-      if (var_a) {
-	dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
-	dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
-	d2Rdydx = -(g*costheta-b*sintheta);
-	d2Idydx = -(g*sintheta+b*costheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vm and a
-      }
-
-      if (var_phi) {
-	dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = -indicator_phi*a*(-g*sintheta-b*costheta);
-	d2Idydx = -indicator_phi*a*(g*costheta-b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // vm and phi
+	dRdy = dRdx;
+	dIdy = dIdx;
+	d2Rdydx = 0;
+	d2Idydx = 0;
+	HESSIAN_ENTRY(v_index[m],v_index[m]);
+	H_nnz_val++;   // vm and vm
+
+	if (var_a) {
+	  dRdy = indicator_a*2.*a_temp*(g_sh[k]+g)*v[k]-v[m]*(g*costheta-b*sintheta);
+	  dIdy = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
+	  d2Rdydx = -(g*costheta-b*sintheta);
+	  d2Idydx = -(g*sintheta+b*costheta);
+	  HESSIAN_ENTRY(v_index[m],a_index);
+	  H_nnz_val++; // vm and a
+	}
+
+	if (var_phi) {
+	  dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = -indicator_phi*a*(-g*sintheta-b*costheta);
+	  d2Idydx = -indicator_phi*a*(g*costheta-b*sintheta);
+	  HESSIAN_ENTRY(v_index[m],phi_index);
+	  H_nnz_val++; // vm and phi
+	}
+	H_nnz[J_row_val] = H_nnz_val;
       }
-      H_nnz[(*J_row)] = H_nnz_val;
     }
 
     //********
@@ -932,28 +972,30 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = indicator_a*2.*a_temp*(b_sh[k]+b)*v[k]-v[m]*(g*sintheta+b*costheta);
       
       // J 
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/da
+      JACOBIAN_ENTRY(a_index,(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/da
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
-
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = indicator_a*2.*(g_sh[k]+g)*v[k];
-      d2Idydx = indicator_a*2.*(b_sh[k]+b)*v[k];
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // a and a
-
-      if (var_phi) {
-	dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
-	dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
-	d2Rdydx = -indicator_phi*v[m]*(-g*sintheta-b*costheta);
-	d2Idydx = -indicator_phi*v[m]*(g*costheta-b*sintheta);
-	H[H_nnz_val] = HESSIAN_VAL();
-	H_nnz_val++; // a and phi
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
+
+	dRdy = dRdx;
+	dIdy = dIdx;
+	d2Rdydx = indicator_a*2.*(g_sh[k]+g)*v[k];
+	d2Idydx = indicator_a*2.*(b_sh[k]+b)*v[k];
+	HESSIAN_ENTRY(a_index,a_index);
+	H_nnz_val++;   // a and a
+
+	if (var_phi) {
+	  dRdy = -indicator_phi*a*v[m]*(-g*sintheta-b*costheta);
+	  dIdy = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
+	  d2Rdydx = -indicator_phi*v[m]*(-g*sintheta-b*costheta);
+	  d2Idydx = -indicator_phi*v[m]*(g*costheta-b*sintheta);
+	  HESSIAN_ENTRY(a_index,phi_index);
+	  H_nnz_val++; // a and phi
+	}
+	H_nnz[J_row_val] = H_nnz_val;
       }
-      H_nnz[(*J_row)] = H_nnz_val;
     }
     
     //**********
@@ -963,37 +1005,28 @@ void CONSTR_AC_FLOW_LIM_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec
       dIdx = -indicator_phi*a*v[m]*(g*costheta-b*sintheta);
       
       // J 
-      J[*J_nnz] = (R*dRdx + I*dIdx)/sqrterm;
-      (*J_nnz)++; // d|ikm|/dphi
+      JACOBIAN_ENTRY(phi_index,(R*dRdx + I*dIdx)/sqrterm);
+      J_nnz_val++; // d|ikm|/dphi
       
       // H
-      H_nnz_val = H_nnz[(*J_row)];
-
-      dRdy = dRdx;
-      dIdy = dIdx;
-      d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
-      d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
-      H[H_nnz_val] = HESSIAN_VAL();
-      H_nnz_val++;   // phi and phi
-      H_nnz[(*J_row)] = H_nnz_val;
+      if (eval_H || prod == CONSTR_PROD_HV) {
+	H_nnz_val = H_nnz[J_row_val];
+
+	dRdy = dRdx;
+	dIdy = dIdx;
+	d2Rdydx = -a*v[m]*(-g*costheta+b*sintheta);
+	d2Idydx = -a*v[m]*(-g*sintheta-b*costheta);
+	HESSIAN_ENTRY(phi_index,phi_index);
+	H_nnz_val++;   // phi and phi
+	H_nnz[J_row_val] = H_nnz_val;
+      }
     }
 
     //**********
-
-    if (VEC_get_size(values_extra) > 0)
-      extra_var = VEC_get(values_extra,*J_row);
-    else
-      extra_var = 0;
-   
-    // f
-    f[*J_row] -= extra_var;
  
     // J 
-    J[*J_nnz] = -1.;
-    (*J_nnz)++;      // extra var
-    
-    // Constraint counter
-    (*J_row)++;
+    JACOBIAN_ENTRY(num_vars+J_row_val,-1.);
+    J_nnz_val++;      // extra var
   }  
 }
 
@@ -237,26 +237,28 @@ void CONSTR_AC_LIN_FLOW_LIM_allocate(Constr* c) {
   int num_vars;
   int G_nnz;
   int G_row;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   net = CONSTR_get_network(c);
   num_vars = NET_get_num_vars(net);
   G_nnz = CONSTR_get_G_nnz(c);
   G_row = CONSTR_get_G_row(c);
 
   // J f (from f(x) = 0)
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // A b (from Ax = b)
-  CONSTR_set_A(c,MAT_new(0,num_vars,0));
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // G l u (from l <= Gx <= u)
-  CONSTR_set_G(c,MAT_new(G_row,    // size1 (rows)
-			 num_vars, // size2 (cols)
-			 G_nnz));  // nnz
-  CONSTR_set_l(c,VEC_new(G_row));
-  CONSTR_set_u(c,VEC_new(G_row));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,G_row,    // size1 (rows)
+					 num_vars, // size2 (cols)
+					 G_nnz));  // nnz
+  CONSTR_set_l(c,VEC_new_from_pool(pool,G_row));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,G_row));
 }
 
 void CONSTR_AC_LIN_FLOW_LIM_analyze_step(Constr* c, Branch* br, int t) {
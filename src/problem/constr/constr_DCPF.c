@@ -35,9 +35,6 @@ void CONSTR_DCPF_clear(Constr* c) {
 
   // Counters
   CONSTR_set_A_nnz(c,0);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_DCPF_count_step(Constr* c, Branch* br, int t) {
@@ -173,28 +170,30 @@ void CONSTR_DCPF_allocate(Constr* c) {
   int num_buses;
   int num_vars;
   int A_nnz;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   net = CONSTR_get_network(c);
   num_buses = NET_get_num_buses(net);
   num_vars = NET_get_num_vars(net);
   A_nnz = CONSTR_get_A_nnz(c);
 
   // J f
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
 
   // b
-  CONSTR_set_b(c,VEC_new(num_buses*NET_get_num_periods(net)));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,num_buses*NET_get_num_periods(net)));
 
   // A
-  CONSTR_set_A(c,MAT_new(num_buses*NET_get_num_periods(net), // size1 (rows)
-			 num_vars,                           // size2 (cols)
-			 A_nnz));                         // nnz
+  CONSTR_set_A(c,MAT_new_from_pool(pool,num_buses*NET_get_num_periods(net), // size1 (rows)
+					 num_vars,                           // size2 (cols)
+					 A_nnz));                         // nnz
 }
 
 void CONSTR_DCPF_analyze_step(Constr* c, Branch* br, int t) {
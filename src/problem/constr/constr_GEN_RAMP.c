@@ -14,6 +14,7 @@ Constr* CONSTR_GEN_RAMP_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c, &CONSTR_GEN_RAMP_init);
   CONSTR_set_func_count_step(c, &CONSTR_GEN_RAMP_count_step);
+  CONSTR_set_func_count(c, &CONSTR_GEN_RAMP_count);
   CONSTR_set_func_allocate(c, &CONSTR_GEN_RAMP_allocate);
   CONSTR_set_func_clear(c, &CONSTR_GEN_RAMP_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_GEN_RAMP_analyze_step);
@@ -36,9 +37,45 @@ void CONSTR_GEN_RAMP_clear(Constr* c) {
   // Counters
   CONSTR_set_G_nnz(c,0);
   CONSTR_set_G_row(c,0);
+}
+
+void CONSTR_GEN_RAMP_count(Constr* c) {
+
+  // Local variables
+  Net* net;
+  Bus* bus;
+  Gen* gen;
+  int* G_nnz;
+  int* G_row;
+  int num;
+  int T;
+  int i;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  G_nnz = CONSTR_get_G_nnz_ptr(c);
+  G_row = CONSTR_get_G_row_ptr(c);
+  T = NET_get_num_periods(net);
+
+  // Check pointers
+  if (!G_nnz || !G_row || T < 1)
+    return;
+
+  // Generators with active power variables (buses reached by the counting sweep)
+  num = 0;
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    if (BUS_is_isolated(bus))
+      continue;
+    for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	num++;
+    }
+  }
 
-  // Flags
-  CONSTR_clear_bus_counted(c);
+  // One nonzero at t = 0 and two afterwards
+  (*G_nnz) += num*(2*T-1);
+  (*G_row) += num*T;
 }
 
 void CONSTR_GEN_RAMP_count_step(Constr* c, Branch* br, int t) {
@@ -105,25 +142,27 @@ void CONSTR_GEN_RAMP_allocate(Constr* c) {
   int num_constr;
   int num_vars;
   int G_nnz;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
   num_constr = CONSTR_get_G_row(c);
   G_nnz = CONSTR_get_G_nnz(c);
 
   // J f
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // A b
-  CONSTR_set_A(c,MAT_new(0,num_vars,0));
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // G l u
-  CONSTR_set_l(c,VEC_new(num_constr));
-  CONSTR_set_u(c,VEC_new(num_constr));
-  CONSTR_set_G(c,MAT_new(num_constr, // size1 (rows)
-			 num_vars,   // size2 (cols)
-			 G_nnz));    // nnz
+  CONSTR_set_l(c,VEC_new_from_pool(pool,num_constr));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,num_constr));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,num_constr, // size1 (rows)
+					 num_vars,   // size2 (cols)
+					 G_nnz));    // nnz
 }
 
 void CONSTR_GEN_RAMP_analyze_step(Constr* c, Branch* br, int t) {
@@ -14,6 +14,7 @@ Constr* CONSTR_LBOUND_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c,&CONSTR_LBOUND_init);
   CONSTR_set_func_count_step(c,&CONSTR_LBOUND_count_step);
+  CONSTR_set_func_count(c,&CONSTR_LBOUND_count);
   CONSTR_set_func_allocate(c,&CONSTR_LBOUND_allocate);
   CONSTR_set_func_clear(c,&CONSTR_LBOUND_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_LBOUND_analyze_step);
@@ -36,36 +37,39 @@ void CONSTR_LBOUND_clear(Constr* c) {
   // Counters
   CONSTR_set_G_nnz(c,0);
   CONSTR_set_G_row(c,0);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_LBOUND_count_step(Constr* c, Branch* br, int t) {
   // Nothing
 }
 
+void CONSTR_LBOUND_count(Constr* c) {
+  // Nothing (sizes given by number of variables)
+}
+
 void CONSTR_LBOUND_allocate(Constr *c) {
 
   // Local variables
   int num_vars;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
 
   // J f
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // A b
-  CONSTR_set_A(c,MAT_new(0,num_vars,0));
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // l u G
-  CONSTR_set_l(c,VEC_new(num_vars));
-  CONSTR_set_u(c,VEC_new(num_vars));
-  CONSTR_set_G(c,MAT_new(num_vars,   // size1 (rows)
-			 num_vars,   // size2 (cols)
-			 num_vars)); // nnz
+  CONSTR_set_l(c,VEC_new_from_pool(pool,num_vars));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,num_vars));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,num_vars,   // size1 (rows)
+					 num_vars,   // size2 (cols)
+					 num_vars)); // nnz
 }
 
 void CONSTR_LBOUND_analyze_step(Constr* c, Branch* br, int t) {
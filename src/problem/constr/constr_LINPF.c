@@ -38,6 +38,7 @@ void CONSTR_LINPF_clear(Constr* c) {
   // ACPF
   Constr* acpf = (Constr*)CONSTR_get_data(c);
   CONSTR_clear(acpf);
+  CONSTR_clear_bus_counted(acpf);
 }
 
 void CONSTR_LINPF_count_step(Constr* c, Branch* br, int t) {
@@ -53,7 +54,9 @@ void CONSTR_LINPF_allocate(Constr* c) {
   Net* net;
   int num_vars;
   Constr* acpf;
+  Pool* pool;
   
+  pool = CONSTR_get_pool(c);
   net = CONSTR_get_network(c);
   num_vars = NET_get_num_vars(net);
   acpf = (Constr*)CONSTR_get_data(c);
@@ -66,13 +69,13 @@ void CONSTR_LINPF_allocate(Constr* c) {
   CONSTR_set_b(c,CONSTR_get_f(acpf)); // temporary
 
   // J f (empty)
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // G l u (empty)
-  CONSTR_set_G(c,MAT_new(0,num_vars,0));
-  CONSTR_set_l(c,VEC_new(0));
-  CONSTR_set_u(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
 }
 
 void CONSTR_LINPF_analyze_step(Constr* c, Branch* br, int t) {
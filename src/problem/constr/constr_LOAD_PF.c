@@ -36,9 +36,6 @@ void CONSTR_LOAD_PF_clear(Constr* c) {
   // Counters
   CONSTR_set_A_nnz(c,0);
   CONSTR_set_A_row(c,0);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_LOAD_PF_count_step(Constr* c, Branch* br, int t) {
@@ -103,27 +100,29 @@ void CONSTR_LOAD_PF_allocate(Constr* c) {
   int num_constr;
   int num_vars;
   int A_nnz;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
   num_constr = CONSTR_get_A_row(c);
   A_nnz = CONSTR_get_A_nnz(c);
 
   // J f
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // A b
-  CONSTR_set_A(c,MAT_new(num_constr, // rows
-			 num_vars,   // cols
-			 A_nnz));    // nnz
-  CONSTR_set_b(c,VEC_new(num_constr));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,num_constr, // rows
+					 num_vars,   // cols
+					 A_nnz));    // nnz
+  CONSTR_set_b(c,VEC_new_from_pool(pool,num_constr));
 
   // G l u
-  CONSTR_set_l(c,VEC_new(0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_G(c,MAT_new(0,        // rows
-			 num_vars, // cols
-			 0));      // nnz
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,        // rows
+					 num_vars, // cols
+					 0));      // nnz
 }
 
 void CONSTR_LOAD_PF_analyze_step(Constr* c, Branch* br, int t) {
@@ -8,6 +8,7 @@
  * PFNET is released under the BSD 2-clause license.
  */
 
+#include <pfnet/array.h>
 #include <pfnet/constr_NBOUND.h>
 
 Constr* CONSTR_NBOUND_new(Net* net) {
@@ -17,7 +18,8 @@ Constr* CONSTR_NBOUND_new(Net* net) {
   CONSTR_set_func_allocate(c, &CONSTR_NBOUND_allocate);
   CONSTR_set_func_clear(c, &CONSTR_NBOUND_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_NBOUND_analyze_step);
-  CONSTR_set_func_eval_step(c, &CONSTR_NBOUND_eval_step);
+  CONSTR_set_func_eval_branch_step(c, &CONSTR_NBOUND_eval_branch_step);
+  CONSTR_set_func_eval_bus_step(c, &CONSTR_NBOUND_eval_bus_step);
   CONSTR_set_func_store_sens_step(c, &CONSTR_NBOUND_store_sens_step);
   CONSTR_set_func_free(c, &CONSTR_NBOUND_free);
   CONSTR_init(c);
@@ -45,9 +47,6 @@ void CONSTR_NBOUND_clear(Constr* c) {
 
   // Counters
   CONSTR_set_J_nnz(c,0);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_NBOUND_count_step(Constr* c, Branch* br, int t) {
@@ -157,47 +156,44 @@ void CONSTR_NBOUND_allocate(Constr* c) {
   // Local variables
   int J_nnz;
   Mat* H_array;
-  Mat* H;
+  int* H_nnz;
   int num_vars;
   int i;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   J_nnz = CONSTR_get_J_nnz(c);
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
 
   // A b
-  CONSTR_set_A(c,MAT_new(0,num_vars,0));
-  CONSTR_set_b(c,VEC_new(0));
+  CONSTR_set_A(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,0));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
 
   // f
-  CONSTR_set_f(c,VEC_new(J_nnz));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,J_nnz));
 
   // J
-  CONSTR_set_J(c,MAT_new(J_nnz,    // size1 (rows)
-			 num_vars, // size2 (cols)
-			 J_nnz));  // nnz
+  CONSTR_set_J(c,MAT_new_from_pool(pool,J_nnz,    // size1 (rows)
+					 num_vars, // size2 (cols)
+					 J_nnz));  // nnz
 
   // H
-  H_array = MAT_array_new(J_nnz);
+  ARRAY_alloc(H_nnz,int,J_nnz);
+  for (i = 0; i < J_nnz; i++)
+    H_nnz[i] = 1;
+  H_array = MAT_array_new_block_from_pool(pool,J_nnz,num_vars,num_vars,H_nnz,NULL);
   CONSTR_set_H_array(c,H_array,J_nnz);
-  for (i = 0; i < J_nnz; i++) {
-    H = MAT_array_get(H_array,i);
-    MAT_set_nnz(H,1);
-    MAT_set_size1(H,num_vars);
-    MAT_set_size2(H,num_vars);
-    MAT_set_row_array(H,(int*)calloc(1,sizeof(int)));
-    MAT_set_col_array(H,(int*)calloc(1,sizeof(int)));
-    MAT_set_data_array(H,(REAL*)malloc(1*sizeof(REAL)));
-  }
+  free(H_nnz);
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars,   // size1 (rows)
-				  num_vars,   // size2 (cols)
-				  J_nnz)); // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars,   // size1 (rows)
+						  num_vars,   // size2 (cols)
+						  J_nnz)); // nnz
 }
 
 void CONSTR_NBOUND_analyze_step(Constr* c, Branch* br, int t) {
@@ -304,6 +300,9 @@ void CONSTR_NBOUND_analyze_step(Constr* c, Branch* br, int t) {
 
     if (!bus_counted[bus_index_t[k]]) { // not counted yet
 
+      // Offset
+      CONSTR_save_bus_counters(c,bus,t);
+
       // Voltage magnitude (V_MAG)
       if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VMAG) && BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
 
@@ -446,21 +445,14 @@ void CONSTR_NBOUND_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
+void CONSTR_NBOUND_eval_branch_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra, char sides) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
-  Gen* gen;
-  Shunt* shunt;
   Mat* H_array;
   REAL* f;
   REAL* J;
   Mat* H;
-  int* J_nnz;
-  char* bus_counted;
-  int bus_index_t[2];
-  int k;
+  int J_nnz_val;
   REAL u;
   REAL umin;
   REAL umax;
@@ -471,34 +463,29 @@ void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* val
   REAL eps;
   REAL sqrterm1;
   REAL sqrterm2;
-  int T;
-
-  // Number of periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   f = VEC_get_data(CONSTR_get_f(c));
   J = MAT_get_data_array(CONSTR_get_J(c));
   H_array = CONSTR_get_H_array(c);
-  J_nnz = CONSTR_get_J_nnz_ptr(c);
-  bus_counted = CONSTR_get_bus_counted(c);
 
   // Check pointers
-  if (!f || !J || !J_nnz || !bus_counted)
+  if (!f || !J)
     return;
 
   // Check outage
   if (BRANCH_is_on_outage(br))
     return;
 
+  // Branch entries are evaluated with side "k"
+  if (!(sides & CONSTR_SIDE_K))
+    return;
+
   // Param
   eps = CONSTR_NBOUND_PARAM;
 
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+  // J offset
+  J_nnz_val = CONSTR_get_branch_J_nnz(c,br,t);
 
   // Branch
   //*******
@@ -519,22 +506,22 @@ void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* val
     sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
     // f
-    f[*J_nnz]   = a1 + b - sqrterm1; // upper
-    f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+    f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+    f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
     // J
-    J[*J_nnz]   = -(1-a1/sqrterm1);
-    J[*J_nnz+1] = (1-a2/sqrterm2);
+    J[J_nnz_val]   = -(1-a1/sqrterm1);
+    J[J_nnz_val+1] = (1-a2/sqrterm2);
 
     // H
-    H = MAT_array_get(H_array,*J_nnz);
+    H = MAT_array_get(H_array,J_nnz_val);
     MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-    H = MAT_array_get(H_array,*J_nnz+1);
+    H = MAT_array_get(H_array,J_nnz_val+1);
     MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-    (*J_nnz)++;
-    (*J_nnz)++;
+    J_nnz_val++;
+    J_nnz_val++;
   }
 
   // Phase shift
@@ -553,214 +540,237 @@ void CONSTR_NBOUND_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* val
     sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
     // f
-    f[*J_nnz]   = a1 + b - sqrterm1; // upper
-    f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+    f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+    f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
     // J
-    J[*J_nnz]   = -(1-a1/sqrterm1);
-    J[*J_nnz+1] = (1-a2/sqrterm2);
+    J[J_nnz_val]   = -(1-a1/sqrterm1);
+    J[J_nnz_val+1] = (1-a2/sqrterm2);
 
     // H
-    H = MAT_array_get(H_array,*J_nnz);
+    H = MAT_array_get(H_array,J_nnz_val);
     MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-    H = MAT_array_get(H_array,*J_nnz+1);
+    H = MAT_array_get(H_array,J_nnz_val+1);
     MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-    (*J_nnz)++;
-    (*J_nnz)++;
+    J_nnz_val++;
+    J_nnz_val++;
   }
+}
 
-  // Buses
-  //******
+void CONSTR_NBOUND_eval_bus_step(Constr* c, Bus* bus, int t, Vec* values, Vec* values_extra) {
 
-  for (k = 0; k < 2; k++) {
+  // Local variables
+  Gen* gen;
+  Shunt* shunt;
+  Mat* H_array;
+  REAL* f;
+  REAL* J;
+  Mat* H;
+  int J_nnz_val;
+  REAL u;
+  REAL umin;
+  REAL umax;
+  REAL du;
+  REAL a1;
+  REAL a2;
+  REAL b;
+  REAL eps;
+  REAL sqrterm1;
+  REAL sqrterm2;
 
-    bus = buses[k];
+  // Constr data
+  f = VEC_get_data(CONSTR_get_f(c));
+  J = MAT_get_data_array(CONSTR_get_J(c));
+  H_array = CONSTR_get_H_array(c);
 
-    if (!bus_counted[bus_index_t[k]]) { // not counted yet
+  // Check pointers
+  if (!f || !J)
+    return;
 
-      // Voltage magnitude (V_MAG)
-      if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VMAG) &&
-	  BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
+  // Param
+  eps = CONSTR_NBOUND_PARAM;
 
-	u = VEC_get(values,BUS_get_index_v_mag(bus,t));
-	umax = BUS_get_v_max_norm(bus);
-	umin = BUS_get_v_min_norm(bus);
-	du = (umax-umin > eps) ? umax-umin : eps;
+  // J offset
+  J_nnz_val = CONSTR_get_bus_J_nnz(c,bus,t);
 
-	a1 = umax-u;
-	a2 = u-umin;
-	b = eps*eps/du;
-	sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
-	sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+  // Voltage magnitude (V_MAG)
+  if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VMAG) &&
+      BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
 
-	// f
-	f[*J_nnz]   = a1 + b - sqrterm1; // upper
-	f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+    u = VEC_get(values,BUS_get_index_v_mag(bus,t));
+    umax = BUS_get_v_max_norm(bus);
+    umin = BUS_get_v_min_norm(bus);
+    du = (umax-umin > eps) ? umax-umin : eps;
 
-	// J
-	J[*J_nnz]   = -(1-a1/sqrterm1);
-	J[*J_nnz+1] = (1-a2/sqrterm2);
+    a1 = umax-u;
+    a2 = u-umin;
+    b = eps*eps/du;
+    sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+    sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
-	// H
-	H = MAT_array_get(H_array,*J_nnz);
-	MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
+    // f
+    f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+    f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
-	H = MAT_array_get(H_array,*J_nnz+1);
-	MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+    // J
+    J[J_nnz_val]   = -(1-a1/sqrterm1);
+    J[J_nnz_val+1] = (1-a2/sqrterm2);
 
-	(*J_nnz)++;
-	(*J_nnz)++;
-      }
+    // H
+    H = MAT_array_get(H_array,J_nnz_val);
+    MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-      // Volage angle (V_ANG)
-      if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VANG) &&
-	  BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) {
+    H = MAT_array_get(H_array,J_nnz_val+1);
+    MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-	u = VEC_get(values,BUS_get_index_v_ang(bus,t));
-	umax = 2*PI;
-	umin = -2*PI;
-	du = (umax-umin > eps) ? umax-umin : eps;
+    J_nnz_val++;
+    J_nnz_val++;
+  }
 
-	a1 = umax-u;
-	a2 = u-umin;
-	b = eps*eps/du;
-	sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
-	sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+  // Volage angle (V_ANG)
+  if (BUS_has_flags(bus,FLAG_BOUNDED,BUS_VAR_VANG) &&
+      BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) {
 
-	// f
-	f[*J_nnz]   = a1 + b - sqrterm1; // upper
-	f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+    u = VEC_get(values,BUS_get_index_v_ang(bus,t));
+    umax = 2*PI;
+    umin = -2*PI;
+    du = (umax-umin > eps) ? umax-umin : eps;
 
-	// J
-	J[*J_nnz]   = -(1-a1/sqrterm1);
-	J[*J_nnz+1] = (1-a2/sqrterm2);
+    a1 = umax-u;
+    a2 = u-umin;
+    b = eps*eps/du;
+    sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+    sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
-	// H
-	H = MAT_array_get(H_array,*J_nnz);
-	MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
+    // f
+    f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+    f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
-	H = MAT_array_get(H_array,*J_nnz+1);
-	MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+    // J
+    J[J_nnz_val]   = -(1-a1/sqrterm1);
+    J[J_nnz_val+1] = (1-a2/sqrterm2);
 
-	(*J_nnz)++;
-	(*J_nnz)++;
-      }
+    // H
+    H = MAT_array_get(H_array,J_nnz_val);
+    MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-      // Generators
-      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+    H = MAT_array_get(H_array,J_nnz_val+1);
+    MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-	// Active power (P)
-	if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_P) &&
-	    GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+    J_nnz_val++;
+    J_nnz_val++;
+  }
 
-	  u = VEC_get(values,GEN_get_index_P(gen,t));
-	  umax = GEN_get_P_max(gen);
-	  umin = GEN_get_P_min(gen);
-	  du = (umax-umin > eps) ? umax-umin : eps;
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
 
-	  a1 = umax-u;
-	  a2 = u-umin;
-	  b = eps*eps/du;
-	  sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
-	  sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+    // Active power (P)
+    if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_P) &&
+	GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
 
-	  // f
-	  f[*J_nnz]   = a1 + b - sqrterm1; // upper
-	  f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+      u = VEC_get(values,GEN_get_index_P(gen,t));
+      umax = GEN_get_P_max(gen);
+      umin = GEN_get_P_min(gen);
+      du = (umax-umin > eps) ? umax-umin : eps;
 
-	  // J
-	  J[*J_nnz]   = -(1-a1/sqrterm1);
-	  J[*J_nnz+1] = (1-a2/sqrterm2);
+      a1 = umax-u;
+      a2 = u-umin;
+      b = eps*eps/du;
+      sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+      sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
-	  // H
-	  H = MAT_array_get(H_array,*J_nnz);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
+      // f
+      f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+      f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
-	  H = MAT_array_get(H_array,*J_nnz+1);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+      // J
+      J[J_nnz_val]   = -(1-a1/sqrterm1);
+      J[J_nnz_val+1] = (1-a2/sqrterm2);
 
-	  (*J_nnz)++;
-	  (*J_nnz)++;
-	}
+      // H
+      H = MAT_array_get(H_array,J_nnz_val);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-	// Reactive power (Q)
-	if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_Q) &&
-	    GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
+      H = MAT_array_get(H_array,J_nnz_val+1);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-	  u = VEC_get(values,GEN_get_index_Q(gen,t));
-	  umax = GEN_get_Q_max(gen);
-	  umin = GEN_get_Q_min(gen);
-	  du = (umax-umin > eps) ? umax-umin : eps;
+      J_nnz_val++;
+      J_nnz_val++;
+    }
 
-	  a1 = umax-u;
-	  a2 = u-umin;
-	  b = eps*eps/du;
-	  sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
-	  sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+    // Reactive power (Q)
+    if (GEN_has_flags(gen,FLAG_BOUNDED,GEN_VAR_Q) &&
+	GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
 
-	  // f
-	  f[*J_nnz]   = a1 + b - sqrterm1; // upper
-	  f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+      u = VEC_get(values,GEN_get_index_Q(gen,t));
+      umax = GEN_get_Q_max(gen);
+      umin = GEN_get_Q_min(gen);
+      du = (umax-umin > eps) ? umax-umin : eps;
 
-	  // J
-	  J[*J_nnz]   = -(1-a1/sqrterm1);
-	  J[*J_nnz+1] = (1-a2/sqrterm2);
+      a1 = umax-u;
+      a2 = u-umin;
+      b = eps*eps/du;
+      sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+      sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
-	  // H
-	  H = MAT_array_get(H_array,*J_nnz);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
+      // f
+      f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+      f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
-	  H = MAT_array_get(H_array,*J_nnz+1);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+      // J
+      J[J_nnz_val]   = -(1-a1/sqrterm1);
+      J[J_nnz_val+1] = (1-a2/sqrterm2);
 
-	  (*J_nnz)++;
-	  (*J_nnz)++;
-	}
-      }
+      // H
+      H = MAT_array_get(H_array,J_nnz_val);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-      // Shunts
-      for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+      H = MAT_array_get(H_array,J_nnz_val+1);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
 
-	// Susceptance
-	if (SHUNT_has_flags(shunt,FLAG_BOUNDED,SHUNT_VAR_SUSC) &&
-	    SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
+      J_nnz_val++;
+      J_nnz_val++;
+    }
+  }
 
-	  u = VEC_get(values,SHUNT_get_index_b(shunt,t));
-	  umax = SHUNT_get_b_max(shunt);
-	  umin = SHUNT_get_b_min(shunt);
-	  du = (umax-umin > eps) ? umax-umin : eps;
+  // Shunts
+  for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
 
-	  a1 = umax-u;
-	  a2 = u-umin;
-	  b = eps*eps/du;
-	  sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
-	  sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
+    // Susceptance
+    if (SHUNT_has_flags(shunt,FLAG_BOUNDED,SHUNT_VAR_SUSC) &&
+	SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
 
-	  // f
-	  f[*J_nnz]   = a1 + b - sqrterm1; // upper
-	  f[*J_nnz+1] = a2 + b - sqrterm2; // lower
+      u = VEC_get(values,SHUNT_get_index_b(shunt,t));
+      umax = SHUNT_get_b_max(shunt);
+      umin = SHUNT_get_b_min(shunt);
+      du = (umax-umin > eps) ? umax-umin : eps;
 
-	  // J
-	  J[*J_nnz]   = -(1-a1/sqrterm1);
-	  J[*J_nnz+1] = (1-a2/sqrterm2);
+      a1 = umax-u;
+      a2 = u-umin;
+      b = eps*eps/du;
+      sqrterm1 = sqrt(a1*a1+b*b+eps*eps);
+      sqrterm2 = sqrt(a2*a2+b*b+eps*eps);
 
-	  // H
-	  H = MAT_array_get(H_array,*J_nnz);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
+      // f
+      f[J_nnz_val]   = a1 + b - sqrterm1; // upper
+      f[J_nnz_val+1] = a2 + b - sqrterm2; // lower
 
-	  H = MAT_array_get(H_array,*J_nnz+1);
-	  MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+      // J
+      J[J_nnz_val]   = -(1-a1/sqrterm1);
+      J[J_nnz_val+1] = (1-a2/sqrterm2);
 
-	  (*J_nnz)++;
-	  (*J_nnz)++;
-	}
-      }
-    }
+      // H
+      H = MAT_array_get(H_array,J_nnz_val);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm1*sqrterm1*sqrterm1));
 
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
+      H = MAT_array_get(H_array,J_nnz_val+1);
+      MAT_set_d(H,0,-(b*b+eps*eps)/(sqrterm2*sqrterm2*sqrterm2));
+
+      J_nnz_val++;
+      J_nnz_val++;
+    }
   }
 }
 
@@ -14,6 +14,7 @@ Constr* CONSTR_PAR_GEN_P_new(Net* net) {
   Constr* c = CONSTR_new(net);
   CONSTR_set_func_init(c, &CONSTR_PAR_GEN_P_init);
   CONSTR_set_func_count_step(c, &CONSTR_PAR_GEN_P_count_step);
+  CONSTR_set_func_count(c, &CONSTR_PAR_GEN_P_count);
   CONSTR_set_func_allocate(c, &CONSTR_PAR_GEN_P_allocate);
   CONSTR_set_func_clear(c, &CONSTR_PAR_GEN_P_clear);
   CONSTR_set_func_analyze_step(c, &CONSTR_PAR_GEN_P_analyze_step);
@@ -36,9 +37,52 @@ void CONSTR_PAR_GEN_P_clear(Constr* c) {
   // Counters
   CONSTR_set_A_nnz(c,0);
   CONSTR_set_A_row(c,0);
+}
+
+void CONSTR_PAR_GEN_P_count(Constr* c) {
+
+  // Local variables
+  Net* net;
+  Bus* bus;
+  Gen* gen1;
+  Gen* gen2;
+  int* A_nnz;
+  int* A_row;
+  int nnz;
+  int row;
+  int T;
+  int i;
+
+  // Constr data
+  net = CONSTR_get_network(c);
+  A_nnz = CONSTR_get_A_nnz_ptr(c);
+  A_row = CONSTR_get_A_row_ptr(c);
+  T = NET_get_num_periods(net);
+
+  // Check pointers
+  if (!A_nnz || !A_row)
+    return;
+
+  // Slack buses (reached by the counting sweep)
+  nnz = 0;
+  row = 0;
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    if (!BUS_is_slack(bus) || BUS_is_isolated(bus))
+      continue;
+    gen1 = BUS_get_gen(bus);
+    for (gen2 = GEN_get_next(gen1); gen2 != NULL; gen2 = GEN_get_next(gen2)) {
+      if (GEN_has_flags(gen1,FLAG_VARS,GEN_VAR_P))
+	nnz++;
+      if (GEN_has_flags(gen2,FLAG_VARS,GEN_VAR_P))
+	nnz++;
+      row++;
+    }
+  }
 
-  // Flags
-  CONSTR_clear_bus_counted(c);
+  // Periods
+  (*A_nnz) += nnz*T;
+  (*A_row) += row*T;
 }
 
 void CONSTR_PAR_GEN_P_count_step(Constr* c, Branch* br, int t) {
@@ -105,27 +149,29 @@ void CONSTR_PAR_GEN_P_allocate(Constr* c) {
   int num_constr;
   int num_vars;
   int A_nnz;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   num_vars = NET_get_num_vars(CONSTR_get_network(c));
   num_constr = CONSTR_get_A_row(c);
   A_nnz = CONSTR_get_A_nnz(c);
 
   // J f
-  CONSTR_set_J(c,MAT_new(0,num_vars,0));
-  CONSTR_set_f(c,VEC_new(0));
+  CONSTR_set_J(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,0));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
 
   // b
-  CONSTR_set_b(c,VEC_new(num_constr));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,num_constr));
 
   // A
-  CONSTR_set_A(c,MAT_new(num_constr, // size1 (rows)
-			 num_vars,   // size2 (rows)
-			 A_nnz)); // nnz
+  CONSTR_set_A(c,MAT_new_from_pool(pool,num_constr, // size1 (rows)
+					 num_vars,   // size2 (rows)
+					 A_nnz)); // nnz
 }
 
 void CONSTR_PAR_GEN_P_analyze_step(Constr* c, Branch* br, int t) {
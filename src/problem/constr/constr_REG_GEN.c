@@ -17,7 +17,7 @@ Constr* CONSTR_REG_GEN_new(Net* net) {
   CONSTR_set_func_allocate(c,&CONSTR_REG_GEN_allocate);
   CONSTR_set_func_clear(c,&CONSTR_REG_GEN_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_REG_GEN_analyze_step);
-  CONSTR_set_func_eval_step(c,&CONSTR_REG_GEN_eval_step);
+  CONSTR_set_func_eval_bus_step(c,&CONSTR_REG_GEN_eval_bus_step);
   CONSTR_set_func_store_sens_step(c,&CONSTR_REG_GEN_store_sens_step);
   CONSTR_set_func_free(c,&CONSTR_REG_GEN_free);
   CONSTR_init(c);
@@ -55,9 +55,6 @@ void CONSTR_REG_GEN_clear(Constr* c) {
   CONSTR_set_A_row(c,0);
   CONSTR_set_J_row(c,0);
   CONSTR_clear_H_nnz(c);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_REG_GEN_count_step(Constr* c, Branch* br, int t) {
@@ -185,12 +182,13 @@ void CONSTR_REG_GEN_allocate(Constr* c) {
   int J_row;
   int* H_nnz;
   Mat* H_array;
-  Mat* H;
   int H_comb_nnz;
   int num_vars;
   int num_extra_vars;
   int i;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   A_nnz = CONSTR_get_A_nnz(c);
   J_nnz = CONSTR_get_J_nnz(c);
   A_row = CONSTR_get_A_row(c);
@@ -200,50 +198,42 @@ void CONSTR_REG_GEN_allocate(Constr* c) {
   num_extra_vars = CONSTR_get_num_extra_vars(c);
 
   // Extra vars
-  CONSTR_set_l_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_u_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_init_extra_vars(c,VEC_new(num_extra_vars));
+  CONSTR_set_l_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_u_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_init_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars+num_extra_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars+num_extra_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
   
   // b
-  CONSTR_set_b(c,VEC_new(A_row));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,A_row));
 
   // A
-  CONSTR_set_A(c,MAT_new(A_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 A_nnz));                 // nnz
+  CONSTR_set_A(c,MAT_new_from_pool(pool,A_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 A_nnz));                 // nnz
 
   // f
-  CONSTR_set_f(c,VEC_new(J_row));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,J_row));
 
   // J
-  CONSTR_set_J(c,MAT_new(J_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 J_nnz));                 // nnz
+  CONSTR_set_J(c,MAT_new_from_pool(pool,J_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 J_nnz));                 // nnz
 
   // H
   H_comb_nnz = 0;
-  H_array = MAT_array_new(J_row);
+  H_array = MAT_array_new_block_from_pool(pool,J_row,num_vars+num_extra_vars,num_vars+num_extra_vars,H_nnz,NULL);
   CONSTR_set_H_array(c,H_array,J_row);
-  for (i = 0; i < J_row; i++) {
-    H = MAT_array_get(H_array,i);
-    MAT_set_nnz(H,H_nnz[i]);
-    MAT_set_size1(H,num_vars+num_extra_vars);
-    MAT_set_size2(H,num_vars+num_extra_vars);
-    MAT_set_row_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_col_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_data_array(H,(REAL*)calloc(H_nnz[i],sizeof(REAL)));
+  for (i = 0; i < J_row; i++)
     H_comb_nnz += H_nnz[i];
-  }
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars+num_extra_vars, // size1 (rows)
-				  num_vars+num_extra_vars, // size2 (cols)
-				  H_comb_nnz));            // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars+num_extra_vars, // size1 (rows)
+						  num_vars+num_extra_vars, // size2 (cols)
+						  H_comb_nnz));            // nnz
 }
 
 void CONSTR_REG_GEN_analyze_step(Constr* c, Branch* br, int t) {
@@ -315,6 +305,9 @@ void CONSTR_REG_GEN_analyze_step(Constr* c, Branch* br, int t) {
 
     if (!bus_counted[bus_index_t[k]]) { // not counted yet
 
+      // Offsets
+      CONSTR_save_bus_counters(c,bus,t);
+
       if (BUS_is_regulated_by_gen(bus) && !BUS_is_slack(bus)) { // regulator and not slack
 
 	// Hessians
@@ -439,11 +432,9 @@ void CONSTR_REG_GEN_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_REG_GEN_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
+void CONSTR_REG_GEN_eval_bus_step(Constr* c, Bus* bus, int t, Vec* values, Vec* values_extra) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
   Gen* rg;
   Gen* rg1;
   Mat* H_array;
@@ -451,12 +442,9 @@ void CONSTR_REG_GEN_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* va
   REAL* J;
   REAL* Hy;
   REAL* Hz;
-  int* J_nnz;
-  int* J_row;
+  int J_nnz_val;
+  int J_row_val;
   int* H_nnz;
-  char* bus_counted;
-  int bus_index_t[2];
-  int k;
   REAL v;
   REAL v_set;
   REAL y;
@@ -468,143 +456,109 @@ void CONSTR_REG_GEN_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* va
   REAL Qz;
   REAL sqrt_termY;
   REAL sqrt_termZ;
-  int T;
-
-  // Number of periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   f = VEC_get_data(CONSTR_get_f(c));
   J = MAT_get_data_array(CONSTR_get_J(c));
   H_array = CONSTR_get_H_array(c);
-  J_nnz = CONSTR_get_J_nnz_ptr(c);
-  J_row = CONSTR_get_J_row_ptr(c);
   H_nnz = CONSTR_get_H_nnz(c);
-  bus_counted = CONSTR_get_bus_counted(c);
 
   // Check pointers
-  if (!f || !J || !J_nnz || !J_row || !H_nnz || !bus_counted)
+  if (!f || !J || !H_nnz)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
+  // Offsets
+  J_nnz_val = CONSTR_get_bus_J_nnz(c,bus,t);
+  J_row_val = CONSTR_get_bus_J_row(c,bus,t);
 
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+  if (BUS_is_regulated_by_gen(bus) && !BUS_is_slack(bus)) { // regulator and not slack
 
-  // Branch
-  //*******
+    // Hessians
+    Hy = MAT_get_data_array(MAT_array_get(H_array,J_row_val));
+    Hz = MAT_get_data_array(MAT_array_get(H_array,J_row_val+1));
 
-  // Buses
-  //******
+    // Extra vars
+    if (VEC_get_size(values_extra) > 0) {
+      y = VEC_get(values_extra,J_row_val);
+      z = VEC_get(values_extra,J_row_val+1);
+    }
+    else {
+      y = 0.;
+      z = 0.;
+    }
 
-  for (k = 0; k < 2; k++) {
+    // Q value
+    Qsum = 0;
+    Qmax = 0;
+    Qmin = 0;
+    for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
+      if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q))
+	Qsum += VEC_get(values,GEN_get_index_Q(rg,t)); // p.u.
+      else
+	Qsum += GEN_get_Q(rg,t); // p.u.
+      Qmax += GEN_get_Q_max(rg); // p.u.
+      Qmin += GEN_get_Q_min(rg); // p.u.
+    }
+    Qy = (Qsum-Qmin);
+    Qz = (Qmax-Qsum);
 
-    bus = buses[k];
+    // Terms
+    sqrt_termY = sqrt( Qy*Qy + y*y + 2*CONSTR_REG_GEN_PARAM );
+    sqrt_termZ = sqrt( Qz*Qz + z*z + 2*CONSTR_REG_GEN_PARAM );
 
-    if (!bus_counted[bus_index_t[k]]) { // not counted yet
+    // f
+    f[J_row_val] = Qy + y - sqrt_termY;   // CompY
+    f[J_row_val+1] = Qz + z - sqrt_termZ; // CompZ
 
-      if (BUS_is_regulated_by_gen(bus) && !BUS_is_slack(bus)) { // regulator and not slack
+    // J
+    J[J_nnz_val] = 1. - y/sqrt_termY;
+    J_nnz_val++; // dCompY/dy
 
-	// Hessians
-	Hy = MAT_get_data_array(MAT_array_get(H_array,*J_row));
-	Hz = MAT_get_data_array(MAT_array_get(H_array,*J_row+1));
+    J[J_nnz_val] = 1. - z/sqrt_termZ;
+    J_nnz_val++; // dCompZ/dz
 
-	// Extra vars
-	if (VEC_get_size(values_extra) > 0) {
-	  y = VEC_get(values_extra,*J_row);
-	  z = VEC_get(values_extra,*J_row+1);
-	}
-	else {
-	  y = 0.;
-	  z = 0.;
-	}
-	
-	// Q value
-	Qsum = 0;
-	Qmax = 0;
-	Qmin = 0;
-	for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
-	  if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q))
-	    Qsum += VEC_get(values,GEN_get_index_Q(rg,t)); // p.u.
-	  else
-	    Qsum += GEN_get_Q(rg,t); // p.u.
-	  Qmax += GEN_get_Q_max(rg); // p.u.
-	  Qmin += GEN_get_Q_min(rg); // p.u.
-	}
-	Qy = (Qsum-Qmin);
-	Qz = (Qmax-Qsum);
+    // H
+    Hy[H_nnz[J_row_val]] = -(Qy*Qy+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
+    H_nnz[J_row_val]++; // y and y (CompY)
 
-	// Terms
-	sqrt_termY = sqrt( Qy*Qy + y*y + 2*CONSTR_REG_GEN_PARAM );
-	sqrt_termZ = sqrt( Qz*Qz + z*z + 2*CONSTR_REG_GEN_PARAM );
+    Hz[H_nnz[J_row_val+1]] = -(Qz*Qz+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
+    H_nnz[J_row_val+1]++; // z and z (CompZ)
 
-	// f
-	f[*J_row] = Qy + y - sqrt_termY;   // CompY
-	f[*J_row+1] = Qz + z - sqrt_termZ; // CompZ
+    for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
+      if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q)) { // Q var
 
 	// J
-	J[*J_nnz] = 1. - y/sqrt_termY;
-	(*J_nnz)++; // dCompY/dy
+	J[J_nnz_val] = 1. - Qy/sqrt_termY;
+	J_nnz_val++; // dcompY/dQ
 
-	J[*J_nnz] = 1. - z/sqrt_termZ;
-	(*J_nnz)++; // dCompZ/dz
+	J[J_nnz_val] = -1. + Qz/sqrt_termZ;
+	J_nnz_val++; // dcompZ/dQ
 
 	// H
-	Hy[H_nnz[*J_row]] = -(Qy*Qy+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
-	H_nnz[*J_row]++; // y and y (CompY)
+	Hy[H_nnz[J_row_val]] = -(y*y+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
+	H_nnz[J_row_val]++; // Q and Q (CompY)
 
-	Hz[H_nnz[*J_row+1]] = -(Qz*Qz+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
-	H_nnz[*J_row+1]++; // z and z (CompZ)
-	
-	for (rg = BUS_get_reg_gen(bus); rg != NULL; rg = GEN_get_reg_next(rg)) {
-	  if (GEN_has_flags(rg,FLAG_VARS,GEN_VAR_Q)) { // Q var
+	Hy[H_nnz[J_row_val]] = Qy*y/pow(sqrt_termY,3.);
+	H_nnz[J_row_val]++; // y and Q (CompZ)
 
-	    // J
-	    J[*J_nnz] = 1. - Qy/sqrt_termY;
-	    (*J_nnz)++; // dcompY/dQ
+	Hz[H_nnz[J_row_val+1]] = -(z*z+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
+	H_nnz[J_row_val+1]++; // Q and Q (CompZ)
 
-	    J[*J_nnz] = -1. + Qz/sqrt_termZ;
-	    (*J_nnz)++; // dcompZ/dQ
+	Hz[H_nnz[J_row_val+1]] = -Qz*z/pow(sqrt_termZ,3.);
+	H_nnz[J_row_val+1]++; // z and Q (CompZ)
 
-	    // H
-	    Hy[H_nnz[*J_row]] = -(y*y+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
-	    H_nnz[*J_row]++; // Q and Q (CompY)
-	    
-	    Hy[H_nnz[*J_row]] = Qy*y/pow(sqrt_termY,3.);
-	    H_nnz[*J_row]++; // y and Q (CompZ)
+	for (rg1 = GEN_get_reg_next(rg); rg1 != NULL; rg1 = GEN_get_reg_next(rg1)) {
+	  if (GEN_has_flags(rg1,FLAG_VARS,GEN_VAR_Q)) { // Q1 var
 
-	    Hz[H_nnz[*J_row+1]] = -(z*z+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
-	    H_nnz[*J_row+1]++; // Q and Q (CompZ)
+	    Hy[H_nnz[J_row_val]] = -(y*y+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
+	    H_nnz[J_row_val]++; // Q and Q1 (CompY)
 
-	    Hz[H_nnz[*J_row+1]] = -Qz*z/pow(sqrt_termZ,3.);
-	    H_nnz[*J_row+1]++; // z and Q (CompZ)
-
-	    for (rg1 = GEN_get_reg_next(rg); rg1 != NULL; rg1 = GEN_get_reg_next(rg1)) {
-	      if (GEN_has_flags(rg1,FLAG_VARS,GEN_VAR_Q)) { // Q1 var
-
-		Hy[H_nnz[*J_row]] = -(y*y+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termY,3.);
-		H_nnz[*J_row]++; // Q and Q1 (CompY)
-
-		Hz[H_nnz[*J_row+1]] = -(z*z+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
-		H_nnz[*J_row+1]++; // Q and Q1 (CompZ)
-	      }
-	    }
+	    Hz[H_nnz[J_row_val+1]] = -(z*z+2*CONSTR_REG_GEN_PARAM)/pow(sqrt_termZ,3.);
+	    H_nnz[J_row_val+1]++; // Q and Q1 (CompZ)
 	  }
 	}
-
-	// Count
-	(*J_row)++; // dCompY
-	(*J_row)++; // dCompZ
       }
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
@@ -17,7 +17,7 @@ Constr* CONSTR_REG_SHUNT_new(Net* net) {
   CONSTR_set_func_allocate(c,&CONSTR_REG_SHUNT_allocate);
   CONSTR_set_func_clear(c,&CONSTR_REG_SHUNT_clear);
   CONSTR_set_func_analyze_step(c,&CONSTR_REG_SHUNT_analyze_step);
-  CONSTR_set_func_eval_step(c,&CONSTR_REG_SHUNT_eval_step);
+  CONSTR_set_func_eval_bus_step(c,&CONSTR_REG_SHUNT_eval_bus_step);
   CONSTR_set_func_store_sens_step(c,&CONSTR_REG_SHUNT_store_sens_step);
   CONSTR_set_func_free(c,&CONSTR_REG_SHUNT_free);
   CONSTR_init(c);
@@ -55,9 +55,6 @@ void CONSTR_REG_SHUNT_clear(Constr* c) {
   CONSTR_set_A_row(c,0);
   CONSTR_set_J_row(c,0);
   CONSTR_clear_H_nnz(c);
-
-  // Flags
-  CONSTR_clear_bus_counted(c);
 }
 
 void CONSTR_REG_SHUNT_count_step(Constr* c, Branch* br, int t) {
@@ -214,12 +211,13 @@ void CONSTR_REG_SHUNT_allocate(Constr* c) {
   int J_row;
   int* H_nnz;
   Mat* H_array;
-  Mat* H;
   int H_comb_nnz;
   int num_vars;
   int num_extra_vars;
   int i;
+  Pool* pool;
 
+  pool = CONSTR_get_pool(c);
   A_nnz = CONSTR_get_A_nnz(c);
   J_nnz = CONSTR_get_J_nnz(c);
   A_row = CONSTR_get_A_row(c);
@@ -229,50 +227,42 @@ void CONSTR_REG_SHUNT_allocate(Constr* c) {
   num_extra_vars = CONSTR_get_num_extra_vars(c);
 
   // Extra vars
-  CONSTR_set_l_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_u_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_init_extra_vars(c,VEC_new(num_extra_vars));
+  CONSTR_set_l_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_u_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_init_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars+num_extra_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars+num_extra_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
 
   // b
-  CONSTR_set_b(c,VEC_new(A_row));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,A_row));
 
   // A
-  CONSTR_set_A(c,MAT_new(A_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 A_nnz));                 // nnz
+  CONSTR_set_A(c,MAT_new_from_pool(pool,A_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 A_nnz));                 // nnz
 
   // f
-  CONSTR_set_f(c,VEC_new(J_row));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,J_row));
 
   // J
-  CONSTR_set_J(c,MAT_new(J_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 J_nnz));                 // nnz
+  CONSTR_set_J(c,MAT_new_from_pool(pool,J_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 J_nnz));                 // nnz
 
   // H
   H_comb_nnz = 0;
-  H_array = MAT_array_new(J_row);
+  H_array = MAT_array_new_block_from_pool(pool,J_row,num_vars+num_extra_vars,num_vars+num_extra_vars,H_nnz,NULL);
   CONSTR_set_H_array(c,H_array,J_row);
-  for (i = 0; i < J_row; i++) {
-    H = MAT_array_get(H_array,i);
-    MAT_set_nnz(H,H_nnz[i]);
-    MAT_set_size1(H,num_vars+num_extra_vars);
-    MAT_set_size2(H,num_vars+num_extra_vars);
-    MAT_set_row_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_col_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_data_array(H,(REAL*)malloc(H_nnz[i]*sizeof(REAL)));
+  for (i = 0; i < J_row; i++)
     H_comb_nnz += H_nnz[i];
-  }
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars+num_extra_vars, // size1 (rows)
-				  num_vars+num_extra_vars, // size2 (cols)
-				  H_comb_nnz));            // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars+num_extra_vars, // size1 (rows)
+						  num_vars+num_extra_vars, // size2 (cols)
+						  H_comb_nnz));            // nnz
 }
 
 void CONSTR_REG_SHUNT_analyze_step(Constr* c, Branch* br, int t) {
@@ -349,6 +339,9 @@ void CONSTR_REG_SHUNT_analyze_step(Constr* c, Branch* br, int t) {
 
     if (!bus_counted[bus_index_t[k]]) { // not counted yet
 
+      // Offsets
+      CONSTR_save_bus_counters(c,bus,t);
+
       // Shunts
       //*******
 
@@ -557,11 +550,9 @@ void CONSTR_REG_SHUNT_analyze_step(Constr* c, Branch* br, int t) {
   }
 }
 
-void CONSTR_REG_SHUNT_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec* values_extra) {
+void CONSTR_REG_SHUNT_eval_bus_step(Constr* c, Bus* bus, int t, Vec* values, Vec* values_extra) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
   Shunt* shunt;
   REAL* f;
   REAL* J;
@@ -570,12 +561,9 @@ void CONSTR_REG_SHUNT_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec*
   REAL* Hvmax;
   REAL* Hbmin;
   REAL* Hbmax;
-  int* J_nnz;
-  int* J_row;
+  int J_nnz_val;
+  int J_row_val;
   int* H_nnz;
-  char* bus_counted;
-  int bus_index_t[2];
-  int k;
   REAL v;
   REAL vl;
   REAL vh;
@@ -591,220 +579,190 @@ void CONSTR_REG_SHUNT_eval_step(Constr* c, Branch* br, int t, Vec* values, Vec*
   REAL sqrtermBmax;
   REAL sqrtermBmin;
   REAL norm = CONSTR_REG_SHUNT_NORM;
-  int T;
-
-  // Number of periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   f = VEC_get_data(CONSTR_get_f(c));
   J = MAT_get_data_array(CONSTR_get_J(c));
   H_array = CONSTR_get_H_array(c);
-  J_nnz = CONSTR_get_J_nnz_ptr(c);
-  J_row = CONSTR_get_J_row_ptr(c);
   H_nnz = CONSTR_get_H_nnz(c);
-  bus_counted = CONSTR_get_bus_counted(c);
 
   // Check pointers
-  if (!f || !J || !J_nnz || !J_row || !H_nnz || !bus_counted)
+  if (!f || !J || !H_nnz)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
-
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+  // Offsets
+  J_nnz_val = CONSTR_get_bus_J_nnz(c,bus,t);
+  J_row_val = CONSTR_get_bus_J_row(c,bus,t);
 
-  // Branch
+  // Shunts
   //*******
 
-  // Buses
-  //******
+  for (shunt = BUS_get_reg_shunt(bus); shunt != NULL; shunt = SHUNT_get_reg_next(shunt)) {
+
+    // v values
+    if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG))
+      v = VEC_get(values,BUS_get_index_v_mag(bus,t));
+    else
+      v = BUS_get_v_mag(bus,t);
+    vmax = BUS_get_v_max_reg(bus);
+    vmin = BUS_get_v_min_reg(bus);
+    if (VEC_get_size(values_extra) > 0) {
+      vl = VEC_get(values_extra,J_row_val+2);
+      vh = VEC_get(values_extra,J_row_val+3);
+    }
+    else {
+      vl = 0;
+      vh = 0;
+    }
 
-  for (k = 0; k < 2; k++) {
+    // b values
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
+      b = VEC_get(values,SHUNT_get_index_b(shunt,t));
+    }
+    else
+      b = SHUNT_get_b(shunt,t);
+    bmax = SHUNT_get_b_max(shunt);
+    bmin = SHUNT_get_b_min(shunt);
+    if (VEC_get_size(values_extra) > 0) {
+      y = VEC_get(values_extra,J_row_val);
+      z = VEC_get(values_extra,J_row_val+1);
+    }
+    else {
+      y = 0.;
+      z = 0;
+    }
 
-    bus = buses[k];
+    // Terms
+    sqrtermVmin = sqrt( (v+vl-vmin)*(v+vl-vmin) + y*y + 2*CONSTR_REG_SHUNT_PARAM );
+    sqrtermVmax = sqrt( (vmax-v+vh)*(vmax-v+vh) + z*z + 2*CONSTR_REG_SHUNT_PARAM );
+    sqrtermBmax = sqrt( (bmax-b)*(bmax-b) + vl*vl + 2*CONSTR_REG_SHUNT_PARAM );
+    sqrtermBmin = sqrt( (b-bmin)*(b-bmin) + vh*vh + 2*CONSTR_REG_SHUNT_PARAM );
 
-    if (!bus_counted[bus_index_t[k]]) { // not counted yet
+    // Hessians (NOTE ORDER!!!)
+    Hvmin = MAT_get_data_array(MAT_array_get(H_array,J_row_val));
+    Hvmax = MAT_get_data_array(MAT_array_get(H_array,J_row_val+1));
+    Hbmax = MAT_get_data_array(MAT_array_get(H_array,J_row_val+2));
+    Hbmin = MAT_get_data_array(MAT_array_get(H_array,J_row_val+3));
 
-      // Shunts
-      //*******
+    // f
+    f[J_row_val] = ((v+vl-vmin) + y - sqrtermVmin)*norm;   // vmin
+    f[J_row_val+1] = ((vmax-v+vh) + z - sqrtermVmax)*norm; // vmax
+    f[J_row_val+2] = ((bmax-b) + vl - sqrtermBmax)*norm;   // bmax
+    f[J_row_val+3] = ((b-bmin) + vh - sqrtermBmin)*norm;   // bmin
 
-      for (shunt = BUS_get_reg_shunt(bus); shunt != NULL; shunt = SHUNT_get_reg_next(shunt)) {
+    // Nonlinear constraints 1 (vmin,vmax)
+    //************************************
 
-	// v values
-	if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG))
-	  v = VEC_get(values,BUS_get_index_v_mag(bus,t));
-	else
-	  v = BUS_get_v_mag(bus,t);
-	vmax = BUS_get_v_max_reg(bus);
-	vmin = BUS_get_v_min_reg(bus);
-	if (VEC_get_size(values_extra) > 0) {
-	  vl = VEC_get(values_extra,*J_row+2);
-	  vh = VEC_get(values_extra,*J_row+3);
-	}
-	else {
-	  vl = 0;
-	  vh = 0;
-	}
+    // J
+    J[J_nnz_val] = (1.-y/sqrtermVmin)*norm;
+    J_nnz_val++; // dcompVmin/dy
 
-	// b values
-	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
-	  b = VEC_get(values,SHUNT_get_index_b(shunt,t));
-	}
-	else
-	  b = SHUNT_get_b(shunt,t);
-	bmax = SHUNT_get_b_max(shunt);
-	bmin = SHUNT_get_b_min(shunt);
-	if (VEC_get_size(values_extra) > 0) {
-	  y = VEC_get(values_extra,*J_row);
-	  z = VEC_get(values_extra,*J_row+1);
-	}
-	else {
-	  y = 0.;
-	  z = 0;
-	}
+    J[J_nnz_val] = (1.-z/sqrtermVmax)*norm;
+    J_nnz_val++; // dcompVmax/dz
 
-	// Terms
-	sqrtermVmin = sqrt( (v+vl-vmin)*(v+vl-vmin) + y*y + 2*CONSTR_REG_SHUNT_PARAM );
-	sqrtermVmax = sqrt( (vmax-v+vh)*(vmax-v+vh) + z*z + 2*CONSTR_REG_SHUNT_PARAM );
-	sqrtermBmax = sqrt( (bmax-b)*(bmax-b) + vl*vl + 2*CONSTR_REG_SHUNT_PARAM );
-	sqrtermBmin = sqrt( (b-bmin)*(b-bmin) + vh*vh + 2*CONSTR_REG_SHUNT_PARAM );
+    // H
+    Hvmin[H_nnz[J_row_val]] = -(((v+vl-vmin)*(v+vl-vmin)+2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
+    H_nnz[J_row_val]++;   // y and y (vmin)
 
-	// Hessians (NOTE ORDER!!!)
-	Hvmin = MAT_get_data_array(MAT_array_get(H_array,*J_row));
-	Hvmax = MAT_get_data_array(MAT_array_get(H_array,*J_row+1));
-	Hbmax = MAT_get_data_array(MAT_array_get(H_array,*J_row+2));
-	Hbmin = MAT_get_data_array(MAT_array_get(H_array,*J_row+3));
+    Hvmax[H_nnz[J_row_val+1]] = -(((vmax-v+vh)*(vmax-v+vh)+2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
+    H_nnz[J_row_val+1]++; // z and z (vmax)
 
-	// f
-	f[*J_row] = ((v+vl-vmin) + y - sqrtermVmin)*norm;   // vmin
-	f[*J_row+1] = ((vmax-v+vh) + z - sqrtermVmax)*norm; // vmax
-	f[*J_row+2] = ((bmax-b) + vl - sqrtermBmax)*norm;   // bmax
-	f[*J_row+3] = ((b-bmin) + vh - sqrtermBmin)*norm;   // bmin
+    if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
 
-	// Nonlinear constraints 1 (vmin,vmax)
-	//************************************
+      Hvmin[H_nnz[J_row_val]] = ((v+vl-vmin)*y/pow(sqrtermVmin,3.))*norm;
+      H_nnz[J_row_val]++;   // y and v (vmin)
 
-	// J
-	J[*J_nnz] = (1.-y/sqrtermVmin)*norm;
-	(*J_nnz)++; // dcompVmin/dy
-	
-	J[*J_nnz] = (1.-z/sqrtermVmax)*norm;
-	(*J_nnz)++; // dcompVmax/dz
+      Hvmax[H_nnz[J_row_val+1]] = -((vmax-v+vh)*z/pow(sqrtermVmax,3.))*norm;
+      H_nnz[J_row_val+1]++; // z and v (vmax)
+    }
 
-	// H
-	Hvmin[H_nnz[*J_row]] = -(((v+vl-vmin)*(v+vl-vmin)+2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
-	H_nnz[*J_row]++;   // y and y (vmin)
-	
-	Hvmax[H_nnz[*J_row+1]] = -(((vmax-v+vh)*(vmax-v+vh)+2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
-	H_nnz[*J_row+1]++; // z and z (vmax)
+    Hvmin[H_nnz[J_row_val]] = ((v+vl-vmin)*y/pow(sqrtermVmin,3.))*norm;
+    H_nnz[J_row_val]++;   // y and vl (vmin)
 
-	if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
+    Hvmax[H_nnz[J_row_val+1]] = ((vmax-v+vh)*z/pow(sqrtermVmax,3.))*norm;
+    H_nnz[J_row_val+1]++; // z and vh (vmax)
 
-	  Hvmin[H_nnz[*J_row]] = ((v+vl-vmin)*y/pow(sqrtermVmin,3.))*norm;
-	  H_nnz[*J_row]++;   // y and v (vmin)
-	  
-	  Hvmax[H_nnz[*J_row+1]] = -((vmax-v+vh)*z/pow(sqrtermVmax,3.))*norm;
-	  H_nnz[*J_row+1]++; // z and v (vmax)
-	}
+    if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
 
-	Hvmin[H_nnz[*J_row]] = ((v+vl-vmin)*y/pow(sqrtermVmin,3.))*norm;
-	H_nnz[*J_row]++;   // y and vl (vmin)
-	
-	Hvmax[H_nnz[*J_row+1]] = ((vmax-v+vh)*z/pow(sqrtermVmax,3.))*norm;
-	H_nnz[*J_row+1]++; // z and vh (vmax)
+      // J
+      J[J_nnz_val] = (1.-(v+vl-vmin)/sqrtermVmin)*norm;
+      J_nnz_val++; // dcompVmin/dv
 
-	if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
+      J[J_nnz_val] = -((1.-(vmax-v+vh)/sqrtermVmax))*norm;
+      J_nnz_val++; // dcompVmax/dv
 
-	  // J
-	  J[*J_nnz] = (1.-(v+vl-vmin)/sqrtermVmin)*norm;
-	  (*J_nnz)++; // dcompVmin/dv
-	  
-	  J[*J_nnz] = -((1.-(vmax-v+vh)/sqrtermVmax))*norm;
-	  (*J_nnz)++; // dcompVmax/dv
-	  
-	  // H
-	  Hvmin[H_nnz[*J_row]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
-	  H_nnz[*J_row]++;   // v and v (vmin)
+      // H
+      Hvmin[H_nnz[J_row_val]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
+      H_nnz[J_row_val]++;   // v and v (vmin)
 
-	  Hvmax[H_nnz[*J_row+1]] = -((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
-	  H_nnz[*J_row+1]++; // v and v (vmax)
-	  
-	  Hvmin[H_nnz[*J_row]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
-	  H_nnz[*J_row]++;   // v and vl (vmin)
-	  
-	  Hvmax[H_nnz[*J_row+1]] = ((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
-	  H_nnz[*J_row+1]++; // v and vh (vmax)
-	}
+      Hvmax[H_nnz[J_row_val+1]] = -((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
+      H_nnz[J_row_val+1]++; // v and v (vmax)
 
-	// J
-	J[*J_nnz] = (1.-(v+vl-vmin)/sqrtermVmin)*norm;
-	(*J_nnz)++; // dcompVmin/dvl
-	
-	J[*J_nnz] = (1.-(vmax-v+vh)/sqrtermVmax)*norm;
-	(*J_nnz)++; // dcompVmax/dvh
-	
-	// H
-	Hvmin[H_nnz[*J_row]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
-	H_nnz[*J_row]++;   // vl and vl (vmin)
-	
-	Hvmax[H_nnz[*J_row+1]] = -((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
-	H_nnz[*J_row+1]++; // vh and vh (vmax)
+      Hvmin[H_nnz[J_row_val]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
+      H_nnz[J_row_val]++;   // v and vl (vmin)
 
-	// Nonlinear constraints 2 (bmax,bmin)
-	//************************************
-	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // t var
+      Hvmax[H_nnz[J_row_val+1]] = ((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
+      H_nnz[J_row_val+1]++; // v and vh (vmax)
+    }
 
-	  // J
-	  J[*J_nnz] = -(1.-(bmax-b)/sqrtermBmax)*norm;
-	  (*J_nnz)++; // dcompBmax/db
+    // J
+    J[J_nnz_val] = (1.-(v+vl-vmin)/sqrtermVmin)*norm;
+    J_nnz_val++; // dcompVmin/dvl
 
-	  J[*J_nnz] = (1.-(b-bmin)/sqrtermBmin)*norm;
-	  (*J_nnz)++; // dcompBmin/db
+    J[J_nnz_val] = (1.-(vmax-v+vh)/sqrtermVmax)*norm;
+    J_nnz_val++; // dcompVmax/dvh
 
-	  // H
-	  Hbmax[H_nnz[*J_row+2]] = -((vl*vl + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmax,3.))*norm;
-	  H_nnz[*J_row+2]++; // b and b (bmax)
+    // H
+    Hvmin[H_nnz[J_row_val]] = -((y*y + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmin,3.))*norm;
+    H_nnz[J_row_val]++;   // vl and vl (vmin)
 
-	  Hbmin[H_nnz[*J_row+3]] = -((vh*vh + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmin,3.))*norm;
-	  H_nnz[*J_row+3]++; // b and b (bmin)
-	  
-	  Hbmax[H_nnz[*J_row+2]] = -(vl*(bmax-b)/pow(sqrtermBmax,3.))*norm;
-	  H_nnz[*J_row+2]++; // b and vl (bmax)
-	  
-	  Hbmin[H_nnz[*J_row+3]] = (vh*(b-bmin)/pow(sqrtermBmin,3.))*norm;
-	  H_nnz[*J_row+3]++; // b and vh (bmin)
-	}
+    Hvmax[H_nnz[J_row_val+1]] = -((z*z + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermVmax,3.))*norm;
+    H_nnz[J_row_val+1]++; // vh and vh (vmax)
 
-	// J
-	J[*J_nnz] = (1.-vl/sqrtermBmax)*norm;
-	(*J_nnz)++; // dcompBmax/dvl
-	
-	J[*J_nnz] = (1.-vh/sqrtermBmin)*norm;
-	(*J_nnz)++; // dcompBmin/dvh
-	
-	// H
-	Hbmax[H_nnz[*J_row+2]] = -(((bmax-b)*(bmax-b) + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmax,3.))*norm;
-	H_nnz[*J_row+2]++; // vl and vl (bmax)
-	
-	Hbmin[H_nnz[*J_row+3]] = -(((b-bmin)*(b-bmin) + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmin,3.))*norm;
-	H_nnz[*J_row+3]++; // vh and vh (bmin)
+    // Nonlinear constraints 2 (bmax,bmin)
+    //************************************
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // t var
 
-	// Count
-	(*J_row)++; // compVmin
-	(*J_row)++; // compVmax
-	(*J_row)++; // compBmax
-	(*J_row)++; // compBmin
-      }
+      // J
+      J[J_nnz_val] = -(1.-(bmax-b)/sqrtermBmax)*norm;
+      J_nnz_val++; // dcompBmax/db
+
+      J[J_nnz_val] = (1.-(b-bmin)/sqrtermBmin)*norm;
+      J_nnz_val++; // dcompBmin/db
+
+      // H
+      Hbmax[H_nnz[J_row_val+2]] = -((vl*vl + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmax,3.))*norm;
+      H_nnz[J_row_val+2]++; // b and b (bmax)
+
+      Hbmin[H_nnz[J_row_val+3]] = -((vh*vh + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmin,3.))*norm;
+      H_nnz[J_row_val+3]++; // b and b (bmin)
+
+      Hbmax[H_nnz[J_row_val+2]] = -(vl*(bmax-b)/pow(sqrtermBmax,3.))*norm;
+      H_nnz[J_row_val+2]++; // b and vl (bmax)
+
+      Hbmin[H_nnz[J_row_val+3]] = (vh*(b-bmin)/pow(sqrtermBmin,3.))*norm;
+      H_nnz[J_row_val+3]++; // b and vh (bmin)
     }
 
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
+    // J
+    J[J_nnz_val] = (1.-vl/sqrtermBmax)*norm;
+    J_nnz_val++; // dcompBmax/dvl
+
+    J[J_nnz_val] = (1.-vh/sqrtermBmin)*norm;
+    J_nnz_val++; // dcompBmin/dvh
+
+    // H
+    Hbmax[H_nnz[J_row_val+2]] = -(((bmax-b)*(bmax-b) + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmax,3.))*norm;
+    H_nnz[J_row_val+2]++; // vl and vl (bmax)
+
+    Hbmin[H_nnz[J_row_val+3]] = -(((b-bmin)*(b-bmin) + 2*CONSTR_REG_SHUNT_PARAM)/pow(sqrtermBmin,3.))*norm;
+    H_nnz[J_row_val+3]++; // vh and vh (bmin)
+
+    // Count
+    J_row_val++; // compVmin
+    J_row_val++; // compVmax
+    J_row_val++; // compBmax
+    J_row_val++; // compBmin
   }
 }
 
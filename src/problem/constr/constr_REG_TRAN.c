@@ -180,12 +180,13 @@ void CONSTR_REG_TRAN_allocate(Constr* c) {
   int J_row; 
   int* H_nnz;
   Mat* H_array;
-  Mat* H;
   int H_comb_nnz;
   int num_vars;
   int num_extra_vars;
   int i;
+  Pool* pool;
   
+  pool = CONSTR_get_pool(c);
   A_nnz = CONSTR_get_A_nnz(c);
   J_nnz = CONSTR_get_J_nnz(c);
   A_row = CONSTR_get_A_row(c);
@@ -195,50 +196,42 @@ void CONSTR_REG_TRAN_allocate(Constr* c) {
   num_extra_vars = CONSTR_get_num_extra_vars(c);
 
   // Extra vars
-  CONSTR_set_l_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_u_extra_vars(c,VEC_new(num_extra_vars));
-  CONSTR_set_init_extra_vars(c,VEC_new(num_extra_vars));
+  CONSTR_set_l_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_u_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
+  CONSTR_set_init_extra_vars(c,VEC_new_from_pool(pool,num_extra_vars));
 
   // G u l
-  CONSTR_set_G(c,MAT_new(0,num_vars+num_extra_vars,0));
-  CONSTR_set_u(c,VEC_new(0));
-  CONSTR_set_l(c,VEC_new(0));
+  CONSTR_set_G(c,MAT_new_from_pool(pool,0,num_vars+num_extra_vars,0));
+  CONSTR_set_u(c,VEC_new_from_pool(pool,0));
+  CONSTR_set_l(c,VEC_new_from_pool(pool,0));
   
   // b
-  CONSTR_set_b(c,VEC_new(A_row));
+  CONSTR_set_b(c,VEC_new_from_pool(pool,A_row));
 
   // A
-  CONSTR_set_A(c,MAT_new(A_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 A_nnz));                 // nnz
+  CONSTR_set_A(c,MAT_new_from_pool(pool,A_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 A_nnz));                 // nnz
   
   // f
-  CONSTR_set_f(c,VEC_new(J_row));
+  CONSTR_set_f(c,VEC_new_from_pool(pool,J_row));
 
   // J
-  CONSTR_set_J(c,MAT_new(J_row,                   // size1 (rows)
-			 num_vars+num_extra_vars, // size2 (cols)
-			 J_nnz));                 // nnz
+  CONSTR_set_J(c,MAT_new_from_pool(pool,J_row,                   // size1 (rows)
+					 num_vars+num_extra_vars, // size2 (cols)
+					 J_nnz));                 // nnz
   
   // H
   H_comb_nnz = 0;
-  H_array = MAT_array_new(J_row);
+  H_array = MAT_array_new_block_from_pool(pool,J_row,num_vars+num_extra_vars,num_vars+num_extra_vars,H_nnz,NULL);
   CONSTR_set_H_array(c,H_array,J_row);
-  for (i = 0; i < J_row; i++) {
-    H = MAT_array_get(H_array,i);
-    MAT_set_nnz(H,H_nnz[i]);
-    MAT_set_size1(H,num_vars+num_extra_vars);
-    MAT_set_size2(H,num_vars+num_extra_vars);
-    MAT_set_row_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_col_array(H,(int*)calloc(H_nnz[i],sizeof(int)));
-    MAT_set_data_array(H,(REAL*)malloc(H_nnz[i]*sizeof(REAL)));
+  for (i = 0; i < J_row; i++)
     H_comb_nnz += H_nnz[i];
-  }
 
   // H combined
-  CONSTR_set_H_combined(c,MAT_new(num_vars+num_extra_vars, // size1 (rows)
-				  num_vars+num_extra_vars, // size2 (cols)
-				  H_comb_nnz));            // nnz
+  CONSTR_set_H_combined(c,MAT_new_from_pool(pool,num_vars+num_extra_vars, // size1 (rows)
+						  num_vars+num_extra_vars, // size2 (cols)
+						  H_comb_nnz));            // nnz
 }
 
 void CONSTR_REG_TRAN_analyze_step(Constr* c, Branch* br, int tau) {
@@ -22,6 +22,9 @@ struct Func {
 
   // Network
   Net* net;    /**< @brief Power network */
+
+  // Memory pool
+  Pool* pool;  /**< @brief Pool of the problem that reuses the buffers of the matrices and vectors (not owned) */
   
   // Weight
   REAL weight; /**< @brief Function weight for forming an objective function */
@@ -43,10 +46,13 @@ struct Func {
   // Functions
   void (*func_init)(Func* f);                                    /**< @brief Initialization function */
   void (*func_count_step)(Func* f, Branch* br, int t);           /**< @brief Function for countinng nonzero entries */
+  void (*func_count)(Func* f);                                   /**< @brief Function for counting nonzero entries in closed form (no sweep) */
   void (*func_allocate)(Func* f);                                /**< @brief Function for allocating required arrays */
   void (*func_clear)(Func* f);                                   /**< @brief Function for clearing flags, counters, and function values */
   void (*func_analyze_step)(Func* f, Branch* br, int t);         /**< @brief Function for analyzing sparsity pattern */
   void (*func_eval_step)(Func* f, Branch* br, int t, Vec* v);    /**< @brief Function for evaluating function */
+  void (*func_eval_branch_step)(Func* f, Branch* br, int t, Vec* v); /**< @brief Function for evaluating the branch terms of the function */
+  void (*func_eval_bus_step)(Func* f, Bus* bus, int t, Vec* v);      /**< @brief Function for evaluating the bus terms of the function */
   void (*func_free)(Func* f);                                    /**< @brief Function for de-allocating any data used */
 
   // Custom data
@@ -65,8 +71,8 @@ void FUNC_del_matvec(Func* f) {
   if (f) {
 
     // Mat and vec
-    VEC_del(f->gphi);
-    MAT_del(f->Hphi);
+    VEC_del_to_pool(f->pool,f->gphi);
+    MAT_del_to_pool(f->pool,f->Hphi);
     f->gphi = NULL;
     f->Hphi = NULL;
   }
@@ -205,6 +211,23 @@ void FUNC_list_count_step(Func* f, Branch* br, int t) {
     FUNC_count_step(ff,br,t);
 }
 
+void FUNC_list_count_closed_form(Func* f) {
+  Func* ff;
+  for (ff = f; ff != NULL; ff = FUNC_get_next(ff)) {
+    if (ff->func_count && FUNC_is_safe_to_count(ff))
+      (*(ff->func_count))(ff);
+  }
+}
+
+BOOL FUNC_list_needs_count_sweep(Func* f) {
+  Func* ff;
+  for (ff = f; ff != NULL; ff = FUNC_get_next(ff)) {
+    if (FUNC_needs_count_sweep(ff))
+      return TRUE;
+  }
+  return FALSE;
+}
+
 void FUNC_list_allocate(Func* f) {
   Func* ff;
   for (ff = f; ff != NULL; ff = FUNC_get_next(ff))
@@ -229,6 +252,18 @@ void FUNC_list_eval_step(Func* f, Branch* br, int t, Vec* values) {
     FUNC_eval_step(ff,br,t,values);
 }
 
+void FUNC_list_eval_bus_step(Func* f, Bus* bus, int t, Vec* values) {
+  Func* ff;
+  for (ff = f; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_eval_bus_step(ff,bus,t,values);
+}
+
+void FUNC_list_clear_bus_counted(Func* f) {
+  Func* ff;
+  for (ff = f; ff != NULL; ff = FUNC_get_next(ff))
+    FUNC_clear_bus_counted(ff);
+}
+
 Func* FUNC_new(REAL weight, Net* net) {
 
   Func* f = (Func*)malloc(sizeof(Func));
@@ -240,6 +275,9 @@ Func* FUNC_new(REAL weight, Net* net) {
   // Network
   f->net = net;
 
+  // Pool
+  f->pool = NULL;
+
   // Name
   strcpy(f->name,"unknown");
 
@@ -258,10 +296,13 @@ Func* FUNC_new(REAL weight, Net* net) {
   // Methods
   f->func_init = NULL;
   f->func_count_step = NULL;
+  f->func_count = NULL;
   f->func_allocate = NULL;
   f->func_clear = NULL;
   f->func_analyze_step = NULL;
   f->func_eval_step = NULL;
+  f->func_eval_branch_step = NULL;
+  f->func_eval_bus_step = NULL;
   f->func_free = NULL;
 
   // Data
@@ -312,6 +353,12 @@ void FUNC_count(Func* f) {
   int t;
   Net* net = FUNC_get_network(f);
   FUNC_clear(f);
+  FUNC_clear_bus_counted(f);
+  if (f && f->func_count) {
+    if (FUNC_is_safe_to_count(f))
+      (*(f->func_count))(f);
+    return;
+  }
   for (t = 0; t < NET_get_num_periods(net); t++) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       FUNC_count_step(f,NET_get_branch(net,i),t);
@@ -319,10 +366,17 @@ void FUNC_count(Func* f) {
 }
 
 void FUNC_count_step(Func* f, Branch* br, int t) {
-  if (f && f->func_count_step && FUNC_is_safe_to_count(f))
+  if (f && f->func_count_step && !f->func_count && FUNC_is_safe_to_count(f))
     (*(f->func_count_step))(f,br,t);
 }
 
+BOOL FUNC_needs_count_sweep(Func* f) {
+  if (f)
+    return (f->func_count_step && !f->func_count);
+  else
+    return FALSE;
+}
+
 void FUNC_allocate(Func* f) {
   if (f && f->func_allocate && FUNC_is_safe_to_count(f)) {
     FUNC_del_matvec(f);
@@ -347,6 +401,7 @@ void FUNC_analyze(Func* f) {
   int t;
   Net* net = FUNC_get_network(f);
   FUNC_clear(f);
+  FUNC_clear_bus_counted(f);
   for (t = 0; t < NET_get_num_periods(net); t++) {
     for (i = 0; i < NET_get_num_branches(net); i++)
       FUNC_analyze_step(f,NET_get_branch(net,i),t);
@@ -361,9 +416,15 @@ void FUNC_analyze_step(Func* f, Branch* br, int t) {
 void FUNC_eval(Func* f, Vec* values) {
   int i;
   int t;
+  Bus* bus;
   Net* net = FUNC_get_network(f);
   FUNC_clear(f);
   for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      bus = NET_get_bus(net,i);
+      if (!BUS_is_isolated(bus))
+	FUNC_eval_bus_step(f,bus,t,values);
+    }
     for (i = 0; i < NET_get_num_branches(net); i++)
       FUNC_eval_step(f,NET_get_branch(net,i),t,values);
   }
@@ -372,6 +433,18 @@ void FUNC_eval(Func* f, Vec* values) {
 void FUNC_eval_step(Func* f, Branch* br, int t, Vec* values) {
   if (f && f->func_eval_step && FUNC_is_safe_to_eval(f,values))
     (*(f->func_eval_step))(f,br,t,values);
+  else if (f && f->func_eval_branch_step && FUNC_is_safe_to_eval(f,values))
+    (*(f->func_eval_branch_step))(f,br,t,values);
+}
+
+void FUNC_eval_branch_step(Func* f, Branch* br, int t, Vec* values) {
+  if (f && f->func_eval_branch_step && FUNC_is_safe_to_eval(f,values))
+    (*(f->func_eval_branch_step))(f,br,t,values);
+}
+
+void FUNC_eval_bus_step(Func* f, Bus* bus, int t, Vec* values) {
+  if (f && f->func_eval_bus_step && FUNC_is_safe_to_eval(f,values))
+    (*(f->func_eval_bus_step))(f,bus,t,values);
 }
 
 BOOL FUNC_is_safe_to_count(Func* f) {
@@ -465,6 +538,18 @@ Net* FUNC_get_network(Func* f) {
     return NULL;
 }
 
+Pool* FUNC_get_pool(Func* f) {
+  if (f)
+    return f->pool;
+  else
+    return NULL;
+}
+
+void FUNC_set_pool(Func* f, Pool* pool) {
+  if (f)
+    f->pool = pool;
+}
+
 void FUNC_set_func_init(Func* f, void (*func)(Func* f)) {
   if (f)
     f->func_init = func;
@@ -475,6 +560,11 @@ void FUNC_set_func_count_step(Func* f, void (*func)(Func* f, Branch* br, int t))
     f->func_count_step = func;
 }
 
+void FUNC_set_func_count(Func* f, void (*func)(Func* f)) {
+  if (f)
+    f->func_count = func;
+}
+
 void FUNC_set_func_allocate(Func* f, void (*func)(Func* f)) {
   if (f)
     f->func_allocate = func;
@@ -495,6 +585,16 @@ void FUNC_set_func_eval_step(Func* f, void (*func)(Func* f, Branch* br, int t, V
     f->func_eval_step = func;
 }
 
+void FUNC_set_func_eval_branch_step(Func* f, void (*func)(Func* f, Branch* br, int t, Vec* v)) {
+  if (f)
+    f->func_eval_branch_step = func;
+}
+
+void FUNC_set_func_eval_bus_step(Func* f, void (*func)(Func* f, Bus* bus, int t, Vec* v)) {
+  if (f)
+    f->func_eval_bus_step = func;
+}
+
 void FUNC_set_func_free(Func* f, void (*func)(Func* f)) {
   if (f)
     f->func_free = func;
@@ -14,10 +14,11 @@ Func* FUNC_GEN_COST_new(REAL weight, Net* net) {
   Func* f = FUNC_new(weight,net);
   FUNC_set_func_init(f, &FUNC_GEN_COST_init);
   FUNC_set_func_count_step(f, &FUNC_GEN_COST_count_step);
+  FUNC_set_func_count(f, &FUNC_GEN_COST_count);
   FUNC_set_func_allocate(f, &FUNC_GEN_COST_allocate);
   FUNC_set_func_clear(f, &FUNC_GEN_COST_clear);
   FUNC_set_func_analyze_step(f, &FUNC_GEN_COST_analyze_step);
-  FUNC_set_func_eval_step(f, &FUNC_GEN_COST_eval_step);
+  FUNC_set_func_eval_bus_step(f, &FUNC_GEN_COST_eval_bus_step);
   FUNC_set_func_free(f, &FUNC_GEN_COST_free);
   FUNC_init(f);
   return f;
@@ -41,9 +42,40 @@ void FUNC_GEN_COST_clear(Func* f) {
 
   // Counter
   FUNC_set_Hphi_nnz(f,0);
+}
+
+void FUNC_GEN_COST_count(Func* f) {
+
+  // Local variables
+  Net* net;
+  Bus* bus;
+  Gen* gen;
+  int* Hphi_nnz;
+  int num;
+  int i;
 
-  // Flags
-  FUNC_clear_bus_counted(f);
+  // Func data
+  net = FUNC_get_network(f);
+  Hphi_nnz = FUNC_get_Hphi_nnz_ptr(f);
+
+  // Check pointer
+  if (!Hphi_nnz)
+    return;
+
+  // Generators with active power variables (buses reached by the counting sweep)
+  num = 0;
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    if (BUS_is_isolated(bus))
+      continue;
+    for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+      if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+	num++;
+    }
+  }
+
+  // Periods
+  (*Hphi_nnz) += num*NET_get_num_periods(net);
 }
 
 void FUNC_GEN_COST_count_step(Func* f, Branch* br, int t) {
@@ -101,17 +133,19 @@ void FUNC_GEN_COST_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_GEN_COST_analyze_step(Func* f, Branch* br, int t) {
@@ -170,14 +204,10 @@ void FUNC_GEN_COST_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_GEN_COST_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
   Gen* gen;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   int index_P;
@@ -185,74 +215,47 @@ void FUNC_GEN_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   REAL Q0;
   REAL Q1;
   REAL Q2;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
-    return;
-
-  // Check outage
-  if (BRANCH_is_on_outage(br))
+  if (!phi || !gphi)
     return;
 
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
 
-  // Buses
-  for (k = 0; k < 2; k++) {
+    Q0 = GEN_get_cost_coeff_Q0(gen);
+    Q1 = GEN_get_cost_coeff_Q1(gen);
+    Q2 = GEN_get_cost_coeff_Q2(gen);
 
-    bus = buses[k];
+    // Variable
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
 
-    if (!bus_counted[bus_index_t[k]]) {
+      // Index
+      index_P = GEN_get_index_P(gen,t);
 
-      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+      // P
+      P = VEC_get(var_values,index_P);
 
-	Q0 = GEN_get_cost_coeff_Q0(gen);
-	Q1 = GEN_get_cost_coeff_Q1(gen);
-	Q2 = GEN_get_cost_coeff_Q2(gen);
+      // phi
+      (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
 
-	// Variable
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
-
-	  // Index
-	  index_P = GEN_get_index_P(gen,t);
-
-	  // P
-	  P = VEC_get(var_values,index_P);
-
-	  // phi
-	  (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
-
-	  // gphi
-	  gphi[index_P] = Q1 + 2.*Q2*P;
-	}
+      // gphi
+      gphi[index_P] = Q1 + 2.*Q2*P;
+    }
 
-	// Constant
-	else {
+    // Constant
+    else {
 
-	  // P
-	  P = GEN_get_P(gen,t);
+      // P
+      P = GEN_get_P(gen,t);
 
-	  // phi
-	  (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
-	}
-      }
+      // phi
+      (*phi) += Q0 + Q1*P + Q2*pow(P,2.);
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
@@ -17,7 +17,7 @@ Func* FUNC_NETCON_COST_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f, &FUNC_NETCON_COST_allocate);
   FUNC_set_func_clear(f, &FUNC_NETCON_COST_clear);
   FUNC_set_func_analyze_step(f, &FUNC_NETCON_COST_analyze_step);
-  FUNC_set_func_eval_step(f, &FUNC_NETCON_COST_eval_step);
+  FUNC_set_func_eval_bus_step(f, &FUNC_NETCON_COST_eval_bus_step);
   FUNC_set_func_free(f, &FUNC_NETCON_COST_free);
   FUNC_init(f);
   return f;
@@ -38,9 +38,6 @@ void FUNC_NETCON_COST_clear(Func* f) {
 
   // Hphi
   // Zero
-
-  // Flags
-  FUNC_clear_bus_counted(f);
 }
 
 void FUNC_NETCON_COST_count_step(Func* f, Branch* br, int t) {
@@ -51,17 +48,19 @@ void FUNC_NETCON_COST_allocate(Func* f) {
 
   // Local variables
   int num_vars;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
   VEC_set_zero(FUNC_get_gphi(f));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  0));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  0));
 }
 
 void FUNC_NETCON_COST_analyze_step(Func* f, Branch* br, int t) {
@@ -142,90 +141,58 @@ void FUNC_NETCON_COST_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_NETCON_COST_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_NETCON_COST_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
   Load* load;
   Gen* gen;
   Vargen* vargen;
   Bat* bat;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL price;
   REAL* phi;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !bus_counted)
+  if (!phi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
-
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
-
-  // Buses
-  for (k = 0; k < 2; k++) {
-
-    bus = buses[k];
-
-    price = BUS_get_price(bus,t);
-
-    if (!bus_counted[bus_index_t[k]]) {
+  price = BUS_get_price(bus,t);
 
-      // Generators
-      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
-	  (*phi) -= price*VEC_get(var_values,GEN_get_index_P(gen,t));
-	else
-	  (*phi) -= price*GEN_get_P(gen,t);
-      }
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P))
+      (*phi) -= price*VEC_get(var_values,GEN_get_index_P(gen,t));
+    else
+      (*phi) -= price*GEN_get_P(gen,t);
+  }
 
-      // Variable generators
-      for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
-	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
-	  (*phi) -= price*VEC_get(var_values,VARGEN_get_index_P(vargen,t));
-	else
-	  (*phi) -= price*VARGEN_get_P(vargen,t);
-      }
+  // Variable generators
+  for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+    if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P))
+      (*phi) -= price*VEC_get(var_values,VARGEN_get_index_P(vargen,t));
+    else
+      (*phi) -= price*VARGEN_get_P(vargen,t);
+  }
 
-      // Loads
-      for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
-	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
-	  (*phi) += price*VEC_get(var_values,LOAD_get_index_P(load,t));
-	else
-	  (*phi) += price*LOAD_get_P(load,t);
-      }
+  // Loads
+  for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
+    if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P))
+      (*phi) += price*VEC_get(var_values,LOAD_get_index_P(load,t));
+    else
+      (*phi) += price*LOAD_get_P(load,t);
+  }
 
-      // Battery charging
-      for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
-	if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
-	  (*phi) += price*VEC_get(var_values,BAT_get_index_Pc(bat,t));
-	  (*phi) -= price*VEC_get(var_values,BAT_get_index_Pd(bat,t));
-	}
-	else {
-	  (*phi) += price*BAT_get_P(bat,t);
-	}
-      }
+  // Battery charging
+  for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
+    if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
+      (*phi) += price*VEC_get(var_values,BAT_get_index_Pc(bat,t));
+      (*phi) -= price*VEC_get(var_values,BAT_get_index_Pd(bat,t));
+    }
+    else {
+      (*phi) += price*BAT_get_P(bat,t);
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
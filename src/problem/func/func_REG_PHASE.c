@@ -68,17 +68,19 @@ void FUNC_REG_PHASE_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
   
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_REG_PHASE_analyze_step(Func* f, Branch* br, int t) {
@@ -17,7 +17,7 @@ Func* FUNC_REG_PQ_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f, &FUNC_REG_PQ_allocate);
   FUNC_set_func_clear(f, &FUNC_REG_PQ_clear);
   FUNC_set_func_analyze_step(f, &FUNC_REG_PQ_analyze_step);
-  FUNC_set_func_eval_step(f, &FUNC_REG_PQ_eval_step);
+  FUNC_set_func_eval_bus_step(f, &FUNC_REG_PQ_eval_bus_step);
   FUNC_set_func_free(f, &FUNC_REG_PQ_free);
   FUNC_init(f);
   return f;
@@ -41,9 +41,6 @@ void FUNC_REG_PQ_clear(Func* f) {
 
   // Counter
   FUNC_set_Hphi_nnz(f,0);
-
-  // Flags
-  FUNC_clear_bus_counted(f);
 }
 
 void FUNC_REG_PQ_count_step(Func* f, Branch* br, int t) {
@@ -104,17 +101,19 @@ void FUNC_REG_PQ_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_REG_PQ_analyze_step(Func* f, Branch* br, int t) {
@@ -191,13 +190,10 @@ void FUNC_REG_PQ_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_REG_PQ_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_REG_PQ_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* bus[2];
   Gen* gen;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   REAL Qmid;
@@ -206,95 +202,69 @@ void FUNC_REG_PQ_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   REAL Q;
   REAL dP;
   REAL dQ;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
-
-  // Bus data
-  bus[0] = BRANCH_get_bus_k(br);
-  bus[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(bus[k])*T+t;
-
-  // Buses
-  for (k = 0; k < 2; k++) {
-
-    if (!bus_counted[bus_index_t[k]]) {
-
-      // Generators
-      for (gen = BUS_get_gen(bus[k]); gen != NULL; gen = GEN_get_next(gen)) {
+  // Generators
+  for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
 
-	// Mid value
-	Qmid = (GEN_get_Q_max(gen)+GEN_get_Q_min(gen))/2.; // p.u.
-	Pmid = (GEN_get_P_max(gen)+GEN_get_P_min(gen))/2.; // p.u.
+    // Mid value
+    Qmid = (GEN_get_Q_max(gen)+GEN_get_Q_min(gen))/2.; // p.u.
+    Pmid = (GEN_get_P_max(gen)+GEN_get_P_min(gen))/2.; // p.u.
 
-	// Normalization factor
-	dQ = GEN_get_Q_max(gen)-GEN_get_Q_min(gen); // p.u.
-	if (dQ < FUNC_REG_PQ_PARAM)
-	  dQ = FUNC_REG_PQ_PARAM;
-	dP = GEN_get_P_max(gen)-GEN_get_P_min(gen); // p.u.
-	if (dP < FUNC_REG_PQ_PARAM)
-	  dP = FUNC_REG_PQ_PARAM;
+    // Normalization factor
+    dQ = GEN_get_Q_max(gen)-GEN_get_Q_min(gen); // p.u.
+    if (dQ < FUNC_REG_PQ_PARAM)
+      dQ = FUNC_REG_PQ_PARAM;
+    dP = GEN_get_P_max(gen)-GEN_get_P_min(gen); // p.u.
+    if (dP < FUNC_REG_PQ_PARAM)
+      dP = FUNC_REG_PQ_PARAM;
 
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) { // Q var
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) { // Q var
 
-	  // Value
-	  Q = VEC_get(var_values,GEN_get_index_Q(gen,t));
+      // Value
+      Q = VEC_get(var_values,GEN_get_index_Q(gen,t));
 
-	  // phi
-	  (*phi) += 0.5*pow((Q-Qmid)/dQ,2.);
+      // phi
+      (*phi) += 0.5*pow((Q-Qmid)/dQ,2.);
 
-	  // gphi
-	  gphi[GEN_get_index_Q(gen,t)] = (Q-Qmid)/(dQ*dQ);
-	}
-	else {
+      // gphi
+      gphi[GEN_get_index_Q(gen,t)] = (Q-Qmid)/(dQ*dQ);
+    }
+    else {
 
-	  // Value
-	  Q = GEN_get_Q(gen,t);
+      // Value
+      Q = GEN_get_Q(gen,t);
 
-	  // phi
-	  (*phi) += 0.5*pow((Q-Qmid)/dQ,2.);
-	}
+      // phi
+      (*phi) += 0.5*pow((Q-Qmid)/dQ,2.);
+    }
 
-	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) { // P var
+    if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) { // P var
 
-	  // Value
-	  P = VEC_get(var_values,GEN_get_index_P(gen,t));
+      // Value
+      P = VEC_get(var_values,GEN_get_index_P(gen,t));
 
-	  // phi
-	  (*phi) += 0.5*pow((P-Pmid)/dP,2.);
+      // phi
+      (*phi) += 0.5*pow((P-Pmid)/dP,2.);
 
-	  // gphi
-	  gphi[GEN_get_index_P(gen,t)] = (P-Pmid)/(dP*dP);
-	}
-	else {
+      // gphi
+      gphi[GEN_get_index_P(gen,t)] = (P-Pmid)/(dP*dP);
+    }
+    else {
 
-	  // Value
-	  P = GEN_get_P(gen,t);
+      // Value
+      P = GEN_get_P(gen,t);
 
-	  // phi
-	  (*phi) += 0.5*pow((P-Pmid)/dP,2.);
-	}
-      }
+      // phi
+      (*phi) += 0.5*pow((P-Pmid)/dP,2.);
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
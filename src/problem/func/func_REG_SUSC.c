@@ -17,7 +17,7 @@ Func* FUNC_REG_SUSC_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f,&FUNC_REG_SUSC_allocate);
   FUNC_set_func_clear(f,&FUNC_REG_SUSC_clear);
   FUNC_set_func_analyze_step(f,&FUNC_REG_SUSC_analyze_step);
-  FUNC_set_func_eval_step(f,&FUNC_REG_SUSC_eval_step);
+  FUNC_set_func_eval_bus_step(f,&FUNC_REG_SUSC_eval_bus_step);
   FUNC_set_func_free(f,&FUNC_REG_SUSC_free);
   FUNC_init(f);
   return f;
@@ -41,9 +41,6 @@ void FUNC_REG_SUSC_clear(Func* f) {
 
   // Counter
   FUNC_set_Hphi_nnz(f,0);
-
-  // Flags
-  FUNC_clear_bus_counted(f);
 }
 
 void FUNC_REG_SUSC_count_step(Func* f, Branch* br, int t) {
@@ -101,17 +98,19 @@ void FUNC_REG_SUSC_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_REG_SUSC_analyze_step(Func* f, Branch* br, int t) {
@@ -176,71 +175,42 @@ void FUNC_REG_SUSC_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_REG_SUSC_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_REG_SUSC_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* bus[2];
   Shunt* shunt;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   REAL b0;
   REAL b;
   REAL db;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
+  // Shunts
+  for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
 
-  // Bus data
-  bus[0] = BRANCH_get_bus_k(br);
-  bus[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(bus[k])*T+t;
+    // Normalization factor
+    db = SHUNT_get_b_max(shunt)-SHUNT_get_b_min(shunt); // p.u.
+    if (db < FUNC_REG_SUSC_PARAM)
+      db = FUNC_REG_SUSC_PARAM;
 
-  // Buses
-  for (k = 0; k < 2; k++) {
-
-    if (!bus_counted[bus_index_t[k]]) {
-
-      // Shunts
-      for (shunt = BUS_get_shunt(bus[k]); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
-
-	// Normalization factor
-	db = SHUNT_get_b_max(shunt)-SHUNT_get_b_min(shunt); // p.u.
-	if (db < FUNC_REG_SUSC_PARAM)
-	  db = FUNC_REG_SUSC_PARAM;
-	
-	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // b var
+    if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) { // b var
 
-	  b0 = SHUNT_get_b(shunt,t);
-	  b = VEC_get(var_values,SHUNT_get_index_b(shunt,t));
-	  (*phi) += 0.5*pow((b-b0)/db,2.);
-	  gphi[SHUNT_get_index_b(shunt,t)] = (b-b0)/(db*db);
-	}
-	else {
-	  // nothing because b0 - b0 = 0
-	}
-      }
+      b0 = SHUNT_get_b(shunt,t);
+      b = VEC_get(var_values,SHUNT_get_index_b(shunt,t));
+      (*phi) += 0.5*pow((b-b0)/db,2.);
+      gphi[SHUNT_get_index_b(shunt,t)] = (b-b0)/(db*db);
+    }
+    else {
+      // nothing because b0 - b0 = 0
     }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
   }
 }
 
@@ -17,7 +17,8 @@ Func* FUNC_REG_VANG_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f, &FUNC_REG_VANG_allocate);
   FUNC_set_func_clear(f, &FUNC_REG_VANG_clear);
   FUNC_set_func_analyze_step(f, &FUNC_REG_VANG_analyze_step);
-  FUNC_set_func_eval_step(f, &FUNC_REG_VANG_eval_step);
+  FUNC_set_func_eval_branch_step(f, &FUNC_REG_VANG_eval_branch_step);
+  FUNC_set_func_eval_bus_step(f, &FUNC_REG_VANG_eval_bus_step);
   FUNC_set_func_free(f, &FUNC_REG_VANG_free);
   FUNC_init(f);
   return f;
@@ -41,9 +42,6 @@ void FUNC_REG_VANG_clear(Func* f) {
 
   // Counter
   FUNC_set_Hphi_nnz(f,0);
-
-  // Flags
-  FUNC_clear_bus_counted(f);
 }
 
 void FUNC_REG_VANG_count_step(Func* f, Branch* br, int t) {
@@ -109,17 +107,19 @@ void FUNC_REG_VANG_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_REG_VANG_analyze_step(Func* f, Branch* br, int t) {
@@ -207,34 +207,26 @@ void FUNC_REG_VANG_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_REG_VANG_eval_branch_step(Func* f, Branch* br, int t, Vec* var_values) {
 
   // Local variables
   Bus* buses[2];
-  int bus_index_t[2];
   int index_v_ang[2];
   REAL w[2];
   BOOL var_w[2];
-  Bus* bus;
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   REAL shift;
   int k;
   REAL wdiff;
   REAL dw = FUNC_REG_VANG_PARAM;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
   // Check outage
@@ -245,7 +237,6 @@ void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   buses[0] = BRANCH_get_bus_k(br);
   buses[1] = BRANCH_get_bus_m(br);
   for (k = 0; k < 2; k++) {
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
     index_v_ang[k] = BUS_get_index_v_ang(buses[k],t);
     var_w[k] = BUS_has_flags(buses[k],FLAG_VARS,BUS_VAR_VANG);
     if (var_w[k])
@@ -268,26 +259,46 @@ void FUNC_REG_VANG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
     gphi[index_v_ang[0]] += wdiff/(dw*dw);
   if (var_w[1]) // wm var
     gphi[index_v_ang[1]] -= wdiff/(dw*dw);
+}
 
-  // Buses
-  for (k = 0; k < 2; k++) {
+void FUNC_REG_VANG_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
-    bus = buses[k];
+  // Local variables
+  int index_v_ang;
+  REAL* phi;
+  REAL* gphi;
+  REAL w;
+  REAL dw = FUNC_REG_VANG_PARAM;
 
-    if (!bus_counted[bus_index_t[k]]) {
+  // Constr data
+  phi = FUNC_get_phi_ptr(f);
+  gphi = VEC_get_data(FUNC_get_gphi(f));
 
-      // phi
-      (*phi) += 0.5*pow(w[k]/dw,2.);
+  // Check pointers
+  if (!phi || !gphi)
+    return;
 
-      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) { // v var
+  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) { // v var
 
-	// gphi
-	gphi[index_v_ang[k]] += w[k]/(dw*dw);
-      }
-    }
+    // Index
+    index_v_ang = BUS_get_index_v_ang(bus,t);
 
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
+    // w
+    w = VEC_get(var_values,index_v_ang);
+
+    // phi
+    (*phi) += 0.5*pow(w/dw,2.);
+
+    // gphi
+    gphi[index_v_ang] += w/(dw*dw);
+  }
+  else {
+
+    // w
+    w = BUS_get_v_ang(bus,t);
+
+    // phi
+    (*phi) += 0.5*pow(w/dw,2.);
   }
 }
 
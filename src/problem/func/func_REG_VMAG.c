@@ -17,7 +17,7 @@ Func* FUNC_REG_VMAG_new(REAL weight, Net* net) {
   FUNC_set_func_allocate(f,&FUNC_REG_VMAG_allocate);
   FUNC_set_func_clear(f,&FUNC_REG_VMAG_clear);
   FUNC_set_func_analyze_step(f,&FUNC_REG_VMAG_analyze_step);
-  FUNC_set_func_eval_step(f,&FUNC_REG_VMAG_eval_step);
+  FUNC_set_func_eval_bus_step(f,&FUNC_REG_VMAG_eval_bus_step);
   FUNC_set_func_free(f,&FUNC_REG_VMAG_free);
   FUNC_init(f);
   return f;
@@ -41,9 +41,6 @@ void FUNC_REG_VMAG_clear(Func* f) {
 
   // Counter
   FUNC_set_Hphi_nnz(f,0);
-
-  // Flags
-  FUNC_clear_bus_counted(f);
 }
 
 void FUNC_REG_VMAG_count_step(Func* f, Branch* br, int t) {
@@ -99,17 +96,19 @@ void FUNC_REG_VMAG_allocate(Func* f) {
   // Local variables
   int num_vars;
   int Hphi_nnz;
+  Pool* pool;
 
+  pool = FUNC_get_pool(f);
   num_vars = NET_get_num_vars(FUNC_get_network(f));
   Hphi_nnz = FUNC_get_Hphi_nnz(f);
 
   // gphi
-  FUNC_set_gphi(f,VEC_new(num_vars));
+  FUNC_set_gphi(f,VEC_new_from_pool(pool,num_vars));
 
   // Hphi
-  FUNC_set_Hphi(f,MAT_new(num_vars,
-			  num_vars,
-			  Hphi_nnz));
+  FUNC_set_Hphi(f,MAT_new_from_pool(pool,num_vars,
+					  num_vars,
+					  Hphi_nnz));
 }
 
 void FUNC_REG_VMAG_analyze_step(Func* f, Branch* br, int t) {
@@ -167,13 +166,9 @@ void FUNC_REG_VMAG_analyze_step(Func* f, Branch* br, int t) {
   }
 }
 
-void FUNC_REG_VMAG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
+void FUNC_REG_VMAG_eval_bus_step(Func* f, Bus* bus, int t, Vec* var_values) {
 
   // Local variables
-  Bus* buses[2];
-  Bus* bus;
-  int bus_index_t[2];
-  char* bus_counted;
   REAL* phi;
   REAL* gphi;
   int index_v_mag;
@@ -188,67 +183,39 @@ void FUNC_REG_VMAG_eval_step(Func* f, Branch* br, int t, Vec* var_values) {
   REAL vl;
   REAL vh;
   REAL dv = FUNC_REG_VMAG_PARAM;
-  int k;
-  int T;
-
-  // Num periods
-  T = BRANCH_get_num_periods(br);
 
   // Constr data
   phi = FUNC_get_phi_ptr(f);
   gphi = VEC_get_data(FUNC_get_gphi(f));
-  bus_counted = FUNC_get_bus_counted(f);
 
   // Check pointers
-  if (!phi || !gphi || !bus_counted)
+  if (!phi || !gphi)
     return;
 
-  // Check outage
-  if (BRANCH_is_on_outage(br))
-    return;
-
-  // Bus data
-  buses[0] = BRANCH_get_bus_k(br);
-  buses[1] = BRANCH_get_bus_m(br);
-  for (k = 0; k < 2; k++)
-    bus_index_t[k] = BUS_get_index(buses[k])*T+t;
-
-  // Buses
-  for (k = 0; k < 2; k++) {
-
-    bus = buses[k];
-
-    if (!bus_counted[bus_index_t[k]]) {
-
-      // Set point
-      vt = BUS_get_v_set(bus,t);
+  // Set point
+  vt = BUS_get_v_set(bus,t);
 
-      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
+  if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) { // v var
 
-	// Index
-	index_v_mag = BUS_get_index_v_mag(bus,t);
+    // Index
+    index_v_mag = BUS_get_index_v_mag(bus,t);
 
-	// v
-	v = VEC_get(var_values,index_v_mag);
+    // v
+    v = VEC_get(var_values,index_v_mag);
 
-	// phi
-	(*phi) += 0.5*pow((v-vt)/dv,2.);
+    // phi
+    (*phi) += 0.5*pow((v-vt)/dv,2.);
 
-	// gphi
-	gphi[index_v_mag] = (v-vt)/(dv*dv);
-      }
-      else {
+    // gphi
+    gphi[index_v_mag] = (v-vt)/(dv*dv);
+  }
+  else {
 
-	// v
-	v = BUS_get_v_mag(bus,t);
+    // v
+    v = BUS_get_v_mag(bus,t);
 
-	// phi
-	(*phi) += 0.5*pow((v-vt)/dv,2.);
-      }
-    }
-
-    // Update counted flag
-    bus_counted[bus_index_t[k]] = TRUE;
+    // phi
+    (*phi) += 0.5*pow((v-vt)/dv,2.);
   }
 }
 
@@ -11,6 +11,10 @@
 #include <pfnet/array.h>
 #include <pfnet/problem.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 struct Prob {
 
   // Error
@@ -32,6 +36,9 @@ struct Prob {
   // Network
   Net* net;       /**< @brief Power flow network */
 
+  // Memory pool
+  Pool* pool;     /**< @brief Pool that reuses the buffers of the matrices and vectors across analyses */
+
   // Objective function
   REAL phi;       /**< @brief Combined objective value */
   Vec* gphi;      /**< @brief Gradient of combined objective function */
@@ -51,8 +58,54 @@ struct Prob {
   Vec* l;           /** @brief Lower bound for linear inequality contraints */
   Vec* u;           /** @brief Upper bound for linear inequality contraints */
 
+  // Compressed matrices
+  SpMat* A_csr;          /**< @brief A in compressed sparse row format */
+  SpMat* A_csc;          /**< @brief A in compressed sparse column format */
+  SpMat* G_csr;          /**< @brief G in compressed sparse row format */
+  SpMat* G_csc;          /**< @brief G in compressed sparse column format */
+  SpMat* J_csr;          /**< @brief J in compressed sparse row format */
+  SpMat* J_csc;          /**< @brief J in compressed sparse column format */
+  SpMat* Hphi_csr;       /**< @brief Hphi in compressed sparse row format */
+  SpMat* Hphi_csc;       /**< @brief Hphi in compressed sparse column format */
+  SpMat* H_combined_csr; /**< @brief H_combined in compressed sparse row format */
+  SpMat* H_combined_csc; /**< @brief H_combined in compressed sparse column format */
+
+  // Merged matrices
+  BOOL merge_duplicates;   /**< @brief Flag for returning J, Hphi and H_combined with duplicate entries merged */
+  Mat* J_merged;           /**< @brief J with duplicate entries merged (values are a view of J_csr) */
+  Mat* Hphi_merged;        /**< @brief Hphi with duplicate entries merged (values are a view of Hphi_csr) */
+  Mat* H_combined_merged;  /**< @brief H_combined with duplicate entries merged (values are a view of H_combined_csr) */
+
+  // KKT matrix
+  SpMat* KKT;      /**< @brief Lower triangular part of the KKT matrix in compressed sparse row format */
+  BOOL KKT_reg;    /**< @brief Flag that indicates that the KKT matrix has diagonal regularization entries */
+  REAL KKT_reg_x;  /**< @brief Regularization added to the primal diagonal of the KKT matrix */
+  REAL KKT_reg_c;  /**< @brief Regularization subtracted from the constraint diagonal of the KKT matrix */
+
   // Extra variables
   int num_extra_vars;          /** @brief Number of extra variables */
+
+  // Parallel evaluation
+  int num_threads;   /**< @brief Number of threads for evaluating constraints */
+  int num_parts;     /**< @brief Number of bus partitions of each period (zero for serial evaluation) */
+  int* part_bus_ptr; /**< @brief Start of the buses of each partition (size num_parts+1) */
+  int* part_ptr;     /**< @brief Start of the branch sides of each partition (size num_parts+1) */
+  int* part_branch;  /**< @brief Branch indices of the branch sides of the partitions */
+  char* part_sides;  /**< @brief Branch sides (CONSTR_SIDE_*) owned by the partitions */
+
+  // Evaluation
+  char eval_level;   /**< @brief Level of the last evaluation (EVAL_F, EVAL_FJ or EVAL_FJH) */
+
+  // Incremental evaluation
+  BOOL eval_valid;   /**< @brief Flag that indicates that the problem data corresponds to the last evaluated point */
+  char* var_kind;    /**< @brief Kind of network component of each network variable (PROB_VAR_*) */
+  int* var_comp;     /**< @brief Bus or branch of each network variable (index+t*number of buses or branches) */
+  int* J_row_constr; /**< @brief Position in the list of constraints of each row of J */
+
+  // Structure
+  BOOL struc_valid;                    /**< @brief Flag that indicates that the problem structure has been analyzed */
+  int net_struc_version;               /**< @brief Structural version of the network at the last analysis */
+  unsigned long net_struc_fingerprint; /**< @brief Structural fingerprint of the network at the last analysis */
 };
 
 void PROB_add_constr(Prob* p, Constr* c) {
@@ -62,8 +115,11 @@ void PROB_add_constr(Prob* p, Constr* c) {
       p->error_flag = TRUE;
       return;
     }
-    if (!PROB_find_constr(p,CONSTR_get_name(c)))
+    if (!PROB_find_constr(p,CONSTR_get_name(c))) {
       p->constr = CONSTR_list_add(p->constr,c);
+      CONSTR_set_pool(c,p->pool);
+      p->struc_valid = FALSE;
+    }
   }
 }
 
@@ -75,6 +131,8 @@ void PROB_add_func(Prob* p, Func* f) {
       return;
     }
     p->func = FUNC_list_add(p->func,f);
+    FUNC_set_pool(f,p->pool);
+    p->struc_valid = FALSE;
   }
 }
 
@@ -99,6 +157,8 @@ void PROB_analyze(Prob* p) {
   int Hcombnnz;
   int num_vars;
   int num_extra_vars;
+  BOOL reuse;
+  BOOL sweep;
   int k;
   int t;
   
@@ -106,47 +166,90 @@ void PROB_analyze(Prob* p) {
   if (!p)
     return;
 
+  // Invalidate data
+  p->eval_valid = FALSE;
+
+  // Same structure as last analysis
+  reuse = (p->struc_valid &&
+	   p->net_struc_version == NET_get_struc_version(p->net) &&
+	   p->net_struc_fingerprint == NET_get_struc_fingerprint(p->net));
+  p->struc_valid = FALSE;
+
   // Clear
   CONSTR_list_clear(p->constr);
+  CONSTR_list_clear_bus_counted(p->constr);
   FUNC_list_clear(p->func);
+  FUNC_list_clear_bus_counted(p->func);
   
-  // Count
-  for (t = 0; t < NET_get_num_periods(p->net); t++) {
-    for (k = 0; k < NET_get_num_branches(p->net); k++) {
+  // Count and allocate
+  num_extra_vars = p->num_extra_vars;
+  if (!reuse) {
+
+    // Count (closed form)
+    CONSTR_list_count_closed_form(p->constr);
+    FUNC_list_count_closed_form(p->func);
+
+    // Count (sweep, only if some constraint or function needs it)
+    sweep = (CONSTR_list_needs_count_sweep(p->constr) ||
+	     FUNC_list_needs_count_sweep(p->func));
+    for (t = 0; sweep && t < NET_get_num_periods(p->net); t++) {
+      for (k = 0; k < NET_get_num_branches(p->net); k++) {
       
-      br = NET_get_branch(p->net,k);
+	br = NET_get_branch(p->net,k);
       
-      // Constraints
-      CONSTR_list_count_step(p->constr,br,t);
-      if (CONSTR_list_has_error(p->constr)) {
-	strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
-	p->error_flag = TRUE;
-	return;
-      }
+	// Constraints
+	CONSTR_list_count_step(p->constr,br,t);
+	if (CONSTR_list_has_error(p->constr)) {
+	  strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+	  p->error_flag = TRUE;
+	  return;
+	}
       
-      // Functions
-      FUNC_list_count_step(p->func,br,t);
-      if (FUNC_list_has_error(p->func)) {
-	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
-	p->error_flag = TRUE;
-	return;
+	// Functions
+	FUNC_list_count_step(p->func,br,t);
+	if (FUNC_list_has_error(p->func)) {
+	  strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+	  p->error_flag = TRUE;
+	  return;
+	}
       }
     }
-  }
+    if (CONSTR_list_has_error(p->constr)) {
+      strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+      p->error_flag = TRUE;
+      return;
+    }
+    if (FUNC_list_has_error(p->func)) {
+      strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+      p->error_flag = TRUE;
+      return;
+    }
 
-  // Extra vars
-  num_extra_vars = 0;
-  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
-    num_extra_vars += CONSTR_get_num_extra_vars(c);
-  p->num_extra_vars = num_extra_vars;
+    // Extra vars
+    num_extra_vars = 0;
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+      num_extra_vars += CONSTR_get_num_extra_vars(c);
+    p->num_extra_vars = num_extra_vars;
+
+    // Release matvec (buffers are kept in the pool for the allocations below)
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+      CONSTR_del_matvec(c);
+    for (f = p->func; f != NULL; f = FUNC_get_next(f))
+      FUNC_del_matvec(f);
+    PROB_del_matvec(p);
 
-  // Allocate
-  CONSTR_list_allocate(p->constr);
-  FUNC_list_allocate(p->func);
+    // Allocate
+    CONSTR_list_allocate(p->constr);
+    FUNC_list_allocate(p->func);
 
-  // Clear
-  CONSTR_list_clear(p->constr);
-  FUNC_list_clear(p->func);
+    // Clear
+    CONSTR_list_clear(p->constr);
+    CONSTR_list_clear_bus_counted(p->constr);
+    FUNC_list_clear(p->func);
+    FUNC_list_clear_bus_counted(p->func);
+  }
+  else
+    CONSTR_list_clear_data(p->constr);
 
   // Analyze
   for (t = 0; t < NET_get_num_periods(p->net); t++) {
@@ -173,8 +276,12 @@ void PROB_analyze(Prob* p) {
   }
   CONSTR_list_finalize_structure_of_Hessians(p->constr);
 
-  // Delete matvec
-  PROB_del_matvec(p);
+  // Reuse structure (refresh linear data only)
+  if (reuse) {
+    PROB_update_lin(p);
+    p->struc_valid = TRUE;
+    return;
+  }
 
   // Allocate matvec
   Arow = 0;
@@ -202,23 +309,39 @@ void PROB_analyze(Prob* p) {
     Hphinnz += MAT_get_nnz(FUNC_get_Hphi(f));
 
   p->phi = 0;
-  p->gphi = VEC_new(num_vars+num_extra_vars);
-  p->Hphi = MAT_new(num_vars+num_extra_vars,num_vars+num_extra_vars,Hphinnz);
+  p->gphi = VEC_new_from_pool(p->pool,num_vars+num_extra_vars);
+  p->Hphi = MAT_new_from_pool(p->pool,num_vars+num_extra_vars,num_vars+num_extra_vars,Hphinnz);
 
-  p->b = VEC_new(Arow);
-  p->A = MAT_new(Arow,num_vars+num_extra_vars,Annz);
+  p->b = VEC_new_from_pool(p->pool,Arow);
+  p->A = MAT_new_from_pool(p->pool,Arow,num_vars+num_extra_vars,Annz);
 
-  p->l = VEC_new(Grow);
-  p->u = VEC_new(Grow);
-  p->G = MAT_new(Grow,num_vars+num_extra_vars,Gnnz);
+  p->l = VEC_new_from_pool(p->pool,Grow);
+  p->u = VEC_new_from_pool(p->pool,Grow);
+  p->G = MAT_new_from_pool(p->pool,Grow,num_vars+num_extra_vars,Gnnz);
   
-  p->f = VEC_new(Jrow);
-  p->J = MAT_new(Jrow,num_vars+num_extra_vars,Jnnz);
-  p->H_combined = MAT_new(num_vars+num_extra_vars,num_vars+num_extra_vars,Hcombnnz);
+  p->f = VEC_new_from_pool(p->pool,Jrow);
+  p->J = MAT_new_from_pool(p->pool,Jrow,num_vars+num_extra_vars,Jnnz);
+  p->H_combined = MAT_new_from_pool(p->pool,num_vars+num_extra_vars,num_vars+num_extra_vars,Hcombnnz);
+
+  // Release buffers of the previous structure that were not reused
+  POOL_clear(p->pool);
 
   // Update
   PROB_update_lin(p);
   PROB_update_nonlin_struc(p);
+  PROB_update_nonlin_views(p);
+  PROB_update_compressed_struc(p);
+
+  // Partitions
+  PROB_partition_buses(p);
+
+  // Variable index
+  PROB_update_var_index(p);
+
+  // Structure
+  p->struc_valid = TRUE;
+  p->net_struc_version = NET_get_struc_version(p->net);
+  p->net_struc_fingerprint = NET_get_struc_fingerprint(p->net);
 }
 
 void PROB_apply_heuristics(Prob* p, Vec* point) {
@@ -266,10 +389,242 @@ void PROB_clear_error(Prob* p) {
 }
 
 void PROB_eval(Prob* p, Vec* point) {
+  PROB_eval_with_level(p,point,EVAL_FJH);
+}
+
+void PROB_eval_f(Prob* p, Vec* point) {
+  PROB_eval_with_level(p,point,EVAL_F);
+}
+
+void PROB_eval_fJ(Prob* p, Vec* point) {
+  PROB_eval_with_level(p,point,EVAL_FJ);
+}
+
+void PROB_eval_batch(Prob* p, Vec* points, int num_points, Vec* phi, Vec* f, Vec* J) {
+  /* This function evaluates the problem at num_points points stored one
+     after the other in points. For point k, the objective value is stored
+     in phi[k], the constraint values in f[k*m,(k+1)*m) and the Jacobian
+     values, in the order of the entries of PROB_get_J, in
+     J[k*nnz,(k+1)*nnz). Any of phi, f and J may be NULL. Hessians are
+     not evaluated, and Jacobians only if J is given. */
+
+  // Local variables
+  REAL* points_data;
+  Vec* x;
+  char level;
+  int num_vars;
+  int num_f;
+  int num_J;
+  int k;
+
+  // No p
+  if (!p)
+    return;
+
+  // Sizes
+  num_vars = PROB_get_num_primal_variables(p);
+  num_f = VEC_get_size(p->f);
+  num_J = MAT_get_nnz(PROB_get_J(p));
+
+  // Check sizes
+  if (num_points < 0 ||
+      VEC_get_size(points) != num_points*num_vars ||
+      (phi && VEC_get_size(phi) != num_points) ||
+      (f && VEC_get_size(f) != num_points*num_f) ||
+      (J && VEC_get_size(J) != num_points*num_J)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return;
+  }
+
+  // Level
+  if (J)
+    level = EVAL_FJ;
+  else
+    level = EVAL_F;
+
+  // Points
+  points_data = VEC_get_data(points);
+  for (k = 0; k < num_points; k++) {
+
+    // Eval
+    x = VEC_new_from_array(&(points_data[k*num_vars]),num_vars);
+    PROB_eval_with_level(p,x,level);
+    free(x);
+    if (p->error_flag)
+      return;
+
+    // Store
+    if (phi)
+      VEC_set(phi,k,p->phi);
+    if (f && num_f > 0)
+      memcpy(&(VEC_get_data(f)[k*num_f]),VEC_get_data(p->f),num_f*sizeof(REAL));
+    if (J && num_J > 0)
+      memcpy(&(VEC_get_data(J)[k*num_J]),MAT_get_data_array(PROB_get_J(p)),num_J*sizeof(REAL));
+  }
+}
+
+void PROB_eval_Jv(Prob* p, Vec* point, Vec* v, Vec* Jv) {
+  PROB_eval_product(p,point,CONSTR_PROD_JV,NULL,v,Jv);
+}
+
+void PROB_eval_JTw(Prob* p, Vec* point, Vec* w, Vec* JTw) {
+  PROB_eval_product(p,point,CONSTR_PROD_JTW,NULL,w,JTw);
+}
+
+void PROB_eval_Hv(Prob* p, Vec* point, Vec* coeff, Vec* v, Vec* Hv) {
+  PROB_eval_product(p,point,CONSTR_PROD_HV,coeff,v,Hv);
+}
+
+void PROB_eval_product(Prob* p, Vec* point, char type, Vec* coeff, Vec* in, Vec* out) {
+  /* This function evaluates the nonlinear constraints at point and
+     stores in out the product of type CONSTR_PROD_* of their Jacobian
+     (J*in or J^T*in) or of their combined Hessian (sum_i coeff[i]*H_i)*in.
+     Matrix-free constraints accumulate the product during their
+     evaluation steps without storing J or their Hessians, and the rest
+     multiply their stored values. The evaluation is serial, and the
+     stored problem evaluation is marked as invalid afterwards. */
+
+  // Local variables
+  Constr* c;
+  Vec** c_in;
+  Vec** c_out;
+  Vec** c_coeff;
+  REAL* in_data;
+  REAL* out_data;
+  REAL* coeff_data;
+  int num_vars;
+  int num_extra_vars;
+  int num_f;
+  int num_rows;
+  int num_cols;
+  int num_constr;
+  int num_parts;
+  int row_offset;
+  int col_offset;
+  char level;
+  int i;
+  int k;
+
+  // No p
+  if (!p)
+    return;
+
+  // Sizes
+  num_vars = NET_get_num_vars(p->net);
+  num_rows = VEC_get_size(p->f);
+  num_cols = PROB_get_num_primal_variables(p);
+
+  // Check type and sizes
+  if (type != CONSTR_PROD_JV && type != CONSTR_PROD_JTW && type != CONSTR_PROD_HV) {
+    sprintf(p->error_string,"invalid product type");
+    p->error_flag = TRUE;
+    return;
+  }
+  if (VEC_get_size(point) != num_cols ||
+      VEC_get_size(in) != (type == CONSTR_PROD_JTW ? num_rows : num_cols) ||
+      VEC_get_size(out) != (type == CONSTR_PROD_JV ? num_rows : num_cols) ||
+      (type == CONSTR_PROD_HV && VEC_get_size(coeff) != num_rows)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return;
+  }
+
+  // Allocate
+  num_constr = 0;
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c))
+    num_constr++;
+  ARRAY_zalloc(c_in,Vec*,num_constr);
+  ARRAY_zalloc(c_out,Vec*,num_constr);
+  ARRAY_zalloc(c_coeff,Vec*,num_constr);
+
+  // Set products (rows are views, columns are gathered when there are extra vars)
+  level = EVAL_F;
+  VEC_set_zero(out);
+  in_data = VEC_get_data(in);
+  out_data = VEC_get_data(out);
+  coeff_data = VEC_get_data(coeff);
+  row_offset = 0;
+  col_offset = num_vars;
+  for (c = p->constr, k = 0; c != NULL; c = CONSTR_get_next(c), k++) {
+    num_f = VEC_get_size(CONSTR_get_f(c));
+    num_extra_vars = CONSTR_get_num_extra_vars(c);
+    if (num_f > 0) {
+      if (type == CONSTR_PROD_JTW)
+	c_in[k] = VEC_new_from_array(&(in_data[row_offset]),num_f);
+      else if (num_extra_vars == 0)
+	c_in[k] = VEC_new_from_array(in_data,num_vars);
+      else {
+	c_in[k] = VEC_new(num_vars+num_extra_vars);
+	memcpy(VEC_get_data(c_in[k]),in_data,num_vars*sizeof(REAL));
+	memcpy(&(VEC_get_data(c_in[k])[num_vars]),&(in_data[col_offset]),num_extra_vars*sizeof(REAL));
+      }
+      if (type == CONSTR_PROD_JV)
+	c_out[k] = VEC_new_from_array(&(out_data[row_offset]),num_f);
+      else if (num_extra_vars == 0)
+	c_out[k] = VEC_new_from_array(out_data,num_vars);
+      else
+	c_out[k] = VEC_new(num_vars+num_extra_vars);
+      if (type == CONSTR_PROD_HV)
+	c_coeff[k] = VEC_new_from_array(&(coeff_data[row_offset]),num_f);
+      CONSTR_set_product(c,type,c_coeff[k],c_in[k],c_out[k]);
+      if (!CONSTR_is_matrix_free(c))
+	level = (type == CONSTR_PROD_HV ? EVAL_FJH : EVAL_FJ);
+    }
+    row_offset += num_f;
+    col_offset += num_extra_vars;
+  }
+
+  // Eval (serial since steps of different sides add to the same entries,
+  // and without derivatives if all constraints are matrix-free)
+  num_parts = p->num_parts;
+  p->num_parts = 0;
+  PROB_eval_with_level(p,point,level);
+  p->num_parts = num_parts;
+
+  // Stored products, scatter and clean up
+  col_offset = num_vars;
+  for (c = p->constr, k = 0; c != NULL; c = CONSTR_get_next(c), k++) {
+    num_extra_vars = CONSTR_get_num_extra_vars(c);
+    if (c_in[k]) {
+      if (!CONSTR_is_matrix_free(c))
+	CONSTR_eval_stored_product(c);
+      CONSTR_set_product(c,CONSTR_PROD_NONE,NULL,NULL,NULL);
+      if (type != CONSTR_PROD_JV && num_extra_vars > 0) {
+	for (i = 0; i < num_vars; i++)
+	  out_data[i] += VEC_get(c_out[k],i);
+	for (i = 0; i < num_extra_vars; i++)
+	  out_data[col_offset+i] += VEC_get(c_out[k],num_vars+i);
+	VEC_del(c_out[k]);
+      }
+      else
+	free(c_out[k]);
+      if (type != CONSTR_PROD_JTW && num_extra_vars > 0)
+	VEC_del(c_in[k]);
+      else
+	free(c_in[k]);
+      free(c_coeff[k]);
+    }
+    col_offset += num_extra_vars;
+  }
+  free(c_in);
+  free(c_out);
+  free(c_coeff);
+  p->eval_valid = FALSE;
+}
+
+void PROB_eval_with_level(Prob* p, Vec* point, char level) {
+  /* This function evaluates the problem at point up to the given
+     level. Constraints may skip their Jacobians (level EVAL_F) and
+     Hessians (levels EVAL_F and EVAL_FJ), and the problem skips
+     combining the function gradients and Hessians accordingly.
+     Derivatives that are not evaluated are left unspecified. */
 
   // Local variables
   REAL* point_data;
   Branch* br;
+  Bus* bus;
+  Constr* c;
   int num_vars;
   Vec* x;
   Vec* y;
@@ -287,51 +642,781 @@ void PROB_eval(Prob* p, Vec* point) {
     return;
   }
 
+  // Check level
+  if (level != EVAL_F && level != EVAL_FJ && level != EVAL_FJH) {
+    sprintf(p->error_string,"invalid evaluation level");
+    p->error_flag = TRUE;
+    return;
+  }
+
   // Extract x (network) and y (extra)
   point_data = VEC_get_data(point);
   num_vars = NET_get_num_vars(p->net);
   x = VEC_new_from_array(&(point_data[0]),num_vars);
   y = VEC_new_from_array(&(point_data[num_vars]),VEC_get_size(point)-num_vars);
+  p->eval_valid = FALSE;
+
+  // Level (constraints accumulating products skip J and Hessians)
+  p->eval_level = level;
+  CONSTR_list_set_eval_level(p->constr,level);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+    if (CONSTR_is_matrix_free(c) && CONSTR_get_product_type(c) != CONSTR_PROD_NONE)
+      CONSTR_set_eval_level(c,EVAL_F);
+  }
  
   // Clear
   CONSTR_list_clear(p->constr);
   FUNC_list_clear(p->func);
   NET_clear_properties(p->net);
 
+  // Eval constraints by periods and bus partitions
+  if (p->num_parts > 0) {
+    PROB_eval_partitions(p,x,y);
+    if (p->error_flag) {
+      free(x);
+      free(y);
+      return;
+    }
+  }
+
   // Eval
   for (t = 0; t < NET_get_num_periods(p->net); t++) {
+
+    // Buses
+    for (k = 0; k < NET_get_num_buses(p->net); k++) {
+
+      bus = NET_get_bus(p->net,k);
+      if (BUS_is_isolated(bus))
+	continue;
+
+      // Constraints
+      if (p->num_parts == 0)
+	CONSTR_list_eval_bus_step(p->constr,bus,t,x,y);
+      if (CONSTR_list_has_error(p->constr)) {
+	strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
+	p->error_flag = TRUE;
+	free(x);
+	free(y);
+	return;
+      }
+
+      // Functions
+      FUNC_list_eval_bus_step(p->func,bus,t,x);
+      if (FUNC_list_has_error(p->func)) {
+	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+	p->error_flag = TRUE;
+	free(x);
+	free(y);
+	return;
+      }
+
+      // Network
+      NET_update_properties_bus_step(p->net,bus,t,x);
+    }
+
+    // Branches
     for (k = 0; k < NET_get_num_branches(p->net); k++) {
     
       br = NET_get_branch(p->net,k);
       
       // Constraints
-      CONSTR_list_eval_step(p->constr,br,t,x,y);
+      if (p->num_parts > 0)
+	CONSTR_list_eval_serial_step(p->constr,br,t,x,y);
+      else
+	CONSTR_list_eval_step(p->constr,br,t,x,y);
       if (CONSTR_list_has_error(p->constr)) {
 	strcpy(p->error_string,CONSTR_list_get_error_string(p->constr));
 	p->error_flag = TRUE;
+	free(x);
+	free(y);
 	return;
       }
-      
-      // Functions
-      FUNC_list_eval_step(p->func,br,t,x);
-      if (FUNC_list_has_error(p->func)) {
-	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
-	p->error_flag = TRUE;
-	return;
+      
+      // Functions
+      FUNC_list_eval_step(p->func,br,t,x);
+      if (FUNC_list_has_error(p->func)) {
+	strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+	p->error_flag = TRUE;
+	free(x);
+	free(y);
+	return;
+      }
+      
+      // Network
+      NET_update_properties_step(p->net,br,t,x);
+      if (NET_has_error(p->net)) {
+	strcpy(p->error_string,NET_get_error_string(p->net));
+	p->error_flag = TRUE;
+	free(x);
+	free(y);
+	return;
+      }
+    }
+  }
+
+  // Counters
+  CONSTR_list_sync_eval_counters(p->constr);
+
+  // Update 
+  PROB_update_nonlin_data(p,point);
+  p->eval_valid = !p->error_flag && level == EVAL_FJH;
+
+  // Free
+  free(x);
+  free(y);
+}
+
+void PROB_eval_incremental(Prob* p, Vec* point, Vec* prev_point) {
+  /* This function evaluates the problem at point given that the
+     problem data corresponds to prev_point, which is the case after
+     evaluating the problem at prev_point. Only the contributions
+     that depend on the variables that differ are re-evaluated. */
+
+  // Local variables
+  REAL* x;
+  REAL* x_prev;
+  int* changed;
+  int num_changed;
+  int k;
+
+  // No p
+  if (!p)
+    return;
+
+  // Full
+  if (!p->eval_valid || VEC_get_size(prev_point) != VEC_get_size(point)) {
+    PROB_eval(p,point);
+    return;
+  }
+
+  // Changed variables
+  x = VEC_get_data(point);
+  x_prev = VEC_get_data(prev_point);
+  ARRAY_alloc(changed,int,VEC_get_size(point));
+  num_changed = 0;
+  for (k = 0; k < VEC_get_size(point); k++) {
+    if (x[k] != x_prev[k]) {
+      changed[num_changed] = k;
+      num_changed++;
+    }
+  }
+
+  // Eval
+  PROB_eval_changed(p,point,changed,num_changed);
+
+  // Free
+  free(changed);
+}
+
+void PROB_eval_changed(Prob* p, Vec* point, int* changed, int num_changed) {
+  /* This function evaluates the problem at point given that the
+     problem data corresponds to a point that differs from it only in
+     the variables listed in changed. Constraints whose Jacobian has no
+     column of a changed variable keep their data. Constraints that can
+     clear the entries accumulated at a bus only re-evaluate the buses
+     whose contributions change, together with the branch sides that
+     connect to them. Other affected constraints and the functions are
+     evaluated in full. Network properties are not updated. If the
+     problem has not been evaluated since its analysis, or most buses are
+     affected, the problem is evaluated in full. */
+
+  // Local variables
+  Constr* c;
+  Branch* br;
+  Bus* bus;
+  Vec* x;
+  Vec* y;
+  Vec* ve_c;
+  REAL* point_data;
+  char* constr_dirty;
+  char* constr_full;
+  char* bus_mark;
+  int* bus_list;
+  int num_marked;
+  int* Jptr;
+  int* Jind;
+  int num_constr;
+  int num_vars;
+  int num_buses;
+  int num_branches;
+  int num_periods;
+  int offset;
+  int index_t;
+  int i;
+  int j;
+  int k;
+  int q;
+  int t;
+  BOOL full;
+
+  // No p
+  if (!p)
+    return;
+
+  // Check sizes
+  if (PROB_get_num_primal_variables(p) != VEC_get_size(point)) {
+    sprintf(p->error_string,"invalid vector size");
+    p->error_flag = TRUE;
+    return;
+  }
+
+  // Full
+  if (!p->eval_valid || !PROB_get_J_csc(p) || !p->var_kind || !p->J_row_constr) {
+    PROB_eval(p,point);
+    return;
+  }
+
+  // Sizes
+  num_constr = CONSTR_list_len(p->constr);
+  num_vars = NET_get_num_vars(p->net);
+  num_buses = NET_get_num_buses(p->net);
+  num_branches = NET_get_num_branches(p->net);
+  num_periods = NET_get_num_periods(p->net);
+
+  // Allocate
+  ARRAY_zalloc(constr_dirty,char,num_constr);
+  ARRAY_zalloc(constr_full,char,num_constr);
+  ARRAY_zalloc(bus_mark,char,num_buses*num_periods);
+  ARRAY_alloc(bus_list,int,num_buses*num_periods);
+  num_marked = 0;
+
+  // Mark constraints and buses
+  full = FALSE;
+  Jptr = SPMAT_get_ptr_array(p->J_csc);
+  Jind = SPMAT_get_ind_array(p->J_csc);
+  for (q = 0; q < num_changed; q++) {
+
+    j = changed[q];
+    if (j < 0 || j >= VEC_get_size(point))
+      continue;
+
+    // Constraints
+    for (k = Jptr[j]; k < Jptr[j+1]; k++) {
+      i = p->J_row_constr[Jind[k]];
+      constr_dirty[i] = TRUE;
+      if (j >= num_vars)
+	constr_full[i] = TRUE;
+    }
+
+    // Extra variable
+    if (j >= num_vars)
+      continue;
+
+    // Buses
+    switch (p->var_kind[j]) {
+
+    case PROB_VAR_BUS_V:
+      bus = NET_get_bus(p->net,p->var_comp[j]%num_buses);
+      t = p->var_comp[j]/num_buses;
+      for (br = BUS_get_branch_k(bus); br != NULL; br = BRANCH_get_next_k(br)) {
+	index_t = BUS_get_index(BRANCH_get_bus_m(br))+t*num_buses;
+	if (!bus_mark[index_t]) {
+	  bus_mark[index_t] = TRUE;
+	  bus_list[num_marked++] = index_t;
+	}
+      }
+      for (br = BUS_get_branch_m(bus); br != NULL; br = BRANCH_get_next_m(br)) {
+	index_t = BUS_get_index(BRANCH_get_bus_k(br))+t*num_buses;
+	if (!bus_mark[index_t]) {
+	  bus_mark[index_t] = TRUE;
+	  bus_list[num_marked++] = index_t;
+	}
+      }
+      // fall through
+
+    case PROB_VAR_BUS_INJ:
+      index_t = p->var_comp[j];
+      if (!bus_mark[index_t]) {
+	bus_mark[index_t] = TRUE;
+	bus_list[num_marked++] = index_t;
+      }
+      break;
+
+    case PROB_VAR_BRANCH:
+      br = NET_get_branch(p->net,p->var_comp[j]%num_branches);
+      t = p->var_comp[j]/num_branches;
+      index_t = BUS_get_index(BRANCH_get_bus_k(br))+t*num_buses;
+      if (!bus_mark[index_t]) {
+	bus_mark[index_t] = TRUE;
+	bus_list[num_marked++] = index_t;
+      }
+      index_t = BUS_get_index(BRANCH_get_bus_m(br))+t*num_buses;
+      if (!bus_mark[index_t]) {
+	bus_mark[index_t] = TRUE;
+	bus_list[num_marked++] = index_t;
+      }
+      break;
+
+    default:
+      full = TRUE;
+    }
+  }
+  if (2*num_marked > num_buses*num_periods)
+    full = TRUE;
+
+  // Full
+  if (full) {
+    free(constr_dirty);
+    free(constr_full);
+    free(bus_mark);
+    free(bus_list);
+    PROB_eval(p,point);
+    return;
+  }
+
+  // Extract x (network) and y (extra)
+  point_data = VEC_get_data(point);
+  x = VEC_new_from_array(&(point_data[0]),num_vars);
+  y = VEC_new_from_array(&(point_data[num_vars]),VEC_get_size(point)-num_vars);
+  p->eval_valid = FALSE;
+
+  // Constraints
+  offset = 0;
+  for (c = p->constr, i = 0; c != NULL; c = CONSTR_get_next(c), i++) {
+
+    // Extra variables
+    if (offset + CONSTR_get_num_extra_vars(c) <= VEC_get_size(y))
+      ve_c = VEC_new_from_array(&(point_data[num_vars+offset]),CONSTR_get_num_extra_vars(c));
+    else
+      ve_c = NULL;
+    offset += CONSTR_get_num_extra_vars(c);
+
+    // Eval by buses
+    if (constr_dirty[i] && CONSTR_has_clear_bus_step(c) && !constr_full[i]) {
+      for (q = 0; q < num_marked; q++) {
+	bus = NET_get_bus(p->net,bus_list[q]%num_buses);
+	t = bus_list[q]/num_buses;
+	if (BUS_is_isolated(bus))
+	  continue;
+	CONSTR_clear_bus_step(c,bus,t);
+	CONSTR_eval_bus_step(c,bus,t,x,ve_c);
+	for (br = BUS_get_branch_k(bus); br != NULL; br = BRANCH_get_next_k(br))
+	  CONSTR_eval_branch_step(c,br,t,x,ve_c,CONSTR_SIDE_K);
+	for (br = BUS_get_branch_m(bus); br != NULL; br = BRANCH_get_next_m(br))
+	  CONSTR_eval_branch_step(c,br,t,x,ve_c,CONSTR_SIDE_M);
+      }
+    }
+
+    // Eval in full
+    else if (constr_dirty[i])
+      CONSTR_eval(c,x,ve_c);
+    free(ve_c);
+
+    // Error
+    if (CONSTR_has_error(c)) {
+      strcpy(p->error_string,CONSTR_get_error_string(c));
+      p->error_flag = TRUE;
+      break;
+    }
+  }
+
+  // Functions
+  if (!p->error_flag) {
+    FUNC_list_clear(p->func);
+    for (t = 0; t < num_periods; t++) {
+      for (k = 0; k < num_buses; k++) {
+	bus = NET_get_bus(p->net,k);
+	if (!BUS_is_isolated(bus))
+	  FUNC_list_eval_bus_step(p->func,bus,t,x);
+      }
+      for (k = 0; k < num_branches; k++)
+	FUNC_list_eval_step(p->func,NET_get_branch(p->net,k),t,x);
+    }
+    if (FUNC_list_has_error(p->func)) {
+      strcpy(p->error_string,FUNC_list_get_error_string(p->func));
+      p->error_flag = TRUE;
+    }
+  }
+
+  // Update
+  if (!p->error_flag) {
+    PROB_update_nonlin_data(p,point);
+    p->eval_valid = !p->error_flag;
+  }
+
+  // Free
+  free(x);
+  free(y);
+  free(constr_dirty);
+  free(constr_full);
+  free(bus_mark);
+  free(bus_list);
+}
+
+void PROB_eval_partitions(Prob* p, Vec* x, Vec* y) {
+  /* This function evaluates the constraints that support evaluation
+     by bus and branch steps. These steps only write the entries whose
+     offsets were recorded for their period during the analysis, so
+     periods are independent. The work is split in tasks, one for each
+     period and bus partition. Each task evaluates the buses of its
+     partition and then, in branch order, the sides of the branches
+     incident to them. Hence each accumulated entry is only updated by
+     one task and in the same order as in the serial evaluation.
+     Constraints that couple periods through eval_step are evaluated
+     afterwards in the serial pass of PROB_eval. */
+
+  // Local variables
+  Constr* c;
+  Branch* br;
+  Bus* bus;
+  Vec** ve;
+  REAL* y_data;
+  int num_constr;
+  int num_tasks;
+  int offset;
+  int i;
+  int j;
+  int n;
+  int t;
+  int w;
+
+  // No p
+  if (!p || p->num_parts == 0)
+    return;
+
+  // Extra variables of each constraint
+  num_constr = CONSTR_list_len(p->constr);
+  ARRAY_alloc(ve,Vec*,num_constr);
+  y_data = VEC_get_data(y);
+  offset = 0;
+  for (c = p->constr, i = 0; c != NULL; c = CONSTR_get_next(c), i++) {
+    if (offset + CONSTR_get_num_extra_vars(c) <= VEC_get_size(y))
+      ve[i] = VEC_new_from_array(&(y_data[offset]),CONSTR_get_num_extra_vars(c));
+    else
+      ve[i] = NULL;
+    offset += CONSTR_get_num_extra_vars(c);
+    if (CONSTR_has_bus_branch_steps(c) && !CONSTR_is_safe_to_eval(c,x,ve[i])) {
+      strcpy(p->error_string,CONSTR_get_error_string(c));
+      p->error_flag = TRUE;
+    }
+  }
+
+  // Eval
+  num_tasks = p->num_parts*NET_get_num_periods(p->net);
+  if (!p->error_flag) {
+#ifdef _OPENMP
+#pragma omp parallel for private(c,br,bus,i,j,n,t) schedule(static) num_threads(p->num_threads)
+#endif
+    for (w = 0; w < num_tasks; w++) {
+      t = w/p->num_parts;
+      n = w%p->num_parts;
+      for (j = p->part_bus_ptr[n]; j < p->part_bus_ptr[n+1]; j++) {
+	bus = NET_get_bus(p->net,j);
+	if (BUS_is_isolated(bus))
+	  continue;
+	for (c = p->constr, i = 0; c != NULL; c = CONSTR_get_next(c), i++) {
+	  if (CONSTR_has_bus_branch_steps(c))
+	    CONSTR_eval_bus_step(c,bus,t,x,ve[i]);
+	}
+      }
+      for (j = p->part_ptr[n]; j < p->part_ptr[n+1]; j++) {
+	br = NET_get_branch(p->net,p->part_branch[j]);
+	for (c = p->constr, i = 0; c != NULL; c = CONSTR_get_next(c), i++) {
+	  if (CONSTR_has_bus_branch_steps(c))
+	    CONSTR_eval_branch_step(c,br,t,x,ve[i],p->part_sides[j]);
+	}
+      }
+    }
+  }
+
+  // Free
+  for (i = 0; i < num_constr; i++)
+    free(ve[i]);
+  free(ve);
+}
+
+void PROB_partition_buses(Prob* p) {
+  /* This function assigns each bus to one of num_parts partitions
+     of consecutive bus indices and lists, for each partition and in
+     increasing branch order, the branch sides that connect to its buses.
+     Bus indices coincide with the position of the buses in the network.
+     A branch whose buses belong to different partitions appears in both,
+     once for each side. Since periods are evaluated concurrently, only
+     enough partitions to give each thread a task are created, and
+     networks with at least num_threads periods use a single one. */
+
+  // Local variables
+  Branch* br;
+  int num_buses;
+  int num_branches;
+  int num_periods;
+  int num_parts;
+  int* pos;
+  int owner[2];
+  int k;
+  int n;
+
+  // No p
+  if (!p)
+    return;
+
+  // Free
+  if (p->part_bus_ptr)
+    free(p->part_bus_ptr);
+  if (p->part_ptr)
+    free(p->part_ptr);
+  if (p->part_branch)
+    free(p->part_branch);
+  if (p->part_sides)
+    free(p->part_sides);
+  p->num_parts = 0;
+  p->part_bus_ptr = NULL;
+  p->part_ptr = NULL;
+  p->part_branch = NULL;
+  p->part_sides = NULL;
+
+  // Serial
+  if (p->num_threads <= 1)
+    return;
+
+  // Number of partitions
+  num_buses = NET_get_num_buses(p->net);
+  num_branches = NET_get_num_branches(p->net);
+  num_periods = NET_get_num_periods(p->net);
+  if (num_buses == 0 || num_periods == 0)
+    return;
+  num_parts = (p->num_threads+num_periods-1)/num_periods;
+  if (num_parts > num_buses)
+    num_parts = num_buses;
+
+  // Buses
+  ARRAY_zalloc(p->part_bus_ptr,int,num_parts+1);
+  for (k = 0; k < num_buses; k++)
+    p->part_bus_ptr[(int)(((long)k*num_parts)/num_buses)+1]++;
+  for (n = 0; n < num_parts; n++)
+    p->part_bus_ptr[n+1] += p->part_bus_ptr[n];
+
+  // Count
+  ARRAY_zalloc(p->part_ptr,int,num_parts+1);
+  for (k = 0; k < num_branches; k++) {
+    br = NET_get_branch(p->net,k);
+    if (BRANCH_is_on_outage(br))
+      continue;
+    owner[0] = (int)(((long)BUS_get_index(BRANCH_get_bus_k(br))*num_parts)/num_buses);
+    owner[1] = (int)(((long)BUS_get_index(BRANCH_get_bus_m(br))*num_parts)/num_buses);
+    p->part_ptr[owner[0]+1]++;
+    if (owner[1] != owner[0])
+      p->part_ptr[owner[1]+1]++;
+  }
+  for (n = 0; n < num_parts; n++)
+    p->part_ptr[n+1] += p->part_ptr[n];
+
+  // Fill
+  ARRAY_alloc(p->part_branch,int,p->part_ptr[num_parts]);
+  ARRAY_alloc(p->part_sides,char,p->part_ptr[num_parts]);
+  ARRAY_alloc(pos,int,num_parts);
+  for (n = 0; n < num_parts; n++)
+    pos[n] = p->part_ptr[n];
+  for (k = 0; k < num_branches; k++) {
+    br = NET_get_branch(p->net,k);
+    if (BRANCH_is_on_outage(br))
+      continue;
+    owner[0] = (int)(((long)BUS_get_index(BRANCH_get_bus_k(br))*num_parts)/num_buses);
+    owner[1] = (int)(((long)BUS_get_index(BRANCH_get_bus_m(br))*num_parts)/num_buses);
+    if (owner[1] == owner[0]) {
+      p->part_branch[pos[owner[0]]] = k;
+      p->part_sides[pos[owner[0]]] = CONSTR_SIDE_BOTH;
+      pos[owner[0]]++;
+    }
+    else {
+      p->part_branch[pos[owner[0]]] = k;
+      p->part_sides[pos[owner[0]]] = CONSTR_SIDE_K;
+      pos[owner[0]]++;
+      p->part_branch[pos[owner[1]]] = k;
+      p->part_sides[pos[owner[1]]] = CONSTR_SIDE_M;
+      pos[owner[1]]++;
+    }
+  }
+  free(pos);
+  p->num_parts = num_parts;
+}
+
+void PROB_update_var_index(Prob* p) {
+  /* This function records, for each network variable, the bus or
+     branch it belongs to, and for each row of J, the constraint it
+     belongs to. Voltage variables are distinguished from the variables
+     of the devices connected to the bus since they also enter the
+     flows of the branches of the bus. */
+
+  // Local variables
+  Constr* c;
+  Branch* br;
+  Bus* bus;
+  Gen* gen;
+  Load* load;
+  Vargen* vargen;
+  Shunt* shunt;
+  Bat* bat;
+  int num_vars;
+  int num_buses;
+  int num_branches;
+  int index_t;
+  int Jrow;
+  int i;
+  int k;
+  int t;
+
+  // No p
+  if (!p)
+    return;
+
+  // Free
+  if (p->var_kind)
+    free(p->var_kind);
+  if (p->var_comp)
+    free(p->var_comp);
+  if (p->J_row_constr)
+    free(p->J_row_constr);
+
+  // Allocate
+  num_vars = NET_get_num_vars(p->net);
+  num_buses = NET_get_num_buses(p->net);
+  num_branches = NET_get_num_branches(p->net);
+  ARRAY_zalloc(p->var_kind,char,num_vars);
+  ARRAY_zalloc(p->var_comp,int,num_vars);
+  ARRAY_zalloc(p->J_row_constr,int,MAT_get_size1(p->J));
+
+  // Variables
+  for (t = 0; t < NET_get_num_periods(p->net); t++) {
+
+    // Buses and devices
+    for (k = 0; k < num_buses; k++) {
+      bus = NET_get_bus(p->net,k);
+      index_t = k+t*num_buses;
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VMAG)) {
+	p->var_kind[BUS_get_index_v_mag(bus,t)] = PROB_VAR_BUS_V;
+	p->var_comp[BUS_get_index_v_mag(bus,t)] = index_t;
+      }
+      if (BUS_has_flags(bus,FLAG_VARS,BUS_VAR_VANG)) {
+	p->var_kind[BUS_get_index_v_ang(bus,t)] = PROB_VAR_BUS_V;
+	p->var_comp[BUS_get_index_v_ang(bus,t)] = index_t;
+      }
+      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen)) {
+	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_P)) {
+	  p->var_kind[GEN_get_index_P(gen,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[GEN_get_index_P(gen,t)] = index_t;
+	}
+	if (GEN_has_flags(gen,FLAG_VARS,GEN_VAR_Q)) {
+	  p->var_kind[GEN_get_index_Q(gen,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[GEN_get_index_Q(gen,t)] = index_t;
+	}
+      }
+      for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load)) {
+	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_P)) {
+	  p->var_kind[LOAD_get_index_P(load,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[LOAD_get_index_P(load,t)] = index_t;
+	}
+	if (LOAD_has_flags(load,FLAG_VARS,LOAD_VAR_Q)) {
+	  p->var_kind[LOAD_get_index_Q(load,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[LOAD_get_index_Q(load,t)] = index_t;
+	}
       }
-      
-      // Network
-      NET_update_properties_step(p->net,br,t,x);
-      if (NET_has_error(p->net)) {
-	strcpy(p->error_string,NET_get_error_string(p->net));
-	p->error_flag = TRUE;
-	return;
+      for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen)) {
+	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_P)) {
+	  p->var_kind[VARGEN_get_index_P(vargen,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[VARGEN_get_index_P(vargen,t)] = index_t;
+	}
+	if (VARGEN_has_flags(vargen,FLAG_VARS,VARGEN_VAR_Q)) {
+	  p->var_kind[VARGEN_get_index_Q(vargen,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[VARGEN_get_index_Q(vargen,t)] = index_t;
+	}
+      }
+      for (shunt = BUS_get_shunt(bus); shunt != NULL; shunt = SHUNT_get_next(shunt)) {
+	if (SHUNT_has_flags(shunt,FLAG_VARS,SHUNT_VAR_SUSC)) {
+	  p->var_kind[SHUNT_get_index_b(shunt,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[SHUNT_get_index_b(shunt,t)] = index_t;
+	}
+      }
+      for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat)) {
+	if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_P)) {
+	  p->var_kind[BAT_get_index_Pc(bat,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[BAT_get_index_Pc(bat,t)] = index_t;
+	  p->var_kind[BAT_get_index_Pd(bat,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[BAT_get_index_Pd(bat,t)] = index_t;
+	}
+	if (BAT_has_flags(bat,FLAG_VARS,BAT_VAR_E)) {
+	  p->var_kind[BAT_get_index_E(bat,t)] = PROB_VAR_BUS_INJ;
+	  p->var_comp[BAT_get_index_E(bat,t)] = index_t;
+	}
+      }
+    }
+
+    // Branches
+    for (k = 0; k < num_branches; k++) {
+      br = NET_get_branch(p->net,k);
+      index_t = k+t*num_branches;
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO)) {
+	p->var_kind[BRANCH_get_index_ratio(br,t)] = PROB_VAR_BRANCH;
+	p->var_comp[BRANCH_get_index_ratio(br,t)] = index_t;
+      }
+      if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_PHASE)) {
+	p->var_kind[BRANCH_get_index_phase(br,t)] = PROB_VAR_BRANCH;
+	p->var_comp[BRANCH_get_index_phase(br,t)] = index_t;
       }
     }
   }
 
-  // Update 
-  PROB_update_nonlin_data(p,point);
+  // Rows of J
+  Jrow = 0;
+  for (c = p->constr, i = 0; c != NULL; c = CONSTR_get_next(c), i++) {
+    for (k = 0; k < MAT_get_size1(CONSTR_get_J(c)); k++)
+      p->J_row_constr[Jrow+k] = i;
+    Jrow += MAT_get_size1(CONSTR_get_J(c));
+  }
+}
+
+int PROB_get_num_threads(Prob* p) {
+  if (p)
+    return p->num_threads;
+  else
+    return 0;
+}
+
+void PROB_set_num_threads(Prob* p, int num) {
+  if (p) {
+    if (num < 1)
+      num = 1;
+    p->num_threads = num;
+    if (p->f)
+      PROB_partition_buses(p);
+  }
+}
+
+BOOL PROB_get_merge_duplicates(Prob* p) {
+  if (p)
+    return p->merge_duplicates;
+  else
+    return FALSE;
+}
+
+void PROB_set_merge_duplicates(Prob* p, BOOL flag) {
+  /* This function selects the layout of J, Hphi and H_combined. With
+     flag set (default), their entries are the merged (unique) entries
+     of the compressed row forms. Otherwise, they keep the concatenated
+     layout of the constraint and function matrices, which may contain
+     duplicate entries. */
+  if (p) {
+    p->merge_duplicates = flag;
+    if (!flag)
+      PROB_del_merged(p);
+  }
+}
+
+void PROB_set_KKT_regularization(Prob* p, REAL reg_x, REAL reg_c) {
+  /* This function adds diagonal entries to the KKT matrix (rebuilding
+     its structure the first time) and sets their values to reg_x for
+     the primal rows and -reg_c for the constraint rows. */
+  if (p) {
+    p->KKT_reg_x = reg_x;
+    p->KKT_reg_c = reg_c;
+    if (!p->KKT_reg) {
+      p->KKT_reg = TRUE;
+      SPMAT_del(p->KKT);
+      p->KKT = NULL;
+    }
+    else
+      PROB_update_KKT_data(p);
+  }
 }
 
 void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
@@ -357,6 +1442,8 @@ void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 
   // Clear
   CONSTR_list_clear(p->constr);
+  CONSTR_list_clear_bus_counted(p->constr);
+  p->eval_valid = FALSE;
 
   // Store sens
   for (t = 0; t < NET_get_num_periods(p->net); t++) {
@@ -378,36 +1465,89 @@ void PROB_store_sens(Prob* p, Vec* sA, Vec* sf, Vec* sGu, Vec* sGl) {
 void PROB_del(Prob* p) {
   if (p) {
     PROB_clear(p);
+    POOL_del(p->pool);
     free(p);
   }
 }
 
 void PROB_del_matvec(Prob* p) {
+
+  // Local variables
+  Constr* c;
+
   if (p) {
 
-    VEC_del(p->b);
-    MAT_del(p->A);
+    // Views
+    for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+      VEC_detach_view(CONSTR_get_f(c));
+      MAT_detach_view(CONSTR_get_J(c));
+      MAT_detach_view(CONSTR_get_H_combined(c));
+    }
+
+    VEC_del_to_pool(p->pool,p->b);
+    MAT_del_to_pool(p->pool,p->A);
     p->b = NULL;
     p->A = NULL;
     
-    VEC_del(p->u);
-    VEC_del(p->l);
-    MAT_del(p->G);
+    VEC_del_to_pool(p->pool,p->u);
+    VEC_del_to_pool(p->pool,p->l);
+    MAT_del_to_pool(p->pool,p->G);
     p->u = NULL;
     p->l = NULL;
     p->G = NULL;
  
-    VEC_del(p->f);
-    MAT_del(p->J);
-    MAT_del(p->H_combined);
+    VEC_del_to_pool(p->pool,p->f);
+    MAT_del_to_pool(p->pool,p->J);
+    MAT_del_to_pool(p->pool,p->H_combined);
     p->f = NULL;
     p->J = NULL;
     p->H_combined = NULL;
 
-    VEC_del(p->gphi);
-    MAT_del(p->Hphi);
+    VEC_del_to_pool(p->pool,p->gphi);
+    MAT_del_to_pool(p->pool,p->Hphi);
     p->gphi = NULL;
     p->Hphi = NULL;
+
+    PROB_del_compressed(p);
+  }
+}
+
+void PROB_del_compressed(Prob* p) {
+  if (p) {
+    SPMAT_del(p->A_csr);
+    SPMAT_del(p->A_csc);
+    SPMAT_del(p->G_csr);
+    SPMAT_del(p->G_csc);
+    SPMAT_del(p->J_csr);
+    SPMAT_del(p->J_csc);
+    SPMAT_del(p->Hphi_csr);
+    SPMAT_del(p->Hphi_csc);
+    SPMAT_del(p->H_combined_csr);
+    SPMAT_del(p->H_combined_csc);
+    p->A_csr = NULL;
+    p->A_csc = NULL;
+    p->G_csr = NULL;
+    p->G_csc = NULL;
+    p->J_csr = NULL;
+    p->J_csc = NULL;
+    p->Hphi_csr = NULL;
+    p->Hphi_csc = NULL;
+    p->H_combined_csr = NULL;
+    p->H_combined_csc = NULL;
+    SPMAT_del(p->KKT);
+    p->KKT = NULL;
+    PROB_del_merged(p);
+  }
+}
+
+void PROB_del_merged(Prob* p) {
+  if (p) {
+    MAT_del(p->J_merged);
+    MAT_del(p->Hphi_merged);
+    MAT_del(p->H_combined_merged);
+    p->J_merged = NULL;
+    p->Hphi_merged = NULL;
+    p->H_combined_merged = NULL;
   }
 }
 
@@ -418,10 +1558,34 @@ void PROB_clear(Prob* p) {
     CONSTR_list_del(p->constr);
     FUNC_list_del(p->func);
     HEUR_list_del(p->heur);
+    p->constr = NULL;
+    p->func = NULL;
+    p->heur = NULL;
     
     // Free matvec
     PROB_del_matvec(p);
 
+    // Free partitions
+    if (p->part_bus_ptr)
+      free(p->part_bus_ptr);
+    if (p->part_ptr)
+      free(p->part_ptr);
+    if (p->part_branch)
+      free(p->part_branch);
+    if (p->part_sides)
+      free(p->part_sides);
+
+    // Free variable index
+    if (p->var_kind)
+      free(p->var_kind);
+    if (p->var_comp)
+      free(p->var_comp);
+    if (p->J_row_constr)
+      free(p->J_row_constr);
+
+    // Free retained buffers
+    POOL_clear(p->pool);
+
     // Re-initialize
     PROB_init(p);
   }
@@ -450,16 +1614,24 @@ void PROB_combine_H(Prob* p, Vec* coeff, BOOL ensure_psd) {
   // Combine
   CONSTR_list_combine_H(p->constr,coeff,ensure_psd);
 
-  // Combine and update
+  // Update (nothing to copy for views)
   Hcombnnz = 0;
   Hcomb = MAT_get_data_array(p->H_combined);
   for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
     Hcomb_constr = MAT_get_data_array(CONSTR_get_H_combined(c));
-    for (k = 0; k < MAT_get_nnz(CONSTR_get_H_combined(c)); k++) {
-      Hcomb[Hcombnnz] = Hcomb_constr[k];
-      Hcombnnz++;
+    if (Hcomb_constr != Hcomb+Hcombnnz) {
+      for (k = 0; k < MAT_get_nnz(CONSTR_get_H_combined(c)); k++)
+	Hcomb[Hcombnnz+k] = Hcomb_constr[k];
     }
+    Hcombnnz += MAT_get_nnz(CONSTR_get_H_combined(c));
   }
+
+  // Compressed
+  SPMAT_update(p->H_combined_csr,p->H_combined);
+  SPMAT_update(p->H_combined_csc,p->H_combined);
+
+  // KKT
+  PROB_update_KKT_data(p);
 }
 
 Constr* PROB_find_constr(Prob* p, char* name) {
@@ -585,6 +1757,13 @@ Net* PROB_get_network(Prob* p) {
     return NULL;
 }
 
+Pool* PROB_get_pool(Prob* p) {
+  if (p)
+    return p->pool;
+  else
+    return NULL;
+}
+
 REAL PROB_get_phi(Prob* p) {
   if (p)
     return p->phi;
@@ -600,8 +1779,33 @@ Vec* PROB_get_gphi(Prob* p) {
 }
 
 Mat* PROB_get_Hphi(Prob* p) {
-  if (p)
+  if (!p)
+    return NULL;
+  if (p->merge_duplicates && p->Hphi) {
+    if (!p->Hphi_merged)
+      p->Hphi_merged = SPMAT_new_mat_view(PROB_get_Hphi_csr(p));
+    return p->Hphi_merged;
+  }
+  else
     return p->Hphi;
+}
+
+SpMat* PROB_get_Hphi_csr(Prob* p) {
+  if (p) {
+    if (!p->Hphi_csr)
+      p->Hphi_csr = SPMAT_new_from_mat(p->Hphi,SPMAT_CSR);
+    return p->Hphi_csr;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_Hphi_csc(Prob* p) {
+  if (p) {
+    if (!p->Hphi_csc)
+      p->Hphi_csc = SPMAT_new_from_mat(p->Hphi,SPMAT_CSC);
+    return p->Hphi_csc;
+  }
   else
     return NULL;
 }
@@ -613,6 +1817,26 @@ Mat* PROB_get_A(Prob* p) {
     return NULL;
 }
 
+SpMat* PROB_get_A_csr(Prob* p) {
+  if (p) {
+    if (!p->A_csr)
+      p->A_csr = SPMAT_new_from_mat(p->A,SPMAT_CSR);
+    return p->A_csr;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_A_csc(Prob* p) {
+  if (p) {
+    if (!p->A_csc)
+      p->A_csc = SPMAT_new_from_mat(p->A,SPMAT_CSC);
+    return p->A_csc;
+  }
+  else
+    return NULL;
+}
+
 Vec* PROB_get_b(Prob* p) {
   if (p)
     return p->b;
@@ -627,6 +1851,26 @@ Mat* PROB_get_G(Prob* p) {
     return NULL;
 }
 
+SpMat* PROB_get_G_csr(Prob* p) {
+  if (p) {
+    if (!p->G_csr)
+      p->G_csr = SPMAT_new_from_mat(p->G,SPMAT_CSR);
+    return p->G_csr;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_G_csc(Prob* p) {
+  if (p) {
+    if (!p->G_csc)
+      p->G_csc = SPMAT_new_from_mat(p->G,SPMAT_CSC);
+    return p->G_csc;
+  }
+  else
+    return NULL;
+}
+
 Vec* PROB_get_l(Prob* p) {
   if (p)
     return p->l;
@@ -642,9 +1886,34 @@ Vec* PROB_get_u(Prob* p) {
 }
 
 Mat* PROB_get_J(Prob* p) {
-  if (p)
+  if (!p)
+    return NULL;
+  if (p->merge_duplicates && p->J) {
+    if (!p->J_merged)
+      p->J_merged = SPMAT_new_mat_view(PROB_get_J_csr(p));
+    return p->J_merged;
+  }
+  else
     return p->J;
-  else 
+}
+
+SpMat* PROB_get_J_csr(Prob* p) {
+  if (p) {
+    if (!p->J_csr)
+      p->J_csr = SPMAT_new_from_mat(p->J,SPMAT_CSR);
+    return p->J_csr;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_J_csc(Prob* p) {
+  if (p) {
+    if (!p->J_csc)
+      p->J_csc = SPMAT_new_from_mat(p->J,SPMAT_CSC);
+    return p->J_csc;
+  }
+  else
     return NULL;
 }
 
@@ -656,8 +1925,43 @@ Vec* PROB_get_f(Prob* p) {
 }
 
 Mat* PROB_get_H_combined(Prob* p) {
-  if (p)
+  if (!p)
+    return NULL;
+  if (p->merge_duplicates && p->H_combined) {
+    if (!p->H_combined_merged)
+      p->H_combined_merged = SPMAT_new_mat_view(PROB_get_H_combined_csr(p));
+    return p->H_combined_merged;
+  }
+  else
     return p->H_combined;
+}
+
+SpMat* PROB_get_H_combined_csr(Prob* p) {
+  if (p) {
+    if (!p->H_combined_csr)
+      p->H_combined_csr = SPMAT_new_from_mat(p->H_combined,SPMAT_CSR);
+    return p->H_combined_csr;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_H_combined_csc(Prob* p) {
+  if (p) {
+    if (!p->H_combined_csc)
+      p->H_combined_csc = SPMAT_new_from_mat(p->H_combined,SPMAT_CSC);
+    return p->H_combined_csc;
+  }
+  else
+    return NULL;
+}
+
+SpMat* PROB_get_KKT(Prob* p) {
+  if (p) {
+    if (!p->KKT)
+      PROB_update_KKT_struc(p);
+    return p->KKT;
+  }
   else
     return NULL;
 }
@@ -705,13 +2009,53 @@ void PROB_init(Prob* p) {
     p->J = NULL;
     p->H_combined = NULL;
 
+    p->A_csr = NULL;
+    p->A_csc = NULL;
+    p->G_csr = NULL;
+    p->G_csc = NULL;
+    p->J_csr = NULL;
+    p->J_csc = NULL;
+    p->Hphi_csr = NULL;
+    p->Hphi_csc = NULL;
+    p->H_combined_csr = NULL;
+    p->H_combined_csc = NULL;
+
+    p->J_merged = NULL;
+    p->Hphi_merged = NULL;
+    p->H_combined_merged = NULL;
+
+    p->KKT = NULL;
+
     p->num_extra_vars = 0;
+
+    p->num_parts = 0;
+    p->part_bus_ptr = NULL;
+    p->part_ptr = NULL;
+    p->part_branch = NULL;
+    p->part_sides = NULL;
+
+    p->eval_level = EVAL_FJH;
+
+    p->eval_valid = FALSE;
+    p->var_kind = NULL;
+    p->var_comp = NULL;
+    p->J_row_constr = NULL;
+
+    p->struc_valid = FALSE;
+    p->net_struc_version = 0;
+    p->net_struc_fingerprint = 0;
   }
 }
 
 Prob* PROB_new(Net* net) {
   Prob* p = (Prob*)malloc(sizeof(Prob));
   p->net = net;
+  p->pool = POOL_new();
+  p->num_threads = 1;
+  p->merge_duplicates = TRUE;
+  p->KKT_reg = FALSE;
+  p->KKT_reg_x = 0;
+  p->KKT_reg_c = 0;
   PROB_init(p);
   return p;
 }
@@ -862,7 +2206,8 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
   // phi and derivatives
   p->phi = 0;
   Hphinnz = 0;
-  VEC_set_zero(p->gphi);
+  if (p->eval_level >= EVAL_FJ)
+    VEC_set_zero(p->gphi);
   gphi = VEC_get_data(p->gphi);
   Hphi = MAT_get_data_array(p->Hphi);
   for (func = p->func; func != NULL; func = FUNC_get_next(func)) {
@@ -874,19 +2219,23 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
     p->phi += weight*FUNC_get_phi(func);
 
     //gphi
-    gphi_func = VEC_get_data(FUNC_get_gphi(func));
-    for (k = 0; k < VEC_get_size(FUNC_get_gphi(func)); k++)
-      gphi[k] += weight*gphi_func[k];
+    if (p->eval_level >= EVAL_FJ) {
+      gphi_func = VEC_get_data(FUNC_get_gphi(func));
+      for (k = 0; k < VEC_get_size(FUNC_get_gphi(func)); k++)
+	gphi[k] += weight*gphi_func[k];
+    }
 
     // Hphi
-    Hphi_func = MAT_get_data_array(FUNC_get_Hphi(func));
-    for (k = 0; k < MAT_get_nnz(FUNC_get_Hphi(func)); k++) {
-      Hphi[Hphinnz] = weight*Hphi_func[k];
-      Hphinnz++;
-    }     
+    if (p->eval_level >= EVAL_FJH) {
+      Hphi_func = MAT_get_data_array(FUNC_get_Hphi(func));
+      for (k = 0; k < MAT_get_nnz(FUNC_get_Hphi(func)); k++) {
+	Hphi[Hphinnz] = weight*Hphi_func[k];
+	Hphinnz++;
+      }
+    }
   }
 
-  // f and derivatives
+  // f and derivatives (nothing to copy for views)
   Jnnz = 0;
   Jrow = 0;
   f = VEC_get_data(p->f);
@@ -898,19 +2247,259 @@ void PROB_update_nonlin_data(Prob* p, Vec* point) {
     J_constr = MAT_get_data_array(CONSTR_get_J(c));
 
     // Update f
-    for (k = 0; k < VEC_get_size(CONSTR_get_f(c)); k++) {
-      f[Jrow+k] = f_constr[k];
+    if (f_constr != f+Jrow) {
+      for (k = 0; k < VEC_get_size(CONSTR_get_f(c)); k++)
+	f[Jrow+k] = f_constr[k];
     }
 
     // Update J 
-    for (k = 0; k < MAT_get_nnz(CONSTR_get_J(c)); k++) {
-      J[Jnnz] = J_constr[k];
-      Jnnz++;
+    if (J_constr != J+Jnnz && p->eval_level >= EVAL_FJ) {
+      for (k = 0; k < MAT_get_nnz(CONSTR_get_J(c)); k++)
+	J[Jnnz+k] = J_constr[k];
     }
+    Jnnz += MAT_get_nnz(CONSTR_get_J(c));
 
     // Update row
     Jrow += MAT_get_size1(CONSTR_get_J(c));
   }
+
+  // Compressed
+  if (p->eval_level >= EVAL_FJ) {
+    SPMAT_update(p->J_csr,p->J);
+    SPMAT_update(p->J_csc,p->J);
+  }
+  if (p->eval_level >= EVAL_FJH) {
+    SPMAT_update(p->Hphi_csr,p->Hphi);
+    SPMAT_update(p->Hphi_csc,p->Hphi);
+  }
+
+  // KKT
+  if (p->eval_level >= EVAL_FJ)
+    PROB_update_KKT_data(p);
+}
+
+void PROB_update_compressed_struc(Prob* p) {
+  /* This function discards the compressed row and column forms of the
+     problem matrices after a change of structure. Each form is built
+     on first access by its getter (structure and map from the coordinate
+     entries computed once), and later updates only scatter the coordinate
+     values through the maps. Building them lazily keeps analysis cheap
+     for callers that only use the coordinate matrices. The exception are
+     the merged J, Hphi and H_combined, whose unique patterns and maps are
+     built here so that evaluations accumulate into them. */
+
+  // No p
+  if (!p)
+    return;
+
+  // Delete
+  PROB_del_compressed(p);
+
+  // Merged
+  PROB_get_J(p);
+  PROB_get_Hphi(p);
+  PROB_get_H_combined(p);
+}
+
+void PROB_update_KKT_struc(Prob* p) {
+  /* This function builds the structure of the lower triangular part of
+     the KKT matrix
+
+       [ Hphi+H_combined  J^T  A^T  G^T ]
+       [ J                 0    0    0  ]
+       [ A                 0    0    0  ]
+       [ G                 0    0    0  ]
+
+     in compressed sparse row format, together with the map from the
+     entries of Hphi, H_combined, J, A, G and the diagonal regularization
+     entries (in that order) to the stored entries. Later updates only
+     scatter values through the map. With regularization, the diagonal
+     entry is the last stored entry of every row. */
+
+  // Local variables
+  Mat* mats[5];
+  Mat* K;
+  int* Ki;
+  int* Kj;
+  int* row;
+  int* col;
+  int offset[5];
+  int num_vars;
+  int size;
+  int nnz;
+  int q;
+  int k;
+
+  // No p
+  if (!p)
+    return;
+
+  // Delete
+  SPMAT_del(p->KKT);
+  p->KKT = NULL;
+
+  // Not analyzed
+  if (!p->J || !p->A || !p->G || !p->Hphi || !p->H_combined)
+    return;
+
+  // Blocks
+  num_vars = PROB_get_num_primal_variables(p);
+  mats[0] = p->Hphi;
+  mats[1] = p->H_combined;
+  mats[2] = p->J;
+  mats[3] = p->A;
+  mats[4] = p->G;
+  offset[0] = 0;
+  offset[1] = 0;
+  offset[2] = num_vars;
+  offset[3] = offset[2]+MAT_get_size1(p->J);
+  offset[4] = offset[3]+MAT_get_size1(p->A);
+  size = offset[4]+MAT_get_size1(p->G);
+
+  // Allocate
+  nnz = 0;
+  for (q = 0; q < 5; q++)
+    nnz += MAT_get_nnz(mats[q]);
+  if (p->KKT_reg)
+    nnz += size;
+  K = MAT_new(size,size,nnz);
+  Ki = MAT_get_row_array(K);
+  Kj = MAT_get_col_array(K);
+
+  // Entries (Hessians mapped to the lower triangle)
+  nnz = 0;
+  for (q = 0; q < 5; q++) {
+    row = MAT_get_row_array(mats[q]);
+    col = MAT_get_col_array(mats[q]);
+    for (k = 0; k < MAT_get_nnz(mats[q]); k++) {
+      if (q < 2 && row[k] < col[k]) {
+	Ki[nnz] = col[k];
+	Kj[nnz] = row[k];
+      }
+      else {
+	Ki[nnz] = offset[q]+row[k];
+	Kj[nnz] = col[k];
+      }
+      nnz++;
+    }
+  }
+  if (p->KKT_reg) {
+    for (k = 0; k < size; k++) {
+      Ki[nnz] = k;
+      Kj[nnz] = k;
+      nnz++;
+    }
+  }
+
+  // Compressed
+  p->KKT = SPMAT_new_from_mat(K,SPMAT_CSR);
+  MAT_del(K);
+
+  // Values
+  PROB_update_KKT_data(p);
+}
+
+void PROB_update_KKT_data(Prob* p) {
+  /* This function refills the values of the KKT matrix from the
+     current values of Hphi, H_combined, J, A and G */
+
+  // Local variables
+  Mat* mats[5];
+  REAL* d;
+  REAL* data;
+  int* map;
+  int num_vars;
+  int size;
+  int nnz;
+  int q;
+  int k;
+
+  // No KKT
+  if (!p || !p->KKT)
+    return;
+
+  // Blocks
+  mats[0] = p->Hphi;
+  mats[1] = p->H_combined;
+  mats[2] = p->J;
+  mats[3] = p->A;
+  mats[4] = p->G;
+
+  // Check structure
+  num_vars = PROB_get_num_primal_variables(p);
+  size = SPMAT_get_size1(p->KKT);
+  nnz = 0;
+  for (q = 0; q < 5; q++)
+    nnz += MAT_get_nnz(mats[q]);
+  if (p->KKT_reg)
+    nnz += size;
+  if (nnz != SPMAT_get_coo_nnz(p->KKT))
+    return;
+
+  // Scatter
+  map = SPMAT_get_map_array(p->KKT);
+  data = SPMAT_get_data_array(p->KKT);
+  ARRAY_clear(data,REAL,SPMAT_get_nnz(p->KKT));
+  nnz = 0;
+  for (q = 0; q < 5; q++) {
+    d = MAT_get_data_array(mats[q]);
+    for (k = 0; k < MAT_get_nnz(mats[q]); k++) {
+      if (map[nnz] >= 0)
+	data[map[nnz]] += d[k];
+      nnz++;
+    }
+  }
+  if (p->KKT_reg) {
+    for (k = 0; k < size; k++) {
+      if (map[nnz] >= 0)
+	data[map[nnz]] += (k < num_vars) ? p->KKT_reg_x : -p->KKT_reg_c;
+      nnz++;
+    }
+  }
+}
+
+void PROB_update_nonlin_views(Prob* p) {
+  /* This function makes the constraint f, J and H_combined data
+     views into the problem arrays, so that evaluating the constraints
+     fills in the problem data without copying */
+
+  // Local variables
+  Constr* c;
+  REAL* f;
+  REAL* J;
+  REAL* Hcomb;
+  int Jrow;
+  int Jnnz;
+  int Hcombnnz;
+
+  // No p
+  if (!p)
+    return;
+
+  // Views
+  Jrow = 0;
+  Jnnz = 0;
+  Hcombnnz = 0;
+  f = VEC_get_data(p->f);
+  J = MAT_get_data_array(p->J);
+  Hcomb = MAT_get_data_array(p->H_combined);
+  for (c = p->constr; c != NULL; c = CONSTR_get_next(c)) {
+
+    // Sizes must match problem arrays
+    if (VEC_get_size(CONSTR_get_f(c)) != MAT_get_size1(CONSTR_get_J(c)))
+      return;
+
+    if (VEC_get_size(CONSTR_get_f(c)) > 0)
+      VEC_set_data_view(CONSTR_get_f(c),f+Jrow);
+    if (MAT_get_nnz(CONSTR_get_J(c)) > 0)
+      MAT_set_data_view(CONSTR_get_J(c),J+Jnnz);
+    if (MAT_get_nnz(CONSTR_get_H_combined(c)) > 0)
+      MAT_set_data_view(CONSTR_get_H_combined(c),Hcomb+Hcombnnz);
+
+    Jrow += MAT_get_size1(CONSTR_get_J(c));
+    Jnnz += MAT_get_nnz(CONSTR_get_J(c));
+    Hcombnnz += MAT_get_nnz(CONSTR_get_H_combined(c));
+  }
 }
 
 void PROB_update_lin(Prob* p) {
@@ -1024,6 +2613,15 @@ void PROB_update_lin(Prob* p) {
     // Update offset
     offset += CONSTR_get_num_extra_vars(c);
   }
+
+  // Compressed
+  SPMAT_update(p->A_csr,p->A);
+  SPMAT_update(p->A_csc,p->A);
+  SPMAT_update(p->G_csr,p->G);
+  SPMAT_update(p->G_csc,p->G);
+
+  // KKT
+  PROB_update_KKT_data(p);
 }
 
 int PROB_get_num_primal_variables(Prob* p) {
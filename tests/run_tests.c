@@ -13,6 +13,7 @@
 #include "test_constraints.h"
 #include "test_functions.h"
 #include "test_problem.h"
+#include "test_pflow.h"
 
 int tests_run = 0;
 char* test_case = NULL;
@@ -27,6 +28,9 @@ static char * all_tests() {
   run_test(test_net_fixed);
   run_test(test_net_properties);
   run_test(test_net_init_point);
+  run_test(test_net_copy);
+  run_test(test_net_outages);
+  run_test(test_net_arrays);
 
   // Graph
   run_test(test_graph_basic);
@@ -46,6 +50,26 @@ static char * all_tests() {
 
   // Problem
   run_test(test_problem_basic);
+  run_test(test_problem_parallel);
+  run_test(test_problem_parallel_periods);
+  run_test(test_problem_compressed);
+  run_test(test_problem_incremental);
+  run_test(test_problem_reuse);
+  run_test(test_problem_pool);
+  run_test(test_problem_eval_levels);
+  run_test(test_problem_closed_form_counts);
+  run_test(test_problem_eval_batch);
+  run_test(test_problem_products);
+  run_test(test_problem_merged);
+  run_test(test_problem_KKT);
+  run_test(test_problem_splu);
+
+  // Power flow
+  run_test(test_pflow_NR);
+  run_test(test_pflow_FD);
+  run_test(test_pflow_DC);
+  run_test(test_pflow_DC_screen);
+  run_test(test_pflow_AC_cont);
   
   return 0;
 }
@@ -461,12 +461,14 @@ static char* test_constr_ACPF() {
   Vec* f;
   Mat* J;
   Mat* H;
+  Vec* coeff;
   int Jnnz_computed;
   int Hnnz;
   int Hnnz_computed;
   int* H_nnz;
   int size;
   int i;
+  int k;
 
   printf("test_constr_ACPF ...");
 
@@ -588,6 +590,33 @@ static char* test_constr_ACPF() {
   Assert("error - bad J size", MAT_get_nnz(J) == Jnnz_computed);
   Assert("error - bad H size", MAT_get_size1(H) == NET_get_num_vars(net));
   Assert("error - bad H size", MAT_get_size2(H) == NET_get_num_vars(net));
+
+  // H block (P and Q mismatches of a bus share their structure)
+  Hnnz = 0;
+  for (i = 0; i < CONSTR_get_H_array_size(c); i++) {
+    H = CONSTR_get_H_single(c,i);
+    Assert("error - bad H block",MAT_get_data_array(H) == MAT_array_get_block_data(CONSTR_get_H_array(c),CONSTR_get_H_array_size(c))+Hnnz);
+    if (i % 2 == 1)
+      Assert("error - bad H structure",MAT_get_row_array(H) == MAT_get_row_array(CONSTR_get_H_single(c,i-1)));
+    Hnnz += MAT_get_nnz(H);
+  }
+  Assert("error - bad H combined size",MAT_get_nnz(CONSTR_get_H_combined(c)) == Hnnz);
+
+  // H combined
+  coeff = VEC_new(CONSTR_get_H_array_size(c));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,(i % 3)-1.);
+  CONSTR_combine_H(c,coeff,FALSE);
+  Hnnz = 0;
+  for (i = 0; i < CONSTR_get_H_array_size(c); i++) {
+    H = CONSTR_get_H_single(c,i);
+    for (k = 0; k < MAT_get_nnz(H); k++) {
+      Assert("error - bad H combined",MAT_get_d(CONSTR_get_H_combined(c),Hnnz) == VEC_get(coeff,i)*MAT_get_d(H,k));
+      Assert("error - bad H combined structure",MAT_get_i(CONSTR_get_H_combined(c),Hnnz) == MAT_get_i(H,k));
+      Hnnz++;
+    }
+  }
+  VEC_del(coeff);
   
   CONSTR_clear(c);
   Assert("error - wrong Jnnz counter",CONSTR_get_J_nnz(c) == 0);
@@ -10,6 +10,7 @@
 #include "unit.h"
 #include <pfnet/parser.h>
 #include <pfnet/net.h>
+#include <pfnet/contingency.h>
 
 static char* test_net_new() {
 
@@ -278,3 +279,259 @@ static char* test_net_init_point() {
   return 0;
 }
 
+static char* test_net_copy() {
+
+  Parser* parser;
+  Net* net;
+  Net* copy;
+  Cont* cont;
+  Bus* bus;
+  Bus* bus_copy;
+  Branch* br;
+  Gen* gen;
+  Vec* x;
+  Vec* x_copy;
+  int i;
+
+  printf("test_net_copy ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+  NET_set_flags(net,OBJ_BUS,FLAG_VARS,BUS_PROP_ANY,BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,OBJ_GEN,FLAG_VARS,GEN_PROP_SLACK,GEN_VAR_P);
+  cont = CONT_new();
+  CONT_add_branch_outage(cont,NET_get_branch(net,0));
+  CONT_apply(cont);
+  NET_update_properties(net,NULL);
+
+  // Copy
+  copy = NET_copy(net);
+  Assert("error - failed to copy net",copy != NULL);
+  Assert("error - bad number of buses",NET_get_num_buses(copy) == NET_get_num_buses(net));
+  Assert("error - bad number of branches",NET_get_num_branches(copy) == NET_get_num_branches(net));
+  Assert("error - bad number of gens",NET_get_num_gens(copy) == NET_get_num_gens(net));
+  Assert("error - bad number of loads",NET_get_num_loads(copy) == NET_get_num_loads(net));
+  Assert("error - bad number of shunts",NET_get_num_shunts(copy) == NET_get_num_shunts(net));
+  Assert("error - bad number of vars",NET_get_num_vars(copy) == NET_get_num_vars(net));
+  Assert("error - bad structure",NET_get_struc_fingerprint(copy) == NET_get_struc_fingerprint(net));
+  Assert("error - bad outage",BRANCH_is_on_outage(NET_get_branch(copy,0)));
+  Assert("error - bad outage",BRANCH_get_bus_k(NET_get_branch(copy,0)) ==
+	 NET_get_bus(copy,BUS_get_index(BRANCH_get_bus_k(NET_get_branch(net,0)))));
+  Assert("error - bad property",NET_get_bus_v_vio(copy,0) == NET_get_bus_v_vio(net,0));
+  Assert("error - bad property",NET_get_gen_Q_vio(copy,0) == NET_get_gen_Q_vio(net,0));
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    bus_copy = NET_get_bus(copy,i);
+    Assert("error - bad bus number",BUS_get_number(bus_copy) == BUS_get_number(bus));
+    Assert("error - bad bus hash",NET_bus_hash_number_find(copy,BUS_get_number(bus)) == bus_copy);
+    Assert("error - bad bus degree",BUS_get_degree(bus_copy) == BUS_get_degree(bus));
+    Assert("error - bad bus gens",BUS_get_num_gens(bus_copy) == BUS_get_num_gens(bus));
+    Assert("error - bad bus gen order",
+	   (!BUS_get_gen(bus) && !BUS_get_gen(bus_copy)) ||
+	   GEN_get_index(BUS_get_gen(bus_copy)) == GEN_get_index(BUS_get_gen(bus)));
+    Assert("error - bad bus loads",BUS_get_num_loads(bus_copy) == BUS_get_num_loads(bus));
+    Assert("error - bad bus regulation",BUS_is_regulated_by_gen(bus_copy) == BUS_is_regulated_by_gen(bus));
+    Assert("error - bad bus voltage",BUS_get_v_mag(bus_copy,0) == BUS_get_v_mag(bus,0));
+    Assert("error - bad bus index",BUS_get_index_v_ang(bus_copy,0) == BUS_get_index_v_ang(bus,0));
+  }
+  for (i = 0; i < NET_get_num_branches(net); i++) {
+    br = NET_get_branch(net,i);
+    Assert("error - bad branch",BRANCH_get_b(NET_get_branch(copy,i)) == BRANCH_get_b(br));
+    Assert("error - bad branch",BRANCH_get_ratio(NET_get_branch(copy,i),0) == BRANCH_get_ratio(br,0));
+  }
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    Assert("error - bad gen",GEN_get_P(NET_get_gen(copy,i),0) == GEN_get_P(gen,0));
+    Assert("error - bad gen",GEN_get_cost_coeff_Q2(NET_get_gen(copy,i)) == GEN_get_cost_coeff_Q2(gen));
+  }
+  x = NET_get_var_values(net,CURRENT);
+  x_copy = NET_get_var_values(copy,CURRENT);
+  Assert("error - bad var values",VEC_get_size(x) == VEC_get_size(x_copy));
+  for (i = 0; i < VEC_get_size(x); i++)
+    Assert("error - bad var values",VEC_get(x,i) == VEC_get(x_copy,i));
+
+  // Independence
+  CONT_clear(cont);
+  Assert("error - copy changed",BRANCH_is_on_outage(NET_get_branch(copy,0)));
+  BUS_set_v_mag(NET_get_bus(copy,0),2.,0);
+  Assert("error - net changed",BUS_get_v_mag(NET_get_bus(net,0),0) != 2.);
+
+  // State
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    BUS_set_v_ang(NET_get_bus(net,i),0.1*i,0);
+  NET_copy_state(copy,net);
+  Assert("error - state copy failed",!NET_has_error(copy));
+  Assert("error - bad voltage",BUS_get_v_mag(NET_get_bus(copy,0),0) == BUS_get_v_mag(NET_get_bus(net,0),0));
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - bad voltage",BUS_get_v_ang(NET_get_bus(copy,i),0) == 0.1*i);
+  Assert("error - outage not copied",!BRANCH_is_on_outage(NET_get_branch(copy,0)));
+  Assert("error - bad degree",(BUS_get_degree(BRANCH_get_bus_k(NET_get_branch(copy,0))) ==
+			       BUS_get_degree(BRANCH_get_bus_k(NET_get_branch(net,0)))));
+  Assert("error - bad structure",NET_get_struc_fingerprint(copy) == NET_get_struc_fingerprint(net));
+  gen = NET_get_gen(net,NET_get_num_gens(net)-1);
+  GEN_set_outage(gen,TRUE);
+  BRANCH_set_outage(NET_get_branch(net,1),TRUE);
+  NET_copy_state(copy,net);
+  Assert("error - gen outage not copied",GEN_is_on_outage(NET_get_gen(copy,GEN_get_index(gen))));
+  Assert("error - branch outage not copied",BRANCH_is_on_outage(NET_get_branch(copy,1)));
+  Assert("error - bad structure",NET_get_struc_fingerprint(copy) == NET_get_struc_fingerprint(net));
+  GEN_set_outage(gen,FALSE);
+  BRANCH_set_outage(NET_get_branch(net,1),FALSE);
+
+  VEC_del(x);
+  VEC_del(x_copy);
+  CONT_del(cont);
+  NET_del(net);
+  NET_del(copy);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_outages() {
+
+  Parser* parser;
+  Net* net;
+  Cont* cont;
+  Bus* bus;
+  Bus* bus_k;
+  Bus* reg_bus;
+  Branch* br;
+  Gen* gen;
+  Gen* g;
+  int num_gens;
+  int num_reg_gens;
+  int degree;
+  int gen_index;
+  int i;
+
+  printf("test_net_outages ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+
+  // Regulating gen
+  gen = NULL;
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    if (GEN_is_regulator(NET_get_gen(net,i))) {
+      gen = NET_get_gen(net,i);
+      break;
+    }
+  }
+  Assert("error - no regulating gen",gen != NULL);
+  br = NET_get_branch(net,0);
+  bus = GEN_get_bus(gen);
+  reg_bus = GEN_get_reg_bus(gen);
+  bus_k = BRANCH_get_bus_k(br);
+  num_gens = BUS_get_num_gens(bus);
+  num_reg_gens = BUS_get_num_reg_gens(reg_bus);
+  degree = BUS_get_degree(bus_k);
+  gen_index = GEN_get_index(BUS_get_gen(bus));
+
+  // Apply
+  cont = CONT_new();
+  CONT_add_gen_outage(cont,gen);
+  CONT_add_branch_outage(cont,br);
+  CONT_apply(cont);
+  Assert("error - bad gen outage",GEN_is_on_outage(gen) && !GEN_is_regulator(gen));
+  Assert("error - bad gen bus",GEN_get_bus(gen) == bus && GEN_get_reg_bus(gen) == reg_bus);
+  Assert("error - bad branch bus",BRANCH_get_bus_k(br) == bus_k);
+  Assert("error - bad num gens",BUS_get_num_gens(bus) == num_gens-1);
+  Assert("error - bad num reg gens",BUS_get_num_reg_gens(reg_bus) == num_reg_gens-1);
+  Assert("error - bad degree",BUS_get_degree(bus_k) == degree-1);
+  for (g = BUS_get_gen(bus); g != NULL; g = GEN_get_next(g))
+    Assert("error - gen on outage listed",g != gen);
+  for (g = BUS_get_reg_gen(reg_bus); g != NULL; g = GEN_get_reg_next(g))
+    Assert("error - gen on outage listed",g != gen);
+  Assert("error - bad num gens",NET_get_num_gens_not_on_outage(net) == NET_get_num_gens(net)-1);
+
+  // Clear
+  CONT_clear(cont);
+  Assert("error - bad num gens",BUS_get_num_gens(bus) == num_gens);
+  Assert("error - bad num reg gens",BUS_get_num_reg_gens(reg_bus) == num_reg_gens);
+  Assert("error - bad degree",BUS_get_degree(bus_k) == degree);
+  Assert("error - bad gen order",GEN_get_index(BUS_get_gen(bus)) == gen_index);
+  Assert("error - bad gen regulation",GEN_is_regulator(gen));
+
+  CONT_del(cont);
+  PARSER_del(parser);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_net_arrays() {
+
+  Parser* parser;
+  Net* net;
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  Load* load;
+  REAL* v_mag;
+  REAL* v_ang;
+  REAL* ratio;
+  REAL* phase;
+  int i;
+  int t;
+
+  printf("test_net_arrays ... ");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    v_mag = NET_get_bus_v_mag_array(net,t);
+    v_ang = NET_get_bus_v_ang_array(net,t);
+    ratio = NET_get_branch_ratio_array(net,t);
+    phase = NET_get_branch_phase_array(net,t);
+    Assert("error - missing arrays",v_mag && v_ang && ratio && phase);
+    for (i = 0; i < NET_get_num_buses(net); i++) {
+      bus = NET_get_bus(net,i);
+      BUS_set_v_ang(bus,0.01*(i+t),t);
+      Assert("error - bad v_mag array",v_mag[i] == BUS_get_v_mag(bus,t));
+      Assert("error - bad v_ang array",v_ang[i] == 0.01*(i+t));
+      v_mag[i] = 1.+0.001*i;
+      Assert("error - bad v_mag",BUS_get_v_mag(bus,t) == 1.+0.001*i);
+    }
+    for (i = 0; i < NET_get_num_branches(net); i++) {
+      br = NET_get_branch(net,i);
+      Assert("error - bad ratio array",ratio[i] == BRANCH_get_ratio(br,t));
+      Assert("error - bad phase array",phase[i] == BRANCH_get_phase(br,t));
+    }
+  }
+  Assert("error - bad period",NET_get_bus_v_mag_array(net,3) == NULL);
+
+  // Per-period arrays carved from shared blocks
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_gens(net); i++) {
+      gen = NET_get_gen(net,i);
+      GEN_set_P(gen,i+0.1*t,t);
+      GEN_set_Q(gen,-i-0.1*t,t);
+    }
+    for (i = 0; i < NET_get_num_loads(net); i++) {
+      load = NET_get_load(net,i);
+      LOAD_set_P(load,i+0.1*t,t);
+      LOAD_set_Q(load,-i-0.1*t,t);
+    }
+  }
+  for (t = 0; t < NET_get_num_periods(net); t++) {
+    for (i = 0; i < NET_get_num_gens(net); i++) {
+      gen = NET_get_gen(net,i);
+      Assert("error - bad gen P",GEN_get_P(gen,t) == i+0.1*t);
+      Assert("error - bad gen Q",GEN_get_Q(gen,t) == -i-0.1*t);
+      Assert("error - bad gen sens",GEN_get_sens_P_u_bound(gen,t) == 0.);
+    }
+    for (i = 0; i < NET_get_num_loads(net); i++) {
+      load = NET_get_load(net,i);
+      Assert("error - bad load P",LOAD_get_P(load,t) == i+0.1*t);
+      Assert("error - bad load Q",LOAD_get_Q(load,t) == -i-0.1*t);
+      Assert("error - bad load sens",LOAD_get_sens_P_u_bound(load,t) == 0.);
+    }
+  }
+
+  PARSER_del(parser);
+  NET_del(net);
+  printf("ok\n");
+  return 0;
+}
@@ -0,0 +1,687 @@
+/** @file test_pflow.h
+ *
+ * This file is part of PFNET.
+ *
+ * Copyright (c) 2015-2017, Tomas Tinoco De Rubira.
+ *
+ * PFNET is released under the BSD 2-clause license.
+ */
+
+#include "unit.h"
+#include <pfnet/parser.h>
+#include <pfnet/net.h>
+#include <pfnet/pflow.h>
+#include <pfnet/dcflow.h>
+#include <pfnet/dcscreen.h>
+#include <pfnet/contana.h>
+
+static char* test_pflow_NR() {
+
+  Parser* parser;
+  Net* net;
+  PFlow* pf;
+  Gen* gen;
+  Gen* reg_gen;
+  Bus* bus;
+  REAL Qmax;
+  REAL tol;
+  int num_iters;
+  int i;
+  int k;
+
+  printf("test_pflow_NR ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Init
+  pf = PFLOW_new();
+  Assert("error - bad power flow init",!PFLOW_has_error(pf) && !PFLOW_has_converged(pf));
+  Assert("error - bad default tolerance",PFLOW_get_tol(pf) == PFLOW_TOL);
+  Assert("error - bad default max iters",PFLOW_get_max_iters(pf) == PFLOW_MAX_ITERS);
+  Assert("error - bad initial stats",PFLOW_get_num_iters(pf) == 0 && PFLOW_get_mismatch(pf) == 0);
+
+  // No steps
+  PFLOW_set_max_iters(pf,0);
+  PFLOW_solve(pf,net);
+  Assert("error - power flow failed",!PFLOW_has_error(pf));
+  Assert("error - bad number of iterations",PFLOW_get_num_iters(pf) == 0);
+  Assert("error - initial point should not be solved",!PFLOW_has_converged(pf));
+  Assert("error - bad mismatch",PFLOW_get_mismatch(pf) >= PFLOW_get_tol(pf));
+  Assert("error - bad network mismatches",NET_get_bus_P_mis(net,0) > 0 && NET_get_bus_Q_mis(net,0) > 0);
+
+  // Solve
+  tol = 1e-8;
+  PFLOW_set_tol(pf,tol);
+  PFLOW_set_max_iters(pf,PFLOW_MAX_ITERS);
+  PFLOW_solve(pf,net);
+  Assert("error - power flow failed",!PFLOW_has_error(pf));
+  Assert("error - power flow did not converge",PFLOW_has_converged(pf));
+  num_iters = PFLOW_get_num_iters(pf);
+  Assert("error - bad number of iterations",num_iters > 0 && num_iters <= PFLOW_MAX_ITERS);
+  Assert("error - bad mismatch",PFLOW_get_mismatch(pf) < tol);
+  Assert("error - bad final iteration mismatch",PFLOW_get_iter_mismatch(pf,num_iters) == PFLOW_get_mismatch(pf));
+  Assert("error - bad initial iteration mismatch",PFLOW_get_iter_mismatch(pf,0) > PFLOW_get_mismatch(pf));
+  for (k = 0; k < num_iters; k++) {
+    Assert("error - bad step",PFLOW_get_iter_step(pf,k) > 0 && PFLOW_get_iter_step(pf,k) <= 1.);
+    Assert("error - bad iteration time",PFLOW_get_iter_time(pf,k) >= 0);
+  }
+  Assert("error - bad time",PFLOW_get_time(pf) >= 0);
+  Assert("error - bad stats out of range",PFLOW_get_iter_step(pf,num_iters) == 0);
+
+  // Network
+  for (k = 0; k < NET_get_num_periods(net); k++) {
+    Assert("error - bad active power mismatch",NET_get_bus_P_mis(net,k) < 1e3*tol*NET_get_base_power(net));
+    Assert("error - bad reactive power mismatch",NET_get_bus_Q_mis(net,k) < 1e3*tol*NET_get_base_power(net));
+  }
+
+  // One factorization per step
+  Assert("error - bad number of factorizations",
+	 (SPLU_get_num_factorizations(PFLOW_get_LU(pf))+
+	  SPLU_get_num_refactorizations(PFLOW_get_LU(pf))) == num_iters);
+
+  // Reactive power limit of a regulating generator
+  reg_gen = NULL;
+  for (i = 0; i < NET_get_num_gens(net) && !reg_gen; i++) {
+    gen = NET_get_gen(net,i);
+    if (GEN_is_regulator(gen) && !GEN_is_slack(gen) && GEN_get_Q(gen,0) > GEN_get_Q_min(gen)+1e-2)
+      reg_gen = gen;
+  }
+  Assert("error - no regulating generator",reg_gen != NULL);
+  bus = GEN_get_reg_bus(reg_gen);
+  Qmax = 0.5*(GEN_get_Q(reg_gen,0)+GEN_get_Q_min(reg_gen));
+  GEN_set_Q_max(reg_gen,Qmax);
+
+  // PV-PQ switching
+  PFLOW_solve(pf,net);
+  Assert("error - power flow failed",!PFLOW_has_error(pf) && PFLOW_has_converged(pf));
+  Assert("error - bad mismatch",PFLOW_get_mismatch(pf) < tol);
+  Assert("error - PV-PQ switching failed",fabs(GEN_get_Q(reg_gen,0)-Qmax) < 1e-8);
+  Assert("error - PV-PQ switching failed",BUS_get_v_mag(bus,0) < BUS_get_v_set(bus,0));
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    if (!GEN_is_regulator(gen) || GEN_is_slack(gen))
+      continue;
+    for (k = 0; k < NET_get_num_periods(net); k++) {
+      Assert("error - PV-PQ switching failed",GEN_get_Q(gen,k) <= GEN_get_Q_max(gen)+1e-8);
+      Assert("error - PV-PQ switching failed",GEN_get_Q(gen,k) >= GEN_get_Q_min(gen)-1e-8);
+    }
+  }
+  num_iters += PFLOW_get_num_iters(pf);
+
+  // No PV-PQ switching and no line search
+  PFLOW_set_pvpq(pf,FALSE);
+  PFLOW_set_line_search(pf,FALSE);
+  PFLOW_solve(pf,net);
+  Assert("error - power flow failed",!PFLOW_has_error(pf) && PFLOW_has_converged(pf));
+  Assert("error - bad mismatch",PFLOW_get_mismatch(pf) < tol);
+  Assert("error - voltage not at set point",fabs(BUS_get_v_mag(bus,0)-BUS_get_v_set(bus,0)) < 1e-8);
+  Assert("error - reactive power limit not violated",GEN_get_Q(reg_gen,0) > Qmax);
+  for (k = 0; k < PFLOW_get_num_iters(pf); k++)
+    Assert("error - bad step",PFLOW_get_iter_step(pf,k) == 1.);
+  num_iters += PFLOW_get_num_iters(pf);
+  Assert("error - bad number of factorizations",
+	 (SPLU_get_num_factorizations(PFLOW_get_LU(pf))+
+	  SPLU_get_num_refactorizations(PFLOW_get_LU(pf))) == num_iters);
+
+  PFLOW_del(pf);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_pflow_FD() {
+
+  Parser* parser;
+  Net* net;
+  Net* net_NR;
+  PFlow* pf;
+  Gen* gen;
+  Bus* bus;
+  REAL tol;
+  char method;
+  int num_solves;
+  int i;
+  int k;
+
+  printf("test_pflow_FD ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net_NR = PARSER_parse(parser,test_case,2);
+
+  // Reference
+  tol = 1e-8;
+  pf = PFLOW_new();
+  Assert("error - bad default method",PFLOW_get_method(pf) == PFLOW_METHOD_NR);
+  PFLOW_set_tol(pf,tol);
+  PFLOW_set_pvpq(pf,FALSE);
+  PFLOW_solve(pf,net_NR);
+  Assert("error - power flow failed",!PFLOW_has_error(pf) && PFLOW_has_converged(pf));
+
+  num_solves = 0;
+  for (method = PFLOW_METHOD_FDXB; method <= PFLOW_METHOD_FDBX; method++) {
+
+    net = PARSER_parse(parser,test_case,2);
+
+    // Solve
+    PFLOW_set_method(pf,method);
+    Assert("error - bad method",PFLOW_get_method(pf) == method);
+    PFLOW_set_max_iters(pf,50);
+    PFLOW_solve(pf,net);
+    num_solves++;
+    Assert("error - power flow failed",!PFLOW_has_error(pf));
+    Assert("error - power flow did not converge",PFLOW_has_converged(pf));
+    Assert("error - bad number of iterations",PFLOW_get_num_iters(pf) > 0);
+    Assert("error - bad mismatch",PFLOW_get_mismatch(pf) < tol);
+    for (k = 0; k < PFLOW_get_num_iters(pf); k++)
+      Assert("error - bad step",PFLOW_get_iter_step(pf,k) == 1.);
+
+    // One factorization of B' and B'' per solve
+    Assert("error - bad number of factorizations",
+	   (SPLU_get_num_factorizations(PFLOW_get_LU_Bp(pf))+
+	    SPLU_get_num_refactorizations(PFLOW_get_LU_Bp(pf))) == num_solves);
+    Assert("error - bad number of factorizations",
+	   (SPLU_get_num_factorizations(PFLOW_get_LU_Bpp(pf))+
+	    SPLU_get_num_refactorizations(PFLOW_get_LU_Bpp(pf))) == num_solves);
+
+    // Same solution as Newton-Raphson
+    for (k = 0; k < NET_get_num_periods(net); k++) {
+      Assert("error - bad active power mismatch",NET_get_bus_P_mis(net,k) < 1e3*tol*NET_get_base_power(net));
+      Assert("error - bad reactive power mismatch",NET_get_bus_Q_mis(net,k) < 1e3*tol*NET_get_base_power(net));
+      for (i = 0; i < NET_get_num_buses(net); i++) {
+	bus = NET_get_bus(net,i);
+	Assert("error - bad voltage magnitude",fabs(BUS_get_v_mag(bus,k)-BUS_get_v_mag(NET_get_bus(net_NR,i),k)) < 1e-6);
+	Assert("error - bad voltage angle",fabs(BUS_get_v_ang(bus,k)-BUS_get_v_ang(NET_get_bus(net_NR,i),k)) < 1e-6);
+	if (BUS_is_regulated_by_gen(bus))
+	  Assert("error - voltage not at set point",BUS_get_v_mag(bus,k) == BUS_get_v_set(bus,k));
+      }
+      for (i = 0; i < NET_get_num_gens(net); i++) {
+	gen = NET_get_gen(net,i);
+	Assert("error - bad active power",fabs(GEN_get_P(gen,k)-GEN_get_P(NET_get_gen(net_NR,i),k)) < 1e-6);
+	Assert("error - bad reactive power",fabs(GEN_get_Q(gen,k)-GEN_get_Q(NET_get_gen(net_NR,i),k)) < 1e-6);
+      }
+    }
+
+    NET_del(net);
+  }
+
+  PFLOW_del(pf);
+  NET_del(net_NR);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_pflow_DC() {
+
+  Parser* parser;
+  Net* net;
+  DCFlow* dc;
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  Load* load;
+  Vargen* vargen;
+  Bat* bat;
+  Vec* flows;
+  Vec* P;
+  Vec* w;
+  REAL* column;
+  REAL mis;
+  REAL delta;
+  int* bus_indices;
+  int num_buses;
+  int num_branches;
+  int i;
+  int j;
+  int k;
+
+  printf("test_pflow_DC ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+  num_buses = NET_get_num_buses(net);
+  num_branches = NET_get_num_branches(net);
+
+  // Init
+  dc = DCFLOW_new();
+  Assert("error - bad DC flow init",!DCFLOW_has_error(dc) && !DCFLOW_is_analyzed(dc));
+  Assert("error - PTDF without analysis",DCFLOW_get_PTDF_column(dc,0) == NULL);
+
+  // Solve
+  DCFLOW_solve(dc,net);
+  Assert("error - DC power flow failed",!DCFLOW_has_error(dc));
+  Assert("error - not analyzed",DCFLOW_is_analyzed(dc));
+  Assert("error - bad sizes",DCFLOW_get_num_buses(dc) == num_buses && DCFLOW_get_num_branches(dc) == num_branches);
+  Assert("error - bad number of factorizations",SPLU_get_num_factorizations(DCFLOW_get_LU(dc)) == 1);
+
+  // Power balance at every bus (including slack)
+  for (k = 0; k < NET_get_num_periods(net); k++) {
+    for (i = 0; i < num_buses; i++) {
+      bus = NET_get_bus(net,i);
+      mis = 0;
+      for (gen = BUS_get_gen(bus); gen != NULL; gen = GEN_get_next(gen))
+	mis += GEN_get_P(gen,k);
+      for (vargen = BUS_get_vargen(bus); vargen != NULL; vargen = VARGEN_get_next(vargen))
+	mis += VARGEN_get_P(vargen,k);
+      for (bat = BUS_get_bat(bus); bat != NULL; bat = BAT_get_next(bat))
+	mis -= BAT_get_P(bat,k);
+      for (load = BUS_get_load(bus); load != NULL; load = LOAD_get_next(load))
+	mis -= LOAD_get_P(load,k);
+      for (br = BUS_get_branch_k(bus); br != NULL; br = BRANCH_get_next_k(br))
+	mis -= BRANCH_get_P_km_DC(br,k);
+      for (br = BUS_get_branch_m(bus); br != NULL; br = BRANCH_get_next_m(br))
+	mis -= BRANCH_get_P_mk_DC(br,k);
+      Assert("error - bad DC power balance",fabs(mis) < 1e-10);
+    }
+  }
+
+  // PTDF against re-solve
+  delta = 0.1;
+  flows = VEC_new(num_branches);
+  for (j = 0; j < num_branches; j++)
+    VEC_set(flows,j,BRANCH_get_P_km_DC(NET_get_branch(net,j),0));
+  for (i = 0; i < num_buses; i++) {
+    bus = NET_get_bus(net,i);
+    load = BUS_get_load(bus);
+    if (!load || BUS_is_slack(bus))
+      continue;
+    LOAD_set_P(load,LOAD_get_P(load,0)-delta,0);
+    DCFLOW_solve(dc,net);
+    LOAD_set_P(load,LOAD_get_P(load,0)+delta,0);
+    column = DCFLOW_get_PTDF_column(dc,i);
+    Assert("error - bad PTDF column",column != NULL);
+    for (j = 0; j < num_branches; j++) {
+      br = NET_get_branch(net,j);
+      Assert("error - bad PTDF",fabs(BRANCH_get_P_km_DC(br,0)-VEC_get(flows,j)-delta*column[j]) < 1e-10);
+      Assert("error - bad PTDF entry",DCFLOW_get_PTDF(dc,j,i) == column[j]);
+    }
+  }
+  Assert("error - bad number of factorizations",SPLU_get_num_factorizations(DCFLOW_get_LU(dc)) == 1);
+
+  // Batch of injection vectors and PTDF cache
+  P = VEC_new(num_buses*num_buses);
+  w = VEC_new(num_buses*num_buses);
+  VEC_set_zero(P);
+  for (i = 0; i < num_buses; i++)
+    VEC_set(P,i*num_buses+i,1.);
+  DCFLOW_solve_angles(dc,P,w,num_buses);
+  VEC_del(flows);
+  flows = VEC_new(num_branches*num_buses);
+  DCFLOW_compute_flows(dc,w,flows,num_buses);
+  DCFLOW_clear_PTDF(dc);
+  Assert("error - PTDF cache not cleared",DCFLOW_get_num_PTDF_columns(dc) == 0);
+  bus_indices = (int*)malloc(num_buses*sizeof(int));
+  for (i = 0; i < num_buses; i++)
+    bus_indices[i] = i;
+  DCFLOW_compute_PTDF(dc,bus_indices,num_buses);
+  Assert("error - DC flow error",!DCFLOW_has_error(dc));
+  Assert("error - bad number of PTDF columns",DCFLOW_get_num_PTDF_columns(dc) == num_buses);
+  for (i = 0; i < num_buses; i++) {
+    column = DCFLOW_get_PTDF_column(dc,i);
+    for (j = 0; j < num_branches; j++) {
+      if (BUS_is_slack(NET_get_bus(net,i)))
+	Assert("error - bad slack PTDF",column[j] == 0);
+      Assert("error - bad batch flows",fabs(VEC_get(flows,i*num_branches+j)-column[j]) < 1e-12);
+    }
+  }
+
+  // Re-analysis
+  DCFLOW_analyze(dc,net);
+  Assert("error - PTDF cache not cleared",DCFLOW_get_num_PTDF_columns(dc) == 0);
+  Assert("error - bad number of refactorizations",SPLU_get_num_refactorizations(DCFLOW_get_LU(dc)) == 1);
+
+  free(bus_indices);
+  VEC_del(flows);
+  VEC_del(P);
+  VEC_del(w);
+  DCFLOW_del(dc);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_pflow_DC_screen() {
+
+  Parser* parser;
+  Net* net;
+  DCFlow* dc;
+  DCFlow* dc_cont;
+  DCScreen* s;
+  Cont* cont;
+  Branch* br;
+  REAL* f0;
+  REAL* sev;
+  REAL post;
+  REAL sev_sum;
+  int doubles[6] = {0,1,2,5,3,7};
+  int num_branches;
+  int num_conts;
+  int num_islanding;
+  int num_overloaded;
+  int br_index[2];
+  int c;
+  int k;
+  int l;
+  int j;
+
+  printf("test_pflow_DC_screen ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+  num_branches = NET_get_num_branches(net);
+
+  // Base case
+  dc = DCFLOW_new();
+  DCFLOW_solve(dc,net);
+  Assert("error - DC power flow failed",!DCFLOW_has_error(dc));
+  f0 = (REAL*)malloc(num_branches*sizeof(REAL));
+  for (l = 0; l < num_branches; l++) {
+    br = NET_get_branch(net,l);
+    f0[l] = BRANCH_get_P_km_DC(br,0);
+    BRANCH_set_ratingA(br,fabs(f0[l]) > 1e-3 ? 1.1*fabs(f0[l]) : 0);
+  }
+
+  // Screening
+  s = DCSCREEN_new();
+  Assert("error - bad defaults",DCSCREEN_get_top(s) == DCSCREEN_TOP && DCSCREEN_get_singles(s));
+  Assert("error - bad default rating",DCSCREEN_get_rating(s) == DCSCREEN_RATING_A);
+  DCSCREEN_add_double(s,1,1);
+  Assert("error - invalid double outage accepted",DCSCREEN_has_error(s) && DCSCREEN_get_num_doubles(s) == 0);
+  DCSCREEN_clear_error(s);
+  for (k = 0; k < 3; k++)
+    DCSCREEN_add_double(s,doubles[2*k],doubles[2*k+1]);
+  DCSCREEN_set_top(s,num_branches+3);
+  DCSCREEN_run(s,dc,net,0);
+  Assert("error - screening failed",!DCSCREEN_has_error(s));
+  Assert("error - bad number of screened contingencies",DCSCREEN_get_num_screened(s) == num_branches+3);
+
+  // Brute force
+  num_conts = num_branches+3;
+  sev = (REAL*)malloc(num_conts*sizeof(REAL));
+  dc_cont = DCFLOW_new();
+  num_islanding = 0;
+  num_overloaded = 0;
+  for (c = 0; c < num_conts; c++) {
+    br_index[0] = c < num_branches ? c : doubles[2*(c-num_branches)];
+    br_index[1] = c < num_branches ? -1 : doubles[2*(c-num_branches)+1];
+    cont = CONT_new();
+    for (j = 0; j < 2; j++) {
+      if (br_index[j] >= 0)
+	CONT_add_branch_outage(cont,NET_get_branch(net,br_index[j]));
+    }
+    CONT_apply(cont);
+    DCFLOW_analyze(dc_cont,net);
+    DCFLOW_solve(dc_cont,net);
+    sev[c] = -1;
+    if (DCFLOW_has_error(dc_cont)) {
+      DCFLOW_clear_error(dc_cont);
+      num_islanding++;
+      if (br_index[1] < 0) {
+	for (l = 0; l < num_branches; l++)
+	  Assert("error - bad islanding LODF",DCFLOW_get_LODF(dc,l,c) == 0 || l == c);
+      }
+    }
+    else {
+      sev[c] = 0;
+      for (l = 0; l < num_branches; l++) {
+	br = NET_get_branch(net,l);
+	if (l == br_index[0] || l == br_index[1])
+	  continue;
+	post = BRANCH_get_P_km_DC(br,0);
+	if (br_index[1] < 0)
+	  Assert("error - bad LODF",fabs(f0[l]+DCFLOW_get_LODF(dc,l,c)*f0[c]-post) < 1e-8);
+	if (BRANCH_get_ratingA(br) > 0 && fabs(post) > BRANCH_get_ratingA(br))
+	  sev[c] += fabs(post)/BRANCH_get_ratingA(br)-1.;
+      }
+      if (sev[c] > 0)
+	num_overloaded++;
+    }
+    CONT_clear(cont);
+    CONT_del(cont);
+  }
+  Assert("error - bad number of islanding contingencies",DCSCREEN_get_num_islanding(s) == num_islanding);
+  Assert("error - bad number of overloaded contingencies",DCSCREEN_get_num_overloaded(s) == num_overloaded);
+  Assert("error - bad number of results",DCSCREEN_get_num_results(s) == num_overloaded);
+
+  // Ranking
+  sev_sum = 0;
+  for (k = 0; k < DCSCREEN_get_num_results(s); k++) {
+    br_index[0] = DCSCREEN_get_result_branch(s,k,0);
+    br_index[1] = DCSCREEN_get_result_branch(s,k,1);
+    if (br_index[1] < 0)
+      c = br_index[0];
+    else {
+      for (c = 0; c < 3; c++) {
+	if (doubles[2*c] == br_index[0] && doubles[2*c+1] == br_index[1])
+	  break;
+      }
+      Assert("error - bad double outage",c < 3);
+      c += num_branches;
+    }
+    Assert("error - bad severity",fabs(DCSCREEN_get_result_severity(s,k)-sev[c]) < 1e-8);
+    Assert("error - bad max loading",DCSCREEN_get_result_max_loading(s,k) > 1.);
+    Assert("error - bad worst branch",DCSCREEN_get_result_worst_branch(s,k) >= 0);
+    if (k > 0)
+      Assert("error - bad ranking",DCSCREEN_get_result_severity(s,k) <= DCSCREEN_get_result_severity(s,k-1));
+    sev_sum += sev[c];
+  }
+
+  // Top contingencies for AC study
+  DCSCREEN_set_top(s,2);
+  DCSCREEN_run(s,dc,net,0);
+  Assert("error - bad number of results",DCSCREEN_get_num_results(s) == (num_overloaded < 2 ? num_overloaded : 2));
+  for (k = 0; k < DCSCREEN_get_num_results(s); k++) {
+    cont = DCSCREEN_new_cont(s,net,k);
+    Assert("error - bad contingency",CONT_get_num_branch_outages(cont) == (DCSCREEN_get_result_branch(s,k,1) < 0 ? 1 : 2));
+    CONT_del(cont);
+  }
+
+  free(f0);
+  free(sev);
+  DCFLOW_del(dc);
+  DCFLOW_del(dc_cont);
+  DCSCREEN_del(s);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_pflow_AC_cont() {
+
+  Parser* parser;
+  Net* net;
+  Net* net1;
+  Net* net2;
+  PFlow* pf;
+  ContAna* ca;
+  Cont** conts;
+  Cont** iconts;
+  Cont* cont;
+  Bus* bus;
+  Branch* br;
+  Gen* gen;
+  REAL* v_mag;
+  REAL* loading;
+  REAL* v_vio;
+  REAL* Q_vio;
+  REAL flows[BRANCH_FLOW_SIZE];
+  REAL S;
+  char* converged;
+  int num_branches;
+  int num_conts;
+  int num_iconts;
+  int c;
+  int i;
+  int l;
+
+  printf("test_pflow_AC_cont ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+  num_branches = NET_get_num_branches(net);
+
+  // Base case
+  pf = PFLOW_new();
+  PFLOW_solve(pf,net);
+  Assert("error - power flow failed",!PFLOW_has_error(pf) && PFLOW_has_converged(pf));
+  for (l = 0; l < num_branches; l++) {
+    br = NET_get_branch(net,l);
+    BRANCH_compute_flows(br,NULL,0,flows);
+    S = sqrt(flows[BRANCH_P_KM]*flows[BRANCH_P_KM]+flows[BRANCH_Q_KM]*flows[BRANCH_Q_KM]);
+    BRANCH_set_ratingA(br,S > 1e-3 ? 1.1*S : 0);
+  }
+  v_mag = (REAL*)malloc(NET_get_num_buses(net)*sizeof(REAL));
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    v_mag[i] = BUS_get_v_mag(NET_get_bus(net,i),0);
+
+  // Contingencies
+  num_conts = (num_branches < 20 ? num_branches : 20)+1;
+  conts = (Cont**)malloc(num_conts*sizeof(Cont*));
+  for (c = 0; c < num_conts-1; c++) {
+    conts[c] = CONT_new();
+    CONT_add_branch_outage(conts[c],NET_get_branch(net,c));
+  }
+  conts[c] = CONT_new();
+  for (i = 0; i < NET_get_num_gens(net); i++) {
+    gen = NET_get_gen(net,i);
+    if (!GEN_is_slack(gen)) {
+      CONT_add_gen_outage(conts[c],gen);
+      break;
+    }
+  }
+  Assert("error - bad contingency",CONT_get_branch_outage(conts[0],0) == NET_get_branch(net,0));
+  Assert("error - bad contingency",CONT_get_branch_outage(conts[0],1) == NULL);
+
+  // Serial
+  ca = CONTANA_new();
+  Assert("error - bad number of workers",CONTANA_get_num_workers(ca) == 1);
+  CONTANA_set_num_threads(ca,1);
+  CONTANA_run(ca,net,conts,num_conts);
+  Assert("error - contingency analysis failed",!CONTANA_has_error(ca));
+  Assert("error - bad number of contingencies",CONTANA_get_num_conts(ca) == num_conts);
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - base solution not restored",BUS_get_v_mag(NET_get_bus(net,i),0) == v_mag[i]);
+  converged = (char*)malloc(num_conts*sizeof(char));
+  loading = (REAL*)malloc(num_conts*sizeof(REAL));
+  for (c = 0; c < num_conts; c++) {
+    converged[c] = CONTANA_has_converged(ca,c);
+    loading[c] = CONTANA_get_branch_max_loading(ca,c);
+    if (converged[c])
+      Assert("error - bad mismatch",CONTANA_get_mismatch(ca,c) < PFLOW_get_tol(CONTANA_get_pflow(ca)));
+  }
+
+  // Direct
+  net1 = PARSER_parse(parser,test_case,1);
+  net2 = PARSER_parse(parser,test_case,1);
+  for (l = 0; l < num_branches; l++) {
+    BRANCH_set_ratingA(NET_get_branch(net1,l),BRANCH_get_ratingA(NET_get_branch(net,l)));
+    BRANCH_set_ratingA(NET_get_branch(net2,l),BRANCH_get_ratingA(NET_get_branch(net,l)));
+  }
+  PFLOW_solve(pf,net1);
+  cont = CONT_new();
+  CONT_add_branch_outage(cont,NET_get_branch(net1,0));
+  CONT_apply(cont);
+  PFLOW_solve(pf,net1);
+  Assert("error - bad convergence",PFLOW_has_converged(pf) == converged[0]);
+  Assert("error - bad number of iterations",PFLOW_get_num_iters(pf) == CONTANA_get_num_iters(ca,0));
+  Assert("error - bad voltage violation",fabs(NET_get_bus_v_vio(net1,0)-CONTANA_get_bus_v_vio(ca,0)) < 1e-8);
+  Assert("error - bad reactive power violation",fabs(NET_get_gen_Q_vio(net1,0)-CONTANA_get_gen_Q_vio(ca,0)) < 1e-8);
+  CONT_clear(cont);
+  CONT_del(cont);
+
+  // Workers
+  CONTANA_add_worker(ca,net);
+  CONTANA_run(ca,net,conts,num_conts);
+  Assert("error - base network accepted as worker",CONTANA_has_error(ca));
+  CONTANA_del(ca);
+  ca = CONTANA_new();
+  CONTANA_add_worker(ca,net1);
+  CONTANA_add_worker(ca,net2);
+  Assert("error - bad number of workers",CONTANA_get_num_workers(ca) == 3);
+  CONTANA_run(ca,net,conts,num_conts);
+  Assert("error - contingency analysis failed",!CONTANA_has_error(ca));
+  for (c = 0; c < num_conts; c++) {
+    Assert("error - bad convergence",CONTANA_has_converged(ca,c) == converged[c]);
+    if (converged[c])
+      Assert("error - bad max loading",fabs(CONTANA_get_branch_max_loading(ca,c)-loading[c]) < 1e-6);
+  }
+  for (i = 0; i < NET_get_num_buses(net); i++)
+    Assert("error - base solution not restored",BUS_get_v_mag(NET_get_bus(net,i),0) == v_mag[i]);
+
+  // Copies
+  CONTANA_del(ca);
+  ca = CONTANA_new();
+  CONTANA_set_num_threads(ca,3);
+  CONTANA_run(ca,net,conts,num_conts);
+  Assert("error - contingency analysis failed",!CONTANA_has_error(ca));
+  for (c = 0; c < num_conts; c++) {
+    Assert("error - bad convergence",CONTANA_has_converged(ca,c) == converged[c]);
+    if (converged[c])
+      Assert("error - bad max loading",fabs(CONTANA_get_branch_max_loading(ca,c)-loading[c]) < 1e-6);
+  }
+
+  // Islanding outages (failed solves) between regular ones
+  br = NULL;
+  for (i = 0; i < NET_get_num_buses(net); i++) {
+    bus = NET_get_bus(net,i);
+    if (BUS_get_degree(bus) == 1) {
+      br = BUS_get_branch_k(bus) ? BUS_get_branch_k(bus) : BUS_get_branch_m(bus);
+      break;
+    }
+  }
+  Assert("error - no radial bus",br != NULL);
+  num_iconts = 2*(num_conts-1);
+  iconts = (Cont**)malloc(num_iconts*sizeof(Cont*));
+  for (c = 0; c < num_conts-1; c++) {
+    iconts[2*c] = conts[c];
+    iconts[2*c+1] = CONT_new();
+    CONT_add_branch_outage(iconts[2*c+1],br);
+  }
+  v_vio = (REAL*)malloc(num_iconts*sizeof(REAL));
+  Q_vio = (REAL*)malloc(num_iconts*sizeof(REAL));
+  CONTANA_del(ca);
+  ca = CONTANA_new();
+  CONTANA_set_num_threads(ca,1);
+  CONTANA_run(ca,net,iconts,num_iconts);
+  Assert("error - contingency analysis failed",!CONTANA_has_error(ca));
+  for (c = 0; c < num_iconts; c++) {
+    v_vio[c] = CONTANA_get_bus_v_vio(ca,c);
+    Q_vio[c] = CONTANA_get_gen_Q_vio(ca,c);
+    if (c % 2) {
+      Assert("error - islanding outage converged",!CONTANA_has_converged(ca,c));
+      Assert("error - stale voltage violation",v_vio[c] == v_vio[1]);
+      Assert("error - stale reactive power violation",Q_vio[c] == Q_vio[1]);
+    }
+  }
+  CONTANA_set_num_threads(ca,3);
+  CONTANA_run(ca,net,iconts,num_iconts);
+  Assert("error - contingency analysis failed",!CONTANA_has_error(ca));
+  for (c = 0; c < num_iconts; c++) {
+    Assert("error - bad voltage violation",fabs(CONTANA_get_bus_v_vio(ca,c)-v_vio[c]) < 1e-8);
+    Assert("error - bad reactive power violation",fabs(CONTANA_get_gen_Q_vio(ca,c)-Q_vio[c]) < 1e-8);
+  }
+  for (c = 0; c < num_conts-1; c++)
+    CONT_del(iconts[2*c+1]);
+  free(iconts);
+  free(v_vio);
+  free(Q_vio);
+
+  for (c = 0; c < num_conts; c++)
+    CONT_del(conts[c]);
+  free(conts);
+  free(v_mag);
+  free(converged);
+  free(loading);
+  PFLOW_del(pf);
+  CONTANA_del(ca);
+  NET_del(net);
+  NET_del(net1);
+  NET_del(net2);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
@@ -94,7 +94,1757 @@ static char* test_problem_basic() {
   Assert("error - problem failed on eval",!PROB_has_error(p));
   Assert("error - bad objective value",PROB_get_phi(p) > 0.);
 
+  // Constraint data in problem arrays (concatenated layout)
+  PROB_set_merge_duplicates(p,FALSE);
+  Assert("error - bad constraint f view",
+	 VEC_get_data(CONSTR_get_f(PROB_find_constr(p,"AC power balance"))) == VEC_get_data(PROB_get_f(p)));
+  Assert("error - bad constraint J view",
+	 MAT_get_data_array(CONSTR_get_J(PROB_find_constr(p,"AC power balance"))) == MAT_get_data_array(PROB_get_J(p)));
+
+  // Re-analyze
+  PROB_analyze(p);
+  PROB_eval(p,x);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+
+  VEC_del(x);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_parallel() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Vec* x;
+  Vec* coeff;
+  Vec* f;
+  Mat* J;
+  Mat* H;
+  REAL phi;
+  int i;
+
+  printf("test_problem_parallel ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,1);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_BRANCH,
+		FLAG_VARS,
+		BRANCH_PROP_TAP_CHANGER,
+		BRANCH_VAR_RATIO);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_BOUNDED,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG);
+
+  p = PROB_new(net);
+
+  Assert("error - bad default number of threads",PROB_get_num_threads(p) == 1);
+
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_add_constr(p,CONSTR_NBOUND_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VANG_new(1.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  x = PROB_get_init_point(p);
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 7)-3.));
+  coeff = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,1.+i);
+
+  // Serial
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  f = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    VEC_set(f,i,VEC_get(PROB_get_f(p),i));
+  J = MAT_copy(PROB_get_J(p));
+  H = MAT_copy(PROB_get_H_combined(p));
+  phi = PROB_get_phi(p);
+
+  // Partitioned
+  PROB_set_num_threads(p,3);
+  Assert("error - bad number of threads",PROB_get_num_threads(p) == 3);
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on parallel eval",!PROB_has_error(p));
+  Assert("error - bad phi",PROB_get_phi(p) == phi);
+  Assert("error - bad f",memcmp(VEC_get_data(f),VEC_get_data(PROB_get_f(p)),
+				VEC_get_size(f)*sizeof(REAL)) == 0);
+  Assert("error - bad J",memcmp(MAT_get_data_array(J),MAT_get_data_array(PROB_get_J(p)),
+				MAT_get_nnz(J)*sizeof(REAL)) == 0);
+  Assert("error - bad H",memcmp(MAT_get_data_array(H),MAT_get_data_array(PROB_get_H_combined(p)),
+				MAT_get_nnz(H)*sizeof(REAL)) == 0);
+  Assert("error - bad J counter",
+	 CONSTR_get_J_nnz(PROB_find_constr(p,"AC power balance")) ==
+	 MAT_get_nnz(CONSTR_get_J(PROB_find_constr(p,"AC power balance"))));
+  Assert("error - bad J row counter",
+	 CONSTR_get_J_row(PROB_find_constr(p,"AC branch flow limits")) ==
+	 VEC_get_size(CONSTR_get_f(PROB_find_constr(p,"AC branch flow limits"))));
+  Assert("error - bad J row counter",
+	 CONSTR_get_J_row(PROB_find_constr(p,"voltage regulation by generators")) ==
+	 VEC_get_size(CONSTR_get_f(PROB_find_constr(p,"voltage regulation by generators"))));
+
+  VEC_del(x);
+  VEC_del(coeff);
+  VEC_del(f);
+  MAT_del(J);
+  MAT_del(H);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_parallel_periods() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Vec* x;
+  Vec* f;
+  Mat* J;
+  Mat* A;
+  int i;
+
+  printf("test_problem_parallel_periods ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,5);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+
+  p = PROB_new(net);
+
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_constr(p,CONSTR_GEN_RAMP_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  x = PROB_get_init_point(p);
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 5)-2.));
+
+  // Serial
+  PROB_eval(p,x);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  f = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    VEC_set(f,i,VEC_get(PROB_get_f(p),i));
+  J = MAT_copy(PROB_get_J(p));
+  A = MAT_copy(PROB_get_A(p));
+
+  // Periods in parallel
+  PROB_set_num_threads(p,2);
+  PROB_eval(p,x);
+  Assert("error - problem failed on parallel eval",!PROB_has_error(p));
+  Assert("error - bad f",memcmp(VEC_get_data(f),VEC_get_data(PROB_get_f(p)),
+				VEC_get_size(f)*sizeof(REAL)) == 0);
+  Assert("error - bad J",memcmp(MAT_get_data_array(J),MAT_get_data_array(PROB_get_J(p)),
+				MAT_get_nnz(J)*sizeof(REAL)) == 0);
+  Assert("error - bad A",MAT_get_nnz(A) == MAT_get_nnz(PROB_get_A(p)));
+  Assert("error - bad J counter",
+	 CONSTR_get_J_nnz(PROB_find_constr(p,"AC power balance")) ==
+	 MAT_get_nnz(CONSTR_get_J(PROB_find_constr(p,"AC power balance"))));
+
+  // Periods and partitions in parallel
+  PROB_set_num_threads(p,8);
+  PROB_eval(p,x);
+  Assert("error - problem failed on parallel eval",!PROB_has_error(p));
+  Assert("error - bad f",memcmp(VEC_get_data(f),VEC_get_data(PROB_get_f(p)),
+				VEC_get_size(f)*sizeof(REAL)) == 0);
+  Assert("error - bad J",memcmp(MAT_get_data_array(J),MAT_get_data_array(PROB_get_J(p)),
+				MAT_get_nnz(J)*sizeof(REAL)) == 0);
+
+  VEC_del(x);
+  VEC_del(f);
+  MAT_del(J);
+  MAT_del(A);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static BOOL check_compressed(Mat* m, SpMat* s) {
+
+  REAL* x;
+  REAL* y;
+  int num_major;
+  int num_minor;
+  int i;
+  int j;
+  int k;
+  BOOL ok;
+
+  if (!m || !s)
+    return FALSE;
+  if (SPMAT_get_coo_nnz(s) != MAT_get_nnz(m) ||
+      SPMAT_get_size1(s) != MAT_get_size1(m) ||
+      SPMAT_get_size2(s) != MAT_get_size2(m))
+    return FALSE;
+
+  if (SPMAT_get_format(s) == SPMAT_CSR) {
+    num_major = MAT_get_size1(m);
+    num_minor = MAT_get_size2(m);
+  }
+  else {
+    num_major = MAT_get_size2(m);
+    num_minor = MAT_get_size1(m);
+  }
+
+  // Structure (sorted and duplicate-free)
+  if (SPMAT_get_ptr_array(s)[0] != 0 || SPMAT_get_ptr_array(s)[num_major] != SPMAT_get_nnz(s))
+    return FALSE;
+  for (i = 0; i < num_major; i++) {
+    for (k = SPMAT_get_ptr_array(s)[i]; k < SPMAT_get_ptr_array(s)[i+1]; k++) {
+      if (SPMAT_get_ind_array(s)[k] < 0 || SPMAT_get_ind_array(s)[k] >= num_minor)
+	return FALSE;
+      if (k > SPMAT_get_ptr_array(s)[i] && SPMAT_get_ind_array(s)[k] <= SPMAT_get_ind_array(s)[k-1])
+	return FALSE;
+    }
+  }
+
+  // Values (y = M*x)
+  x = (REAL*)malloc(sizeof(REAL)*(num_minor+1));
+  y = (REAL*)calloc(num_major+1,sizeof(REAL));
+  for (j = 0; j < num_minor; j++)
+    x[j] = 1.+0.01*(j % 17);
+  for (k = 0; k < MAT_get_nnz(m); k++) {
+    if (SPMAT_get_format(s) == SPMAT_CSR)
+      y[MAT_get_i(m,k)] += MAT_get_d(m,k)*x[MAT_get_j(m,k)];
+    else
+      y[MAT_get_j(m,k)] += MAT_get_d(m,k)*x[MAT_get_i(m,k)];
+  }
+  for (i = 0; i < num_major; i++) {
+    for (k = SPMAT_get_ptr_array(s)[i]; k < SPMAT_get_ptr_array(s)[i+1]; k++)
+      y[i] -= SPMAT_get_data_array(s)[k]*x[SPMAT_get_ind_array(s)[k]];
+  }
+  ok = TRUE;
+  for (i = 0; i < num_major; i++) {
+    if (fabs(y[i]) > 1e-10*(1.+fabs(y[i])))
+      ok = FALSE;
+  }
+  free(x);
+  free(y);
+  return ok;
+}
+
+static char* test_problem_compressed() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Vec* x;
+  Vec* coeff;
+  int i;
+
+  printf("test_problem_compressed ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS|FLAG_BOUNDED,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+
+  p = PROB_new(net);
+  PROB_set_merge_duplicates(p,FALSE);
+
+  Assert("error - bad compressed init",PROB_get_J_csr(p) == NULL);
+
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_P_new(net));
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(2.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  x = PROB_get_init_point(p);
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 5)-2.));
+  coeff = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,1.+0.1*(i % 3));
+
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+
+  // Duplicates merged
+  Assert("error - bad J compressed nnz",SPMAT_get_nnz(PROB_get_J_csr(p)) <= MAT_get_nnz(PROB_get_J(p)));
+  Assert("error - bad J compressed nnz",SPMAT_get_nnz(PROB_get_J_csr(p)) == SPMAT_get_nnz(PROB_get_J_csc(p)));
+  Assert("error - bad H compressed nnz",
+	 SPMAT_get_nnz(PROB_get_H_combined_csr(p)) < MAT_get_nnz(PROB_get_H_combined(p)));
+
+  // Structure and values
+  Assert("error - bad A csr",check_compressed(PROB_get_A(p),PROB_get_A_csr(p)));
+  Assert("error - bad A csc",check_compressed(PROB_get_A(p),PROB_get_A_csc(p)));
+  Assert("error - bad G csr",check_compressed(PROB_get_G(p),PROB_get_G_csr(p)));
+  Assert("error - bad G csc",check_compressed(PROB_get_G(p),PROB_get_G_csc(p)));
+  Assert("error - bad J csr",check_compressed(PROB_get_J(p),PROB_get_J_csr(p)));
+  Assert("error - bad J csc",check_compressed(PROB_get_J(p),PROB_get_J_csc(p)));
+  Assert("error - bad Hphi csr",check_compressed(PROB_get_Hphi(p),PROB_get_Hphi_csr(p)));
+  Assert("error - bad Hphi csc",check_compressed(PROB_get_Hphi(p),PROB_get_Hphi_csc(p)));
+  Assert("error - bad Hcomb csr",check_compressed(PROB_get_H_combined(p),PROB_get_H_combined_csr(p)));
+  Assert("error - bad Hcomb csc",check_compressed(PROB_get_H_combined(p),PROB_get_H_combined_csc(p)));
+
+  // New point
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 3)-1.));
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  Assert("error - bad J csr update",check_compressed(PROB_get_J(p),PROB_get_J_csr(p)));
+  Assert("error - bad J csc update",check_compressed(PROB_get_J(p),PROB_get_J_csc(p)));
+  Assert("error - bad Hcomb csr update",check_compressed(PROB_get_H_combined(p),PROB_get_H_combined_csr(p)));
+
+  VEC_del(x);
+  VEC_del(coeff);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_incremental() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Bus* bus;
+  Bus* far;
+  Branch* br;
+  Gen* gen;
+  Constr* acpf;
+  Vec* x0;
+  Vec* x1;
+  Vec* coeff;
+  Vec* f;
+  Vec* gphi;
+  Mat* J;
+  Mat* Hphi;
+  Mat* H;
+  REAL phi;
+  REAL sentinel;
+  int far_row;
+  int i;
+  int k;
+
+  printf("test_problem_incremental ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_BRANCH,
+		FLAG_VARS,
+		BRANCH_PROP_TAP_CHANGER,
+		BRANCH_VAR_RATIO);
+
+  p = PROB_new(net);
+
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_P_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(1.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  acpf = PROB_find_constr(p,"AC power balance");
+
+  // Points
+  x0 = PROB_get_init_point(p);
+  for (i = 0; i < VEC_get_size(x0); i++)
+    VEC_add_to_entry(x0,i,1e-2*((i % 5)-2.));
+  x1 = VEC_new(VEC_get_size(x0));
+  for (i = 0; i < VEC_get_size(x0); i++)
+    VEC_set(x1,i,VEC_get(x0,i));
+  coeff = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,1.+0.1*(i % 3));
+
+  // Changes (voltage of a bus, a generator in the second period, a tap ratio)
+  bus = NET_get_bus(net,0);
+  VEC_add_to_entry(x1,BUS_get_index_v_mag(bus,0),0.03);
+  gen = NET_get_gen(net,NET_get_num_gens(net)-1);
+  VEC_add_to_entry(x1,GEN_get_index_Q(gen,1),0.2);
+  for (k = 0; k < NET_get_num_branches(net); k++) {
+    br = NET_get_branch(net,k);
+    if (BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO)) {
+      VEC_add_to_entry(x1,BRANCH_get_index_ratio(br,0),0.01);
+      break;
+    }
+  }
+
+  // Bus not affected by the changes
+  far = NULL;
+  for (k = 0; k < NET_get_num_buses(net) && !far; k++) {
+    far = NET_get_bus(net,k);
+    if (far == bus || far == GEN_get_bus(gen))
+      far = NULL;
+    for (i = 0; i < NET_get_num_branches(net) && far; i++) {
+      br = NET_get_branch(net,i);
+      if ((BRANCH_get_bus_k(br) == far || BRANCH_get_bus_m(br) == far) &&
+	  (BRANCH_get_bus_k(br) == bus || BRANCH_get_bus_m(br) == bus ||
+	   BRANCH_has_flags(br,FLAG_VARS,BRANCH_VAR_RATIO)))
+	far = NULL;
+    }
+  }
+  Assert("error - no unaffected bus",far != NULL);
+  far_row = BUS_get_index_P(far);
+
+  // Incremental
+  PROB_eval(p,x0);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  sentinel = VEC_get(CONSTR_get_f(acpf),far_row)+1.;
+  VEC_set(CONSTR_get_f(acpf),far_row,sentinel);
+  PROB_eval_incremental(p,x1,x0);
+  Assert("error - problem failed on incremental eval",!PROB_has_error(p));
+  Assert("error - unaffected bus re-evaluated",VEC_get(CONSTR_get_f(acpf),far_row) == sentinel);
+  VEC_set(CONSTR_get_f(acpf),far_row,sentinel-1.);
+  PROB_combine_H(p,coeff,FALSE);
+  phi = PROB_get_phi(p);
+  f = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    VEC_set(f,i,VEC_get(PROB_get_f(p),i));
+  gphi = VEC_new(VEC_get_size(PROB_get_gphi(p)));
+  for (i = 0; i < VEC_get_size(gphi); i++)
+    VEC_set(gphi,i,VEC_get(PROB_get_gphi(p),i));
+  J = MAT_copy(PROB_get_J(p));
+  Hphi = MAT_copy(PROB_get_Hphi(p));
+  H = MAT_copy(PROB_get_H_combined(p));
+
+  // Full
+  PROB_eval(p,x1);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  Assert("error - bad incremental phi",fabs(phi-PROB_get_phi(p)) < 1e-10*(1.+fabs(phi)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    Assert("error - bad incremental f",fabs(VEC_get(f,i)-VEC_get(PROB_get_f(p),i)) < 1e-10);
+  for (i = 0; i < VEC_get_size(gphi); i++)
+    Assert("error - bad incremental gphi",fabs(VEC_get(gphi,i)-VEC_get(PROB_get_gphi(p),i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(J); i++)
+    Assert("error - bad incremental J",fabs(MAT_get_d(J,i)-MAT_get_d(PROB_get_J(p),i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(Hphi); i++)
+    Assert("error - bad incremental Hphi",fabs(MAT_get_d(Hphi,i)-MAT_get_d(PROB_get_Hphi(p),i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(H); i++)
+    Assert("error - bad incremental H",fabs(MAT_get_d(H,i)-MAT_get_d(PROB_get_H_combined(p),i)) < 1e-10);
+
+  VEC_del(x0);
+  VEC_del(x1);
+  VEC_del(coeff);
+  VEC_del(f);
+  VEC_del(gphi);
+  MAT_del(J);
+  MAT_del(Hphi);
+  MAT_del(H);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_reuse() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Prob* q;
+  Cont* cont;
+  Mat* A;
+  int A_nnz;
+  int version;
+  int i;
+
+  printf("test_problem_reuse ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  version = NET_get_struc_version(net);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_NOT_SLACK,
+		BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS|FLAG_BOUNDED,
+		GEN_PROP_ANY,
+		GEN_VAR_P);
+  Assert("error - bad structural version",NET_get_struc_version(net) == version+2);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_DCPF_new(net));
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  A = PROB_get_A(p);
+  A_nnz = MAT_get_nnz(A);
+
+  // Data change
+  for (i = 0; i < NET_get_num_loads(net); i++) {
+    LOAD_set_P(NET_get_load(net,i),1.1*LOAD_get_P(NET_get_load(net,i),0)+0.01,0);
+    LOAD_set_P(NET_get_load(net,i),0.9*LOAD_get_P(NET_get_load(net,i),1),1);
+  }
+  GEN_set_P_max(NET_get_gen(net,0),GEN_get_P_max(NET_get_gen(net,0))+1.);
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  Assert("error - structure not reused",PROB_get_A(p) == A);
+
+  // Compare with new problem
+  q = PROB_new(net);
+  PROB_add_constr(q,CONSTR_DCPF_new(net));
+  PROB_add_constr(q,CONSTR_LBOUND_new(net));
+  PROB_add_func(q,FUNC_GEN_COST_new(1.,net));
+  PROB_analyze(q);
+  Assert("error - problem failed on analyze",!PROB_has_error(q));
+  Assert("error - bad A nnz",MAT_get_nnz(PROB_get_A(q)) == A_nnz);
+  for (i = 0; i < A_nnz; i++) {
+    Assert("error - bad A",MAT_get_i(A,i) == MAT_get_i(PROB_get_A(q),i));
+    Assert("error - bad A",MAT_get_j(A,i) == MAT_get_j(PROB_get_A(q),i));
+    Assert("error - bad A",MAT_get_d(A,i) == MAT_get_d(PROB_get_A(q),i));
+  }
+  Assert("error - bad b size",VEC_get_size(PROB_get_b(p)) == VEC_get_size(PROB_get_b(q)));
+  for (i = 0; i < VEC_get_size(PROB_get_b(p)); i++)
+    Assert("error - bad b",VEC_get(PROB_get_b(p),i) == VEC_get(PROB_get_b(q),i));
+  Assert("error - bad u size",VEC_get_size(PROB_get_u(p)) == VEC_get_size(PROB_get_u(q)));
+  for (i = 0; i < VEC_get_size(PROB_get_u(p)); i++)
+    Assert("error - bad u",VEC_get(PROB_get_u(p),i) == VEC_get(PROB_get_u(q),i));
+  PROB_del(q);
+
+  // Outage
+  cont = CONT_new();
+  CONT_add_branch_outage(cont,NET_get_branch(net,0));
+  CONT_apply(cont);
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  Assert("error - outage not detected",MAT_get_nnz(PROB_get_A(p)) < A_nnz);
+  CONT_clear(cont);
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  Assert("error - outage clear not detected",MAT_get_nnz(PROB_get_A(p)) == A_nnz);
+  CONT_del(cont);
+
+  // Flags
+  NET_set_flags(net,
+		OBJ_LOAD,
+		FLAG_VARS,
+		LOAD_PROP_ANY,
+		LOAD_VAR_P);
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  Assert("error - flags not detected",MAT_get_size2(PROB_get_A(p)) == NET_get_num_vars(net));
+  Assert("error - flags not detected",MAT_get_nnz(PROB_get_A(p)) > A_nnz);
+
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_pool() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Prob* q;
+  Pool* pool;
+  Cont* cont;
+  Vec* x;
+  Mat* J;
+  Mat* H;
+  int num_reuses;
+  int k;
+  int i;
+
+  printf("test_problem_pool ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(1.,net));
+  pool = PROB_get_pool(p);
+  Assert("error - missing pool",pool != NULL);
+  Assert("error - bad constraint pool",CONSTR_get_pool(PROB_get_constr(p)) == pool);
+  Assert("error - bad function pool",FUNC_get_pool(PROB_get_func(p)) == pool);
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  Assert("error - bad number of reuses",POOL_get_num_reuses(pool) == 0);
+  Assert("error - buffers retained",POOL_get_num_bytes(pool) == 0);
+
+  // Structural changes
+  cont = CONT_new();
+  CONT_add_branch_outage(cont,NET_get_branch(net,0));
+  num_reuses = 0;
+  for (k = 0; k < 4; k++) {
+
+    if (k%2 == 0)
+      CONT_apply(cont);
+    else
+      CONT_clear(cont);
+
+    POOL_reset_stats(pool);
+    PROB_analyze(p);
+    Assert("error - problem failed on analyze",!PROB_has_error(p));
+    Assert("error - no buffers reused",POOL_get_num_reuses(pool) > 0);
+    Assert("error - bad high-water mark",POOL_get_max_num_bytes(pool) > 0);
+    Assert("error - buffers retained",POOL_get_num_bytes(pool) == 0);
+    Assert("error - buffers retained",POOL_get_num_buffers(pool) == 0);
+    num_reuses += POOL_get_num_reuses(pool);
+
+    // Compare with new problem
+    q = PROB_new(net);
+    PROB_add_constr(q,CONSTR_ACPF_new(net));
+    PROB_add_constr(q,CONSTR_REG_GEN_new(net));
+    PROB_add_func(q,FUNC_REG_VMAG_new(1.,net));
+    PROB_analyze(q);
+    Assert("error - problem failed on analyze",!PROB_has_error(q));
+    x = PROB_get_init_point(q);
+    PROB_eval(p,x);
+    PROB_eval(q,x);
+    J = PROB_get_J(p);
+    H = PROB_get_H_combined(p);
+    Assert("error - bad J nnz",MAT_get_nnz(J) == MAT_get_nnz(PROB_get_J(q)));
+    for (i = 0; i < MAT_get_nnz(J); i++) {
+      Assert("error - bad J",MAT_get_i(J,i) == MAT_get_i(PROB_get_J(q),i));
+      Assert("error - bad J",MAT_get_j(J,i) == MAT_get_j(PROB_get_J(q),i));
+      Assert("error - bad J",MAT_get_d(J,i) == MAT_get_d(PROB_get_J(q),i));
+    }
+    Assert("error - bad f size",VEC_get_size(PROB_get_f(p)) == VEC_get_size(PROB_get_f(q)));
+    for (i = 0; i < VEC_get_size(PROB_get_f(p)); i++)
+      Assert("error - bad f",VEC_get(PROB_get_f(p),i) == VEC_get(PROB_get_f(q),i));
+    Assert("error - bad H nnz",MAT_get_nnz(H) == MAT_get_nnz(PROB_get_H_combined(q)));
+    Assert("error - bad phi",PROB_get_phi(p) == PROB_get_phi(q));
+    VEC_del(x);
+    PROB_del(q);
+  }
+  Assert("error - no buffers reused",num_reuses > 0);
+  CONT_del(cont);
+
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_eval_levels() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Constr* acpf;
+  Vec* x0;
+  Vec* x1;
+  Vec* f;
+  Vec* gphi;
+  Mat* J;
+  Mat* H;
+  REAL phi;
+  int i;
+
+  printf("test_problem_eval_levels ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_BRANCH,
+		FLAG_VARS,
+		BRANCH_PROP_TAP_CHANGER,
+		BRANCH_VAR_RATIO);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(1.,net));
+
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+  acpf = PROB_find_constr(p,"AC power balance");
+
+  // Points
+  x0 = PROB_get_init_point(p);
+  x1 = VEC_new(VEC_get_size(x0));
+  for (i = 0; i < VEC_get_size(x0); i++)
+    VEC_set(x1,i,VEC_get(x0,i)+1e-2*((i % 7)-3.));
+
+  // Full at x1
+  PROB_eval(p,x1);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  phi = PROB_get_phi(p);
+  f = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    VEC_set(f,i,VEC_get(PROB_get_f(p),i));
+  gphi = VEC_new(VEC_get_size(PROB_get_gphi(p)));
+  for (i = 0; i < VEC_get_size(gphi); i++)
+    VEC_set(gphi,i,VEC_get(PROB_get_gphi(p),i));
+  J = MAT_copy(PROB_get_J(p));
+  H = MAT_copy(MAT_array_get(CONSTR_get_H_array(acpf),0));
+
+  // Full at x0
+  PROB_eval(p,x0);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  Assert("error - bad ACPF eval level",CONSTR_get_eval_level(acpf) == EVAL_FJH);
+
+  // Values only at x1 (derivatives stay at x0)
+  PROB_eval_f(p,x1);
+  Assert("error - problem failed on eval_f",!PROB_has_error(p));
+  Assert("error - bad ACPF eval level",CONSTR_get_eval_level(acpf) == EVAL_F);
+  Assert("error - bad phi",fabs(PROB_get_phi(p)-phi) < 1e-10*(1.+fabs(phi)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    Assert("error - bad f",fabs(VEC_get(PROB_get_f(p),i)-VEC_get(f,i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(J); i++) {
+    if (fabs(MAT_get_d(PROB_get_J(p),i)-MAT_get_d(J,i)) > 1e-10)
+      break;
+  }
+  Assert("error - J evaluated at level f",i < MAT_get_nnz(J));
+
+  // Values and first derivatives at x1
+  PROB_eval_fJ(p,x1);
+  Assert("error - problem failed on eval_fJ",!PROB_has_error(p));
+  Assert("error - bad phi",fabs(PROB_get_phi(p)-phi) < 1e-10*(1.+fabs(phi)));
+  for (i = 0; i < VEC_get_size(f); i++)
+    Assert("error - bad f",fabs(VEC_get(PROB_get_f(p),i)-VEC_get(f,i)) < 1e-10);
+  for (i = 0; i < VEC_get_size(gphi); i++)
+    Assert("error - bad gphi",fabs(VEC_get(PROB_get_gphi(p),i)-VEC_get(gphi,i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(J); i++)
+    Assert("error - bad J",fabs(MAT_get_d(PROB_get_J(p),i)-MAT_get_d(J,i)) < 1e-10);
+  for (i = 0; i < MAT_get_nnz(H); i++) {
+    if (fabs(MAT_get_d(MAT_array_get(CONSTR_get_H_array(acpf),0),i)-MAT_get_d(H,i)) > 1e-10)
+      break;
+  }
+  Assert("error - H evaluated at level fJ",i < MAT_get_nnz(H));
+
+  // Incremental requires full evaluation
+  PROB_eval_incremental(p,x0,x1);
+  Assert("error - problem failed on incremental eval",!PROB_has_error(p));
+  Assert("error - bad ACPF eval level",CONSTR_get_eval_level(acpf) == EVAL_FJH);
+
+  // Bad level
+  PROB_eval_with_level(p,x1,0);
+  Assert("error - bad level not detected",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  VEC_del(x0);
+  VEC_del(x1);
+  VEC_del(f);
+  VEC_del(gphi);
+  MAT_del(J);
+  MAT_del(H);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_closed_form_counts() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p[2];
+  Constr* c;
+  Func* f;
+  Bus* bus;
+  Branch* br;
+  Mat* m[2];
+  int i;
+  int j;
+  int k;
+
+  printf("test_problem_closed_form_counts ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,3);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_LOAD,
+		FLAG_VARS,
+		LOAD_PROP_ANY,
+		LOAD_VAR_P);
+
+  // Problems with and without closed-form counts
+  for (k = 0; k < 2; k++) {
+    p[k] = PROB_new(net);
+    PROB_add_constr(p[k],CONSTR_LBOUND_new(net));
+    PROB_add_constr(p[k],CONSTR_GEN_RAMP_new(net));
+    PROB_add_constr(p[k],CONSTR_PAR_GEN_P_new(net));
+    PROB_add_func(p[k],FUNC_GEN_COST_new(1.,net));
+    PROB_add_func(p[k],FUNC_LOAD_UTIL_new(1.,net));
+  }
+  for (c = PROB_get_constr(p[1]); c != NULL; c = CONSTR_get_next(c))
+    CONSTR_set_func_count(c,NULL);
+  for (f = PROB_get_func(p[1]); f != NULL; f = FUNC_get_next(f))
+    FUNC_set_func_count(f,NULL);
+  Assert("error - sweep needed",!CONSTR_list_needs_count_sweep(PROB_get_constr(p[0])));
+  Assert("error - sweep needed",!FUNC_list_needs_count_sweep(PROB_get_func(p[0])));
+  Assert("error - sweep not needed",CONSTR_list_needs_count_sweep(PROB_get_constr(p[1])));
+
+  for (j = 0; j < 2; j++) {
+
+    // Isolate a bus with generators
+    if (j == 1) {
+      bus = GEN_get_bus(NET_get_gen(net,0));
+      for (br = BUS_get_branch_k(bus); br != NULL; br = BRANCH_get_next_k(br))
+	BRANCH_set_outage(br,TRUE);
+      for (br = BUS_get_branch_m(bus); br != NULL; br = BRANCH_get_next_m(br))
+	BRANCH_set_outage(br,TRUE);
+      Assert("error - bus not isolated",BUS_is_isolated(bus));
+    }
+
+    for (k = 0; k < 2; k++) {
+      PROB_analyze(p[k]);
+      Assert("error - problem failed on analyze",!PROB_has_error(p[k]));
+    }
+
+    // Same structure
+    for (i = 0; i < 3; i++) {
+      for (k = 0; k < 2; k++) {
+	if (i == 0)
+	  m[k] = PROB_get_A(p[k]);
+	else if (i == 1)
+	  m[k] = PROB_get_G(p[k]);
+	else
+	  m[k] = PROB_get_Hphi(p[k]);
+      }
+      Assert("error - bad size",MAT_get_size1(m[0]) == MAT_get_size1(m[1]));
+      Assert("error - bad nnz",MAT_get_nnz(m[0]) == MAT_get_nnz(m[1]));
+      for (k = 0; k < MAT_get_nnz(m[0]); k++) {
+	Assert("error - bad row",MAT_get_i(m[0],k) == MAT_get_i(m[1],k));
+	Assert("error - bad col",MAT_get_j(m[0],k) == MAT_get_j(m[1],k));
+      }
+    }
+    Assert("error - bad G",MAT_get_nnz(PROB_get_G(p[0])) > NET_get_num_vars(net));
+    Assert("error - bad Hphi",MAT_get_nnz(PROB_get_Hphi(p[0])) > 0);
+  }
+
+  for (k = 0; k < 2; k++)
+    PROB_del(p[k]);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_eval_batch() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Vec* x0;
+  Vec* x;
+  Vec* points;
+  Vec* phi;
+  Vec* f;
+  Vec* J;
+  int num_points;
+  int num_vars;
+  int num_f;
+  int num_J;
+  int i;
+  int k;
+
+  printf("test_problem_eval_batch ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  // Sizes
+  num_points = 3;
+  num_vars = PROB_get_num_primal_variables(p);
+  num_f = VEC_get_size(PROB_get_f(p));
+  num_J = MAT_get_nnz(PROB_get_J(p));
+  Assert("error - bad sizes",num_vars > 0 && num_f > 0 && num_J > 0);
+
+  // Points
+  x0 = PROB_get_init_point(p);
+  points = VEC_new(num_points*num_vars);
+  for (k = 0; k < num_points; k++) {
+    for (i = 0; i < num_vars; i++)
+      VEC_set(points,k*num_vars+i,VEC_get(x0,i)+1e-2*k*((i % 5)-2.));
+  }
+
+  // Batch
+  phi = VEC_new(num_points);
+  f = VEC_new(num_points*num_f);
+  J = VEC_new(num_points*num_J);
+  PROB_eval_batch(p,points,num_points,phi,f,J);
+  Assert("error - problem failed on eval_batch",!PROB_has_error(p));
+
+  // Compare with single evaluations
+  for (k = 0; k < num_points; k++) {
+    x = VEC_new_from_array(&(VEC_get_data(points)[k*num_vars]),num_vars);
+    PROB_eval(p,x);
+    free(x);
+    Assert("error - problem failed on eval",!PROB_has_error(p));
+    Assert("error - bad phi",fabs(VEC_get(phi,k)-PROB_get_phi(p)) < 1e-10*(1.+fabs(PROB_get_phi(p))));
+    for (i = 0; i < num_f; i++)
+      Assert("error - bad f",fabs(VEC_get(f,k*num_f+i)-VEC_get(PROB_get_f(p),i)) < 1e-10);
+    for (i = 0; i < num_J; i++)
+      Assert("error - bad J",fabs(VEC_get(J,k*num_J+i)-MAT_get_d(PROB_get_J(p),i)) < 1e-10);
+  }
+
+  // Values only
+  PROB_eval_batch(p,points,num_points,NULL,f,NULL);
+  Assert("error - problem failed on eval_batch",!PROB_has_error(p));
+  for (i = 0; i < num_f; i++)
+    Assert("error - bad f",fabs(VEC_get(f,(num_points-1)*num_f+i)-VEC_get(PROB_get_f(p),i)) < 1e-10);
+
+  // Bad size
+  PROB_eval_batch(p,points,num_points+1,phi,f,J);
+  Assert("error - bad size not detected",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  VEC_del(x0);
+  VEC_del(points);
+  VEC_del(phi);
+  VEC_del(f);
+  VEC_del(J);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static char* test_problem_products() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  Mat* J;
+  Mat* H;
+  Vec* x0;
+  Vec* x;
+  Vec* v;
+  Vec* w;
+  Vec* coeff;
+  Vec* Jv;
+  Vec* JTw;
+  Vec* Hv;
+  Vec* Jv_ref;
+  Vec* JTw_ref;
+  Vec* Hv_ref;
+  int num_vars;
+  int num_f;
+  int i;
+  int j;
+  int k;
+
+  printf("test_problem_products ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Ratings (for flow limits)
+  for (i = 0; i < NET_get_num_branches(net); i++)
+    BRANCH_set_ratingA(NET_get_branch(net,i),1.+0.1*i);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_BRANCH,
+		FLAG_VARS,
+		BRANCH_PROP_ANY,
+		BRANCH_VAR_RATIO|BRANCH_VAR_PHASE);
+  NET_set_flags(net,
+		OBJ_SHUNT,
+		FLAG_VARS,
+		SHUNT_PROP_ANY,
+		SHUNT_VAR_SUSC);
+  NET_set_flags(net,
+		OBJ_LOAD,
+		FLAG_VARS,
+		LOAD_PROP_ANY,
+		LOAD_VAR_P|LOAD_VAR_Q);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_constr(p,CONSTR_REG_GEN_new(net));
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  // Sizes
+  num_vars = PROB_get_num_primal_variables(p);
+  num_f = VEC_get_size(PROB_get_f(p));
+  Assert("error - bad sizes",num_vars > 0 && num_f > 0 && num_vars != num_f);
+  Assert("error - no extra vars",PROB_get_num_extra_vars(p) > 0);
+
+  // Vectors
+  x0 = PROB_get_init_point(p);
+  x = VEC_new(num_vars);
+  v = VEC_new(num_vars);
+  w = VEC_new(num_f);
+  coeff = VEC_new(num_f);
+  Jv = VEC_new(num_f);
+  JTw = VEC_new(num_vars);
+  Hv = VEC_new(num_vars);
+  for (i = 0; i < num_vars; i++) {
+    VEC_set(x,i,VEC_get(x0,i)+1e-2*((i % 5)-2.));
+    VEC_set(v,i,1.+0.1*(i % 7));
+  }
+  for (i = 0; i < num_f; i++) {
+    VEC_set(w,i,0.5-0.1*(i % 9));
+    VEC_set(coeff,i,(i % 4)-1.5);
+  }
+
+  // Reference products from stored J and combined Hessian
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  J = PROB_get_J(p);
+  H = PROB_get_H_combined(p);
+  Jv_ref = MAT_rmul_by_vec(J,v);
+  JTw_ref = VEC_new(num_vars);
+  for (k = 0; k < MAT_get_nnz(J); k++)
+    VEC_add_to_entry(JTw_ref,MAT_get_j(J,k),MAT_get_d(J,k)*VEC_get(w,MAT_get_i(J,k)));
+  Hv_ref = VEC_new(num_vars);
+  for (k = 0; k < MAT_get_nnz(H); k++) {
+    i = MAT_get_i(H,k);
+    j = MAT_get_j(H,k);
+    VEC_add_to_entry(Hv_ref,i,MAT_get_d(H,k)*VEC_get(v,j));
+    if (i != j)
+      VEC_add_to_entry(Hv_ref,j,MAT_get_d(H,k)*VEC_get(v,i));
+  }
+
+  // Products
+  PROB_eval_Jv(p,x,v,Jv);
+  Assert("error - problem failed on eval_Jv",!PROB_has_error(p));
+  for (i = 0; i < num_f; i++)
+    Assert("error - bad Jv",fabs(VEC_get(Jv,i)-VEC_get(Jv_ref,i)) < 1e-8*(1.+fabs(VEC_get(Jv_ref,i))));
+  PROB_eval_JTw(p,x,w,JTw);
+  Assert("error - problem failed on eval_JTw",!PROB_has_error(p));
+  for (i = 0; i < num_vars; i++)
+    Assert("error - bad JTw",fabs(VEC_get(JTw,i)-VEC_get(JTw_ref,i)) < 1e-8*(1.+fabs(VEC_get(JTw_ref,i))));
+  PROB_eval_Hv(p,x,coeff,v,Hv);
+  Assert("error - problem failed on eval_Hv",!PROB_has_error(p));
+  for (i = 0; i < num_vars; i++)
+    Assert("error - bad Hv",fabs(VEC_get(Hv,i)-VEC_get(Hv_ref,i)) < 1e-8*(1.+fabs(VEC_get(Hv_ref,i))));
+
+  // Stored evaluation unaffected
+  PROB_eval(p,x);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  VEC_del(Jv);
+  Jv = MAT_rmul_by_vec(PROB_get_J(p),v);
+  for (i = 0; i < num_f; i++)
+    Assert("error - bad J",fabs(VEC_get(Jv,i)-VEC_get(Jv_ref,i)) < 1e-10*(1.+fabs(VEC_get(Jv_ref,i))));
+
+  // Bad size
+  PROB_eval_Jv(p,x,w,Jv);
+  Assert("error - bad size not detected",PROB_has_error(p));
+  PROB_clear_error(p);
+
+  VEC_del(x0);
+  VEC_del(x);
+  VEC_del(v);
+  VEC_del(w);
+  VEC_del(coeff);
+  VEC_del(Jv);
+  VEC_del(JTw);
+  VEC_del(Hv);
+  VEC_del(Jv_ref);
+  VEC_del(JTw_ref);
+  VEC_del(Hv_ref);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static BOOL check_merged(Mat* merged, Mat* m) {
+
+  REAL* x;
+  REAL* y;
+  int k;
+  int i;
+  BOOL ok;
+
+  if (!merged || !m)
+    return FALSE;
+  if (MAT_get_size1(merged) != MAT_get_size1(m) ||
+      MAT_get_size2(merged) != MAT_get_size2(m) ||
+      MAT_get_nnz(merged) > MAT_get_nnz(m))
+    return FALSE;
+
+  // Structure (sorted by row and column, duplicate-free)
+  for (k = 1; k < MAT_get_nnz(merged); k++) {
+    if (MAT_get_i(merged,k) < MAT_get_i(merged,k-1))
+      return FALSE;
+    if (MAT_get_i(merged,k) == MAT_get_i(merged,k-1) &&
+	MAT_get_j(merged,k) <= MAT_get_j(merged,k-1))
+      return FALSE;
+  }
+
+  // Values (y = merged*x - m*x)
+  x = (REAL*)malloc(sizeof(REAL)*(MAT_get_size2(m)+1));
+  y = (REAL*)calloc(MAT_get_size1(m)+1,sizeof(REAL));
+  for (i = 0; i < MAT_get_size2(m); i++)
+    x[i] = 1.+0.01*(i % 13);
+  for (k = 0; k < MAT_get_nnz(merged); k++)
+    y[MAT_get_i(merged,k)] += MAT_get_d(merged,k)*x[MAT_get_j(merged,k)];
+  for (k = 0; k < MAT_get_nnz(m); k++)
+    y[MAT_get_i(m,k)] -= MAT_get_d(m,k)*x[MAT_get_j(m,k)];
+  ok = TRUE;
+  for (i = 0; i < MAT_get_size1(m); i++) {
+    if (fabs(y[i]) > 1e-10)
+      ok = FALSE;
+  }
+  free(x);
+  free(y);
+  return ok;
+}
+
+static char* test_problem_merged() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p1;
+  Prob* p2;
+  Vec* x;
+  Vec* coeff;
+  int i;
+  int k;
+
+  printf("test_problem_merged ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG|BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  for (k = 0; k < NET_get_num_branches(net); k++)
+    BRANCH_set_ratingA(NET_get_branch(net,k),1.);
+
+  // Problems (merged and concatenated layouts)
+  p1 = PROB_new(net);
+  p2 = PROB_new(net);
+  Assert("error - bad default layout",PROB_get_merge_duplicates(p1));
+  PROB_set_merge_duplicates(p2,FALSE);
+  Assert("error - bad layout flag",!PROB_get_merge_duplicates(p2));
+  Assert("error - bad J init",PROB_get_J(p1) == NULL);
+  PROB_add_constr(p1,CONSTR_ACPF_new(net));
+  PROB_add_constr(p1,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_func(p1,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p1,FUNC_REG_VMAG_new(2.,net));
+  PROB_add_constr(p2,CONSTR_ACPF_new(net));
+  PROB_add_constr(p2,CONSTR_AC_FLOW_LIM_new(net));
+  PROB_add_func(p2,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p2,FUNC_REG_VMAG_new(2.,net));
+  PROB_analyze(p1);
+  PROB_analyze(p2);
+  Assert("error - problem failed on analyze",!PROB_has_error(p1) && !PROB_has_error(p2));
+
+  // Eval
+  x = PROB_get_init_point(p1);
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 5)-2.));
+  coeff = VEC_new(VEC_get_size(PROB_get_f(p1)));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,1.+0.1*(i % 3));
+  for (k = 0; k < 2; k++) {
+    PROB_eval(p1,x);
+    PROB_eval(p2,x);
+    PROB_combine_H(p1,coeff,FALSE);
+    PROB_combine_H(p2,coeff,FALSE);
+    Assert("error - problem failed on eval",!PROB_has_error(p1) && !PROB_has_error(p2));
+
+    // Unique patterns with the same values
+    Assert("error - bad J",check_merged(PROB_get_J(p1),PROB_get_J(p2)));
+    Assert("error - bad Hphi",check_merged(PROB_get_Hphi(p1),PROB_get_Hphi(p2)));
+    Assert("error - bad H_combined",check_merged(PROB_get_H_combined(p1),PROB_get_H_combined(p2)));
+    Assert("error - bad H_combined nnz",
+	   MAT_get_nnz(PROB_get_H_combined(p1)) < MAT_get_nnz(PROB_get_H_combined(p2)));
+    Assert("error - bad J csr",MAT_get_nnz(PROB_get_J(p1)) == SPMAT_get_nnz(PROB_get_J_csr(p1)));
+    Assert("error - bad J view",MAT_get_data_array(PROB_get_J(p1)) == SPMAT_get_data_array(PROB_get_J_csr(p1)));
+
+    // New point
+    for (i = 0; i < VEC_get_size(x); i++)
+      VEC_add_to_entry(x,i,1e-2*((i % 3)-1.));
+  }
+
+  // Switch layouts
+  PROB_set_merge_duplicates(p1,FALSE);
+  Assert("error - bad concatenated J",MAT_get_nnz(PROB_get_J(p1)) == MAT_get_nnz(PROB_get_J(p2)));
+  PROB_set_merge_duplicates(p1,TRUE);
+  Assert("error - bad merged J",check_merged(PROB_get_J(p1),PROB_get_J(p2)));
+
+  VEC_del(x);
+  VEC_del(coeff);
+  PROB_del(p1);
+  PROB_del(p2);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static void add_sym_product(Mat* m, int row_offset, BOOL sym, Vec* v, REAL* y) {
+
+  int i;
+  int j;
+  int k;
+
+  for (k = 0; k < MAT_get_nnz(m); k++) {
+    i = MAT_get_i(m,k)+row_offset;
+    j = MAT_get_j(m,k);
+    y[i] += MAT_get_d(m,k)*VEC_get(v,j);
+    if (i != j && (sym || row_offset > 0))
+      y[j] += MAT_get_d(m,k)*VEC_get(v,i);
+  }
+}
+
+static BOOL check_KKT(Prob* p, SpMat* K, Vec* v, REAL reg_x, REAL reg_c) {
+
+  REAL* y;
+  int num_vars;
+  int num_J;
+  int num_A;
+  int i;
+  int k;
+  BOOL ok;
+
+  num_vars = PROB_get_num_primal_variables(p);
+  num_J = VEC_get_size(PROB_get_f(p));
+  num_A = VEC_get_size(PROB_get_b(p));
+  if (!K || SPMAT_get_size1(K) != VEC_get_size(v) || SPMAT_get_size2(K) != VEC_get_size(v))
+    return FALSE;
+
+  // Lower triangular
+  for (i = 0; i < SPMAT_get_size1(K); i++) {
+    for (k = SPMAT_get_ptr_array(K)[i]; k < SPMAT_get_ptr_array(K)[i+1]; k++) {
+      if (SPMAT_get_ind_array(K)[k] > i)
+	return FALSE;
+    }
+  }
+
+  // y = K*v - reference
+  y = (REAL*)calloc(VEC_get_size(v)+1,sizeof(REAL));
+  for (i = 0; i < SPMAT_get_size1(K); i++) {
+    for (k = SPMAT_get_ptr_array(K)[i]; k < SPMAT_get_ptr_array(K)[i+1]; k++) {
+      y[i] -= SPMAT_get_data_array(K)[k]*VEC_get(v,SPMAT_get_ind_array(K)[k]);
+      if (SPMAT_get_ind_array(K)[k] != i)
+	y[SPMAT_get_ind_array(K)[k]] -= SPMAT_get_data_array(K)[k]*VEC_get(v,i);
+    }
+  }
+  add_sym_product(PROB_get_Hphi(p),0,TRUE,v,y);
+  add_sym_product(PROB_get_H_combined(p),0,TRUE,v,y);
+  add_sym_product(PROB_get_J(p),num_vars,FALSE,v,y);
+  add_sym_product(PROB_get_A(p),num_vars+num_J,FALSE,v,y);
+  add_sym_product(PROB_get_G(p),num_vars+num_J+num_A,FALSE,v,y);
+  for (i = 0; i < VEC_get_size(v); i++)
+    y[i] += (i < num_vars ? reg_x : -reg_c)*VEC_get(v,i);
+  ok = TRUE;
+  for (i = 0; i < VEC_get_size(v); i++) {
+    if (fabs(y[i]) > 1e-8)
+      ok = FALSE;
+  }
+  free(y);
+  return ok;
+}
+
+static char* test_problem_KKT() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  SpMat* K;
+  REAL* data;
+  Vec* x;
+  Vec* v;
+  Vec* coeff;
+  int size;
+  int nnz;
+  int i;
+
+  printf("test_problem_KKT ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Set variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS|FLAG_BOUNDED,
+		BUS_PROP_ANY,
+		BUS_VAR_VMAG);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_ANY,
+		BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_ANY,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_FIXED,
+		BUS_PROP_SLACK,
+		BUS_VAR_VANG);
+
+  p = PROB_new(net);
+  Assert("error - bad KKT init",PROB_get_KKT(p) == NULL);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_FIX_new(net));
+  PROB_add_constr(p,CONSTR_LBOUND_new(net));
+  PROB_add_func(p,FUNC_GEN_COST_new(1.,net));
+  PROB_add_func(p,FUNC_REG_VMAG_new(2.,net));
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  // Sizes
+  size = (PROB_get_num_primal_variables(p)+
+	  VEC_get_size(PROB_get_f(p))+
+	  VEC_get_size(PROB_get_b(p))+
+	  VEC_get_size(PROB_get_l(p)));
+  Assert("error - bad sizes",VEC_get_size(PROB_get_b(p)) > 0 && VEC_get_size(PROB_get_l(p)) > 0);
+
+  // Points
+  x = PROB_get_init_point(p);
+  v = VEC_new(size);
+  for (i = 0; i < size; i++)
+    VEC_set(v,i,1.+0.01*(i % 7));
+  coeff = VEC_new(VEC_get_size(PROB_get_f(p)));
+  for (i = 0; i < VEC_get_size(coeff); i++)
+    VEC_set(coeff,i,1.+0.1*(i % 3));
+
+  // Eval
+  PROB_eval(p,x);
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  K = PROB_get_KKT(p);
+  nnz = SPMAT_get_nnz(K);
+  data = SPMAT_get_data_array(K);
+  Assert("error - bad KKT",check_KKT(p,K,v,0.,0.));
+
+  // New point (same structure, values refilled)
+  for (i = 0; i < VEC_get_size(x); i++)
+    VEC_add_to_entry(x,i,1e-2*((i % 5)-2.));
+  PROB_eval(p,x);
+  Assert("error - bad KKT update",check_KKT(p,K,v,0.,0.));
+  PROB_combine_H(p,coeff,FALSE);
+  Assert("error - problem failed on eval",!PROB_has_error(p));
+  Assert("error - bad KKT reuse",PROB_get_KKT(p) == K);
+  Assert("error - bad KKT reuse",SPMAT_get_nnz(K) == nnz && SPMAT_get_data_array(K) == data);
+  Assert("error - bad KKT update",check_KKT(p,K,v,0.,0.));
+
+  // Regularization
+  PROB_set_KKT_regularization(p,1e-3,2e-3);
+  K = PROB_get_KKT(p);
+  Assert("error - bad KKT regularization",check_KKT(p,K,v,1e-3,2e-3));
+  for (i = 0; i < size; i++)
+    Assert("error - bad KKT diagonal",SPMAT_get_ind_array(K)[SPMAT_get_ptr_array(K)[i+1]-1] == i);
+  PROB_set_KKT_regularization(p,3e-3,4e-3);
+  Assert("error - bad KKT regularization",PROB_get_KKT(p) == K && check_KKT(p,K,v,3e-3,4e-3));
+
+  VEC_del(x);
+  VEC_del(v);
+  VEC_del(coeff);
+  PROB_del(p);
+  NET_del(net);
+  PARSER_del(parser);
+  printf("ok\n");
+  return 0;
+}
+
+static void set_newton_matrix(Prob* p, Mat* M) {
+
+  Mat* A;
+  Mat* J;
+  int k;
+
+  A = PROB_get_A(p);
+  J = PROB_get_J(p);
+  for (k = 0; k < MAT_get_nnz(A); k++) {
+    MAT_set_i(M,k,MAT_get_i(A,k));
+    MAT_set_j(M,k,MAT_get_j(A,k));
+    MAT_set_d(M,k,MAT_get_d(A,k));
+  }
+  for (k = 0; k < MAT_get_nnz(J); k++) {
+    MAT_set_i(M,MAT_get_nnz(A)+k,MAT_get_size1(A)+MAT_get_i(J,k));
+    MAT_set_j(M,MAT_get_nnz(A)+k,MAT_get_j(J,k));
+    MAT_set_d(M,MAT_get_nnz(A)+k,MAT_get_d(J,k));
+  }
+}
+
+static REAL lu_residual(Mat* M, BOOL sym, Vec* x, Vec* b) {
+
+  REAL* r;
+  REAL res;
+  int i;
+  int j;
+  int k;
+
+  r = (REAL*)calloc(VEC_get_size(b)+1,sizeof(REAL));
+  for (i = 0; i < VEC_get_size(b); i++)
+    r[i] = -VEC_get(b,i);
+  for (k = 0; k < MAT_get_nnz(M); k++) {
+    i = MAT_get_i(M,k);
+    j = MAT_get_j(M,k);
+    r[i] += MAT_get_d(M,k)*VEC_get(x,j);
+    if (sym && i != j)
+      r[j] += MAT_get_d(M,k)*VEC_get(x,i);
+  }
+  res = 0;
+  for (i = 0; i < VEC_get_size(b); i++)
+    res = fabs(r[i]) > res ? fabs(r[i]) : res;
+  free(r);
+  return res;
+}
+
+static char* test_problem_splu() {
+
+  Parser* parser;
+  Net* net;
+  Prob* p;
+  SpLU* lu;
+  SpMat* S;
+  SpMat* K;
+  Mat* M;
+  Mat* Kcoo;
+  Vec* x;
+  Vec* b;
+  Vec* sol;
+  int* Q;
+  int n;
+  int i;
+  int k;
+
+  printf("test_problem_splu ...");
+
+  parser = PARSER_new_for_file(test_case);
+  net = PARSER_parse(parser,test_case,2);
+
+  // Power flow variables
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_NOT_REG_BY_GEN,
+		BUS_VAR_VMAG);
+  NET_set_flags(net,
+		OBJ_BUS,
+		FLAG_VARS,
+		BUS_PROP_NOT_SLACK,
+		BUS_VAR_VANG);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_SLACK,
+		GEN_VAR_P|GEN_VAR_Q);
+  NET_set_flags(net,
+		OBJ_GEN,
+		FLAG_VARS,
+		GEN_PROP_REG,
+		GEN_VAR_Q);
+
+  p = PROB_new(net);
+  PROB_add_constr(p,CONSTR_ACPF_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_P_new(net));
+  PROB_add_constr(p,CONSTR_PAR_GEN_Q_new(net));
+  PROB_analyze(p);
+  Assert("error - problem failed on analyze",!PROB_has_error(p));
+
+  // Newton matrix [A;J]
+  n = PROB_get_num_primal_variables(p);
+  Assert("error - bad Newton system",
+	 n == MAT_get_size1(PROB_get_A(p))+MAT_get_size1(PROB_get_J(p)));
+  x = PROB_get_init_point(p);
+  PROB_eval(p,x);
+  M = MAT_new(n,n,MAT_get_nnz(PROB_get_A(p))+MAT_get_nnz(PROB_get_J(p)));
+  set_newton_matrix(p,M);
+  S = SPMAT_new_from_mat(M,SPMAT_CSC);
+  b = VEC_new(n);
+  sol = VEC_new(n);
+
+  // Init
+  lu = SPLU_new();
+  Assert("error - bad LU init",!SPLU_is_factorized(lu) && SPLU_get_size(lu) == 0);
+  SPLU_solve(lu,sol);
+  Assert("error - solve without factors not detected",SPLU_has_error(lu));
+  SPLU_clear_error(lu);
+
+  // Factorize and solve
+  SPLU_factorize(lu,S);
+  Assert("error - LU failed",!SPLU_has_error(lu) && SPLU_is_factorized(lu));
+  Assert("error - bad LU size",SPLU_get_size(lu) == n);
+  Assert("error - bad LU nnz",SPLU_get_L_nnz(lu) >= n && SPLU_get_U_nnz(lu) >= n);
+  Q = SPLU_get_ordering(lu);
+  for (i = 0; i < n; i++)
+    VEC_set(sol,i,0.);
+  for (i = 0; i < n; i++)
+    VEC_add_to_entry(sol,Q[i],1.);
+  for (i = 0; i < n; i++)
+    Assert("error - bad ordering",VEC_get(sol,i) == 1.);
+  for (i = 0; i < n; i++) {
+    VEC_set(b,i,1.+0.1*(i % 7));
+    VEC_set(sol,i,VEC_get(b,i));
+  }
+  SPLU_solve(lu,sol);
+  Assert("error - LU solve failed",!SPLU_has_error(lu));
+  Assert("error - bad LU solution",lu_residual(M,FALSE,sol,b) < 1e-8);
+
+  // Same pattern, new values (pivot sequence reused)
+  for (k = 0; k < 3; k++) {
+    for (i = 0; i < VEC_get_size(x); i++)
+      VEC_add_to_entry(x,i,1e-2*((i % 5)-2.));
+    PROB_eval(p,x);
+    set_newton_matrix(p,M);
+    SPMAT_update(S,M);
+    SPLU_refactorize(lu,S);
+    Assert("error - LU refactorization failed",!SPLU_has_error(lu));
+    for (i = 0; i < n; i++)
+      VEC_set(sol,i,VEC_get(b,i));
+    SPLU_solve(lu,sol);
+    Assert("error - bad LU solution after refactorization",lu_residual(M,FALSE,sol,b) < 1e-8);
+  }
+  Assert("error - bad number of factorizations",SPLU_get_num_factorizations(lu) == 1);
+  Assert("error - bad number of refactorizations",SPLU_get_num_refactorizations(lu) == 3);
+
+  // Bad size
+  VEC_del(sol);
+  sol = VEC_new(n+1);
+  SPLU_solve(lu,sol);
+  Assert("error - bad size not detected",SPLU_has_error(lu));
+  SPLU_clear_error(lu);
+
+  // Symmetric KKT (lower triangular part)
+  PROB_add_func(p,FUNC_REG_VMAG_new(1.,net));
+  PROB_analyze(p);
+  PROB_eval(p,x);
+  PROB_set_KKT_regularization(p,1e-4,1e-4);
+  K = PROB_get_KKT(p);
+  SPLU_set_symmetric(lu,TRUE);
+  SPLU_factorize(lu,K);
+  Assert("error - KKT LU failed",!SPLU_has_error(lu));
+  Assert("error - bad KKT LU size",SPLU_get_size(lu) == SPMAT_get_size1(K));
+  Kcoo = SPMAT_new_mat_view(K);
+  VEC_del(b);
+  VEC_del(sol);
+  b = VEC_new(SPMAT_get_size1(K));
+  sol = VEC_new(SPMAT_get_size1(K));
+  for (i = 0; i < VEC_get_size(b); i++) {
+    VEC_set(b,i,1.-0.1*(i % 5));
+    VEC_set(sol,i,VEC_get(b,i));
+  }
+  SPLU_solve(lu,sol);
+  Assert("error - bad KKT solution",lu_residual(Kcoo,TRUE,sol,b) < 1e-8);
+  MAT_del(Kcoo);
+
+  // Same size and nnz, different pattern (refactorization not reused)
+  MAT_del(M);
+  SPMAT_del(S);
+  SPLU_set_symmetric(lu,FALSE);
+  for (k = 0; k < 2; k++) {
+    M = MAT_new(41,41,43);
+    for (i = 0; i < 41; i++) {
+      MAT_set_i(M,i,i);
+      MAT_set_j(M,i,i);
+      MAT_set_d(M,i,4.);
+    }
+    MAT_set_i(M,41,k == 0 ? 2 : 3);
+    MAT_set_j(M,41,0);
+    MAT_set_d(M,41,1.);
+    MAT_set_i(M,42,k == 0 ? 40 : 9);
+    MAT_set_j(M,42,0);
+    MAT_set_d(M,42,1.);
+    S = SPMAT_new_from_mat(M,SPMAT_CSC);
+    if (k == 0) {
+      SPLU_factorize(lu,S);
+      Assert("error - LU failed",!SPLU_has_error(lu));
+    }
+    else {
+      Assert("error - different pattern reported as matching",!SPLU_matches_pattern(lu,S));
+      i = SPLU_get_num_factorizations(lu);
+      SPLU_refactorize(lu,S);
+      Assert("error - LU refactorization failed",!SPLU_has_error(lu));
+      Assert("error - factors of a different pattern reused",SPLU_get_num_factorizations(lu) == i+1);
+    }
+    VEC_del(b);
+    VEC_del(sol);
+    b = VEC_new(41);
+    sol = VEC_new(41);
+    for (i = 0; i < 41; i++) {
+      VEC_set(b,i,1.+0.1*(i % 3));
+      VEC_set(sol,i,VEC_get(b,i));
+    }
+    SPLU_solve(lu,sol);
+    Assert("error - bad LU solution",lu_residual(M,FALSE,sol,b) < 1e-8);
+    Assert("error - pattern not matched",SPLU_matches_pattern(lu,S));
+    MAT_del(M);
+    SPMAT_del(S);
+  }
+
+  // Singular
+  M = MAT_new(2,2,2);
+  MAT_set_i(M,0,0);
+  MAT_set_j(M,0,0);
+  MAT_set_i(M,1,1);
+  MAT_set_j(M,1,0);
+  S = SPMAT_new_from_mat(M,SPMAT_CSR);
+  SPLU_set_symmetric(lu,FALSE);
+  SPLU_factorize(lu,S);
+  Assert("error - singular matrix not detected",SPLU_has_error(lu) && !SPLU_is_factorized(lu));
+
+  SPLU_del(lu);
+  SPMAT_del(S);
+  MAT_del(M);
   VEC_del(x);
+  VEC_del(b);
+  VEC_del(sol);
   PROB_del(p);
   NET_del(net);
   PARSER_del(parser);